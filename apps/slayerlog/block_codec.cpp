@@ -0,0 +1,221 @@
+#include "block_codec.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+constexpr std::size_t minimum_match_length = 4;
+// Matches may not start within the last bytes of a block and must leave a literal tail, mirroring LZ4.
+constexpr std::size_t match_start_margin = 12;
+constexpr std::size_t literal_tail_size  = 5;
+constexpr std::size_t maximum_offset     = 65535;
+constexpr unsigned hash_bits             = 14;
+
+std::uint32_t read_u32(const char* data)
+{
+    std::uint32_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::uint32_t hash_sequence(std::uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - hash_bits);
+}
+
+void write_length_extension(std::string& output, std::size_t length)
+{
+    while (length >= 255)
+    {
+        output.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+
+    output.push_back(static_cast<char>(length));
+}
+
+void write_sequence(std::string& output, std::string_view literals, std::size_t offset, std::size_t match_length)
+{
+    const std::size_t literal_nibble = literals.size() < 15 ? literals.size() : 15;
+    std::size_t match_nibble         = 0;
+    if (match_length > 0)
+    {
+        const std::size_t encoded_match = match_length - minimum_match_length;
+        match_nibble                    = encoded_match < 15 ? encoded_match : 15;
+    }
+
+    output.push_back(static_cast<char>((literal_nibble << 4) | match_nibble));
+    if (literal_nibble == 15)
+    {
+        write_length_extension(output, literals.size() - 15);
+    }
+
+    output.append(literals);
+    if (match_length == 0)
+    {
+        return;
+    }
+
+    output.push_back(static_cast<char>(offset & 0xFF));
+    output.push_back(static_cast<char>((offset >> 8) & 0xFF));
+    if (match_nibble == 15)
+    {
+        write_length_extension(output, match_length - minimum_match_length - 15);
+    }
+}
+
+std::size_t read_length_extension(std::string_view compressed, std::size_t& position)
+{
+    std::size_t length = 0;
+    while (true)
+    {
+        if (position >= compressed.size())
+        {
+            throw std::runtime_error("Compressed block is truncated");
+        }
+
+        const auto byte = static_cast<unsigned char>(compressed[position++]);
+        length += byte;
+        if (byte != 255)
+        {
+            return length;
+        }
+    }
+}
+
+} // namespace
+
+std::string compress_block(std::string_view input)
+{
+    if (input.size() >= UINT32_MAX)
+    {
+        throw std::length_error("Block is too large to compress");
+    }
+
+    std::string output;
+    output.reserve(input.size() + input.size() / 255 + 16);
+
+    std::size_t anchor = 0;
+    if (input.size() > match_start_margin)
+    {
+        // Slot values are positions plus one so zero can mean "empty".
+        std::vector<std::uint32_t> table(std::size_t {1} << hash_bits, 0);
+        const char* data              = input.data();
+        const std::size_t match_limit = input.size() - match_start_margin;
+        const std::size_t match_end   = input.size() - literal_tail_size;
+
+        std::size_t position = 0;
+        while (position < match_limit)
+        {
+            const std::uint32_t sequence = read_u32(data + position);
+            std::uint32_t& slot          = table[hash_sequence(sequence)];
+            const std::size_t candidate  = slot;
+            slot                         = static_cast<std::uint32_t>(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > maximum_offset || read_u32(data + candidate - 1) != sequence)
+            {
+                ++position;
+                continue;
+            }
+
+            std::size_t match_position = candidate - 1;
+            while (position > anchor && match_position > 0 && data[position - 1] == data[match_position - 1])
+            {
+                --position;
+                --match_position;
+            }
+
+            std::size_t match_length = minimum_match_length;
+            while (position + match_length < match_end && data[position + match_length] == data[match_position + match_length])
+            {
+                ++match_length;
+            }
+
+            write_sequence(output, input.substr(anchor, position - anchor), position - match_position, match_length);
+            position += match_length;
+            anchor = position;
+        }
+    }
+
+    write_sequence(output, input.substr(anchor), 0, 0);
+    return output;
+}
+
+void decompress_block(std::string_view compressed, std::size_t decompressed_size, std::string& output)
+{
+    output.resize(decompressed_size);
+    std::size_t input_position  = 0;
+    std::size_t output_position = 0;
+
+    while (input_position < compressed.size())
+    {
+        const auto token           = static_cast<unsigned char>(compressed[input_position++]);
+        std::size_t literal_length = token >> 4;
+        if (literal_length == 15)
+        {
+            literal_length += read_length_extension(compressed, input_position);
+        }
+
+        if (literal_length > compressed.size() - input_position || literal_length > decompressed_size - output_position)
+        {
+            throw std::runtime_error("Compressed block has an out of range literal run");
+        }
+
+        std::memcpy(&output[output_position], compressed.data() + input_position, literal_length);
+        input_position += literal_length;
+        output_position += literal_length;
+        if (input_position == compressed.size())
+        {
+            break;
+        }
+
+        if (compressed.size() - input_position < 2)
+        {
+            throw std::runtime_error("Compressed block is truncated");
+        }
+
+        const std::size_t offset = static_cast<unsigned char>(compressed[input_position]) | (static_cast<std::size_t>(static_cast<unsigned char>(compressed[input_position + 1])) << 8);
+        input_position += 2;
+
+        std::size_t match_length = (token & 0x0F) + minimum_match_length;
+        if ((token & 0x0F) == 15)
+        {
+            match_length += read_length_extension(compressed, input_position);
+        }
+
+        if (offset == 0 || offset > output_position || match_length > decompressed_size - output_position)
+        {
+            throw std::runtime_error("Compressed block has an out of range match");
+        }
+
+        // Matches may overlap their own output, so copy forward byte by byte when they do.
+        const std::size_t match_position = output_position - offset;
+        if (offset >= match_length)
+        {
+            std::memcpy(&output[output_position], &output[match_position], match_length);
+        }
+        else
+        {
+            for (std::size_t index = 0; index < match_length; ++index)
+            {
+                output[output_position + index] = output[match_position + index];
+            }
+        }
+
+        output_position += match_length;
+    }
+
+    if (output_position != decompressed_size)
+    {
+        throw std::runtime_error("Compressed block does not match its recorded size");
+    }
+}
+
+} // namespace slayerlog
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace slayerlog
+{
+
+/**
+ * @brief Compresses a block with a fast byte-oriented LZ77 codec laid out like the LZ4 block format.
+ *
+ * Blocks carry no header; callers keep the uncompressed size next to the compressed bytes.
+ */
+std::string compress_block(std::string_view input);
+
+/** @brief Decompresses a block produced by compress_block into output; throws std::runtime_error on corrupt input. */
+void decompress_block(std::string_view compressed, std::size_t decompressed_size, std::string& output);
+
+} // namespace slayerlog
@@ -0,0 +1,271 @@
+#include "clipboard.hpp"
+#include "debug_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#    define NOMINMAX
+#    include <windows.h>
+#endif
+
+namespace slayerlog
+{
+
+namespace
+{
+
+std::optional<std::filesystem::path> write_text_to_temp_file(const std::string& text)
+{
+    std::error_code error_code;
+    const auto directory = std::filesystem::temp_directory_path(error_code);
+    if (error_code)
+    {
+        return std::nullopt;
+    }
+
+    const auto unique_suffix = std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+    const auto path          = directory / ("slayerlog-selection-" + unique_suffix + ".txt");
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (!output.flush())
+    {
+        SLAYERLOG_LOG_WARNING("Failed to write selection file=" << path.string());
+        return std::nullopt;
+    }
+
+    return path;
+}
+
+#ifdef _WIN32
+
+bool copy_with_windows_clipboard(const std::string& text)
+{
+    const int wide_length = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, nullptr, 0);
+    if (wide_length <= 0)
+    {
+        return false;
+    }
+
+    auto* memory = GlobalAlloc(GMEM_MOVEABLE, static_cast<SIZE_T>(wide_length) * sizeof(wchar_t));
+    if (memory == nullptr)
+    {
+        return false;
+    }
+
+    auto* wide_text = static_cast<wchar_t*>(GlobalLock(memory));
+    if (wide_text == nullptr)
+    {
+        GlobalFree(memory);
+        return false;
+    }
+
+    const int converted = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, wide_text, wide_length);
+    GlobalUnlock(memory);
+    if (converted <= 0)
+    {
+        GlobalFree(memory);
+        return false;
+    }
+
+    if (!OpenClipboard(nullptr))
+    {
+        GlobalFree(memory);
+        return false;
+    }
+
+    EmptyClipboard();
+    if (SetClipboardData(CF_UNICODETEXT, memory) == nullptr)
+    {
+        CloseClipboard();
+        GlobalFree(memory);
+        return false;
+    }
+
+    CloseClipboard();
+    return true;
+}
+
+#else
+
+constexpr std::size_t pipe_chunk_bytes = 1024 * 1024;
+
+bool env_var_is_set(const char* name)
+{
+    const auto* value = std::getenv(name);
+    return value != nullptr && value[0] != '\0';
+}
+
+bool is_ssh_session()
+{
+    return env_var_is_set("SSH_CONNECTION") || env_var_is_set("SSH_CLIENT") || env_var_is_set("SSH_TTY");
+}
+
+bool write_text_to_command(const char* command, const std::string& text)
+{
+    auto* pipe = popen(command, "w");
+    if (pipe == nullptr)
+    {
+        return false;
+    }
+
+    // Streaming in chunks stops the copy at the first failed write instead of after pushing the whole selection.
+    std::size_t bytes_written = 0;
+    while (bytes_written < text.size())
+    {
+        const std::size_t chunk_size = std::min(pipe_chunk_bytes, text.size() - bytes_written);
+        if (std::fwrite(text.data() + bytes_written, 1, chunk_size, pipe) != chunk_size)
+        {
+            break;
+        }
+
+        bytes_written += chunk_size;
+    }
+
+    const int status = pclose(pipe);
+    return bytes_written == text.size() && status == 0;
+}
+
+std::string base64_encode(const std::string& text)
+{
+    static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string encoded;
+    encoded.reserve(((text.size() + 2) / 3) * 4);
+
+    std::size_t index = 0;
+    while (index + 3 <= text.size())
+    {
+        const unsigned int value = (static_cast<unsigned char>(text[index]) << 16) | (static_cast<unsigned char>(text[index + 1]) << 8) | static_cast<unsigned char>(text[index + 2]);
+        encoded.push_back(alphabet[(value >> 18) & 0x3F]);
+        encoded.push_back(alphabet[(value >> 12) & 0x3F]);
+        encoded.push_back(alphabet[(value >> 6) & 0x3F]);
+        encoded.push_back(alphabet[value & 0x3F]);
+        index += 3;
+    }
+
+    const std::size_t remainder = text.size() - index;
+    if (remainder == 1)
+    {
+        const unsigned int value = static_cast<unsigned char>(text[index]) << 16;
+        encoded.push_back(alphabet[(value >> 18) & 0x3F]);
+        encoded.push_back(alphabet[(value >> 12) & 0x3F]);
+        encoded.push_back('=');
+        encoded.push_back('=');
+    }
+    else if (remainder == 2)
+    {
+        const unsigned int value = (static_cast<unsigned char>(text[index]) << 16) | (static_cast<unsigned char>(text[index + 1]) << 8);
+        encoded.push_back(alphabet[(value >> 18) & 0x3F]);
+        encoded.push_back(alphabet[(value >> 12) & 0x3F]);
+        encoded.push_back(alphabet[(value >> 6) & 0x3F]);
+        encoded.push_back('=');
+    }
+
+    return encoded;
+}
+
+std::string build_osc52_sequence(const std::string& text)
+{
+    const std::string payload = "52;c;" + base64_encode(text) + '\a';
+
+    if (env_var_is_set("TMUX"))
+    {
+        return "\x1bPtmux;\x1b]" + payload + "\x1b\\";
+    }
+
+    const auto* term = std::getenv("TERM");
+    if (term != nullptr && std::string(term).rfind("screen", 0) == 0)
+    {
+        return "\x1bP\x1b]" + payload + "\x1b\\";
+    }
+
+    return "\x1b]" + payload;
+}
+
+bool write_text_to_terminal_clipboard(const std::string& text)
+{
+    auto* terminal = std::fopen("/dev/tty", "w");
+    if (terminal == nullptr)
+    {
+        return false;
+    }
+
+    const auto sequence      = build_osc52_sequence(text);
+    const auto bytes_written = std::fwrite(sequence.data(), 1, sequence.size(), terminal);
+    const bool flushed       = std::fflush(terminal) == 0;
+    std::fclose(terminal);
+
+    return bytes_written == sequence.size() && flushed;
+}
+
+bool copy_with_local_clipboard_tools(const std::string& text)
+{
+#    ifdef __APPLE__
+    if (write_text_to_command("pbcopy 2>/dev/null", text))
+    {
+        return true;
+    }
+#    endif
+
+    if (write_text_to_command("wl-copy --type text/plain;charset=utf-8 2>/dev/null", text))
+    {
+        return true;
+    }
+
+    if (write_text_to_command("xclip -in -selection clipboard 2>/dev/null", text))
+    {
+        return true;
+    }
+
+    if (write_text_to_command("xsel --clipboard --input 2>/dev/null", text))
+    {
+        return true;
+    }
+
+    return false;
+}
+
+bool copy_text_to_clipboard_on_unix(const std::string& text, const ClipboardLimits& limits)
+{
+    const bool fits_osc52 = text.size() <= limits.osc52_max_bytes;
+    if (is_ssh_session())
+    {
+        return (fits_osc52 && write_text_to_terminal_clipboard(text)) || copy_with_local_clipboard_tools(text);
+    }
+
+    return copy_with_local_clipboard_tools(text) || (fits_osc52 && write_text_to_terminal_clipboard(text));
+}
+
+#endif
+
+} // namespace
+
+ClipboardCopyResult copy_text_to_clipboard(const std::string& text, const ClipboardLimits& limits)
+{
+    ClipboardCopyResult result;
+    if (text.size() <= limits.clipboard_max_bytes)
+    {
+#ifdef _WIN32
+        result.copied = copy_with_windows_clipboard(text);
+        return result;
+#else
+        result.copied = copy_text_to_clipboard_on_unix(text, limits);
+        // Without a clipboard tool the only route left may be OSC 52, which cannot carry text this large.
+        if (result.copied || text.size() <= limits.osc52_max_bytes)
+        {
+            return result;
+        }
+#endif
+    }
+
+    result.saved_path = write_text_to_temp_file(text);
+    return result;
+}
+
+} // namespace slayerlog
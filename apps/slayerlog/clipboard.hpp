@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace slayerlog
+{
+
+struct ClipboardLimits
+{
+    /** @brief Many terminals drop OSC 52 sequences above about 100 000 base64 bytes, which this much text encodes to. */
+    std::size_t osc52_max_bytes = 74994;
+    /** @brief Larger text is written to a temp file instead, since clipboard tools and managers choke on it. */
+    std::size_t clipboard_max_bytes = 32 * 1024 * 1024;
+};
+
+/** @brief Where copied text ended up. */
+struct ClipboardCopyResult
+{
+    bool copied = false;
+    /** @brief Set when the text was written to this file instead of the clipboard. */
+    std::optional<std::filesystem::path> saved_path;
+};
+
+/**
+ * @brief Puts text on the system clipboard, or writes it to a temp file when it is too large for any route.
+ *
+ * On Unix a clipboard tool gets the text streamed through a pipe in chunks, and OSC 52 through the terminal is only
+ * tried when the text fits in osc52_max_bytes; over SSH OSC 52 is tried first.
+ */
+ClipboardCopyResult copy_text_to_clipboard(const std::string& text, const ClipboardLimits& limits = {});
+
+} // namespace slayerlog
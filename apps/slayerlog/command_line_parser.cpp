@@ -2,13 +2,124 @@
 
 #include <boost/program_options.hpp>
 
+#include <cctype>
 #include <cstdlib>
+#include <exception>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace slayerlog
 {
 
+namespace
+{
+
+/** @brief Parses a byte count with an optional binary K, M or G suffix, e.g. "512M". */
+std::optional<std::size_t> parse_byte_size(const std::string& text)
+{
+    if (text.empty() || std::isdigit(static_cast<unsigned char>(text.front())) == 0)
+    {
+        return std::nullopt;
+    }
+
+    std::size_t parsed_length = 0;
+    unsigned long long value  = 0;
+    try
+    {
+        value = std::stoull(text, &parsed_length);
+    }
+    catch (const std::exception&)
+    {
+        return std::nullopt;
+    }
+
+    std::string suffix = text.substr(parsed_length);
+    for (char& character : suffix)
+    {
+        character = static_cast<char>(std::toupper(static_cast<unsigned char>(character)));
+    }
+
+    if (suffix.size() == 2 && suffix[1] == 'B')
+    {
+        suffix.pop_back();
+    }
+
+    unsigned long long multiplier = 1;
+    if (suffix == "K")
+    {
+        multiplier = 1ULL << 10;
+    }
+    else if (suffix == "M")
+    {
+        multiplier = 1ULL << 20;
+    }
+    else if (suffix == "G")
+    {
+        multiplier = 1ULL << 30;
+    }
+    else if (!suffix.empty() && suffix != "B")
+    {
+        return std::nullopt;
+    }
+
+    if (value > std::numeric_limits<std::size_t>::max() / multiplier)
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<std::size_t>(value * multiplier);
+}
+
+std::optional<ColdStorageMode> parse_cold_storage_mode(const std::string& text)
+{
+    if (text == "off")
+    {
+        return ColdStorageMode::Off;
+    }
+
+    if (text == "compress")
+    {
+        return ColdStorageMode::Compressed;
+    }
+
+    if (text == "spill")
+    {
+        return ColdStorageMode::Spilled;
+    }
+
+    return std::nullopt;
+}
+
+/** @brief Splits a comma separated field list, skipping empty names. */
+std::vector<std::string> parse_field_list(const std::string& text)
+{
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    while (start <= text.size())
+    {
+        auto end = text.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+
+        if (end > start)
+        {
+            fields.push_back(text.substr(start, end - start));
+        }
+
+        start = end + 1;
+    }
+
+    return fields;
+}
+
+} // namespace
+
 Config parse_command_line(int argc, char* argv[])
 {
     namespace po = boost::program_options;
@@ -17,8 +128,20 @@ Config parse_command_line(int argc, char* argv[])
     // clang-format off
     desc.add_options()
         ("help,h", "Show help message")
-        ("file,f", po::value<std::vector<std::string>>()->composing(), "Path to a log file to open on startup. Repeat for multiple files.")
-        ("poll-interval-ms", po::value<int>()->default_value(250), "Polling interval in milliseconds");
+        ("file,f", po::value<std::vector<std::string>>()->composing(), "Log source to open on startup: a file path, directory or glob such as 'pods/**/*.log', ssh://host/path, - for stdin or cmd:<command>. Repeat for multiple sources.")
+        ("poll-interval-ms", po::value<int>()->default_value(250), "Polling interval in milliseconds while sources are idle; sources that produce lines are polled faster")
+        ("max-lines", po::value<std::size_t>()->default_value(0), "Keep at most this many lines, evicting the oldest; 0 keeps everything")
+        ("max-memory", po::value<std::string>()->default_value("0"), "Keep line storage under this size (e.g. 512M, 2G), evicting the oldest lines; 0 disables the limit")
+        ("max-paused-memory", po::value<std::string>()->default_value("256M"), "Keep at most this much of the lines that arrive while paused in memory, spilling older held lines to a temp file beyond it; 0 disables the limit")
+        ("cold-storage", po::value<std::string>()->default_value("off"), "Keep older lines compressed in memory (compress) or in a temp file (spill); off keeps them uncompressed")
+        ("ssh-compression", po::bool_switch(), "Compress the ssh transport of remote sources; speeds up catching up on large logs over slow links")
+        ("remote-filter", po::bool_switch(), "Apply literal filter-in/filter-out text on the remote host so filtered lines of ssh sources are never transferred")
+        ("no-index-cache", po::bool_switch(), "Do not keep sidecar line indexes; with them, reopening a large file under --max-lines or --max-memory only reads its end")
+        ("json-fields", po::value<std::string>()->default_value(""), "Comma separated top-level fields of JSON lines, e.g. level,trace_id,latency_ms, to extract on ingest for filter-field; other fields are extracted on first use")
+        ("level-token", po::value<std::vector<std::string>>()->composing(), "Extra word that marks a line's level for filter-level, as <level>=<token> (e.g. error=E); repeat for more")
+        ("max-fps", po::value<int>()->default_value(30), "Redraw at most this many times per second while lines stream in; 0 redraws after every batch")
+        ("max-line-display", po::value<std::string>()->default_value("64K"), "Show at most this much of each line (e.g. 16K), cutting longer lines off; copying and save-view still get whole lines; 0 shows whole lines")
+        ("search-prefix", po::value<std::string>()->default_value("0"), "Let filters and find only look at this much of the start of each line (e.g. 4K), which keeps them fast on huge lines; 0 searches whole lines");
     // clang-format on
 
     std::vector<std::string> arguments;
@@ -52,12 +175,73 @@ Config parse_command_line(int argc, char* argv[])
             config.file_paths = variables["file"].as<std::vector<std::string>>();
         }
         config.poll_interval_ms = variables["poll-interval-ms"].as<int>();
+        config.max_lines        = variables["max-lines"].as<std::size_t>();
+        config.ssh_compression  = variables["ssh-compression"].as<bool>();
+        config.remote_filter    = variables["remote-filter"].as<bool>();
+        config.max_fps          = variables["max-fps"].as<int>();
+        config.line_index_cache = !variables["no-index-cache"].as<bool>();
+        config.json_fields      = parse_field_list(variables["json-fields"].as<std::string>());
 
         if (config.poll_interval_ms <= 0)
         {
             throw po::error("--poll-interval-ms must be greater than 0");
         }
 
+        if (config.max_fps < 0)
+        {
+            throw po::error("--max-fps must not be negative");
+        }
+
+        const auto max_memory_bytes = parse_byte_size(variables["max-memory"].as<std::string>());
+        if (!max_memory_bytes.has_value())
+        {
+            throw po::error("--max-memory must be a byte count with an optional K, M or G suffix");
+        }
+        config.max_memory_bytes = *max_memory_bytes;
+
+        const auto max_paused_memory_bytes = parse_byte_size(variables["max-paused-memory"].as<std::string>());
+        if (!max_paused_memory_bytes.has_value())
+        {
+            throw po::error("--max-paused-memory must be a byte count with an optional K, M or G suffix");
+        }
+        config.max_paused_memory_bytes = *max_paused_memory_bytes;
+
+        const auto cold_storage = parse_cold_storage_mode(variables["cold-storage"].as<std::string>());
+        if (!cold_storage.has_value())
+        {
+            throw po::error("--cold-storage must be one of off, compress or spill");
+        }
+        config.cold_storage = *cold_storage;
+
+        const auto max_line_display_bytes = parse_byte_size(variables["max-line-display"].as<std::string>());
+        if (!max_line_display_bytes.has_value())
+        {
+            throw po::error("--max-line-display must be a byte count with an optional K, M or G suffix");
+        }
+        config.max_line_display_bytes = *max_line_display_bytes;
+
+        const auto search_prefix_bytes = parse_byte_size(variables["search-prefix"].as<std::string>());
+        if (!search_prefix_bytes.has_value())
+        {
+            throw po::error("--search-prefix must be a byte count with an optional K, M or G suffix");
+        }
+        config.search_prefix_bytes = *search_prefix_bytes;
+
+        if (variables.count("level-token") != 0U)
+        {
+            for (const auto& text : variables["level-token"].as<std::vector<std::string>>())
+            {
+                try
+                {
+                    config.level_tokens.push_back(parse_log_level_token(text));
+                }
+                catch (const std::invalid_argument& error)
+                {
+                    throw po::error("--level-token '" + text + "': " + error.what());
+                }
+            }
+        }
+
         return config;
     }
     catch (const po::error& error)
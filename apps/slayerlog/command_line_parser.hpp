@@ -1,15 +1,31 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
+#include "log_levels.hpp"
+#include "log_line_store.hpp"
+
 namespace slayerlog
 {
 
 struct Config
 {
     std::vector<std::string> file_paths;
-    int poll_interval_ms = 250;
+    int poll_interval_ms                = 250;
+    std::size_t max_lines               = 0;
+    std::size_t max_memory_bytes        = 0;
+    std::size_t max_paused_memory_bytes = 256U * 1024U * 1024U;
+    ColdStorageMode cold_storage        = ColdStorageMode::Off;
+    bool ssh_compression                = false;
+    bool remote_filter                  = false;
+    int max_fps                         = 30;
+    bool line_index_cache               = true;
+    std::size_t max_line_display_bytes  = 64U * 1024U;
+    std::size_t search_prefix_bytes     = 0;
+    std::vector<std::string> json_fields;
+    std::vector<LogLevelToken> level_tokens;
 };
 
 Config parse_command_line(int argc, char* argv[]);
@@ -0,0 +1,404 @@
+#include "load_generator.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+constexpr std::size_t output_buffer_size      = 1 << 20;
+constexpr std::string_view sequence_marker    = "seq=";
+constexpr std::string_view sent_time_marker   = " sent_ns=";
+constexpr std::string_view padding_characters = "abcdefghijklmnopqrstuvwxyz0123456789";
+
+void append_unsigned(std::string& text, std::uint64_t value)
+{
+    char digits[24];
+    const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+    text.append(digits, static_cast<std::size_t>(end - digits));
+}
+
+void append_signed(std::string& text, std::int64_t value)
+{
+    char digits[24];
+    const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+    text.append(digits, static_cast<std::size_t>(end - digits));
+}
+
+void append_padded(std::string& text, int value, int width)
+{
+    char digits[12];
+    const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+    const int length        = static_cast<int>(end - digits);
+    for (int index = length; index < width; ++index)
+    {
+        text.push_back('0');
+    }
+
+    text.append(digits, static_cast<std::size_t>(length));
+}
+
+std::tm to_local_time(std::time_t seconds)
+{
+    std::tm local_time {};
+#ifdef _WIN32
+    localtime_s(&local_time, &seconds);
+#else
+    localtime_r(&seconds, &local_time);
+#endif
+    return local_time;
+}
+
+} // namespace
+
+std::optional<LoadTimestampFormat> parse_load_timestamp_format(std::string_view text)
+{
+    if (text == "none")
+    {
+        return LoadTimestampFormat::None;
+    }
+
+    if (text == "iso")
+    {
+        return LoadTimestampFormat::Iso8601;
+    }
+
+    if (text == "iso-ms")
+    {
+        return LoadTimestampFormat::Iso8601Milliseconds;
+    }
+
+    if (text == "bracketed")
+    {
+        return LoadTimestampFormat::Bracketed;
+    }
+
+    if (text == "space")
+    {
+        return LoadTimestampFormat::SpaceSeparated;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<LoadRotationMode> parse_load_rotation_mode(std::string_view text)
+{
+    if (text == "none")
+    {
+        return LoadRotationMode::None;
+    }
+
+    if (text == "truncate")
+    {
+        return LoadRotationMode::Truncate;
+    }
+
+    if (text == "rename")
+    {
+        return LoadRotationMode::Rename;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<LoadLineStamp> parse_load_line_stamp(std::string_view line)
+{
+    const std::size_t sequence_start = line.find(sequence_marker);
+    if (sequence_start == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+
+    LoadLineStamp stamp;
+    const char* sequence_begin = line.data() + sequence_start + sequence_marker.size();
+    const char* line_end       = line.data() + line.size();
+    const auto sequence_result = std::from_chars(sequence_begin, line_end, stamp.sequence);
+    if (sequence_result.ec != std::errc())
+    {
+        return std::nullopt;
+    }
+
+    const std::string_view rest(sequence_result.ptr, static_cast<std::size_t>(line_end - sequence_result.ptr));
+    if (rest.rfind(sent_time_marker, 0) != 0)
+    {
+        return std::nullopt;
+    }
+
+    const char* sent_begin = sequence_result.ptr + sent_time_marker.size();
+    if (std::from_chars(sent_begin, line_end, stamp.sent_ns).ec != std::errc())
+    {
+        return std::nullopt;
+    }
+
+    return stamp;
+}
+
+std::int64_t load_generator_now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+LoadGenerator::LoadGenerator(LoadGeneratorConfig config) : _config(std::move(config))
+{
+    if (_config.file_paths.empty())
+    {
+        throw std::invalid_argument("Load generator needs at least one output file");
+    }
+
+    _outputs.reserve(_config.file_paths.size());
+    for (const auto& file_path : _config.file_paths)
+    {
+        Output output;
+        output.path  = file_path;
+        output.label = std::filesystem::path(file_path).filename().string();
+        _outputs.push_back(std::move(output));
+    }
+
+    for (auto& output : _outputs)
+    {
+        open_output(output);
+    }
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    for (auto& output : _outputs)
+    {
+        close_output(output);
+    }
+}
+
+std::size_t LoadGenerator::write_lines(std::size_t count)
+{
+    std::size_t bytes_written = 0;
+    std::vector<bool> touched(_outputs.size(), false);
+
+    for (std::size_t line = 0; line < count; ++line)
+    {
+        auto& output = _outputs[_next_output_index];
+        touched[_next_output_index] = true;
+        _next_output_index          = (_next_output_index + 1) % _outputs.size();
+
+        if (!output.held_back_fragment.empty())
+        {
+            bytes_written += write_to_output(output, output.held_back_fragment);
+            output.held_back_fragment.clear();
+        }
+
+        if (_config.rotation_mode != LoadRotationMode::None && _config.rotate_every_lines > 0 && output.lines_since_rotation >= _config.rotate_every_lines)
+        {
+            rotate_output(output);
+        }
+
+        format_line(output, _line_buffer);
+        ++output.lines_since_rotation;
+        ++_lines_written;
+
+        const bool last_line_for_output = line + _outputs.size() >= count;
+        if (_config.partial_writes && last_line_for_output && _line_buffer.size() > 1)
+        {
+            const std::size_t split = _line_buffer.size() / 2;
+            bytes_written += write_to_output(output, std::string_view(_line_buffer).substr(0, split));
+            output.held_back_fragment.assign(_line_buffer, split, std::string::npos);
+            continue;
+        }
+
+        bytes_written += write_to_output(output, _line_buffer);
+    }
+
+    for (std::size_t index = 0; index < _outputs.size(); ++index)
+    {
+        if (touched[index])
+        {
+            std::fflush(_outputs[index].file);
+        }
+    }
+
+    return bytes_written;
+}
+
+std::size_t LoadGenerator::finish()
+{
+    std::size_t bytes_written = 0;
+    for (auto& output : _outputs)
+    {
+        if (!output.held_back_fragment.empty())
+        {
+            bytes_written += write_to_output(output, output.held_back_fragment);
+            output.held_back_fragment.clear();
+        }
+
+        std::fflush(output.file);
+    }
+
+    return bytes_written;
+}
+
+std::uint64_t LoadGenerator::lines_written() const
+{
+    return _lines_written;
+}
+
+std::uint64_t LoadGenerator::rotations() const
+{
+    return _rotations;
+}
+
+void LoadGenerator::open_output(Output& output)
+{
+    output.file = std::fopen(output.path.c_str(), "wb");
+    if (output.file == nullptr)
+    {
+        throw std::runtime_error("Failed to open output file: " + output.path);
+    }
+
+    std::setvbuf(output.file, nullptr, _IOFBF, output_buffer_size);
+    output.lines_since_rotation = 0;
+}
+
+void LoadGenerator::close_output(Output& output)
+{
+    if (output.file != nullptr)
+    {
+        std::fclose(output.file);
+        output.file = nullptr;
+    }
+}
+
+void LoadGenerator::rotate_output(Output& output)
+{
+    close_output(output);
+    if (_config.rotation_mode == LoadRotationMode::Rename)
+    {
+        std::error_code error;
+        std::filesystem::rename(output.path, output.path + ".1", error);
+        if (error)
+        {
+            throw std::runtime_error("Failed to rotate output file: " + output.path + ": " + error.message());
+        }
+    }
+
+    open_output(output);
+    ++_rotations;
+}
+
+std::size_t LoadGenerator::write_to_output(Output& output, std::string_view bytes)
+{
+    const std::size_t written = std::fwrite(bytes.data(), 1, bytes.size(), output.file);
+    if (written != bytes.size())
+    {
+        throw std::runtime_error("Failed to write output file: " + output.path);
+    }
+
+    return written;
+}
+
+void LoadGenerator::format_line(Output& output, std::string& line)
+{
+    line.clear();
+    append_timestamp(line);
+    line.append(output.label);
+    line.push_back(' ');
+    line.append(sequence_marker);
+    append_unsigned(line, output.next_sequence++);
+    line.append(sent_time_marker);
+    append_signed(line, load_generator_now_ns());
+    line.push_back(' ');
+
+    std::size_t padding_index = 0;
+    while (line.size() < _config.line_size)
+    {
+        line.push_back(padding_characters[padding_index]);
+        padding_index = (padding_index + 1) % padding_characters.size();
+    }
+
+    line.push_back('\n');
+}
+
+void LoadGenerator::append_timestamp(std::string& line)
+{
+    if (_config.timestamp_format == LoadTimestampFormat::None)
+    {
+        return;
+    }
+
+    const auto now          = std::chrono::system_clock::now();
+    const std::time_t epoch = std::chrono::system_clock::to_time_t(now);
+    if (epoch != _cached_timestamp_second)
+    {
+        // Formatting the calendar part is the expensive bit; it only changes once per second.
+        const std::tm local_time = to_local_time(epoch);
+        _cached_timestamp_second = epoch;
+        _cached_timestamp_prefix.clear();
+        append_padded(_cached_timestamp_prefix, local_time.tm_year + 1900, 4);
+        _cached_timestamp_prefix.push_back('-');
+        append_padded(_cached_timestamp_prefix, local_time.tm_mon + 1, 2);
+        _cached_timestamp_prefix.push_back('-');
+        append_padded(_cached_timestamp_prefix, local_time.tm_mday, 2);
+        _cached_timestamp_prefix.push_back(_config.timestamp_format == LoadTimestampFormat::SpaceSeparated ? ' ' : 'T');
+        append_padded(_cached_timestamp_prefix, local_time.tm_hour, 2);
+        _cached_timestamp_prefix.push_back(':');
+        append_padded(_cached_timestamp_prefix, local_time.tm_min, 2);
+        _cached_timestamp_prefix.push_back(':');
+        append_padded(_cached_timestamp_prefix, local_time.tm_sec, 2);
+    }
+
+    if (_config.timestamp_format == LoadTimestampFormat::Bracketed)
+    {
+        line.push_back('[');
+    }
+
+    line.append(_cached_timestamp_prefix);
+    if (_config.timestamp_format != LoadTimestampFormat::Iso8601)
+    {
+        const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+        line.push_back('.');
+        append_padded(line, static_cast<int>(milliseconds), 3);
+    }
+
+    if (_config.timestamp_format == LoadTimestampFormat::Bracketed)
+    {
+        line.push_back(']');
+    }
+
+    line.push_back(' ');
+}
+
+void LatencyRecorder::record(std::chrono::nanoseconds latency)
+{
+    _samples_ns.push_back(latency.count());
+}
+
+LatencyRecorder::Summary LatencyRecorder::summarize_and_reset()
+{
+    Summary summary;
+    summary.samples = _samples_ns.size();
+    if (_samples_ns.empty())
+    {
+        return summary;
+    }
+
+    std::sort(_samples_ns.begin(), _samples_ns.end());
+    const auto percentile = [this](double fraction)
+    {
+        const auto index = static_cast<std::size_t>(fraction * static_cast<double>(_samples_ns.size() - 1));
+        return std::chrono::nanoseconds(_samples_ns[index]);
+    };
+
+    summary.p50 = percentile(0.50);
+    summary.p90 = percentile(0.90);
+    summary.p99 = percentile(0.99);
+    summary.max = std::chrono::nanoseconds(_samples_ns.back());
+    _samples_ns.clear();
+    return summary;
+}
+
+} // namespace slayerlog
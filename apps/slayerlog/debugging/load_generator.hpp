@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace slayerlog
+{
+
+enum class LoadTimestampFormat
+{
+    None,
+    Iso8601,
+    Iso8601Milliseconds,
+    Bracketed,
+    SpaceSeparated,
+};
+
+enum class LoadRotationMode
+{
+    None,
+    Truncate,
+    Rename,
+};
+
+struct LoadGeneratorConfig
+{
+    std::vector<std::string> file_paths;
+    std::size_t line_size                = 120;
+    LoadTimestampFormat timestamp_format = LoadTimestampFormat::Iso8601Milliseconds;
+    LoadRotationMode rotation_mode       = LoadRotationMode::None;
+    std::uint64_t rotate_every_lines     = 0;
+    bool partial_writes                  = false;
+};
+
+/** @brief Sequence number and steady-clock send time embedded in every generated line. */
+struct LoadLineStamp
+{
+    std::uint64_t sequence = 0;
+    std::int64_t sent_ns   = 0;
+};
+
+std::optional<LoadTimestampFormat> parse_load_timestamp_format(std::string_view text);
+std::optional<LoadRotationMode> parse_load_rotation_mode(std::string_view text);
+std::optional<LoadLineStamp> parse_load_line_stamp(std::string_view line);
+
+/**
+ * @brief Writes synthetic log lines round-robin across one or more files.
+ *
+ * When partial writes are enabled the second half of the last line of every batch is held back
+ * until the next batch, so watchers always observe a flushed, incomplete trailing line.
+ */
+class LoadGenerator
+{
+public:
+    explicit LoadGenerator(LoadGeneratorConfig config);
+    ~LoadGenerator();
+
+    LoadGenerator(const LoadGenerator&)            = delete;
+    LoadGenerator& operator=(const LoadGenerator&) = delete;
+
+    /** @brief Writes and flushes count lines; returns the number of bytes written. */
+    std::size_t write_lines(std::size_t count);
+    /** @brief Completes any held-back partial line so every file ends with a newline. */
+    std::size_t finish();
+
+    std::uint64_t lines_written() const;
+    std::uint64_t rotations() const;
+
+private:
+    struct Output
+    {
+        std::string path;
+        std::string label;
+        std::FILE* file                    = nullptr;
+        std::uint64_t next_sequence        = 0;
+        std::uint64_t lines_since_rotation = 0;
+        std::string held_back_fragment;
+    };
+
+    void open_output(Output& output);
+    void close_output(Output& output);
+    void rotate_output(Output& output);
+    std::size_t write_to_output(Output& output, std::string_view bytes);
+    void format_line(Output& output, std::string& line);
+    void append_timestamp(std::string& line);
+
+    LoadGeneratorConfig _config;
+    std::vector<Output> _outputs;
+    std::size_t _next_output_index = 0;
+    std::uint64_t _lines_written   = 0;
+    std::uint64_t _rotations       = 0;
+    std::string _line_buffer;
+
+    std::time_t _cached_timestamp_second = -1;
+    std::string _cached_timestamp_prefix;
+};
+
+/** @brief Collects end-to-end latency samples and reports percentiles per reporting interval. */
+class LatencyRecorder
+{
+public:
+    struct Summary
+    {
+        std::size_t samples = 0;
+        std::chrono::nanoseconds p50 {0};
+        std::chrono::nanoseconds p90 {0};
+        std::chrono::nanoseconds p99 {0};
+        std::chrono::nanoseconds max {0};
+    };
+
+    void record(std::chrono::nanoseconds latency);
+    Summary summarize_and_reset();
+
+private:
+    std::vector<std::int64_t> _samples_ns;
+};
+
+std::int64_t load_generator_now_ns();
+
+} // namespace slayerlog
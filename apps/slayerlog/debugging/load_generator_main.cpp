@@ -0,0 +1,351 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "debugging/load_generator.hpp"
+#include "watchers/file_watcher.hpp"
+
+namespace
+{
+
+std::atomic<bool> stop_requested = false;
+
+void handle_stop_signal(int)
+{
+    stop_requested = true;
+}
+
+struct LoadGeneratorOptions
+{
+    slayerlog::LoadGeneratorConfig generator;
+    double lines_per_second   = 10000.0;
+    double duration_seconds   = 10.0;
+    std::uint64_t total_lines = 0;
+    bool measure_latency      = false;
+    int watcher_poll_interval = 250;
+};
+
+/**
+ * @brief Polls the generated files with the same watcher slayerlog uses and records write-to-poll latency.
+ */
+class LatencyProbe
+{
+public:
+    LatencyProbe(const std::vector<std::string>& file_paths, int poll_interval_ms) : _poll_interval_ms(poll_interval_ms)
+    {
+        for (const auto& file_path : file_paths)
+        {
+            _watchers.push_back(std::make_unique<slayerlog::FileWatcher>(file_path));
+        }
+
+        _expected_sequences.resize(file_paths.size(), 0);
+        _thread = std::thread([this] { run(); });
+    }
+
+    ~LatencyProbe() { stop(); }
+
+    void stop()
+    {
+        _keep_running = false;
+        if (_thread.joinable())
+        {
+            _thread.join();
+        }
+    }
+
+    slayerlog::LatencyRecorder::Summary take_summary()
+    {
+        std::lock_guard lock(_mutex);
+        return _recorder.summarize_and_reset();
+    }
+
+    std::uint64_t lines_seen() const { return _lines_seen; }
+
+    std::uint64_t lines_missing() const { return _lines_missing; }
+
+    std::uint64_t lines_repeated() const { return _lines_repeated; }
+
+private:
+    void run()
+    {
+        std::vector<std::string> lines;
+        while (_keep_running)
+        {
+            poll_once(lines);
+            std::this_thread::sleep_for(std::chrono::milliseconds(_poll_interval_ms));
+        }
+
+        // One final sweep so lines written just before shutdown are not reported as missing.
+        poll_once(lines);
+    }
+
+    void poll_once(std::vector<std::string>& lines)
+    {
+        for (std::size_t index = 0; index < _watchers.size(); ++index)
+        {
+            try
+            {
+                _watchers[index]->poll(lines);
+            }
+            catch (const std::exception&)
+            {
+                // The generator may be between rename and reopen during rotation.
+                continue;
+            }
+
+            const std::int64_t now_ns = slayerlog::load_generator_now_ns();
+            std::lock_guard lock(_mutex);
+            for (const auto& line : lines)
+            {
+                const auto stamp = slayerlog::parse_load_line_stamp(line);
+                if (!stamp.has_value())
+                {
+                    continue;
+                }
+
+                ++_lines_seen;
+                auto& expected_sequence = _expected_sequences[index];
+                if (stamp->sequence > expected_sequence)
+                {
+                    _lines_missing += stamp->sequence - expected_sequence;
+                }
+                else if (stamp->sequence < expected_sequence)
+                {
+                    ++_lines_repeated;
+                }
+
+                expected_sequence = stamp->sequence + 1;
+                _recorder.record(std::chrono::nanoseconds(now_ns - stamp->sent_ns));
+            }
+        }
+    }
+
+    int _poll_interval_ms;
+    std::vector<std::unique_ptr<slayerlog::FileWatcher>> _watchers;
+    std::vector<std::uint64_t> _expected_sequences;
+    std::atomic<bool> _keep_running            = true;
+    std::atomic<std::uint64_t> _lines_seen     = 0;
+    std::atomic<std::uint64_t> _lines_missing  = 0;
+    std::atomic<std::uint64_t> _lines_repeated = 0;
+    std::mutex _mutex;
+    slayerlog::LatencyRecorder _recorder;
+    std::thread _thread;
+};
+
+double to_milliseconds(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void print_latency(const slayerlog::LatencyRecorder::Summary& summary)
+{
+    if (summary.samples == 0)
+    {
+        std::cout << " latency: no samples";
+        return;
+    }
+
+    std::cout << " latency_ms p50=" << to_milliseconds(summary.p50) << " p90=" << to_milliseconds(summary.p90) << " p99=" << to_milliseconds(summary.p99)
+              << " max=" << to_milliseconds(summary.max);
+}
+
+LoadGeneratorOptions parse_options(int argc, char* argv[])
+{
+    namespace po = boost::program_options;
+
+    po::options_description desc("Slayerlog Load Generator Options");
+    // clang-format off
+    desc.add_options()
+        ("help,h", "Show help message")
+        ("file,f", po::value<std::vector<std::string>>()->composing(), "Output file. Repeat to interleave lines across several files.")
+        ("rate", po::value<double>()->default_value(10000.0), "Total lines per second across all files; 0 writes as fast as possible")
+        ("line-size", po::value<std::size_t>()->default_value(120), "Minimum line length in bytes, excluding the newline")
+        ("timestamp-format", po::value<std::string>()->default_value("iso-ms"), "none, iso, iso-ms, bracketed or space")
+        ("duration-s", po::value<double>()->default_value(10.0), "Stop after this many seconds; 0 runs until interrupted")
+        ("lines", po::value<std::uint64_t>()->default_value(0), "Stop after this many lines; 0 disables the limit")
+        ("rotate-every", po::value<std::uint64_t>()->default_value(0), "Rotate each file after this many lines")
+        ("rotate-mode", po::value<std::string>()->default_value("rename"), "truncate or rename")
+        ("partial-writes", "Flush the first half of the last line of every batch on its own")
+        ("measure-latency", "Tail the files with slayerlog's FileWatcher and report write-to-poll latency")
+        ("poll-interval-ms", po::value<int>()->default_value(250), "Watcher polling interval used with --measure-latency");
+    // clang-format on
+
+    po::positional_options_description positional;
+    positional.add("file", -1);
+
+    po::variables_map variables;
+    try
+    {
+        po::store(po::command_line_parser(argc, argv).options(desc).positional(positional).run(), variables);
+        po::notify(variables);
+
+        if (variables.count("help") != 0U)
+        {
+            std::cout << desc << '\n';
+            std::exit(0);
+        }
+
+        LoadGeneratorOptions options;
+        if (variables.count("file") != 0U)
+        {
+            options.generator.file_paths = variables["file"].as<std::vector<std::string>>();
+        }
+
+        if (options.generator.file_paths.empty())
+        {
+            throw po::error("at least one --file is required");
+        }
+
+        const auto timestamp_format = slayerlog::parse_load_timestamp_format(variables["timestamp-format"].as<std::string>());
+        if (!timestamp_format.has_value())
+        {
+            throw po::error("--timestamp-format must be one of none, iso, iso-ms, bracketed, space");
+        }
+
+        const auto rotation_mode = slayerlog::parse_load_rotation_mode(variables["rotate-mode"].as<std::string>());
+        if (!rotation_mode.has_value() || *rotation_mode == slayerlog::LoadRotationMode::None)
+        {
+            throw po::error("--rotate-mode must be truncate or rename");
+        }
+
+        options.generator.line_size          = variables["line-size"].as<std::size_t>();
+        options.generator.timestamp_format   = *timestamp_format;
+        options.generator.rotate_every_lines = variables["rotate-every"].as<std::uint64_t>();
+        options.generator.rotation_mode      = options.generator.rotate_every_lines > 0 ? *rotation_mode : slayerlog::LoadRotationMode::None;
+        options.generator.partial_writes     = variables.count("partial-writes") != 0U;
+        options.lines_per_second             = variables["rate"].as<double>();
+        options.duration_seconds             = variables["duration-s"].as<double>();
+        options.total_lines                  = variables["lines"].as<std::uint64_t>();
+        options.measure_latency              = variables.count("measure-latency") != 0U;
+        options.watcher_poll_interval        = variables["poll-interval-ms"].as<int>();
+
+        if (options.lines_per_second < 0.0 || options.duration_seconds < 0.0 || options.watcher_poll_interval <= 0)
+        {
+            throw po::error("--rate, --duration-s and --poll-interval-ms must not be negative");
+        }
+
+        return options;
+    }
+    catch (const po::error& error)
+    {
+        std::cerr << "Error: " << error.what() << '\n';
+        std::cerr << desc << '\n';
+        std::exit(2);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const LoadGeneratorOptions options = parse_options(argc, argv);
+    std::signal(SIGINT, handle_stop_signal);
+    std::signal(SIGTERM, handle_stop_signal);
+
+    try
+    {
+        slayerlog::LoadGenerator generator(options.generator);
+        std::unique_ptr<LatencyProbe> probe;
+        if (options.measure_latency)
+        {
+            probe = std::make_unique<LatencyProbe>(options.generator.file_paths, options.watcher_poll_interval);
+        }
+
+        constexpr std::size_t unthrottled_batch_size = 4096;
+        constexpr auto tick                          = std::chrono::milliseconds(1);
+
+        const auto start_time      = std::chrono::steady_clock::now();
+        auto next_report_time      = start_time + std::chrono::seconds(1);
+        std::uint64_t report_lines = 0;
+        std::uint64_t report_bytes = 0;
+        std::uint64_t total_bytes  = 0;
+
+        std::cout << std::fixed << std::setprecision(2);
+        while (!stop_requested)
+        {
+            const auto now     = std::chrono::steady_clock::now();
+            const auto elapsed = std::chrono::duration<double>(now - start_time).count();
+            if (options.duration_seconds > 0.0 && elapsed >= options.duration_seconds)
+            {
+                break;
+            }
+
+            if (options.total_lines > 0 && generator.lines_written() >= options.total_lines)
+            {
+                break;
+            }
+
+            std::size_t due_lines = unthrottled_batch_size;
+            if (options.lines_per_second > 0.0)
+            {
+                const auto target_lines = static_cast<std::uint64_t>(elapsed * options.lines_per_second);
+                due_lines               = target_lines > generator.lines_written() ? static_cast<std::size_t>(target_lines - generator.lines_written()) : 0;
+            }
+
+            if (options.total_lines > 0)
+            {
+                due_lines = static_cast<std::size_t>(std::min<std::uint64_t>(due_lines, options.total_lines - generator.lines_written()));
+            }
+
+            if (due_lines > 0)
+            {
+                const std::size_t bytes = generator.write_lines(due_lines);
+                report_lines += due_lines;
+                report_bytes += bytes;
+                total_bytes += bytes;
+            }
+            else
+            {
+                std::this_thread::sleep_for(tick);
+            }
+
+            if (now >= next_report_time)
+            {
+                std::cout << "wrote lines/s=" << static_cast<double>(report_lines) << " MB/s=" << static_cast<double>(report_bytes) / (1024.0 * 1024.0)
+                          << " rotations=" << generator.rotations();
+                if (probe != nullptr)
+                {
+                    print_latency(probe->take_summary());
+                }
+
+                std::cout << '\n';
+                report_lines = 0;
+                report_bytes = 0;
+                next_report_time += std::chrono::seconds(1);
+            }
+        }
+
+        total_bytes += generator.finish();
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        std::cout << "total lines=" << generator.lines_written() << " bytes=" << total_bytes << " seconds=" << elapsed
+                  << " avg_lines/s=" << (elapsed > 0.0 ? static_cast<double>(generator.lines_written()) / elapsed : 0.0) << '\n';
+
+        if (probe != nullptr)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.watcher_poll_interval));
+            probe->stop();
+            std::cout << "watcher lines_seen=" << probe->lines_seen() << " missing=" << probe->lines_missing() << " repeated=" << probe->lines_repeated();
+            print_latency(probe->take_summary());
+            std::cout << '\n';
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "file_change_notifier.hpp"
+#include "debug_log.hpp"
+
+#include <cstdint>
+
+#ifdef __linux__
+#    include <cerrno>
+#    include <sys/inotify.h>
+#    include <unistd.h>
+#endif
+
+namespace slayerlog
+{
+
+#ifdef __linux__
+
+namespace
+{
+
+constexpr std::size_t read_buffer_size = 1 << 16;
+
+constexpr std::uint32_t directory_event_mask = IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+} // namespace
+
+FileChangeNotifier::FileChangeNotifier()
+{
+    _handle = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_handle < 0)
+    {
+        SLAYERLOG_LOG_WARNING("inotify_init1 failed errno=" << errno << "; falling back to polling");
+    }
+}
+
+FileChangeNotifier::~FileChangeNotifier()
+{
+    if (_handle >= 0)
+    {
+        ::close(_handle);
+    }
+}
+
+bool FileChangeNotifier::available() const
+{
+    return _handle >= 0;
+}
+
+int FileChangeNotifier::handle() const
+{
+    return _handle;
+}
+
+bool FileChangeNotifier::watch_directory(const std::string& directory)
+{
+    if (_handle < 0)
+    {
+        return false;
+    }
+
+    if (watching(directory))
+    {
+        return true;
+    }
+
+    const int watch_id = ::inotify_add_watch(_handle, directory.c_str(), directory_event_mask);
+    if (watch_id < 0)
+    {
+        SLAYERLOG_LOG_WARNING("inotify_add_watch failed directory=" << directory << " errno=" << errno);
+        return false;
+    }
+
+    _directories[watch_id] = directory;
+    _watch_ids[directory]  = watch_id;
+    return true;
+}
+
+bool FileChangeNotifier::watching(const std::string& directory) const
+{
+    return _watch_ids.find(directory) != _watch_ids.end();
+}
+
+FileChanges FileChangeNotifier::read_changes()
+{
+    FileChanges changes;
+    if (_handle < 0)
+    {
+        return changes;
+    }
+
+    _read_buffer.resize(read_buffer_size);
+    while (true)
+    {
+        const ssize_t bytes_read = ::read(_handle, _read_buffer.data(), _read_buffer.size());
+        if (bytes_read <= 0)
+        {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < bytes_read;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(_read_buffer.data() + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if ((event->mask & IN_Q_OVERFLOW) != 0)
+            {
+                changes.overflowed        = true;
+                changes.structure_changed = true;
+                continue;
+            }
+
+            const auto directory = _directories.find(event->wd);
+            if (directory == _directories.end())
+            {
+                continue;
+            }
+
+            if ((event->mask & IN_IGNORED) != 0)
+            {
+                _watch_ids.erase(directory->second);
+                _directories.erase(directory);
+                changes.structure_changed = true;
+                continue;
+            }
+
+            if ((event->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF)) != 0)
+            {
+                changes.structure_changed = true;
+            }
+
+            if ((event->mask & IN_MODIFY) != 0 && event->len > 0)
+            {
+                changes.modified_paths.push_back(directory->second + "/" + event->name);
+            }
+        }
+    }
+
+    return changes;
+}
+
+#else
+
+FileChangeNotifier::FileChangeNotifier()  = default;
+FileChangeNotifier::~FileChangeNotifier() = default;
+
+bool FileChangeNotifier::available() const
+{
+    return false;
+}
+
+int FileChangeNotifier::handle() const
+{
+    return -1;
+}
+
+bool FileChangeNotifier::watch_directory(const std::string&)
+{
+    return false;
+}
+
+bool FileChangeNotifier::watching(const std::string&) const
+{
+    return false;
+}
+
+FileChanges FileChangeNotifier::read_changes()
+{
+    return {};
+}
+
+#endif
+
+} // namespace slayerlog
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace slayerlog
+{
+
+/** @brief What changed in the watched directories since the last read_changes(). */
+struct FileChanges
+{
+    /** @brief Files written to, as "<watched directory>/<name>". */
+    std::vector<std::string> modified_paths;
+    /** @brief Entries were created, deleted or renamed, so the set of matching files has to be rescanned. */
+    bool structure_changed = false;
+    /** @brief Events were dropped; every file has to be treated as modified. */
+    bool overflowed = false;
+};
+
+/**
+ * @brief Reports writes and directory changes for whole directories so a large set of files does not have to be polled.
+ *
+ * Linux uses one inotify watch per directory rather than per file, which keeps thousands of files well below the
+ * default watch limit. Elsewhere, or when inotify cannot be set up, available() returns false and callers keep polling.
+ */
+class FileChangeNotifier
+{
+public:
+    FileChangeNotifier();
+    ~FileChangeNotifier();
+
+    FileChangeNotifier(const FileChangeNotifier&)            = delete;
+    FileChangeNotifier& operator=(const FileChangeNotifier&) = delete;
+
+    bool available() const;
+    /** @brief Readable while changes are pending, for registration with a PipeReactor; -1 when unavailable. */
+    int handle() const;
+    /** @brief Returns false when the directory could not be watched, for example because the watch limit was reached. */
+    bool watch_directory(const std::string& directory);
+    bool watching(const std::string& directory) const;
+    /** @brief Drains pending events without blocking. */
+    FileChanges read_changes();
+
+private:
+    int _handle = -1;
+    std::unordered_map<int, std::string> _directories;
+    std::unordered_map<std::string, int> _watch_ids;
+    std::vector<char> _read_buffer;
+};
+
+} // namespace slayerlog
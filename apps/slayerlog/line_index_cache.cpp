@@ -0,0 +1,204 @@
+#include "line_index_cache.hpp"
+#include "debug_log.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#ifndef _WIN32
+#    include <sys/stat.h>
+#endif
+
+namespace slayerlog
+{
+
+namespace
+{
+
+constexpr const char* sidecar_magic           = "slayerlog-line-index";
+constexpr int sidecar_version                 = 2;
+constexpr std::uint64_t identity_window_bytes = 4096;
+
+std::uint64_t fnv1a(std::string_view bytes)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const char byte : bytes)
+    {
+        hash ^= static_cast<unsigned char>(byte);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+bool read_range(std::ifstream& input, std::uint64_t offset, std::uint64_t size, std::string& bytes)
+{
+    bytes.assign(static_cast<std::size_t>(size), '\0');
+    input.clear();
+    input.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    input.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<std::uint64_t>(input.gcount()) == size;
+}
+
+void file_identity(const std::string& file_path, std::uint64_t& device, std::uint64_t& inode)
+{
+    device = 0;
+    inode  = 0;
+#ifndef _WIN32
+    struct stat status {};
+    if (::stat(file_path.c_str(), &status) == 0)
+    {
+        device = static_cast<std::uint64_t>(status.st_dev);
+        inode  = static_cast<std::uint64_t>(status.st_ino);
+    }
+#endif
+}
+
+} // namespace
+
+bool identify_indexed_content(const std::string& file_path, LineIndex& index)
+{
+    std::error_code error_code;
+    const auto file_size = std::filesystem::file_size(file_path, error_code);
+    if (error_code || file_size < index.indexed_size)
+    {
+        return false;
+    }
+
+    std::ifstream input(file_path, std::ios::binary);
+    if (!input)
+    {
+        return false;
+    }
+
+    const std::uint64_t window_size = std::min(index.indexed_size, identity_window_bytes);
+    std::string window;
+    if (!read_range(input, 0, window_size, window))
+    {
+        return false;
+    }
+
+    index.head_hash = fnv1a(window);
+    if (!read_range(input, index.indexed_size - window_size, window_size, window))
+    {
+        return false;
+    }
+
+    index.tail_hash = fnv1a(window);
+    file_identity(file_path, index.device, index.inode);
+    return true;
+}
+
+LineIndexCache::LineIndexCache(std::filesystem::path directory)
+    : _directory(std::move(directory))
+{
+}
+
+std::optional<LineIndex> LineIndexCache::load(const std::string& file_path) const
+{
+    std::ifstream input(sidecar_path(file_path));
+    if (!input)
+    {
+        return std::nullopt;
+    }
+
+    std::string magic;
+    int version = 0;
+    std::string stored_path;
+    LineIndex stored;
+    std::size_t checkpoint_count = 0;
+    input >> magic >> version >> std::quoted(stored_path) >> stored.device >> stored.inode >> stored.indexed_size >> stored.head_hash >> stored.tail_hash >> stored.line_count >> checkpoint_count;
+    if (!input || magic != sidecar_magic || version != sidecar_version || stored_path != file_path)
+    {
+        return std::nullopt;
+    }
+
+    stored.checkpoints.resize(checkpoint_count);
+    for (auto& checkpoint : stored.checkpoints)
+    {
+        bool has_timestamp      = false;
+        LogTimePoint::rep ticks = 0;
+        input >> checkpoint.offset >> checkpoint.line_number >> has_timestamp >> ticks;
+        if (has_timestamp)
+        {
+            checkpoint.timestamp = LogTimePoint(LogTimePoint::duration(ticks));
+        }
+    }
+
+    if (!input)
+    {
+        SLAYERLOG_LOG_WARNING("Ignoring truncated line index file=" << file_path);
+        return std::nullopt;
+    }
+
+    LineIndex current;
+    current.indexed_size = stored.indexed_size;
+    if (!identify_indexed_content(file_path, current) || current.device != stored.device || current.inode != stored.inode || current.head_hash != stored.head_hash
+        || current.tail_hash != stored.tail_hash)
+    {
+        SLAYERLOG_LOG_DEBUG("Line index no longer matches file=" << file_path);
+        return std::nullopt;
+    }
+
+    SLAYERLOG_LOG_DEBUG("Loaded line index file=" << file_path << " indexed_size=" << stored.indexed_size << " line_count=" << stored.line_count);
+    return stored;
+}
+
+bool LineIndexCache::store(const std::string& file_path, LineIndex index) const
+{
+    if (!identify_indexed_content(file_path, index))
+    {
+        return false;
+    }
+
+    std::error_code error_code;
+    std::filesystem::create_directories(_directory, error_code);
+    const auto path           = sidecar_path(file_path);
+    const auto temporary_path = path.string() + ".tmp";
+    {
+        std::ofstream output(temporary_path, std::ios::trunc);
+        output << sidecar_magic << ' ' << sidecar_version << ' ' << std::quoted(file_path) << '\n'
+               << index.device << ' ' << index.inode << ' ' << index.indexed_size << ' ' << index.head_hash << ' ' << index.tail_hash << ' ' << index.line_count << ' '
+               << index.checkpoints.size() << '\n';
+        for (const auto& checkpoint : index.checkpoints)
+        {
+            output << checkpoint.offset << ' ' << checkpoint.line_number << ' ' << checkpoint.timestamp.has_value() << ' '
+                   << (checkpoint.timestamp.has_value() ? checkpoint.timestamp->time_since_epoch().count() : 0) << '\n';
+        }
+
+        if (!output.flush())
+        {
+            SLAYERLOG_LOG_WARNING("Failed to write line index file=" << file_path << " sidecar=" << temporary_path);
+            return false;
+        }
+    }
+
+    // Replacing the sidecar in one rename keeps a concurrent reader from seeing half an index.
+    std::filesystem::rename(temporary_path, path, error_code);
+    if (error_code)
+    {
+        SLAYERLOG_LOG_WARNING("Failed to replace line index file=" << file_path << " error=" << error_code.message());
+        std::filesystem::remove(temporary_path, error_code);
+        return false;
+    }
+
+    return true;
+}
+
+const std::filesystem::path& LineIndexCache::directory() const
+{
+    return _directory;
+}
+
+std::filesystem::path LineIndexCache::sidecar_path(const std::string& file_path) const
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << fnv1a(file_path) << ".idx";
+    return _directory / name.str();
+}
+
+} // namespace slayerlog
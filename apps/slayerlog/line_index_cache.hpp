@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "log_timestamp.hpp"
+
+namespace slayerlog
+{
+
+/**
+ * @brief Start of a line in a local file, with the number of lines before it.
+ *
+ * timestamp is the first one found in the lines after the checkpoint. In a log written in time order, the lines between
+ * two checkpoints lie within their timestamps.
+ */
+struct LineIndexCheckpoint
+{
+    std::uint64_t offset      = 0;
+    std::uint64_t line_number = 0;
+    std::optional<LogTimePoint> timestamp;
+};
+
+/**
+ * @brief Line offsets of the complete lines in a file's first indexed_size bytes, one checkpoint every checkpoint_interval lines.
+ *
+ * The device, inode and the hashes of the first bytes and of the bytes just before indexed_size identify the file
+ * content the index was built from, so an index only applies while the file has been appended to since.
+ */
+struct LineIndex
+{
+    static constexpr std::uint64_t checkpoint_interval = 4096;
+
+    std::uint64_t device       = 0;
+    std::uint64_t inode        = 0;
+    std::uint64_t indexed_size = 0;
+    std::uint64_t head_hash    = 0;
+    std::uint64_t tail_hash    = 0;
+    std::uint64_t line_count   = 0;
+    std::vector<LineIndexCheckpoint> checkpoints;
+};
+
+/** @brief Fills in the identity fields of index for the first index.indexed_size bytes of file_path; returns false when the file cannot be read. */
+bool identify_indexed_content(const std::string& file_path, LineIndex& index);
+
+/** @brief Keeps one sidecar line index per local file so a reopen can skip what it already indexed. */
+class LineIndexCache
+{
+public:
+    explicit LineIndexCache(std::filesystem::path directory);
+
+    /** @brief Returns the stored index of file_path if it still describes the start of the file. */
+    std::optional<LineIndex> load(const std::string& file_path) const;
+    /** @brief Writes the index of file_path, identity included; returns false when it could not be written. */
+    bool store(const std::string& file_path, LineIndex index) const;
+
+    const std::filesystem::path& directory() const;
+
+private:
+    std::filesystem::path sidecar_path(const std::string& file_path) const;
+
+    std::filesystem::path _directory;
+};
+
+} // namespace slayerlog
@@ -0,0 +1,74 @@
+#include "line_numbering.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace slayerlog
+{
+
+void LineNumbering::clear()
+{
+    _gaps.clear();
+}
+
+void LineNumbering::skip_before(AllLineIndex index, std::uint64_t skipped_count)
+{
+    if (skipped_count == 0)
+    {
+        return;
+    }
+
+    const std::int64_t skipped_total = (_gaps.empty() ? 0 : _gaps.back().skipped_total) + static_cast<std::int64_t>(skipped_count);
+    if (!_gaps.empty() && _gaps.back().index == index.value)
+    {
+        _gaps.back().skipped_total = skipped_total;
+        return;
+    }
+
+    _gaps.push_back(Gap {index.value, skipped_total});
+}
+
+void LineNumbering::truncate(AllLineIndex end_index)
+{
+    while (!_gaps.empty() && _gaps.back().index >= end_index.value)
+    {
+        _gaps.pop_back();
+    }
+}
+
+void LineNumbering::erase_before(AllLineIndex first_retained_index)
+{
+    // The last gap before the retained lines still carries the count of every earlier one.
+    while (_gaps.size() > 1 && _gaps[1].index < first_retained_index.value)
+    {
+        _gaps.pop_front();
+    }
+}
+
+std::int64_t LineNumbering::line_number(AllLineIndex index) const
+{
+    const auto next_gap = std::upper_bound(_gaps.begin(), _gaps.end(), index.value, [](std::int64_t value, const Gap& gap) { return value < gap.index; });
+    return index.value + 1 + (next_gap == _gaps.begin() ? 0 : std::prev(next_gap)->skipped_total);
+}
+
+AllLineIndex LineNumbering::first_index_at_or_after(std::int64_t line_number) const
+{
+    // Line numbers only grow with the index, so the answer lies in the stretch after the last gap that starts at or
+    // before line_number, or is the first line of the gap after it.
+    const auto next_gap = std::partition_point(_gaps.begin(), _gaps.end(), [line_number](const Gap& gap) { return gap.index + 1 + gap.skipped_total <= line_number; });
+    const std::int64_t skipped_total = next_gap == _gaps.begin() ? 0 : std::prev(next_gap)->skipped_total;
+    const std::int64_t index         = line_number - 1 - skipped_total;
+    if (next_gap != _gaps.end() && next_gap->index <= index)
+    {
+        return AllLineIndex {next_gap->index};
+    }
+
+    return AllLineIndex {index};
+}
+
+std::size_t LineNumbering::memory_bytes() const
+{
+    return _gaps.size() * sizeof(Gap);
+}
+
+} // namespace slayerlog
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "log_line_store.hpp"
+
+namespace slayerlog
+{
+
+/**
+ * @brief Maps stored lines to line numbers that also count the source lines left out between them.
+ *
+ * A remote source that filters before sending leaves gaps; numbering the stored lines by the source's own line count
+ * keeps a line's number the same whichever filter it arrived under. Only lines that follow a gap are recorded, so a
+ * model without gaps numbers its lines by index alone.
+ */
+class LineNumbering
+{
+public:
+    void clear();
+    /** @brief Records skipped_count left out lines right before the line at index; indices must be recorded in order. */
+    void skip_before(AllLineIndex index, std::uint64_t skipped_count);
+    /** @brief Drops the gaps at or after end_index, for lines that are about to be stored again. */
+    void truncate(AllLineIndex end_index);
+    /** @brief Drops the gaps before first_retained_index; the retained lines keep their numbers. */
+    void erase_before(AllLineIndex first_retained_index);
+
+    std::int64_t line_number(AllLineIndex index) const;
+    /** @brief Returns the first index whose line number is at least line_number. */
+    AllLineIndex first_index_at_or_after(std::int64_t line_number) const;
+
+    std::size_t memory_bytes() const;
+
+private:
+    struct Gap
+    {
+        std::int64_t index = 0;
+        // Lines left out before index, counting the earlier gaps.
+        std::int64_t skipped_total = 0;
+    };
+
+    std::deque<Gap> _gaps;
+};
+
+} // namespace slayerlog
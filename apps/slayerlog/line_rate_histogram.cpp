@@ -0,0 +1,339 @@
+#include "line_rate_histogram.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+std::int64_t floor_div(std::int64_t value, std::int64_t divisor)
+{
+    const std::int64_t quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+std::int64_t align_down(std::int64_t value, std::int64_t alignment)
+{
+    return floor_div(value, alignment) * alignment;
+}
+
+} // namespace
+
+std::int64_t epoch_second(LogTimePoint time_point)
+{
+    return std::chrono::floor<std::chrono::seconds>(time_point.time_since_epoch()).count();
+}
+
+void LineRateHistogram::clear()
+{
+    _buckets.clear();
+    _runs.clear();
+    _origin_second  = 0;
+    _bucket_seconds = 1;
+    _last_second.reset();
+    _far_second.reset();
+    ++_generation;
+}
+
+void LineRateHistogram::append(AllLineIndex entry_index, std::optional<LogTimePoint> timestamp, bool error)
+{
+    if (timestamp.has_value())
+    {
+        const std::int64_t second = epoch_second(*timestamp);
+        if (!far_from_range(second) || (_far_second.has_value() && std::abs(second - *_far_second) <= static_cast<std::int64_t>(max_bucket_count)))
+        {
+            _last_second = second;
+            _far_second.reset();
+        }
+        else
+        {
+            _far_second = second;
+        }
+    }
+
+    // Lines before the first timestamp have no place on the timeline.
+    if (!_last_second.has_value())
+    {
+        return;
+    }
+
+    const std::int64_t second = *_last_second;
+    if (_runs.empty() || _runs.back().second != second || _runs.back().first_index + _runs.back().lines != entry_index.value)
+    {
+        const std::int64_t max_second = _runs.empty() ? second : std::max(second, _runs.back().max_second);
+        _runs.push_back(Run {entry_index.value, second, 0, 0, max_second});
+    }
+
+    auto& run    = _runs.back();
+    auto& bucket = bucket_for(second);
+    ++run.lines;
+    ++bucket.lines;
+    if (error)
+    {
+        ++run.errors;
+        ++bucket.errors;
+    }
+
+    ++_generation;
+}
+
+void LineRateHistogram::erase_before(AllLineIndex first_retained_index)
+{
+    bool erased = false;
+    while (!_runs.empty() && _runs.front().first_index + _runs.front().lines <= first_retained_index.value)
+    {
+        const auto& run           = _runs.front();
+        const std::int64_t offset = floor_div(run.second - _origin_second, _bucket_seconds);
+        if (offset >= 0 && offset < static_cast<std::int64_t>(_buckets.size()))
+        {
+            auto& bucket = _buckets[static_cast<std::size_t>(offset)];
+            bucket.lines -= std::min<std::uint64_t>(bucket.lines, run.lines);
+            bucket.errors -= std::min<std::uint64_t>(bucket.errors, run.errors);
+        }
+
+        _runs.pop_front();
+        erased = true;
+    }
+
+    if (!erased)
+    {
+        return;
+    }
+
+    trim_empty_buckets();
+    if (_runs.empty())
+    {
+        _buckets.clear();
+        _bucket_seconds = 1;
+    }
+
+    refine();
+    ++_generation;
+}
+
+void LineRateHistogram::recount_errors(const std::function<bool(AllLineIndex)>& counted_error)
+{
+    for (auto& run : _runs)
+    {
+        std::uint32_t errors = 0;
+        for (std::int64_t index = run.first_index; index < run.first_index + run.lines; ++index)
+        {
+            errors += counted_error(AllLineIndex {index}) ? 1U : 0U;
+        }
+
+        auto& bucket = _buckets[static_cast<std::size_t>(floor_div(run.second - _origin_second, _bucket_seconds))];
+        bucket.errors -= std::min<std::uint64_t>(bucket.errors, run.errors);
+        bucket.errors += errors;
+        run.errors = errors;
+    }
+
+    ++_generation;
+}
+
+bool LineRateHistogram::empty() const
+{
+    return _buckets.empty();
+}
+
+std::int64_t LineRateHistogram::first_second() const
+{
+    return _origin_second;
+}
+
+std::int64_t LineRateHistogram::end_second() const
+{
+    return _origin_second + static_cast<std::int64_t>(_buckets.size()) * _bucket_seconds;
+}
+
+std::int64_t LineRateHistogram::bucket_seconds() const
+{
+    return _bucket_seconds;
+}
+
+std::uint64_t LineRateHistogram::generation() const
+{
+    return _generation;
+}
+
+std::vector<LineRate> LineRateHistogram::resample(std::int64_t from_second, std::int64_t to_second, int column_count) const
+{
+    std::vector<LineRate> rates(static_cast<std::size_t>(std::max(column_count, 0)));
+    if (rates.empty() || to_second <= from_second || _buckets.empty())
+    {
+        return rates;
+    }
+
+    // Each bucket's counts are spread over the columns it overlaps in proportion to the overlap, which keeps rates
+    // right both when a column spans many buckets and when zooming in makes one bucket span many columns.
+    const double span           = static_cast<double>(to_second - from_second);
+    const double column_seconds = span / static_cast<double>(column_count);
+    const std::int64_t first    = std::max<std::int64_t>(0, floor_div(from_second - _origin_second, _bucket_seconds));
+    const std::int64_t last     = std::min<std::int64_t>(static_cast<std::int64_t>(_buckets.size()), floor_div(to_second - _origin_second - 1, _bucket_seconds) + 1);
+    for (std::int64_t index = first; index < last; ++index)
+    {
+        const auto& bucket = _buckets[static_cast<std::size_t>(index)];
+        if (bucket.lines == 0)
+        {
+            continue;
+        }
+
+        const double bucket_start = static_cast<double>(_origin_second + index * _bucket_seconds - from_second);
+        const double bucket_end   = bucket_start + static_cast<double>(_bucket_seconds);
+        const int first_column    = std::clamp(static_cast<int>(bucket_start / column_seconds), 0, column_count - 1);
+        const int last_column     = std::clamp(static_cast<int>(bucket_end / column_seconds), 0, column_count - 1);
+        for (int column = first_column; column <= last_column; ++column)
+        {
+            const double column_start = column * column_seconds;
+            const double overlap      = std::min(bucket_end, column_start + column_seconds) - std::max(bucket_start, column_start);
+            if (overlap <= 0.0)
+            {
+                continue;
+            }
+
+            const double share = overlap / static_cast<double>(_bucket_seconds);
+            auto& rate         = rates[static_cast<std::size_t>(column)];
+            rate.lines_per_second += static_cast<double>(bucket.lines) * share / column_seconds;
+            rate.errors_per_second += static_cast<double>(bucket.errors) * share / column_seconds;
+        }
+    }
+
+    return rates;
+}
+
+std::optional<AllLineIndex> LineRateHistogram::first_line_at_or_after(std::int64_t second) const
+{
+    // No run before the partition point reaches second. Evicted runs may have raised max_second past the first
+    // run that does, so the scan goes on from there.
+    auto run = std::partition_point(_runs.begin(), _runs.end(), [second](const Run& candidate) { return candidate.max_second < second; });
+    run      = std::find_if(run, _runs.end(), [second](const Run& candidate) { return candidate.second >= second; });
+    if (run == _runs.end())
+    {
+        return std::nullopt;
+    }
+
+    return AllLineIndex {run->first_index};
+}
+
+std::size_t LineRateHistogram::memory_bytes() const
+{
+    return _buckets.size() * sizeof(Bucket) + _runs.size() * sizeof(Run);
+}
+
+LineRateHistogram::Bucket& LineRateHistogram::bucket_for(std::int64_t second)
+{
+    if (_buckets.empty())
+    {
+        _origin_second = align_down(second, _bucket_seconds);
+        _buckets.emplace_back();
+    }
+
+    // A timestamp far outside the covered range widens the buckets until the whole range fits again.
+    while (true)
+    {
+        const std::int64_t first = std::min(_origin_second, align_down(second, _bucket_seconds));
+        const std::int64_t end   = std::max(end_second(), align_down(second, _bucket_seconds) + _bucket_seconds);
+        if ((end - first) / _bucket_seconds <= static_cast<std::int64_t>(max_bucket_count))
+        {
+            break;
+        }
+
+        coarsen();
+    }
+
+    while (second < _origin_second)
+    {
+        _buckets.emplace_front();
+        _origin_second -= _bucket_seconds;
+    }
+
+    while (second >= end_second())
+    {
+        _buckets.emplace_back();
+    }
+
+    return _buckets[static_cast<std::size_t>((second - _origin_second) / _bucket_seconds)];
+}
+
+bool LineRateHistogram::far_from_range(std::int64_t second) const
+{
+    if (_buckets.empty())
+    {
+        return false;
+    }
+
+    // Growing the range up to this much only widens the buckets a couple of times, as a steadily advancing log does.
+    const std::int64_t reach = 4 * std::max(end_second() - _origin_second, static_cast<std::int64_t>(max_bucket_count));
+    return second < _origin_second - reach || second >= end_second() + reach;
+}
+
+void LineRateHistogram::coarsen()
+{
+    const std::int64_t bucket_seconds = _bucket_seconds * 2;
+    const std::int64_t origin_second  = align_down(_origin_second, bucket_seconds);
+    std::deque<Bucket> buckets;
+    for (std::size_t index = 0; index < _buckets.size(); ++index)
+    {
+        const auto target = static_cast<std::size_t>((_origin_second + static_cast<std::int64_t>(index) * _bucket_seconds - origin_second) / bucket_seconds);
+        if (target >= buckets.size())
+        {
+            buckets.resize(target + 1);
+        }
+
+        buckets[target].lines += _buckets[index].lines;
+        buckets[target].errors += _buckets[index].errors;
+    }
+
+    _buckets        = std::move(buckets);
+    _origin_second  = origin_second;
+    _bucket_seconds = bucket_seconds;
+}
+
+void LineRateHistogram::refine()
+{
+    // The covered range is only known to bucket precision, so each rebuild may reveal a narrower one.
+    while (true)
+    {
+        const std::int64_t span     = end_second() - _origin_second;
+        std::int64_t bucket_seconds = _bucket_seconds;
+        // One bucket of slack, since the range is aligned to the new width.
+        while (bucket_seconds > 1 && span / (bucket_seconds / 2) + 1 < static_cast<std::int64_t>(max_bucket_count))
+        {
+            bucket_seconds /= 2;
+        }
+
+        if (bucket_seconds == _bucket_seconds)
+        {
+            return;
+        }
+
+        _buckets.clear();
+        _bucket_seconds = bucket_seconds;
+        for (const auto& run : _runs)
+        {
+            auto& bucket = bucket_for(run.second);
+            bucket.lines += run.lines;
+            bucket.errors += run.errors;
+        }
+    }
+}
+
+void LineRateHistogram::trim_empty_buckets()
+{
+    while (!_buckets.empty() && _buckets.front().lines == 0)
+    {
+        _buckets.pop_front();
+        _origin_second += _bucket_seconds;
+    }
+
+    while (!_buckets.empty() && _buckets.back().lines == 0)
+    {
+        _buckets.pop_back();
+    }
+}
+
+} // namespace slayerlog
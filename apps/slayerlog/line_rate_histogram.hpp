@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "log_line_store.hpp"
+#include "log_timestamp.hpp"
+
+namespace slayerlog
+{
+
+/** @brief Average rates over one displayed time span. */
+struct LineRate
+{
+    double lines_per_second  = 0.0;
+    double errors_per_second = 0.0;
+};
+
+/**
+ * @brief Line and error counts of the stored lines in fixed-width time buckets, kept up to date as lines are appended and evicted.
+ *
+ * Buckets start one second wide and double in width whenever the covered time range would need more than
+ * max_bucket_count of them, so their memory stays bounded however long the session runs; once the range shrinks again
+ * they are rebuilt at the finest width that fits. Consecutive lines within the same second form a run; runs let
+ * eviction subtract whole runs and let a time be mapped back to the first line at it. Runs are not bounded by the
+ * buckets: there is at most one per stored line, typically one per second, and they leave with the evicted lines.
+ *
+ * A lone line far outside the covered range, such as a mangled or epoch timestamp, would coarsen every bucket, so a
+ * far timestamp only counts once the next timestamped line lands near it; until then it counts like a line without one.
+ */
+class LineRateHistogram
+{
+public:
+    static constexpr std::size_t max_bucket_count = 16384;
+
+    void clear();
+    /** @brief Counts the line at entry_index; a line without a timestamp counts in the second of the line before it. */
+    void append(AllLineIndex entry_index, std::optional<LogTimePoint> timestamp, bool error);
+    /** @brief Drops the runs that lie entirely before first_retained_index; a partly evicted run stays counted until it is gone. */
+    void erase_before(AllLineIndex first_retained_index);
+    /** @brief Counts the errors of every run again after the line levels changed; counted_error is asked for each line a run spans. */
+    void recount_errors(const std::function<bool(AllLineIndex)>& counted_error);
+
+    bool empty() const;
+    /** @brief First second of the oldest non-empty bucket. */
+    std::int64_t first_second() const;
+    /** @brief Second just past the newest non-empty bucket. */
+    std::int64_t end_second() const;
+    std::int64_t bucket_seconds() const;
+    /** @brief Changes on every append or eviction, so views can cache what they derived from the buckets. */
+    std::uint64_t generation() const;
+
+    /**
+     * @brief Splits [from_second, to_second) into column_count equal spans and returns the average rates in each.
+     *
+     * Columns narrower than a bucket get the bucket's counts in proportion to their overlap, so zooming in further than
+     * the buckets only shows the bucket averages.
+     */
+    std::vector<LineRate> resample(std::int64_t from_second, std::int64_t to_second, int column_count) const;
+    /** @brief Returns the first stored line whose second is at or after second, in line order; a binary search when the seconds only grow. */
+    std::optional<AllLineIndex> first_line_at_or_after(std::int64_t second) const;
+
+    std::size_t memory_bytes() const;
+
+private:
+    struct Bucket
+    {
+        std::uint64_t lines  = 0;
+        std::uint64_t errors = 0;
+    };
+
+    struct Run
+    {
+        std::int64_t first_index = 0;
+        std::int64_t second      = 0;
+        std::uint32_t lines      = 0;
+        std::uint32_t errors     = 0;
+        // Highest second of this run and the ones before it, which never decreases along _runs and so can be searched.
+        std::int64_t max_second = 0;
+    };
+
+    Bucket& bucket_for(std::int64_t second);
+    /** @brief Returns whether second lies so far outside the covered range that taking it in would coarsen the buckets several times. */
+    bool far_from_range(std::int64_t second) const;
+    void coarsen();
+    /** @brief Rebuilds the buckets from the runs at the finest width the covered range fits in, if that is finer than now. */
+    void refine();
+    void trim_empty_buckets();
+
+    std::deque<Bucket> _buckets;
+    std::deque<Run> _runs;
+    std::int64_t _origin_second  = 0;
+    std::int64_t _bucket_seconds = 1;
+    std::uint64_t _generation    = 0;
+    std::optional<std::int64_t> _last_second;
+    // A far timestamp not yet confirmed by the next timestamped line.
+    std::optional<std::int64_t> _far_second;
+};
+
+/** @brief Whole seconds since the epoch, rounded down. */
+std::int64_t epoch_second(LogTimePoint time_point);
+
+} // namespace slayerlog
@@ -0,0 +1,212 @@
+#include "line_templates.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+constexpr std::string_view parameter_text = "<*>";
+
+bool is_token_separator(char character)
+{
+    return character == ' ' || character == '\t';
+}
+
+bool has_digit(std::string_view token)
+{
+    return std::any_of(token.begin(), token.end(), [](char character) { return character >= '0' && character <= '9'; });
+}
+
+} // namespace
+
+TemplateId TemplateMiner::add(std::string_view text)
+{
+    tokenize(text);
+    auto& group = _groups[group_key()];
+
+    // The template matched last is kept first, so a run of the same message costs one comparison per line.
+    std::size_t best_position = group.size();
+    double best_similarity    = -1.0;
+    for (std::size_t position = 0; position < group.size(); ++position)
+    {
+        const auto& candidate = _templates[group[position]];
+        if (candidate.tokens.size() != _tokens.size())
+        {
+            continue;
+        }
+
+        const double candidate_similarity = similarity(candidate);
+        if (candidate_similarity > best_similarity)
+        {
+            best_similarity = candidate_similarity;
+            best_position   = position;
+        }
+
+        if (candidate_similarity >= 1.0)
+        {
+            break;
+        }
+    }
+
+    if (best_position < group.size() && best_similarity >= similarity_threshold)
+    {
+        const TemplateId id = group[best_position];
+        auto& tokens        = _templates[id].tokens;
+        for (std::size_t index = 0; index < tokens.size(); ++index)
+        {
+            if (!tokens[index].empty() && tokens[index] != _tokens[index])
+            {
+                tokens[index].clear();
+            }
+        }
+
+        std::rotate(group.begin(), group.begin() + static_cast<std::ptrdiff_t>(best_position), group.begin() + static_cast<std::ptrdiff_t>(best_position) + 1);
+        return id;
+    }
+
+    // The group is ordered by last match, so its back is the least recently matched template.
+    if (group.size() >= max_templates_per_group)
+    {
+        auto& retired = _templates[group.back()].tokens;
+        for (const auto& token : retired)
+        {
+            _token_bytes -= sizeof(std::string) + token.size();
+        }
+
+        std::vector<std::string>().swap(retired);
+        group.pop_back();
+        ++_retired_count;
+    }
+
+    const auto id = static_cast<TemplateId>(_templates.size());
+    Template added;
+    added.tokens.reserve(_tokens.size());
+    for (const auto token : _tokens)
+    {
+        added.tokens.emplace_back(token);
+        _token_bytes += sizeof(std::string) + token.size();
+    }
+
+    _templates.push_back(std::move(added));
+    group.insert(group.begin(), id);
+    return id;
+}
+
+std::string TemplateMiner::template_text(TemplateId id) const
+{
+    std::string text;
+    if (id >= _templates.size())
+    {
+        return text;
+    }
+
+    for (const auto& token : _templates[id].tokens)
+    {
+        if (!text.empty())
+        {
+            text.push_back(' ');
+        }
+
+        text.append(token.empty() ? parameter_text : std::string_view(token));
+    }
+
+    return text;
+}
+
+std::size_t TemplateMiner::template_count() const
+{
+    return _templates.size() - _retired_count;
+}
+
+void TemplateMiner::clear()
+{
+    _templates.clear();
+    _groups.clear();
+    _token_bytes   = 0;
+    _retired_count = 0;
+}
+
+std::size_t TemplateMiner::memory_bytes() const
+{
+    std::size_t group_bytes = 0;
+    for (const auto& group : _groups)
+    {
+        group_bytes += sizeof(group) + group.second.capacity() * sizeof(TemplateId);
+    }
+
+    return _templates.capacity() * sizeof(Template) + _token_bytes + group_bytes;
+}
+
+void TemplateMiner::tokenize(std::string_view text)
+{
+    _tokens.clear();
+    std::size_t position = 0;
+    while (_tokens.size() < max_tokens)
+    {
+        while (position < text.size() && is_token_separator(text[position]))
+        {
+            ++position;
+        }
+
+        if (position == text.size())
+        {
+            break;
+        }
+
+        const std::size_t start = position;
+        while (position < text.size() && !is_token_separator(text[position]))
+        {
+            ++position;
+        }
+
+        // Ids, counters, addresses and timestamps nearly always hold a digit, so such tokens start out as parameters.
+        const auto token = text.substr(start, position - start);
+        _tokens.push_back(has_digit(token) ? std::string_view() : token);
+    }
+}
+
+std::uint64_t TemplateMiner::group_key() const
+{
+    std::uint64_t key = _tokens.size();
+    for (std::size_t index = 0; index < std::min<std::size_t>(_tokens.size(), 2); ++index)
+    {
+        // Boost's hash_combine; a collision only puts two groups' templates side by side.
+        key ^= std::hash<std::string_view> {}(_tokens[index]) + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    }
+
+    return key;
+}
+
+double TemplateMiner::similarity(const Template& candidate) const
+{
+    if (_tokens.empty())
+    {
+        return 1.0;
+    }
+
+    // As in Drain, only words count as agreeing, so parameters cannot pull unrelated messages together; a line of
+    // parameters only matches a template that is all parameters.
+    std::size_t equal_words      = 0;
+    std::size_t equal_parameters = 0;
+    for (std::size_t index = 0; index < _tokens.size(); ++index)
+    {
+        if (candidate.tokens[index] == _tokens[index])
+        {
+            ++(_tokens[index].empty() ? equal_parameters : equal_words);
+        }
+    }
+
+    if (equal_parameters == _tokens.size())
+    {
+        return 1.0;
+    }
+
+    return static_cast<double>(equal_words) / static_cast<double>(_tokens.size());
+}
+
+} // namespace slayerlog
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace slayerlog
+{
+
+using TemplateId = std::uint32_t;
+
+/**
+ * @brief Streaming Drain-style clustering of lines into message templates such as "user <*> logged in from <*>".
+ *
+ * A line is split on whitespace and tokens holding a digit are masked as parameters. Lines are grouped by token count
+ * and their first two tokens; within a group the line joins the most similar template when at least
+ * similarity_threshold of its tokens are the template's words, turning the differing tokens into parameters, and starts
+ * a new template otherwise. A full group retires its least recently matched template to make room, which bounds the
+ * per-line work without forcing unrelated lines into one template; a retired template keeps its id but no longer
+ * matches and its text is released.
+ */
+class TemplateMiner
+{
+public:
+    static constexpr double similarity_threshold         = 0.4;
+    static constexpr std::size_t max_templates_per_group = 64;
+    /** @brief Tokens past this many do not take part in clustering. */
+    static constexpr std::size_t max_tokens = 64;
+
+    /** @brief Returns the template of text; the id of a template never changes as it generalizes. */
+    TemplateId add(std::string_view text);
+    /** @brief Returns the template tokens joined by single spaces, with "<*>" for parameters; empty once retired. */
+    std::string template_text(TemplateId id) const;
+    /** @brief Returns the number of templates that can still be matched. */
+    std::size_t template_count() const;
+    void clear();
+    std::size_t memory_bytes() const;
+
+private:
+    struct Template
+    {
+        // An empty token is a parameter; real tokens are never empty.
+        std::vector<std::string> tokens;
+    };
+
+    void tokenize(std::string_view text);
+    std::uint64_t group_key() const;
+    double similarity(const Template& candidate) const;
+
+    std::vector<Template> _templates;
+    std::unordered_map<std::uint64_t, std::vector<TemplateId>> _groups;
+    std::size_t _token_bytes   = 0;
+    std::size_t _retired_count = 0;
+    // Reused between calls so mining a line does not allocate once its group exists.
+    std::vector<std::string_view> _tokens;
+};
+
+} // namespace slayerlog
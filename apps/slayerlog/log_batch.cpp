@@ -2,7 +2,9 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "log_timestamp.hpp"
@@ -16,6 +18,7 @@ namespace
 struct WatcherState
 {
     std::size_t next_line_index = 0;
+    std::size_t next_skipped_index = 0;
     bool current_timestamp_parsed = false;
     std::optional<LogTimePoint> current_timestamp;
 };
@@ -36,6 +39,22 @@ std::optional<LogTimePoint> get_current_timestamp(const WatcherLineBatch& watche
     return watcher_state.current_timestamp;
 }
 
+std::uint64_t take_skipped_count(const std::vector<std::vector<SkippedLines>>& skipped_lines, std::size_t watcher_index, WatcherState& watcher_state)
+{
+    if (watcher_index >= skipped_lines.size())
+    {
+        return 0;
+    }
+
+    const auto& skipped = skipped_lines[watcher_index];
+    if (watcher_state.next_skipped_index < skipped.size() && skipped[watcher_state.next_skipped_index].line == watcher_state.next_line_index)
+    {
+        return skipped[watcher_state.next_skipped_index++].count;
+    }
+
+    return 0;
+}
+
 void advance_watcher(WatcherState& watcher_state)
 {
     ++watcher_state.next_line_index;
@@ -46,8 +65,9 @@ void advance_watcher(WatcherState& watcher_state)
 } // namespace
 
 std::vector<ObservedLogLine> merge_log_batch(
-    const std::vector<WatcherLineBatch>& watcher_batches,
-    const std::vector<std::string>& source_labels)
+    std::vector<WatcherLineBatch> watcher_batches,
+    const std::vector<std::string>& source_labels,
+    const std::vector<std::vector<SkippedLines>>& skipped_lines)
 {
     assert(source_labels.size() == watcher_batches.size());
 
@@ -66,7 +86,7 @@ std::vector<ObservedLogLine> merge_log_batch(
     {
         for (std::size_t watcher_index = 0; watcher_index < watcher_batches.size(); ++watcher_index)
         {
-            const auto& watcher_batch = watcher_batches[watcher_index];
+            auto& watcher_batch = watcher_batches[watcher_index];
             auto& watcher_state = watcher_states[watcher_index];
 
             while (has_pending_line(watcher_batch, watcher_state))
@@ -77,9 +97,13 @@ std::vector<ObservedLogLine> merge_log_batch(
                     break;
                 }
 
+                const std::uint64_t skipped_count = take_skipped_count(skipped_lines, watcher_index, watcher_state);
                 merged_lines.push_back({
                     source_labels[watcher_index],
-                    watcher_batch[watcher_state.next_line_index],
+                    std::move(watcher_batch[watcher_state.next_line_index]),
+                    true,
+                    std::nullopt,
+                    skipped_count,
                 });
                 advance_watcher(watcher_state);
             }
@@ -122,9 +146,13 @@ std::vector<ObservedLogLine> merge_log_batch(
         }
 
         auto& next_watcher_state = watcher_states[next_watcher_index.value()];
+        const std::uint64_t skipped_count = take_skipped_count(skipped_lines, next_watcher_index.value(), next_watcher_state);
         merged_lines.push_back({
             source_labels[next_watcher_index.value()],
-            watcher_batches[next_watcher_index.value()][next_watcher_state.next_line_index],
+            std::move(watcher_batches[next_watcher_index.value()][next_watcher_state.next_line_index]),
+            true,
+            next_timestamp,
+            skipped_count,
         });
         advance_watcher(next_watcher_state);
     }
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "log_timestamp.hpp"
+
 namespace slayerlog
 {
 
@@ -10,12 +15,30 @@ struct ObservedLogLine
 {
     std::string source_label;
     std::string text;
+    /** @brief Set by merge_log_batch, which parses every timestamp anyway, so the model need not parse the line again. */
+    bool timestamp_parsed                 = false;
+    std::optional<LogTimePoint> timestamp = std::nullopt;
+    /** @brief Source lines left out right before this one, such as lines a remote filter dropped; they still count towards line numbers. */
+    std::uint64_t skipped_before = 0;
 };
 
 using WatcherLineBatch = std::vector<std::string>;
 
+/** @brief Source lines a watcher left out right before the line at index line of its batch. */
+struct SkippedLines
+{
+    std::size_t line    = 0;
+    std::uint64_t count = 0;
+};
+
+/**
+ * @brief Interleaves the batches by timestamp; the line strings are moved out of the batches rather than copied.
+ *
+ * skipped_lines, when given, holds for each batch the gaps before its lines in line order and is carried over to the merged lines.
+ */
 std::vector<ObservedLogLine> merge_log_batch(
-    const std::vector<WatcherLineBatch>& watcher_batches,
-    const std::vector<std::string>& source_labels);
+    std::vector<WatcherLineBatch> watcher_batches,
+    const std::vector<std::string>& source_labels,
+    const std::vector<std::vector<SkippedLines>>& skipped_lines = {});
 
 } // namespace slayerlog
@@ -1,15 +1,13 @@
 #include "log_controller.hpp"
 
+#include "clipboard.hpp"
+
+#include <ftxui_components/text_width.hpp>
+
 #include <algorithm>
-#include <cstdio>
-#include <cstdlib>
-#include <sstream>
+#include <climits>
 #include <string>
-
-#ifdef _WIN32
-#    define NOMINMAX
-#    include <windows.h>
-#endif
+#include <string_view>
 
 namespace slayerlog
 {
@@ -22,144 +20,6 @@ bool is_before(const TextPosition& lhs, const TextPosition& rhs)
     return lhs.line < rhs.line || (lhs.line == rhs.line && lhs.column < rhs.column);
 }
 
-#ifndef _WIN32
-
-bool env_var_is_set(const char* name)
-{
-    const auto* value = std::getenv(name);
-    return value != nullptr && value[0] != '\0';
-}
-
-bool is_ssh_session()
-{
-    return env_var_is_set("SSH_CONNECTION") || env_var_is_set("SSH_CLIENT") || env_var_is_set("SSH_TTY");
-}
-
-bool write_text_to_command(const char* command, const std::string& text)
-{
-    auto* pipe = popen(command, "w");
-    if (pipe == nullptr)
-    {
-        return false;
-    }
-
-    const std::size_t bytes_written = std::fwrite(text.data(), 1, text.size(), pipe);
-    const int status                = pclose(pipe);
-    return bytes_written == text.size() && status == 0;
-}
-
-std::string base64_encode(const std::string& text)
-{
-    static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-    std::string encoded;
-    encoded.reserve(((text.size() + 2) / 3) * 4);
-
-    std::size_t index = 0;
-    while (index + 3 <= text.size())
-    {
-        const unsigned int value = (static_cast<unsigned char>(text[index]) << 16) | (static_cast<unsigned char>(text[index + 1]) << 8) | static_cast<unsigned char>(text[index + 2]);
-        encoded.push_back(alphabet[(value >> 18) & 0x3F]);
-        encoded.push_back(alphabet[(value >> 12) & 0x3F]);
-        encoded.push_back(alphabet[(value >> 6) & 0x3F]);
-        encoded.push_back(alphabet[value & 0x3F]);
-        index += 3;
-    }
-
-    const std::size_t remainder = text.size() - index;
-    if (remainder == 1)
-    {
-        const unsigned int value = static_cast<unsigned char>(text[index]) << 16;
-        encoded.push_back(alphabet[(value >> 18) & 0x3F]);
-        encoded.push_back(alphabet[(value >> 12) & 0x3F]);
-        encoded.push_back('=');
-        encoded.push_back('=');
-    }
-    else if (remainder == 2)
-    {
-        const unsigned int value = (static_cast<unsigned char>(text[index]) << 16) | (static_cast<unsigned char>(text[index + 1]) << 8);
-        encoded.push_back(alphabet[(value >> 18) & 0x3F]);
-        encoded.push_back(alphabet[(value >> 12) & 0x3F]);
-        encoded.push_back(alphabet[(value >> 6) & 0x3F]);
-        encoded.push_back('=');
-    }
-
-    return encoded;
-}
-
-std::string build_osc52_sequence(const std::string& text)
-{
-    const std::string payload = "52;c;" + base64_encode(text) + '\a';
-
-    if (env_var_is_set("TMUX"))
-    {
-        return "\x1bPtmux;\x1b]" + payload + "\x1b\\";
-    }
-
-    const auto* term = std::getenv("TERM");
-    if (term != nullptr && std::string(term).rfind("screen", 0) == 0)
-    {
-        return "\x1bP\x1b]" + payload + "\x1b\\";
-    }
-
-    return "\x1b]" + payload;
-}
-
-bool write_text_to_terminal_clipboard(const std::string& text)
-{
-    auto* terminal = std::fopen("/dev/tty", "w");
-    if (terminal == nullptr)
-    {
-        return false;
-    }
-
-    const auto sequence      = build_osc52_sequence(text);
-    const auto bytes_written = std::fwrite(sequence.data(), 1, sequence.size(), terminal);
-    const bool flushed       = std::fflush(terminal) == 0;
-    std::fclose(terminal);
-
-    return bytes_written == sequence.size() && flushed;
-}
-
-bool copy_with_local_clipboard_tools(const std::string& text)
-{
-#    ifdef __APPLE__
-    if (write_text_to_command("pbcopy 2>/dev/null", text))
-    {
-        return true;
-    }
-#    endif
-
-    if (write_text_to_command("wl-copy --type text/plain;charset=utf-8 2>/dev/null", text))
-    {
-        return true;
-    }
-
-    if (write_text_to_command("xclip -in -selection clipboard 2>/dev/null", text))
-    {
-        return true;
-    }
-
-    if (write_text_to_command("xsel --clipboard --input 2>/dev/null", text))
-    {
-        return true;
-    }
-
-    return false;
-}
-
-bool copy_text_to_clipboard_on_unix(const std::string& text)
-{
-    if (is_ssh_session())
-    {
-        return write_text_to_terminal_clipboard(text) || copy_with_local_clipboard_tools(text);
-    }
-
-    return copy_with_local_clipboard_tools(text) || write_text_to_terminal_clipboard(text);
-}
-
-#endif
-
 } // namespace
 
 void LogController::reset()
@@ -168,11 +28,13 @@ void LogController::reset()
     _first_visible_col        = 0;
     _follow_bottom            = true;
 
+    _evicted_visible_line_baseline = 0;
     _active_find_entry_index.reset();
 
     _selection_in_progress = false;
     _selection_anchor.reset();
     _selection_focus.reset();
+    _clipboard_notice.clear();
 }
 
 int LogController::first_visible_col(const LogModel& model, int viewport_col_count) const
@@ -187,17 +49,20 @@ VisibleLineIndex LogController::first_visible_line_index(const LogModel& model,
         return VisibleLineIndex {max_first_visible_line_index(model, viewport_line_count)};
     }
 
-    return VisibleLineIndex {std::clamp(_first_visible_line_index.value, 0, max_first_visible_line_index(model, viewport_line_count))};
+    const int first_visible_line_index = _first_visible_line_index.value - pending_evicted_visible_lines(model);
+    return VisibleLineIndex {std::clamp(first_visible_line_index, 0, max_first_visible_line_index(model, viewport_line_count))};
 }
 
 void LogController::scroll_up(const LogModel& model, int viewport_line_count, int amount)
 {
+    apply_evicted_visible_lines(model);
     _first_visible_line_index = VisibleLineIndex {std::max(0, first_visible_line_index(model, viewport_line_count).value - std::max(1, amount))};
     _follow_bottom            = _first_visible_line_index.value >= max_first_visible_line_index(model, viewport_line_count);
 }
 
 void LogController::scroll_down(const LogModel& model, int viewport_line_count, int amount)
 {
+    apply_evicted_visible_lines(model);
     _first_visible_line_index = VisibleLineIndex {std::min(first_visible_line_index(model, viewport_line_count).value + std::max(1, amount), max_first_visible_line_index(model, viewport_line_count))};
     _follow_bottom            = _first_visible_line_index.value >= max_first_visible_line_index(model, viewport_line_count);
 }
@@ -214,6 +79,7 @@ void LogController::scroll_right(const LogModel& model, int viewport_col_count,
 
 void LogController::scroll_to_top(const LogModel& model, int viewport_line_count)
 {
+    apply_evicted_visible_lines(model);
     _first_visible_line_index = VisibleLineIndex {0};
     _follow_bottom            = _first_visible_line_index.value >= max_first_visible_line_index(model, viewport_line_count);
 }
@@ -223,7 +89,7 @@ void LogController::scroll_to_bottom()
     _follow_bottom = true;
 }
 
-bool LogController::go_to_line(const LogModel& model, int line_number, int viewport_line_count)
+bool LogController::go_to_line(const LogModel& model, std::int64_t line_number, int viewport_line_count)
 {
     const auto target_visible_index = model.visible_line_index_for_line_number(line_number);
     if (!target_visible_index.has_value())
@@ -235,6 +101,24 @@ bool LogController::go_to_line(const LogModel& model, int line_number, int viewp
     return true;
 }
 
+bool LogController::go_to_second(const LogModel& model, std::int64_t second, int viewport_line_count)
+{
+    const auto entry_index = model.line_rates().first_line_at_or_after(second);
+    if (!entry_index.has_value())
+    {
+        return false;
+    }
+
+    const auto target_visible_index = model.first_visible_line_at_or_after(*entry_index);
+    if (!target_visible_index.has_value())
+    {
+        return false;
+    }
+
+    center_on_visible_line(model, *target_visible_index, viewport_line_count);
+    return true;
+}
+
 bool LogController::set_find_query(LogModel& model, std::string query, int viewport_line_count)
 {
     const bool has_matches = model.set_find_query(std::move(query));
@@ -345,13 +229,16 @@ std::optional<VisibleLineIndex> LogController::active_find_visible_index(const L
 
 void LogController::begin_selection(const LogModel& model, TextPosition position)
 {
+    apply_evicted_visible_lines(model);
     _selection_anchor      = clamp_selection_position(model, position);
     _selection_focus       = _selection_anchor;
     _selection_in_progress = _selection_anchor.has_value();
+    _clipboard_notice.clear();
 }
 
 void LogController::update_selection(const LogModel& model, TextPosition position)
 {
+    apply_evicted_visible_lines(model);
     if (!_selection_in_progress || !_selection_anchor.has_value())
     {
         return;
@@ -362,6 +249,7 @@ void LogController::update_selection(const LogModel& model, TextPosition positio
 
 void LogController::end_selection(const LogModel& model, std::optional<TextPosition> position)
 {
+    apply_evicted_visible_lines(model);
     _selection_in_progress = false;
     if (position.has_value() && _selection_anchor.has_value())
     {
@@ -374,6 +262,7 @@ void LogController::clear_selection()
     _selection_anchor.reset();
     _selection_focus.reset();
     _selection_in_progress = false;
+    _clipboard_notice.clear();
 }
 
 bool LogController::selection_in_progress() const
@@ -388,8 +277,14 @@ std::optional<std::pair<TextPosition, TextPosition>> LogController::selection_bo
         return std::nullopt;
     }
 
-    auto start = clamp_selection_position(model, *_selection_anchor);
-    auto end   = clamp_selection_position(model, *_selection_focus);
+    const int evicted_line_count = pending_evicted_visible_lines(model);
+    if (selection_evicted(evicted_line_count))
+    {
+        return std::nullopt;
+    }
+
+    auto start = clamp_selection_position(model, shift_for_eviction(*_selection_anchor, evicted_line_count));
+    auto end   = clamp_selection_position(model, shift_for_eviction(*_selection_focus, evicted_line_count));
     if (is_before(end, start))
     {
         std::swap(start, end);
@@ -407,24 +302,43 @@ std::string LogController::selection_text(const LogModel& model) const
     }
 
     const auto [start, end] = *bounds;
-    std::ostringstream output;
+    // Lines are rendered straight into one buffer, sized from the first line, so copying a huge selection does not
+    // build a temporary string per line.
+    std::string output;
     for (int line_index = start.line; line_index <= end.line; ++line_index)
     {
-        const auto line            = model.rendered_line(line_index);
-        const int line_start       = (line_index == start.line) ? start.column : 0;
-        const int line_end         = (line_index == end.line) ? end.column : static_cast<int>(line.size());
-        const int clamped_start    = std::clamp(line_start, 0, static_cast<int>(line.size()));
-        const int clamped_end      = std::clamp(line_end, clamped_start, static_cast<int>(line.size()));
-        const auto selection_count = static_cast<std::size_t>(clamped_end - clamped_start);
+        const std::size_t line_start = output.size();
+        model.append_rendered_line(line_index, output);
+        if (line_index == start.line)
+        {
+            output.reserve(output.size() * static_cast<std::size_t>(end.line - start.line + 1) + 1);
+        }
+
+        // The shown line may be cut off at the display limit, so a selection that reaches its end copies the whole line.
+        // Selected columns are display cells, which only the first and last line need mapped back to bytes.
+        const bool to_line_end = line_index != end.line || end.column >= model.rendered_line_width(line_index);
+        if (line_index == start.line || !to_line_end)
+        {
+            const std::string_view line(output.data() + line_start, output.size() - line_start);
+            const TextColumnIndex columns(line);
+            const std::size_t end_byte   = to_line_end ? line.size() : columns.byte_offset(line, std::max(0, end.column));
+            const std::size_t start_byte = line_index == start.line ? std::min(columns.byte_offset(line, std::max(0, start.column)), end_byte) : 0;
+            output.resize(line_start + end_byte);
+            output.erase(line_start, start_byte);
+        }
 
-        output << line.substr(static_cast<std::size_t>(clamped_start), selection_count);
         if (line_index != end.line)
         {
-            output << '\n';
+            output.push_back('\n');
         }
     }
 
-    return output.str();
+    return output;
+}
+
+const std::string& LogController::clipboard_notice() const
+{
+    return _clipboard_notice;
 }
 
 LogEventResult LogController::handle_event(LogModel& model, ftxui::Event event, int viewport_line_count, int viewport_col_count, const std::function<std::optional<TextPosition>(const ftxui::Mouse& mouse)>& mouse_to_text_position)
@@ -591,7 +505,7 @@ LogEventResult LogController::handle_event(LogModel& model, ftxui::Event event,
     return {false, false};
 }
 
-bool LogController::copy_selection_to_clipboard(const LogModel& model) const
+bool LogController::copy_selection_to_clipboard(const LogModel& model)
 {
     const auto text = selection_text(model);
     if (text.empty())
@@ -599,53 +513,22 @@ bool LogController::copy_selection_to_clipboard(const LogModel& model) const
         return false;
     }
 
-#ifdef _WIN32
-    const int wide_length = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, nullptr, 0);
-    if (wide_length <= 0)
-    {
-        return false;
-    }
-
-    auto* memory = GlobalAlloc(GMEM_MOVEABLE, static_cast<SIZE_T>(wide_length) * sizeof(wchar_t));
-    if (memory == nullptr)
+    const auto result = copy_text_to_clipboard(text);
+    if (result.saved_path.has_value())
     {
-        return false;
-    }
-
-    auto* wide_text = static_cast<wchar_t*>(GlobalLock(memory));
-    if (wide_text == nullptr)
-    {
-        GlobalFree(memory);
-        return false;
-    }
-
-    const int converted = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, wide_text, wide_length);
-    GlobalUnlock(memory);
-    if (converted <= 0)
-    {
-        GlobalFree(memory);
-        return false;
-    }
-
-    if (!OpenClipboard(nullptr))
-    {
-        GlobalFree(memory);
-        return false;
+        _clipboard_notice = "Selection too large for the clipboard, saved to " + result.saved_path->string();
+        return true;
     }
 
-    EmptyClipboard();
-    if (SetClipboardData(CF_UNICODETEXT, memory) == nullptr)
+    if (!result.copied)
     {
-        CloseClipboard();
-        GlobalFree(memory);
+        _clipboard_notice = "Copy failed";
         return false;
     }
 
-    CloseClipboard();
+    const auto line_count = static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')) + 1;
+    _clipboard_notice     = "Copied " + std::to_string(line_count) + (line_count == 1 ? " line" : " lines");
     return true;
-#else
-    return copy_text_to_clipboard_on_unix(text);
-#endif
 }
 
 int LogController::max_first_visible_line_index(const LogModel& model, int viewport_line_count) const
@@ -660,6 +543,7 @@ int LogController::max_first_visible_col(const LogModel& model, int viewport_col
 
 void LogController::center_on_visible_line(const LogModel& model, VisibleLineIndex target_visible_index, int viewport_line_count)
 {
+    apply_evicted_visible_lines(model);
     _first_visible_line_index       = VisibleLineIndex {target_visible_index.value - (std::max(1, viewport_line_count) / 2)};
     _first_visible_line_index.value = std::clamp(_first_visible_line_index.value, 0, max_first_visible_line_index(model, viewport_line_count));
     _follow_bottom                  = _first_visible_line_index.value >= max_first_visible_line_index(model, viewport_line_count);
@@ -673,9 +557,62 @@ TextPosition LogController::clamp_selection_position(const LogModel& model, Text
     }
 
     position.line          = std::clamp(position.line, 0, model.line_count() - 1);
-    const auto line_length = static_cast<int>(model.rendered_line(position.line).size());
+    const auto line_length = model.rendered_line_width(position.line);
     position.column        = std::clamp(position.column, 0, line_length);
     return position;
 }
 
+int LogController::pending_evicted_visible_lines(const LogModel& model) const
+{
+    const std::uint64_t evicted_line_count = model.evicted_visible_line_count();
+    if (evicted_line_count <= _evicted_visible_line_baseline)
+    {
+        return 0;
+    }
+
+    return static_cast<int>(std::min<std::uint64_t>(evicted_line_count - _evicted_visible_line_baseline, INT_MAX));
+}
+
+void LogController::apply_evicted_visible_lines(const LogModel& model)
+{
+    const int evicted_line_count   = pending_evicted_visible_lines(model);
+    _evicted_visible_line_baseline = model.evicted_visible_line_count();
+    if (evicted_line_count == 0)
+    {
+        return;
+    }
+
+    _first_visible_line_index.value = std::max(0, _first_visible_line_index.value - evicted_line_count);
+    if (!_selection_anchor.has_value() || !_selection_focus.has_value())
+    {
+        return;
+    }
+
+    if (selection_evicted(evicted_line_count))
+    {
+        clear_selection();
+        return;
+    }
+
+    _selection_anchor = shift_for_eviction(*_selection_anchor, evicted_line_count);
+    _selection_focus  = shift_for_eviction(*_selection_focus, evicted_line_count);
+}
+
+bool LogController::selection_evicted(int evicted_line_count) const
+{
+    return _selection_anchor.has_value() && _selection_focus.has_value() && std::max(_selection_anchor->line, _selection_focus->line) < evicted_line_count;
+}
+
+TextPosition LogController::shift_for_eviction(TextPosition position, int evicted_line_count)
+{
+    position.line -= evicted_line_count;
+    if (position.line < 0)
+    {
+        // Only part of the selection was evicted; it now starts at the oldest retained line.
+        return TextPosition {0, 0};
+    }
+
+    return position;
+}
+
 } // namespace slayerlog
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <string>
@@ -39,7 +40,9 @@ public:
     void scroll_to_top(const LogModel& model, int viewport_line_count);
     void scroll_to_bottom();
     int first_visible_col(const LogModel& model, int viewport_col_count) const;
-    bool go_to_line(const LogModel& model, int line_number, int viewport_line_count);
+    bool go_to_line(const LogModel& model, std::int64_t line_number, int viewport_line_count);
+    /** @brief Centers on the first visible line logged at or after second, in seconds since the epoch. */
+    bool go_to_second(const LogModel& model, std::int64_t second, int viewport_line_count);
 
     bool set_find_query(LogModel& model, std::string query, int viewport_line_count);
     void clear_find(LogModel& model);
@@ -54,26 +57,38 @@ public:
     bool selection_in_progress() const;
     std::optional<std::pair<TextPosition, TextPosition>> selection_bounds(const LogModel& model) const;
     std::string selection_text(const LogModel& model) const;
+    /** @brief Outcome of the last copy, shown in the header until the selection changes. */
+    const std::string& clipboard_notice() const;
 
     LogEventResult handle_event(LogModel& model, ftxui::Event event, int viewport_line_count, int viewport_col_count, const std::function<std::optional<TextPosition>(const ftxui::Mouse& mouse)>& mouse_to_text_position);
 
 private:
-    bool copy_selection_to_clipboard(const LogModel& model) const;
+    bool copy_selection_to_clipboard(const LogModel& model);
 
     int max_first_visible_line_index(const LogModel& model, int viewport_line_count) const;
     int max_first_visible_col(const LogModel& model, int viewport_col_count) const;
     void center_on_visible_line(const LogModel& model, VisibleLineIndex target_visible_index, int viewport_line_count);
     TextPosition clamp_selection_position(const LogModel& model, TextPosition position) const;
 
+    /** @brief Visible lines evicted by the model since stored positions were last rebased. */
+    int pending_evicted_visible_lines(const LogModel& model) const;
+    /** @brief Shifts stored visible positions so they keep pointing at the same lines after eviction. */
+    void apply_evicted_visible_lines(const LogModel& model);
+    bool selection_evicted(int evicted_line_count) const;
+    static TextPosition shift_for_eviction(TextPosition position, int evicted_line_count);
+
     VisibleLineIndex _first_visible_line_index {0};
     int _first_visible_col = 0;
     bool _follow_bottom    = true;
 
+    std::uint64_t _evicted_visible_line_baseline = 0;
+
     std::optional<AllLineIndex> _active_find_entry_index;
 
     bool _selection_in_progress = false;
     std::optional<TextPosition> _selection_anchor;
     std::optional<TextPosition> _selection_focus;
+    std::string _clipboard_notice;
 };
 
 } // namespace slayerlog
@@ -0,0 +1,301 @@
+#include "log_levels.hpp"
+
+#include <cctype>
+#include <stdexcept>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+constexpr std::array<std::string_view, log_level_count> level_names = {"trace", "debug", "info", "warn", "error", "fatal"};
+
+bool equals_ignoring_case(std::string_view lhs, std::string_view rhs)
+{
+    return lhs.size() == rhs.size()
+           && std::equal(lhs.begin(), lhs.end(), rhs.begin(),
+                         [](char left, char right) { return std::tolower(static_cast<unsigned char>(left)) == std::tolower(static_cast<unsigned char>(right)); });
+}
+
+bool is_word_character(char character)
+{
+    return std::isalnum(static_cast<unsigned char>(character)) != 0 || character == '_';
+}
+
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())) != 0)
+    {
+        text.remove_prefix(1);
+    }
+
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())) != 0)
+    {
+        text.remove_suffix(1);
+    }
+
+    return text;
+}
+
+} // namespace
+
+std::string_view log_level_name(LogLevel level)
+{
+    return level_names[static_cast<std::size_t>(level)];
+}
+
+std::optional<LogLevel> parse_log_level(std::string_view text)
+{
+    struct Alias
+    {
+        std::string_view name;
+        LogLevel level;
+    };
+
+    constexpr Alias aliases[] = {
+        {"trace", LogLevel::Trace}, {"debug", LogLevel::Debug}, {"info", LogLevel::Info},   {"warn", LogLevel::Warn},         {"warning", LogLevel::Warn},
+        {"error", LogLevel::Error}, {"err", LogLevel::Error},   {"fatal", LogLevel::Fatal}, {"critical", LogLevel::Fatal},
+    };
+
+    for (const auto& alias : aliases)
+    {
+        if (equals_ignoring_case(text, alias.name))
+        {
+            return alias.level;
+        }
+    }
+
+    return std::nullopt;
+}
+
+LogLevelMask parse_log_level_filter(std::string_view text)
+{
+    LogLevelMask levels = 0;
+    std::size_t start   = 0;
+    while (start <= text.size())
+    {
+        auto end = text.find_first_of(", ", start);
+        if (end == std::string_view::npos)
+        {
+            end = text.size();
+        }
+
+        auto name            = text.substr(start, end - start);
+        start                = end + 1;
+        const bool and_above = !name.empty() && name.back() == '+';
+        if (and_above)
+        {
+            name.remove_suffix(1);
+        }
+
+        if (name.empty())
+        {
+            continue;
+        }
+
+        const auto level = parse_log_level(name);
+        if (!level.has_value())
+        {
+            throw std::invalid_argument("Unknown level '" + std::string(name) + "'; expected trace, debug, info, warn, error or fatal");
+        }
+
+        for (std::size_t index = static_cast<std::size_t>(*level); index < (and_above ? log_level_count : static_cast<std::size_t>(*level) + 1); ++index)
+        {
+            levels |= log_level_bit(static_cast<LogLevel>(index));
+        }
+    }
+
+    if (levels == 0)
+    {
+        throw std::invalid_argument("Expected at least one level");
+    }
+
+    return levels;
+}
+
+LogLevelToken parse_log_level_token(std::string_view text)
+{
+    const auto separator = text.find('=');
+    if (separator == std::string_view::npos)
+    {
+        throw std::invalid_argument("Expected <level>=<token>");
+    }
+
+    const auto level = parse_log_level(trim(text.substr(0, separator)));
+    const auto token = trim(text.substr(separator + 1));
+    if (!level.has_value() || token.empty() || !std::all_of(token.begin(), token.end(), is_word_character))
+    {
+        throw std::invalid_argument("Expected <level>=<token> with a known level and a token of letters, digits or underscores");
+    }
+
+    return LogLevelToken {*level, std::string(token)};
+}
+
+LogLevelDetector::LogLevelDetector()
+{
+    constexpr std::pair<LogLevel, std::string_view> defaults[] = {
+        {LogLevel::Trace, "TRACE"},   {LogLevel::Trace, "TRC"},   {LogLevel::Trace, "VRB"},   {LogLevel::Debug, "DEBUG"},    {LogLevel::Debug, "DBG"},
+        {LogLevel::Info, "INFO"},     {LogLevel::Info, "INF"},    {LogLevel::Warn, "WARN"},   {LogLevel::Warn, "WARNING"},   {LogLevel::Warn, "WRN"},
+        {LogLevel::Error, "ERROR"},   {LogLevel::Error, "ERR"},   {LogLevel::Fatal, "FATAL"}, {LogLevel::Fatal, "CRITICAL"}, {LogLevel::Fatal, "CRIT"},
+        {LogLevel::Fatal, "FTL"},
+    };
+
+    for (const auto& [level, token] : defaults)
+    {
+        add_token(LogLevelToken {level, std::string(token)});
+    }
+}
+
+void LogLevelDetector::add_token(LogLevelToken token)
+{
+    _longest_token = std::max(_longest_token, token.token.size());
+    // Tokens added later take precedence, so --level-token can reassign a default word.
+    _tokens.insert(_tokens.begin(), std::move(token));
+}
+
+std::optional<LogLevel> LogLevelDetector::detect(std::string_view line) const
+{
+    const std::string_view window = line.substr(0, detection_window_bytes);
+    std::size_t position          = 0;
+    while (position < window.size())
+    {
+        if (!is_word_character(window[position]))
+        {
+            ++position;
+            continue;
+        }
+
+        const std::size_t start = position;
+        while (position < window.size() && is_word_character(window[position]))
+        {
+            ++position;
+        }
+
+        const auto word = window.substr(start, position - start);
+        if (word.size() > _longest_token || std::isdigit(static_cast<unsigned char>(word.front())) != 0)
+        {
+            continue;
+        }
+
+        for (const auto& token : _tokens)
+        {
+            if (equals_ignoring_case(word, token.token))
+            {
+                return token.level;
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+void LevelBitmaps::clear(AllLineIndex first_index)
+{
+    for (auto& words : _words)
+    {
+        words.clear();
+    }
+
+    _word_count = 0;
+    _base       = first_index.value;
+    _end        = first_index.value;
+}
+
+void LevelBitmaps::append(std::optional<LogLevel> level)
+{
+    const auto offset = static_cast<std::size_t>(_end - _base);
+    if (offset / 64 == _word_count)
+    {
+        for (auto& words : _words)
+        {
+            words.push_back(0);
+        }
+
+        ++_word_count;
+    }
+
+    if (level.has_value())
+    {
+        _words[static_cast<std::size_t>(*level)][offset / 64] |= std::uint64_t {1} << (offset % 64);
+    }
+
+    ++_end;
+}
+
+void LevelBitmaps::erase_before(AllLineIndex first_retained_index)
+{
+    const auto dropped_words = static_cast<std::size_t>(std::clamp<std::int64_t>(first_retained_index.value - _base, 0, _end - _base) / 64);
+    if (dropped_words == 0)
+    {
+        return;
+    }
+
+    for (auto& words : _words)
+    {
+        words.erase(words.begin(), words.begin() + static_cast<std::ptrdiff_t>(dropped_words));
+    }
+
+    _word_count -= dropped_words;
+    _base += static_cast<std::int64_t>(dropped_words * 64);
+}
+
+AllLineIndex LevelBitmaps::end_index() const
+{
+    return AllLineIndex {_end};
+}
+
+bool LevelBitmaps::contains(LogLevelMask levels, AllLineIndex index) const
+{
+    if (index.value < _base || index.value >= _end)
+    {
+        return false;
+    }
+
+    const auto offset = static_cast<std::size_t>(index.value - _base);
+    return ((union_word(levels, offset / 64) >> (offset % 64)) & 1U) != 0;
+}
+
+std::size_t LevelBitmaps::memory_bytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& words : _words)
+    {
+        bytes += words.size() * sizeof(std::uint64_t);
+    }
+
+    return bytes;
+}
+
+std::uint64_t LevelBitmaps::union_word(LogLevelMask levels, std::size_t word_index) const
+{
+    std::uint64_t word = 0;
+    for (std::size_t level = 0; level < log_level_count; ++level)
+    {
+        if ((levels & log_level_bit(static_cast<LogLevel>(level))) != 0)
+        {
+            word |= _words[level][word_index];
+        }
+    }
+
+    return word;
+}
+
+int LevelBitmaps::lowest_set_bit(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while ((word & 1U) == 0)
+    {
+        word >>= 1;
+        ++bit;
+    }
+
+    return bit;
+#endif
+}
+
+} // namespace slayerlog
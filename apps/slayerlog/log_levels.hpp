@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log_line_store.hpp"
+
+namespace slayerlog
+{
+
+enum class LogLevel : std::uint8_t
+{
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Fatal,
+};
+
+constexpr std::size_t log_level_count = 6;
+
+/** @brief Set of levels, one bit per LogLevel. */
+using LogLevelMask = std::uint8_t;
+
+constexpr LogLevelMask log_level_bit(LogLevel level)
+{
+    return static_cast<LogLevelMask>(1U << static_cast<unsigned>(level));
+}
+
+std::string_view log_level_name(LogLevel level);
+/** @brief Parses a level name case-insensitively; accepts the usual aliases such as warning, err and critical. */
+std::optional<LogLevel> parse_log_level(std::string_view text);
+/**
+ * @brief Parses "error,warn" or "warn+" into a level set; "+" adds every more severe level.
+ *
+ * Throws std::invalid_argument on an unknown level or an empty list.
+ */
+LogLevelMask parse_log_level_filter(std::string_view text);
+
+/** @brief A word that marks a line as having level. */
+struct LogLevelToken
+{
+    LogLevel level = LogLevel::Info;
+    std::string token;
+};
+
+/** @brief Parses "<level>=<token>" as given to --level-token; throws std::invalid_argument when it is malformed. */
+LogLevelToken parse_log_level_token(std::string_view text);
+
+/**
+ * @brief Finds the level of a line from the first level word near its start.
+ *
+ * Words are compared case-insensitively and only within the first detection_window_bytes, where timestamps and levels
+ * usually are, so message text rarely decides the level.
+ */
+class LogLevelDetector
+{
+public:
+    static constexpr std::size_t detection_window_bytes = 160;
+
+    /** @brief Starts with the common level words, including short forms such as WRN and ERR. */
+    LogLevelDetector();
+
+    void add_token(LogLevelToken token);
+    std::optional<LogLevel> detect(std::string_view line) const;
+
+private:
+    std::vector<LogLevelToken> _tokens;
+    std::size_t _longest_token = 0;
+};
+
+/**
+ * @brief One bitmap per level over the stored lines, so severity filters read words of 64 lines instead of the text.
+ *
+ * Bits are addressed by AllLineIndex; evicting the front drops whole words once no retained line uses them, which the
+ * deques do without moving the words that remain.
+ */
+class LevelBitmaps
+{
+public:
+    void clear(AllLineIndex first_index);
+    void append(std::optional<LogLevel> level);
+    void erase_before(AllLineIndex first_retained_index);
+
+    AllLineIndex end_index() const;
+    bool contains(LogLevelMask levels, AllLineIndex index) const;
+    std::size_t memory_bytes() const;
+
+    /** @brief Calls visit for every index from first_index on whose level is in levels, in order. */
+    template <typename Visitor>
+    void for_each(LogLevelMask levels, AllLineIndex first_index, Visitor&& visit) const
+    {
+        const std::int64_t start = std::max(first_index.value, _base) - _base;
+        for (std::size_t word_index = static_cast<std::size_t>(start / 64); word_index < _word_count; ++word_index)
+        {
+            std::uint64_t word = union_word(levels, word_index);
+            if (word_index == static_cast<std::size_t>(start / 64))
+            {
+                word &= ~std::uint64_t {0} << (start % 64);
+            }
+
+            while (word != 0)
+            {
+                const int bit = lowest_set_bit(word);
+                word &= word - 1;
+                const AllLineIndex index {_base + static_cast<std::int64_t>(word_index * 64) + bit};
+                if (index.value >= _end)
+                {
+                    return;
+                }
+
+                visit(index);
+            }
+        }
+    }
+
+private:
+    std::uint64_t union_word(LogLevelMask levels, std::size_t word_index) const;
+    static int lowest_set_bit(std::uint64_t word);
+
+    std::array<std::deque<std::uint64_t>, log_level_count> _words;
+    std::size_t _word_count = 0;
+    std::int64_t _base      = 0;
+    std::int64_t _end       = 0;
+};
+
+} // namespace slayerlog
@@ -0,0 +1,555 @@
+#include "log_line_store.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "block_codec.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+constexpr std::int64_t no_timestamp = std::numeric_limits<std::int64_t>::min();
+
+bool seek_spill_file(std::FILE* file, std::uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+} // namespace
+
+void LogLineStore::FileCloser::operator()(std::FILE* file) const
+{
+    std::fclose(file);
+}
+
+LogLineStore::LogLineStore(std::size_t chunk_line_capacity, std::size_t chunk_byte_capacity)
+    : _chunk_line_capacity(std::max<std::size_t>(1, chunk_line_capacity)), _chunk_byte_capacity(std::max<std::size_t>(1, chunk_byte_capacity))
+{
+}
+
+void LogLineStore::clear(AllLineIndex first_index)
+{
+    _chunks.clear();
+    _first_sequence = first_index.value;
+    _end_sequence   = first_index.value;
+    _sealed_bytes   = 0;
+    _source_labels.clear();
+    _closed_sources.clear();
+    _source_ids.clear();
+    _last_source_id = 0;
+
+    // The spill file stays open; its contents are simply overwritten from the start.
+    _cold_chunk_count = 0;
+    _spilled_bytes    = 0;
+    _spill_file_end   = 0;
+    _spill_free_extents.clear();
+    _cache.clear();
+    std::string().swap(_thaw_buffer);
+    std::string().swap(_spill_read_buffer);
+}
+
+LogLineStore LogLineStore::empty_copy(AllLineIndex first_index) const
+{
+    LogLineStore copy(_chunk_line_capacity, _chunk_byte_capacity);
+    copy.set_cold_storage(_cold_storage);
+    copy.clear(first_index);
+    return copy;
+}
+
+void LogLineStore::set_chunk_capacity(std::size_t chunk_line_capacity, std::size_t chunk_byte_capacity)
+{
+    _chunk_line_capacity = std::max<std::size_t>(1, chunk_line_capacity);
+    _chunk_byte_capacity = std::max<std::size_t>(1, chunk_byte_capacity);
+}
+
+void LogLineStore::set_cold_storage(ColdStorageOptions options)
+{
+    options.cache_chunk_count = std::max<std::size_t>(1, options.cache_chunk_count);
+    if (options.mode == ColdStorageMode::Spilled && !_spill_file)
+    {
+        _spill_file.reset(std::tmpfile());
+        if (!_spill_file)
+        {
+            throw std::runtime_error("Could not create a temporary file for spilled log lines");
+        }
+    }
+
+    _cold_storage = options;
+    if (_cache.size() > _cold_storage.cache_chunk_count)
+    {
+        _cache.clear();
+    }
+
+    freeze_cold_chunks();
+}
+
+ColdStorageOptions LogLineStore::cold_storage() const
+{
+    return _cold_storage;
+}
+
+std::uint32_t LogLineStore::append(std::string_view source_label, std::string_view text, std::optional<LogTimePoint> timestamp, std::uint64_t skipped_before)
+{
+    const std::uint32_t source_id = intern_source_label(source_label);
+    Chunk& chunk                  = writable_chunk(text.size());
+    chunk.bytes.append(text);
+    chunk.line_ends.push_back(static_cast<std::uint32_t>(chunk.bytes.size()));
+    chunk.source_ids.push_back(source_id);
+    chunk.timestamps.push_back(timestamp.has_value() ? static_cast<std::int64_t>(timestamp->time_since_epoch().count()) : no_timestamp);
+    if (skipped_before > 0 && chunk.skipped_lines.empty())
+    {
+        chunk.skipped_lines.resize(chunk.line_count);
+    }
+
+    if (skipped_before > 0 || !chunk.skipped_lines.empty())
+    {
+        chunk.skipped_lines.push_back(skipped_before);
+    }
+
+    ++chunk.line_count;
+    ++_end_sequence;
+    return source_id;
+}
+
+LogLineView LogLineStore::line(AllLineIndex index) const
+{
+    const Chunk& chunk        = resident_chunk(chunk_for(index));
+    const auto offset         = static_cast<std::size_t>(index.value - chunk.first_sequence);
+    const std::uint32_t begin = offset == 0 ? 0 : chunk.line_ends[offset - 1];
+    const std::uint32_t end   = chunk.line_ends[offset];
+    const std::int64_t ticks  = chunk.timestamps[offset];
+    return LogLineView {
+        _source_labels[chunk.source_ids[offset]],
+        std::string_view(chunk.bytes).substr(begin, end - begin),
+        chunk.source_ids[offset],
+        ticks == no_timestamp ? std::nullopt : std::optional<LogTimePoint>(LogTimePoint(LogTimePoint::duration(ticks))),
+        chunk.skipped_lines.empty() ? 0 : chunk.skipped_lines[offset],
+    };
+}
+
+AllLineIndex LogLineStore::first_index() const
+{
+    return AllLineIndex {_first_sequence};
+}
+
+AllLineIndex LogLineStore::end_index() const
+{
+    return AllLineIndex {_end_sequence};
+}
+
+std::size_t LogLineStore::size() const
+{
+    return static_cast<std::size_t>(_end_sequence - _first_sequence);
+}
+
+bool LogLineStore::empty() const
+{
+    return _end_sequence == _first_sequence;
+}
+
+bool LogLineStore::contains(AllLineIndex index) const
+{
+    return index.value >= _first_sequence && index.value < _end_sequence;
+}
+
+std::size_t LogLineStore::chunk_count() const
+{
+    return _chunks.size();
+}
+
+std::size_t LogLineStore::oldest_chunk_size() const
+{
+    return _chunks.empty() ? 0 : _chunks.front().line_count;
+}
+
+std::size_t LogLineStore::evict_oldest_chunk()
+{
+    if (_chunks.empty())
+    {
+        return 0;
+    }
+
+    const Chunk& oldest           = _chunks.front();
+    const std::size_t line_count  = oldest.line_count;
+    const bool oldest_is_writable = _chunks.size() == 1;
+    if (!oldest_is_writable)
+    {
+        _sealed_bytes -= chunk_memory_bytes(oldest);
+    }
+
+    if (oldest.cold)
+    {
+        --_cold_chunk_count;
+        if (oldest.spilled)
+        {
+            _spilled_bytes -= oldest.stored_size;
+            release_spill_extent(oldest.spill_offset, oldest.stored_size);
+        }
+    }
+
+    _first_sequence += static_cast<std::int64_t>(line_count);
+    _chunks.pop_front();
+    _cache.erase(std::remove_if(_cache.begin(), _cache.end(), [this](const CachedChunk& cached) { return cached.first_sequence < _first_sequence; }), _cache.end());
+    return line_count;
+}
+
+std::size_t LogLineStore::memory_bytes() const
+{
+    std::size_t bytes = _sealed_bytes + (_chunks.empty() ? 0 : chunk_memory_bytes(_chunks.back()));
+    for (const auto& cached : _cache)
+    {
+        bytes += chunk_memory_bytes(cached.lines);
+    }
+
+    // Empty scratch buffers only hold their small-string storage, which lives inside the store itself.
+    bytes += _thaw_buffer.empty() ? 0 : _thaw_buffer.capacity();
+    bytes += _spill_read_buffer.empty() ? 0 : _spill_read_buffer.capacity();
+    return bytes;
+}
+
+std::size_t LogLineStore::spilled_bytes() const
+{
+    return _spilled_bytes;
+}
+
+std::uint64_t LogLineStore::spill_file_bytes() const
+{
+    return _spill_file_end;
+}
+
+std::size_t LogLineStore::cold_chunk_count() const
+{
+    return _cold_chunk_count;
+}
+
+std::vector<std::uint32_t> LogLineStore::relabel_sources(const SourceRelabel& relabel)
+{
+    std::vector<std::uint32_t> closed_ids;
+    _source_ids.clear();
+    for (std::uint32_t source_id = 0; source_id < _source_labels.size(); ++source_id)
+    {
+        if (_closed_sources[source_id])
+        {
+            continue;
+        }
+
+        auto label = relabel(_source_labels[source_id]);
+        if (!label.has_value())
+        {
+            _closed_sources[source_id] = true;
+            closed_ids.push_back(source_id);
+            continue;
+        }
+
+        _source_labels[source_id] = std::move(*label);
+        _source_ids.emplace(_source_labels[source_id], source_id);
+    }
+
+    // The cached id may now belong to a closed source or carry another label.
+    _last_source_id = static_cast<std::uint32_t>(_source_labels.size());
+    return closed_ids;
+}
+
+bool LogLineStore::source_closed(std::uint32_t source_id) const
+{
+    return _closed_sources[source_id];
+}
+
+std::string_view LogLineStore::source_label(std::uint32_t source_id) const
+{
+    return _source_labels[source_id];
+}
+
+std::size_t LogLineStore::source_count() const
+{
+    return _source_labels.size();
+}
+
+std::uint32_t LogLineStore::intern_source_label(std::string_view source_label)
+{
+    // Batches are merged per source, so consecutive lines almost always share the previous label.
+    if (_last_source_id < _source_labels.size() && _source_labels[_last_source_id] == source_label)
+    {
+        return _last_source_id;
+    }
+
+    const std::string label(source_label);
+    const auto existing = _source_ids.find(label);
+    if (existing != _source_ids.end())
+    {
+        _last_source_id = existing->second;
+        return _last_source_id;
+    }
+
+    _last_source_id = static_cast<std::uint32_t>(_source_labels.size());
+    _source_labels.push_back(label);
+    _closed_sources.push_back(false);
+    _source_ids.emplace(label, _last_source_id);
+    return _last_source_id;
+}
+
+LogLineStore::Chunk& LogLineStore::writable_chunk(std::size_t incoming_bytes)
+{
+    if (incoming_bytes > UINT32_MAX)
+    {
+        throw std::length_error("Log line exceeds the maximum chunk size");
+    }
+
+    if (!_chunks.empty())
+    {
+        Chunk& back            = _chunks.back();
+        const bool lines_full  = back.line_ends.size() >= _chunk_line_capacity;
+        const bool bytes_full  = !back.line_ends.empty() && back.bytes.size() + incoming_bytes > _chunk_byte_capacity;
+        const bool offset_full = back.bytes.size() + incoming_bytes > UINT32_MAX;
+        if (!lines_full && !bytes_full && !offset_full)
+        {
+            return back;
+        }
+
+        // Sealed chunks never grow again, so trim the geometric slack once and account for them exactly.
+        back.bytes.shrink_to_fit();
+        back.line_ends.shrink_to_fit();
+        back.source_ids.shrink_to_fit();
+        back.timestamps.shrink_to_fit();
+        back.skipped_lines.shrink_to_fit();
+        _sealed_bytes += chunk_memory_bytes(back);
+    }
+
+    Chunk chunk;
+    chunk.first_sequence = _end_sequence;
+    chunk.line_ends.reserve(_chunk_line_capacity);
+    chunk.source_ids.reserve(_chunk_line_capacity);
+    chunk.timestamps.reserve(_chunk_line_capacity);
+    _chunks.push_back(std::move(chunk));
+    freeze_cold_chunks();
+    return _chunks.back();
+}
+
+const LogLineStore::Chunk& LogLineStore::chunk_for(AllLineIndex index) const
+{
+    if (!contains(index))
+    {
+        throw std::out_of_range("Log line " + std::to_string(index.value + 1) + " is not retained");
+    }
+
+    const auto next_chunk = std::upper_bound(_chunks.begin(), _chunks.end(), index.value, [](std::int64_t value, const Chunk& chunk) { return value < chunk.first_sequence; });
+    return *std::prev(next_chunk);
+}
+
+const LogLineStore::Chunk& LogLineStore::resident_chunk(const Chunk& chunk) const
+{
+    if (!chunk.cold)
+    {
+        return chunk;
+    }
+
+    ++_cache_clock;
+    for (auto& cached : _cache)
+    {
+        if (cached.first_sequence == chunk.first_sequence)
+        {
+            cached.last_used = _cache_clock;
+            return cached.lines;
+        }
+    }
+
+    if (_cache.size() < _cold_storage.cache_chunk_count)
+    {
+        _cache.emplace_back();
+    }
+
+    auto& slot = *std::min_element(_cache.begin(), _cache.end(), [](const CachedChunk& lhs, const CachedChunk& rhs) { return lhs.last_used < rhs.last_used; });
+    slot.first_sequence = -1;
+    thaw(chunk, slot.lines);
+    slot.first_sequence = chunk.first_sequence;
+    slot.last_used      = _cache_clock;
+    return slot.lines;
+}
+
+void LogLineStore::freeze_cold_chunks()
+{
+    if (_cold_storage.mode == ColdStorageMode::Off || _chunks.empty())
+    {
+        return;
+    }
+
+    // Chunks are frozen oldest first, so the cold ones always form a prefix of _chunks.
+    const std::size_t sealed_chunk_count = _chunks.size() - 1;
+    while (sealed_chunk_count > _cold_chunk_count + _cold_storage.hot_chunk_count)
+    {
+        freeze(_chunks[_cold_chunk_count]);
+        ++_cold_chunk_count;
+    }
+}
+
+void LogLineStore::freeze(Chunk& chunk)
+{
+    const std::size_t table_bytes     = chunk.line_count * sizeof(std::uint32_t);
+    const std::size_t timestamp_bytes = chunk.line_count * sizeof(std::uint64_t);
+    const std::size_t skipped_bytes   = chunk.skipped_lines.size() * sizeof(std::uint64_t);
+    std::string frozen(2 * table_bytes + timestamp_bytes + skipped_bytes + chunk.bytes.size(), '\0');
+    // Line lengths repeat far more often than absolute end offsets, so store those and rebuild the offsets on thaw.
+    std::vector<std::uint32_t> line_lengths(chunk.line_count);
+    std::adjacent_difference(chunk.line_ends.begin(), chunk.line_ends.end(), line_lengths.begin());
+    // Likewise the gaps between timestamps; unsigned arithmetic lets no_timestamp wrap around and back.
+    std::vector<std::uint64_t> timestamp_gaps(chunk.timestamps.begin(), chunk.timestamps.end());
+    std::adjacent_difference(timestamp_gaps.begin(), timestamp_gaps.end(), timestamp_gaps.begin());
+    std::memcpy(frozen.data(), line_lengths.data(), table_bytes);
+    std::memcpy(frozen.data() + table_bytes, chunk.source_ids.data(), table_bytes);
+    std::memcpy(frozen.data() + 2 * table_bytes, timestamp_gaps.data(), timestamp_bytes);
+    if (skipped_bytes > 0)
+    {
+        std::memcpy(frozen.data() + 2 * table_bytes + timestamp_bytes, chunk.skipped_lines.data(), skipped_bytes);
+    }
+
+    std::memcpy(frozen.data() + 2 * table_bytes + timestamp_bytes + skipped_bytes, chunk.bytes.data(), chunk.bytes.size());
+
+    std::string compressed        = compress_block(frozen);
+    const std::size_t stored_size = compressed.size();
+    std::uint64_t spill_offset    = 0;
+    if (_cold_storage.mode == ColdStorageMode::Spilled)
+    {
+        spill_offset = allocate_spill_extent(stored_size);
+        if (!seek_spill_file(_spill_file.get(), spill_offset) || std::fwrite(compressed.data(), 1, compressed.size(), _spill_file.get()) != compressed.size())
+        {
+            release_spill_extent(spill_offset, stored_size);
+            throw std::runtime_error("Failed to write log lines to the spill file");
+        }
+
+        _spilled_bytes += stored_size;
+        std::string().swap(compressed);
+    }
+
+    _sealed_bytes -= chunk_memory_bytes(chunk);
+    std::string().swap(chunk.bytes);
+    std::vector<std::uint32_t>().swap(chunk.line_ends);
+    std::vector<std::uint32_t>().swap(chunk.source_ids);
+    std::vector<std::int64_t>().swap(chunk.timestamps);
+    std::vector<std::uint64_t>().swap(chunk.skipped_lines);
+
+    chunk.cold         = true;
+    chunk.skips_lines  = skipped_bytes > 0;
+    chunk.frozen_size  = frozen.size();
+    chunk.stored_size  = stored_size;
+    chunk.spill_offset = spill_offset;
+    chunk.spilled      = _cold_storage.mode == ColdStorageMode::Spilled;
+    chunk.compressed   = std::move(compressed);
+    chunk.compressed.shrink_to_fit();
+    _sealed_bytes += chunk_memory_bytes(chunk);
+}
+
+void LogLineStore::thaw(const Chunk& chunk, Chunk& target) const
+{
+    std::string_view compressed = chunk.compressed;
+    if (chunk.spilled)
+    {
+        _spill_read_buffer.resize(chunk.stored_size);
+        if (!seek_spill_file(_spill_file.get(), chunk.spill_offset) || std::fread(_spill_read_buffer.data(), 1, chunk.stored_size, _spill_file.get()) != chunk.stored_size)
+        {
+            throw std::runtime_error("Failed to read log lines back from the spill file");
+        }
+
+        compressed = _spill_read_buffer;
+    }
+
+    decompress_block(compressed, chunk.frozen_size, _thaw_buffer);
+
+    const std::size_t table_bytes     = chunk.line_count * sizeof(std::uint32_t);
+    const std::size_t timestamp_bytes = chunk.line_count * sizeof(std::uint64_t);
+    const std::size_t skipped_bytes   = chunk.skips_lines ? chunk.line_count * sizeof(std::uint64_t) : 0;
+    target.first_sequence             = chunk.first_sequence;
+    target.line_count                 = chunk.line_count;
+    target.line_ends.resize(chunk.line_count);
+    target.source_ids.resize(chunk.line_count);
+    std::memcpy(target.line_ends.data(), _thaw_buffer.data(), table_bytes);
+    std::partial_sum(target.line_ends.begin(), target.line_ends.end(), target.line_ends.begin());
+    std::memcpy(target.source_ids.data(), _thaw_buffer.data() + table_bytes, table_bytes);
+    std::vector<std::uint64_t> timestamp_gaps(chunk.line_count);
+    std::memcpy(timestamp_gaps.data(), _thaw_buffer.data() + 2 * table_bytes, timestamp_bytes);
+    std::partial_sum(timestamp_gaps.begin(), timestamp_gaps.end(), timestamp_gaps.begin());
+    target.timestamps.assign(timestamp_gaps.begin(), timestamp_gaps.end());
+    target.skipped_lines.resize(skipped_bytes / sizeof(std::uint64_t));
+    if (skipped_bytes > 0)
+    {
+        std::memcpy(target.skipped_lines.data(), _thaw_buffer.data() + 2 * table_bytes + timestamp_bytes, skipped_bytes);
+    }
+
+    target.bytes.assign(_thaw_buffer, 2 * table_bytes + timestamp_bytes + skipped_bytes, std::string::npos);
+}
+
+std::uint64_t LogLineStore::allocate_spill_extent(std::size_t size)
+{
+    // Chunks are evicted oldest first, so freed space mostly gathers in one extent at the front that new chunks fill in turn.
+    for (auto extent = _spill_free_extents.begin(); extent != _spill_free_extents.end(); ++extent)
+    {
+        if (extent->second < size)
+        {
+            continue;
+        }
+
+        const std::uint64_t offset    = extent->first;
+        const std::uint64_t remaining = extent->second - size;
+        _spill_free_extents.erase(extent);
+        if (remaining > 0)
+        {
+            _spill_free_extents.emplace(offset + size, remaining);
+        }
+
+        return offset;
+    }
+
+    const std::uint64_t offset = _spill_file_end;
+    _spill_file_end += size;
+    return offset;
+}
+
+void LogLineStore::release_spill_extent(std::uint64_t offset, std::size_t size)
+{
+    std::uint64_t start = offset;
+    std::uint64_t end   = offset + size;
+    auto next           = _spill_free_extents.lower_bound(start);
+    if (next != _spill_free_extents.end() && next->first == end)
+    {
+        end += next->second;
+        next = _spill_free_extents.erase(next);
+    }
+
+    if (next != _spill_free_extents.begin())
+    {
+        const auto previous = std::prev(next);
+        if (previous->first + previous->second == start)
+        {
+            start = previous->first;
+            _spill_free_extents.erase(previous);
+        }
+    }
+
+    if (end == _spill_file_end)
+    {
+        _spill_file_end = start;
+        return;
+    }
+
+    _spill_free_extents.emplace(start, end - start);
+}
+
+std::size_t LogLineStore::chunk_memory_bytes(const Chunk& chunk)
+{
+    return sizeof(Chunk) + chunk.bytes.capacity() + chunk.compressed.capacity() + (chunk.line_ends.capacity() + chunk.source_ids.capacity()) * sizeof(std::uint32_t) +
+           chunk.timestamps.capacity() * sizeof(std::int64_t) + chunk.skipped_lines.capacity() * sizeof(std::uint64_t);
+}
+
+} // namespace slayerlog
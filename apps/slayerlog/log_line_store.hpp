@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "log_timestamp.hpp"
+
+namespace slayerlog
+{
+
+/** @brief Absolute sequence number of an observed line; stays stable when older lines are evicted. */
+struct AllLineIndex
+{
+    std::int64_t value = 0;
+};
+
+inline bool operator==(AllLineIndex lhs, AllLineIndex rhs)
+{
+    return lhs.value == rhs.value;
+}
+
+inline bool operator<(AllLineIndex lhs, AllLineIndex rhs)
+{
+    return lhs.value < rhs.value;
+}
+
+/** @brief Borrowed view of a stored line; invalidated by any modification of the store. */
+struct LogLineView
+{
+    std::string_view source_label;
+    std::string_view text;
+    std::uint32_t source_id = 0;
+    std::optional<LogTimePoint> timestamp;
+    /** @brief Source lines left out right before this one, such as lines a remote filter dropped. */
+    std::uint64_t skipped_before = 0;
+};
+
+/** @brief Maps a stored source label to its new label, or to nullopt when that source is closed. */
+using SourceRelabel = std::function<std::optional<std::string>(std::string_view source_label)>;
+
+/** @brief Where sealed chunks outside the hot tail are kept. */
+enum class ColdStorageMode
+{
+    Off,
+    Compressed,
+    Spilled,
+};
+
+struct ColdStorageOptions
+{
+    ColdStorageMode mode = ColdStorageMode::Off;
+    /** @brief Most recently sealed chunks left uncompressed, in addition to the chunk being written. */
+    std::size_t hot_chunk_count = 2;
+    /** @brief Decompressed cold chunks kept around for scrolling and rescans. */
+    std::size_t cache_chunk_count = 4;
+};
+
+/**
+ * @brief Append-only line storage split into chunks so the oldest lines can be dropped a chunk at a time.
+ *
+ * Each chunk keeps its text in one contiguous buffer with an end-offset table, interned source ids, the parsed
+ * timestamps and, once a line follows left out ones, the count left out before each line, which avoids a heap
+ * allocation per line and lets eviction release memory in large blocks.
+ * With cold storage enabled, older sealed chunks are compressed (and optionally written to a temp file)
+ * and decompressed on demand; views into such chunks stay valid until cache_chunk_count other cold chunks were read.
+ */
+class LogLineStore
+{
+public:
+    static constexpr std::size_t default_chunk_line_capacity = 4096;
+    static constexpr std::size_t default_chunk_byte_capacity = 1 << 20;
+
+    explicit LogLineStore(std::size_t chunk_line_capacity = default_chunk_line_capacity, std::size_t chunk_byte_capacity = default_chunk_byte_capacity);
+
+    /** @brief Drops every line and restarts numbering at first_index. */
+    void clear(AllLineIndex first_index = {});
+    /** @brief Returns an empty store with the same chunk sizes and cold storage settings, numbered from first_index. */
+    LogLineStore empty_copy(AllLineIndex first_index) const;
+    /** @brief Applies to chunks started after the call; existing chunks keep their size. */
+    void set_chunk_capacity(std::size_t chunk_line_capacity, std::size_t chunk_byte_capacity);
+    /** @brief Freezes already sealed chunks as needed; switching back to Off only stops freezing new ones. */
+    void set_cold_storage(ColdStorageOptions options);
+    ColdStorageOptions cold_storage() const;
+
+    /** @brief Stores the line with its already parsed timestamp and returns the id its source label is interned under. */
+    std::uint32_t append(std::string_view source_label, std::string_view text, std::optional<LogTimePoint> timestamp = std::nullopt, std::uint64_t skipped_before = 0);
+    LogLineView line(AllLineIndex index) const;
+
+    AllLineIndex first_index() const;
+    AllLineIndex end_index() const;
+    std::size_t size() const;
+    bool empty() const;
+    bool contains(AllLineIndex index) const;
+
+    std::size_t chunk_count() const;
+    /** @brief Returns the number of lines evict_oldest_chunk() would remove. */
+    std::size_t oldest_chunk_size() const;
+    /** @brief Removes the oldest chunk; returns the number of lines it held. */
+    std::size_t evict_oldest_chunk();
+    /** @brief Returns the resident heap footprint, including compressed chunks and the decompression cache. */
+    std::size_t memory_bytes() const;
+    /** @brief Returns the bytes of live chunks written to the spill file. */
+    std::size_t spilled_bytes() const;
+    /** @brief Returns how far the spill file is in use, including extents freed by eviction that wait for reuse. */
+    std::uint64_t spill_file_bytes() const;
+    std::size_t cold_chunk_count() const;
+
+    /**
+     * @brief Renames the open sources in place and closes those relabel maps to nullopt; returns the ids it closed.
+     *
+     * Stored lines keep their source id, so nothing is rewritten. A closed source keeps its label for the lines still
+     * stored, and appending under that label again starts a new source.
+     */
+    std::vector<std::uint32_t> relabel_sources(const SourceRelabel& relabel);
+    bool source_closed(std::uint32_t source_id) const;
+    std::string_view source_label(std::uint32_t source_id) const;
+    /** @brief Returns how many source ids were handed out, including closed ones. */
+    std::size_t source_count() const;
+
+private:
+    struct Chunk
+    {
+        std::int64_t first_sequence = 0;
+        std::size_t line_count      = 0;
+        std::string bytes;
+        std::vector<std::uint32_t> line_ends;
+        std::vector<std::uint32_t> source_ids;
+        // Ticks since the epoch, or no_timestamp.
+        std::vector<std::int64_t> timestamps;
+        // Lines left out before each line; stays empty until a line of the chunk follows left out ones.
+        std::vector<std::uint64_t> skipped_lines;
+
+        // Set once the chunk is frozen; the five containers above are then empty.
+        bool cold        = false;
+        bool skips_lines = false;
+        std::string compressed;
+        std::size_t frozen_size    = 0;
+        std::size_t stored_size    = 0;
+        std::uint64_t spill_offset = 0;
+        bool spilled               = false;
+    };
+
+    struct CachedChunk
+    {
+        std::int64_t first_sequence = -1;
+        std::uint64_t last_used     = 0;
+        Chunk lines;
+    };
+
+    struct FileCloser
+    {
+        void operator()(std::FILE* file) const;
+    };
+
+    std::uint32_t intern_source_label(std::string_view source_label);
+    Chunk& writable_chunk(std::size_t incoming_bytes);
+    const Chunk& chunk_for(AllLineIndex index) const;
+    const Chunk& resident_chunk(const Chunk& chunk) const;
+    void freeze_cold_chunks();
+    void freeze(Chunk& chunk);
+    void thaw(const Chunk& chunk, Chunk& target) const;
+    std::uint64_t allocate_spill_extent(std::size_t size);
+    void release_spill_extent(std::uint64_t offset, std::size_t size);
+    static std::size_t chunk_memory_bytes(const Chunk& chunk);
+
+    std::size_t _chunk_line_capacity;
+    std::size_t _chunk_byte_capacity;
+    std::deque<Chunk> _chunks;
+    std::int64_t _first_sequence = 0;
+    std::int64_t _end_sequence   = 0;
+    std::size_t _sealed_bytes    = 0;
+
+    ColdStorageOptions _cold_storage;
+    std::size_t _cold_chunk_count = 0;
+    std::size_t _spilled_bytes    = 0;
+    std::unique_ptr<std::FILE, FileCloser> _spill_file;
+    std::uint64_t _spill_file_end = 0;
+    // Extents of evicted chunks by offset, merged with their free neighbours, so later chunks reuse them instead of growing the file.
+    std::map<std::uint64_t, std::uint64_t> _spill_free_extents;
+    mutable std::vector<CachedChunk> _cache;
+    mutable std::uint64_t _cache_clock = 0;
+    mutable std::string _thaw_buffer;
+    mutable std::string _spill_read_buffer;
+
+    std::vector<std::string> _source_labels;
+    std::vector<bool> _closed_sources;
+    // Open sources only, so a closed label is never handed out again.
+    std::unordered_map<std::string, std::uint32_t> _source_ids;
+    std::uint32_t _last_source_id = 0;
+};
+
+} // namespace slayerlog
@@ -1,16 +1,20 @@
 #include "log_model.hpp"
+#include "debug_log.hpp"
 
 #include <algorithm>
+#include <array>
 #include <charconv>
 #include <cctype>
 #include <cstddef>
 #include <iterator>
+#include <limits>
 #include <regex>
-#include <sstream>
 #include <stdexcept>
 #include <system_error>
 #include <utility>
 
+#include "log_timestamp.hpp"
+
 namespace slayerlog
 {
 
@@ -52,6 +56,55 @@ std::optional<int> parse_non_negative_integer(std::string_view text)
     return value;
 }
 
+template <typename Integer>
+void append_decimal(std::string& output, Integer value)
+{
+    std::array<char, 24> digits {};
+    const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    output.append(digits.data(), result.ptr);
+}
+
+std::size_t decimal_width(std::uint64_t value)
+{
+    std::size_t width = 1;
+    while (value >= 10)
+    {
+        value /= 10;
+        ++width;
+    }
+
+    return width;
+}
+
+// Shown in place of the bytes of a line beyond the display limit.
+constexpr std::string_view truncation_marker_start = " [... ";
+constexpr std::string_view truncation_marker_end   = " more bytes]";
+
+std::size_t truncation_marker_width(std::size_t hidden_bytes)
+{
+    return truncation_marker_start.size() + decimal_width(hidden_bytes) + truncation_marker_end.size();
+}
+
+std::uint16_t label_display_width(std::string_view source_label)
+{
+    return static_cast<std::uint16_t>(std::min(text_display_width(source_label), static_cast<int>(std::numeric_limits<std::uint16_t>::max())));
+}
+
+// Widths are added up as int, so a single one never gets near its limit.
+std::uint32_t saturate_length(std::size_t length)
+{
+    return static_cast<std::uint32_t>(std::min<std::size_t>(length, std::numeric_limits<int>::max() / 2));
+}
+
+constexpr std::size_t max_text_column_bytes = 16 * 1024 * 1024;
+
+// Levels the timeline counts as errors.
+constexpr LogLevelMask error_levels = log_level_bit(LogLevel::Error) | log_level_bit(LogLevel::Fatal);
+
+// Chunks are sized relative to the retention limits so evicting one never drops more than a small fraction of them.
+constexpr std::size_t retention_chunk_divisor = 16;
+constexpr std::size_t minimum_chunk_bytes     = 4096;
+
 } // namespace
 
 std::optional<HiddenColumnRange> parse_hidden_column_range(std::string_view text)
@@ -75,14 +128,34 @@ std::optional<HiddenColumnRange> parse_hidden_column_range(std::string_view text
 
 void LogModel::reset()
 {
+    ++_store_generation;
     _all_entries.clear();
+    _line_numbers.clear();
     _visible_entry_indices.clear();
+    _visible_repeat_counts.clear();
     _paused_updates.clear();
+    _paused_dropped_line_count  = 0;
+    _evicted_visible_line_count = 0;
 
     _include_filters.clear();
     _exclude_filters.clear();
     _include_filter_patterns.clear();
     _exclude_filter_patterns.clear();
+    _structured_fields.clear_filters();
+    _structured_fields.clear_rows();
+    _level_filters.clear();
+    _level_filter_mask.reset();
+    _level_bitmaps.clear(_all_entries.first_index());
+    _line_rates.clear();
+    _collapse_repeats = false;
+    _template_miner.clear();
+    _line_templates.clear();
+    _expanded_templates.clear();
+    _line_lengths.clear();
+    _source_label_widths.clear();
+    _text_columns.clear();
+    _text_columns_bytes = 0;
+    _max_rendered_line_width.reset();
 
     _find_query.clear();
     _find_match_entry_indices.clear();
@@ -95,11 +168,29 @@ void LogModel::reset()
     _show_source_labels = false;
 }
 
-void LogModel::append_lines(const std::vector<ObservedLogLine>& lines)
+void LogModel::skip_line_numbers(std::uint64_t count)
 {
-    if (_updates_paused)
+    if (_all_entries.empty() && _paused_updates.empty())
     {
-        _paused_updates.insert(_paused_updates.end(), lines.begin(), lines.end());
+        ++_store_generation;
+        _all_entries.clear(AllLineIndex {_all_entries.first_index().value + static_cast<std::int64_t>(count)});
+        _level_bitmaps.clear(_all_entries.first_index());
+        _source_label_widths.clear();
+    }
+}
+
+void LogModel::append_lines(std::vector<ObservedLogLine> lines)
+{
+    // After a resume, new lines queue behind the held ones until drain_paused_updates() has caught up.
+    if (_updates_paused || !_paused_updates.empty())
+    {
+        for (const auto& line : lines)
+        {
+            // The timestamp is parsed now, as it would be for a line added right away, and kept next to the held line.
+            _paused_updates.append(line.source_label, line.text, line.timestamp_parsed ? line.timestamp : parse_log_timestamp(line.text), line.skipped_before);
+        }
+
+        enforce_paused_limits();
     }
     else
     {
@@ -107,12 +198,49 @@ void LogModel::append_lines(const std::vector<ObservedLogLine>& lines)
     }
 }
 
+void LogModel::update_sources(std::vector<ObservedLogLine> added_lines, const SourceRelabel& relabel)
+{
+    if (!_paused_updates.relabel_sources(relabel).empty())
+    {
+        _paused_updates = kept_lines(_paused_updates);
+    }
+
+    const bool sources_closed = !_all_entries.relabel_sources(relabel).empty();
+    measure_source_labels();
+    if (!sources_closed && (added_lines.empty() || _all_entries.empty()))
+    {
+        append_lines_immediately(added_lines);
+        return;
+    }
+
+    merge_into_store(std::move(added_lines));
+}
+
+void LogModel::merge_refetched_lines(std::string_view source_label, std::uint64_t replaced_line_count, std::vector<ObservedLogLine> lines)
+{
+    // Held lines are newer than the stored ones, so the replaced lines are looked for there first.
+    if (const auto held = newest_source_lines(_paused_updates, source_label, replaced_line_count))
+    {
+        _paused_updates = kept_lines(_paused_updates, held);
+    }
+
+    const auto replaced = newest_source_lines(_all_entries, source_label, replaced_line_count);
+    if (!replaced.has_value() && (lines.empty() || _all_entries.empty()))
+    {
+        append_lines_immediately(lines);
+        return;
+    }
+
+    merge_into_store(std::move(lines), replaced);
+}
+
 void LogModel::toggle_pause()
 {
     _updates_paused = !_updates_paused;
     if (!_updates_paused)
     {
-        flush_paused_updates();
+        // Only the first chunk is added here; the watcher thread drains the rest in slices.
+        drain_paused_updates(std::chrono::nanoseconds::zero());
     }
 }
 
@@ -121,9 +249,49 @@ bool LogModel::updates_paused() const
     return _updates_paused;
 }
 
+bool LogModel::resume_pending() const
+{
+    return !_updates_paused && !_paused_updates.empty();
+}
+
+bool LogModel::drain_paused_updates(std::chrono::nanoseconds budget)
+{
+    if (_updates_paused || _paused_updates.empty())
+    {
+        return false;
+    }
+
+    const auto deadline                      = std::chrono::steady_clock::now() + budget;
+    const AllLineIndex first_new_entry_index = _all_entries.end_index();
+    do
+    {
+        const AllLineIndex first_index {_paused_updates.first_index()};
+        const AllLineIndex end_index {first_index.value + static_cast<std::int64_t>(_paused_updates.oldest_chunk_size())};
+        for (AllLineIndex index = first_index; index < end_index; ++index.value)
+        {
+            const auto line = _paused_updates.line(index);
+            store_line(line.source_label, line.text, line.timestamp, line.skipped_before);
+        }
+
+        _paused_updates.evict_oldest_chunk();
+    } while (!_paused_updates.empty() && std::chrono::steady_clock::now() < deadline);
+
+    if (_paused_updates.empty())
+    {
+        // A long pause may have switched the held lines to the spill file; the next pause starts out like the stored lines again.
+        _paused_updates.set_cold_storage(_all_entries.cold_storage());
+    }
+
+    expand_visible_entries(first_new_entry_index);
+    expand_find_matches(first_new_entry_index);
+    enforce_retention_limits();
+    return true;
+}
+
 void LogModel::set_show_source_labels(bool show_source_labels)
 {
     _show_source_labels = show_source_labels;
+    _max_rendered_line_width.reset();
 }
 
 void LogModel::add_include_filter(std::string filter_text)
@@ -158,12 +326,120 @@ void LogModel::add_exclude_filter(std::string filter_text)
     rebuild_find_matches();
 }
 
+void LogModel::add_field_filter(std::string filter_text)
+{
+    if (_structured_fields.add_filter(parse_field_filter(filter_text)))
+    {
+        rebuild_structured_fields();
+    }
+
+    rebuild_visible_entries();
+    rebuild_find_matches();
+}
+
+void LogModel::set_structured_fields(const std::vector<std::string>& field_names)
+{
+    if (_structured_fields.add_fields(field_names))
+    {
+        rebuild_structured_fields();
+    }
+}
+
+void LogModel::add_level_filter(std::string filter_text)
+{
+    const LogLevelMask levels = parse_log_level_filter(filter_text);
+    _level_filter_mask        = _level_filter_mask.value_or(static_cast<LogLevelMask>(~LogLevelMask {0})) & levels;
+    _level_filters.push_back(trim_filter_text(filter_text));
+    rebuild_visible_entries();
+    rebuild_find_matches();
+}
+
+void LogModel::set_level_tokens(const std::vector<LogLevelToken>& tokens)
+{
+    _level_detector = LogLevelDetector();
+    for (const auto& token : tokens)
+    {
+        _level_detector.add_token(token);
+    }
+
+    rebuild_level_bitmaps();
+    // Timestamps do not depend on the level words, so only the error counts of the timeline are redone.
+    const AllLineIndex first_index = _all_entries.first_index();
+    const auto counted_error       = [this, first_index](AllLineIndex entry_index) { return !(entry_index < first_index) && _level_bitmaps.contains(error_levels, entry_index); };
+    _line_rates.recount_errors(counted_error);
+    if (_level_filter_mask.has_value())
+    {
+        rebuild_visible_entries();
+        rebuild_find_matches();
+    }
+}
+
+void LogModel::set_collapse_repeats(bool collapse_repeats)
+{
+    if (collapse_repeats == _collapse_repeats)
+    {
+        return;
+    }
+
+    _collapse_repeats = collapse_repeats;
+    _expanded_templates.clear();
+    if (!_collapse_repeats)
+    {
+        // Template ids only mean something to the miner that handed them out, so it starts over when enabled again.
+        _template_miner.clear();
+    }
+
+    rebuild_line_templates();
+    rebuild_visible_entries();
+}
+
+bool LogModel::collapse_repeats() const
+{
+    return _collapse_repeats;
+}
+
+bool LogModel::toggle_repeat_expansion(std::int64_t line_number)
+{
+    const auto visible_line_index = visible_line_index_for_line_number(line_number);
+    if (!_collapse_repeats || !visible_line_index.has_value())
+    {
+        return false;
+    }
+
+    const TemplateId id = line_template(_visible_entry_indices[*visible_line_index]);
+    if (_expanded_templates.erase(id) == 0)
+    {
+        _expanded_templates.insert(id);
+    }
+
+    rebuild_visible_entries();
+    return true;
+}
+
+std::uint32_t LogModel::repeat_count(VisibleLineIndex visible_line_index) const
+{
+    if (!_collapse_repeats || visible_line_index.value < 0 || visible_line_index.value >= static_cast<int>(_visible_repeat_counts.size()))
+    {
+        return 1;
+    }
+
+    return _visible_repeat_counts[visible_line_index];
+}
+
+std::size_t LogModel::template_count() const
+{
+    return _template_miner.template_count();
+}
+
 void LogModel::reset_filters()
 {
     _include_filters.clear();
     _exclude_filters.clear();
     _include_filter_patterns.clear();
     _exclude_filter_patterns.clear();
+    _structured_fields.clear_filters();
+    _level_filters.clear();
+    _level_filter_mask.reset();
     rebuild_visible_entries();
     rebuild_find_matches();
 }
@@ -178,14 +454,24 @@ const std::vector<std::string>& LogModel::exclude_filters() const
     return _exclude_filters;
 }
 
-void LogModel::hide_before_line_number(int line_number)
+const std::vector<std::string>& LogModel::field_filters() const
+{
+    return _structured_fields.filter_texts();
+}
+
+const std::vector<std::string>& LogModel::level_filters() const
 {
-    _hidden_before_line_number = line_number > 1 ? std::optional<int>(line_number) : std::nullopt;
+    return _level_filters;
+}
+
+void LogModel::hide_before_line_number(std::int64_t line_number)
+{
+    _hidden_before_line_number = line_number > 1 ? std::optional<std::int64_t>(line_number) : std::nullopt;
     rebuild_visible_entries();
     rebuild_find_matches();
 }
 
-std::optional<int> LogModel::hidden_before_line_number() const
+std::optional<std::int64_t> LogModel::hidden_before_line_number() const
 {
     return _hidden_before_line_number;
 }
@@ -195,15 +481,18 @@ void LogModel::hide_columns(int start_column, int end_column)
     if (start_column < 0 || end_column <= start_column)
     {
         _hidden_columns.reset();
+        _max_rendered_line_width.reset();
         return;
     }
 
     _hidden_columns = HiddenColumnRange {start_column, end_column};
+    _max_rendered_line_width.reset();
 }
 
 void LogModel::reset_hidden_columns()
 {
     _hidden_columns.reset();
+    _max_rendered_line_width.reset();
 }
 
 std::optional<HiddenColumnRange> LogModel::hidden_columns() const
@@ -267,8 +556,8 @@ std::optional<AllLineIndex> LogModel::find_match_entry_index(FindResultIndex fin
 
 std::optional<FindResultIndex> LogModel::find_match_position_for_entry_index(AllLineIndex entry_index) const
 {
-    const auto position = std::find(_find_match_entry_indices.begin(), _find_match_entry_indices.end(), entry_index);
-    if (position == _find_match_entry_indices.end())
+    const auto position = std::lower_bound(_find_match_entry_indices.begin(), _find_match_entry_indices.end(), entry_index);
+    if (position == _find_match_entry_indices.end() || !(*position == entry_index))
     {
         return std::nullopt;
     }
@@ -278,33 +567,46 @@ std::optional<FindResultIndex> LogModel::find_match_position_for_entry_index(All
 
 std::optional<VisibleLineIndex> LogModel::visible_line_index_for_entry(AllLineIndex entry_index) const
 {
-    const auto visible_line = std::find(_visible_entry_indices.begin(), _visible_entry_indices.end(), entry_index);
-    if (visible_line == _visible_entry_indices.end())
+    const auto visible_line = std::lower_bound(_visible_entry_indices.begin(), _visible_entry_indices.end(), entry_index);
+    const auto position     = static_cast<int>(std::distance(_visible_entry_indices.begin(), visible_line));
+    if (visible_line != _visible_entry_indices.end() && *visible_line == entry_index)
+    {
+        return VisibleLineIndex {position};
+    }
+
+    // Every visible line after a row and before the next one was folded into that row.
+    if (!_collapse_repeats || position == 0 || repeat_count(VisibleLineIndex {position - 1}) == 1 || !(entry_index < _all_entries.end_index()) || !entry_matches_filters(entry_index))
     {
         return std::nullopt;
     }
 
-    return VisibleLineIndex {static_cast<int>(std::distance(_visible_entry_indices.begin(), visible_line))};
+    return VisibleLineIndex {position - 1};
 }
 
-std::optional<int> LogModel::line_number_for_visible_line(VisibleLineIndex visible_line_index) const
+std::optional<std::int64_t> LogModel::line_number_for_visible_line(VisibleLineIndex visible_line_index) const
 {
     if (visible_line_index.value < 0 || visible_line_index.value >= static_cast<int>(_visible_entry_indices.size()))
     {
         return std::nullopt;
     }
 
-    return _visible_entry_indices[visible_line_index].value + 1;
+    return _line_numbers.line_number(_visible_entry_indices[visible_line_index]);
 }
 
-std::optional<VisibleLineIndex> LogModel::visible_line_index_for_line_number(int line_number) const
+std::optional<VisibleLineIndex> LogModel::visible_line_index_for_line_number(std::int64_t line_number) const
 {
-    if (line_number <= 0)
+    if (!line_number_stored(line_number))
     {
         return std::nullopt;
     }
 
-    return visible_line_index_for_entry(AllLineIndex {line_number - 1});
+    return visible_line_index_for_entry(_line_numbers.first_index_at_or_after(line_number));
+}
+
+bool LogModel::line_number_stored(std::int64_t line_number) const
+{
+    const AllLineIndex entry_index = _line_numbers.first_index_at_or_after(line_number);
+    return _all_entries.contains(entry_index) && _line_numbers.line_number(entry_index) == line_number;
 }
 
 bool LogModel::visible_line_matches_find(int visible_index) const
@@ -321,7 +623,7 @@ bool LogModel::visible_line_matches_find(int visible_index) const
 
 bool LogModel::entry_index_is_visible(AllLineIndex entry_index) const
 {
-    return std::binary_search(_visible_entry_indices.begin(), _visible_entry_indices.end(), entry_index);
+    return visible_line_index_for_entry(entry_index).has_value();
 }
 
 int LogModel::line_count() const
@@ -334,14 +636,29 @@ int LogModel::total_line_count() const
     return static_cast<int>(_all_entries.size());
 }
 
+std::int64_t LogModel::first_line_number() const
+{
+    return _line_numbers.line_number(_all_entries.first_index());
+}
+
+std::int64_t LogModel::last_line_number() const
+{
+    return _line_numbers.line_number(AllLineIndex {_all_entries.end_index().value - 1});
+}
+
 std::string LogModel::rendered_line(int index) const
 {
-    const VisibleLineIndex visible_line_index {index};
-    const AllLineIndex entry_index = _visible_entry_indices[visible_line_index];
-    return render_entry(entry_index);
+    std::string line;
+    append_rendered_window(VisibleLineIndex {index}, 0, std::numeric_limits<int>::max(), line);
+    return line;
 }
 
 std::vector<std::string> LogModel::rendered_lines(int first_index, int count) const
+{
+    return rendered_lines(first_index, count, 0, std::numeric_limits<int>::max());
+}
+
+std::vector<std::string> LogModel::rendered_lines(int first_index, int count, int first_col, int col_count) const
 {
     if (count <= 0)
     {
@@ -355,221 +672,984 @@ std::vector<std::string> LogModel::rendered_lines(int first_index, int count) co
     }
 
     const int last_index = std::min(static_cast<int>(_visible_entry_indices.size()), clamped_first + count);
-    std::vector<std::string> lines;
-    lines.reserve(static_cast<std::size_t>(last_index - clamped_first));
+    std::vector<std::string> lines(static_cast<std::size_t>(last_index - clamped_first));
     for (int index = clamped_first; index < last_index; ++index)
     {
-        const VisibleLineIndex visible_line_index {index};
-        lines.push_back(render_entry(_visible_entry_indices[visible_line_index]));
+        append_rendered_window(VisibleLineIndex {index}, std::max(0, first_col), std::max(0, col_count), lines[static_cast<std::size_t>(index - clamped_first)]);
     }
 
     return lines;
 }
 
-int LogModel::max_rendered_line_width() const
+int LogModel::rendered_line_width(int index) const
 {
-    int width = 0;
-    for (const auto entry_index : _visible_entry_indices)
-    {
-        width = std::max(width, static_cast<int>(render_entry(entry_index).size()));
-    }
-
-    return width;
+    const int width = unhidden_line_width(VisibleLineIndex {index});
+    return width - hidden_span(width).second;
 }
 
-std::string LogModel::render_entry(AllLineIndex entry_index) const
+int LogModel::max_rendered_line_width() const
 {
-    std::ostringstream output;
-    const auto& entry = _all_entries[entry_index];
-    output << entry_index.value + 1 << " ";
-    if (_show_source_labels)
+    const int count = line_count();
+    if (!_max_rendered_line_width.has_value() || _max_width_line_count > count)
     {
-        output << "[" << entry.source_label << "] ";
+        _max_rendered_line_width = 0;
+        _max_width_line_count    = 0;
     }
 
-    output << entry.text;
-    return apply_hidden_columns(output.str());
-}
-
-void LogModel::append_lines_immediately(const std::vector<ObservedLogLine>& lines)
-{
-    const AllLineIndex first_new_entry_index {static_cast<int>(_all_entries.size())};
-
-    for (const auto& line : lines)
+    // The last row measured may have gained repeats since, so it is measured again.
+    for (int index = std::max(0, _max_width_line_count - 1); index < count; ++index)
     {
-        _all_entries.push_back(line);
+        _max_rendered_line_width = std::max(*_max_rendered_line_width, rendered_line_width(index));
     }
 
-    expand_visible_entries(first_new_entry_index);
-    expand_find_matches(first_new_entry_index);
-}
-
-void LogModel::flush_paused_updates()
-{
-    append_lines_immediately(_paused_updates);
-    _paused_updates.clear();
+    _max_width_line_count = count;
+    return *_max_rendered_line_width;
 }
 
-void LogModel::rebuild_visible_entries()
+std::vector<AllLineIndex> LogModel::export_entry_indices(bool find_matches_only) const
 {
-    _visible_entry_indices.clear();
-    _visible_entry_indices.reserve(_all_entries.size());
-    std::size_t index = 0;
-    if (_hidden_before_line_number.has_value())
+    std::vector<AllLineIndex> entries;
+    if (find_matches_only)
     {
-        index = static_cast<std::size_t>(std::max(0, *_hidden_before_line_number - 1));
+        std::copy_if(_find_match_entry_indices.begin(), _find_match_entry_indices.end(), std::back_inserter(entries), [this](AllLineIndex entry_index) { return entry_index_is_visible(entry_index); });
+        return entries;
     }
-    for (; index < _all_entries.size(); ++index)
+
+    entries.reserve(_visible_entry_indices.size());
+    for (int index = 0; index < line_count(); ++index)
     {
-        const AllLineIndex entry_index {static_cast<int>(index)};
-        if (entry_matches_filters(_all_entries[entry_index]))
+        const VisibleLineIndex visible_line_index {index};
+        AllLineIndex entry_index = _visible_entry_indices[visible_line_index];
+        entries.push_back(entry_index);
+        for (std::uint32_t folded = 1; folded < repeat_count(visible_line_index); ++folded)
         {
-            _visible_entry_indices.push_back(entry_index);
+            do
+            {
+                ++entry_index.value;
+            } while (!entry_matches_filters(entry_index));
+
+            entries.push_back(entry_index);
         }
     }
+
+    return entries;
 }
 
-void LogModel::expand_visible_entries(AllLineIndex first_new_entry_index)
+bool LogModel::append_export_line(AllLineIndex entry_index, std::string& output) const
 {
-    int index = first_new_entry_index.value;
-    if (_hidden_before_line_number.has_value())
+    if (entry_index < _all_entries.first_index() || !(entry_index < _all_entries.end_index()))
     {
-        index = std::max(index, std::max(0, *_hidden_before_line_number - 1));
+        return false;
     }
 
-    for (; index < static_cast<int>(_all_entries.size()); ++index)
+    const auto entry = _all_entries.line(entry_index);
+    if (_show_source_labels)
     {
-        const AllLineIndex entry_index {index};
-        if (entry_matches_filters(_all_entries[entry_index]))
-        {
-            _visible_entry_indices.push_back(entry_index);
-        }
+        output.push_back('[');
+        output.append(entry.source_label);
+        output.append("] ");
     }
+
+    output.append(entry.text);
+    output.push_back('\n');
+    return true;
 }
 
-void LogModel::rebuild_find_matches()
+std::uint64_t LogModel::paused_dropped_line_count() const
 {
-    _find_match_entry_indices.clear();
-    if (_find_query.empty())
-    {
-        return;
-    }
+    return _paused_dropped_line_count;
+}
 
-    _find_match_entry_indices.reserve(_all_entries.size());
-    for (std::size_t index = 0; index < _all_entries.size(); ++index)
-    {
-        const AllLineIndex entry_index {static_cast<int>(index)};
-        if (entry_matches_find_query(_all_entries[entry_index]))
-        {
-            _find_match_entry_indices.push_back(entry_index);
-        }
-    }
+std::uint64_t LogModel::store_generation() const
+{
+    return _store_generation;
 }
 
-void LogModel::expand_find_matches(AllLineIndex first_new_entry_index)
+const LineRateHistogram& LogModel::line_rates() const
 {
-    if (_find_query.empty())
-    {
-        return;
-    }
+    return _line_rates;
+}
 
-    for (int index = first_new_entry_index.value; index < static_cast<int>(_all_entries.size()); ++index)
+std::optional<VisibleLineIndex> LogModel::first_visible_line_at_or_after(AllLineIndex entry_index) const
+{
+    const auto visible = std::lower_bound(_visible_entry_indices.begin(), _visible_entry_indices.end(), entry_index);
+    if (visible == _visible_entry_indices.end())
     {
-        const AllLineIndex entry_index {index};
-        if (entry_matches_find_query(_all_entries[entry_index]))
-        {
-            _find_match_entry_indices.push_back(entry_index);
-        }
+        return std::nullopt;
     }
+
+    return VisibleLineIndex {static_cast<int>(std::distance(_visible_entry_indices.begin(), visible))};
 }
 
-bool LogModel::entry_matches_find_query(const ObservedLogLine& entry) const
+void LogModel::set_performance_monitor(PerformanceMonitor* performance_monitor)
 {
-    return _find_pattern.has_value() && matches_pattern(entry.text, *_find_pattern);
+    _performance_monitor = performance_monitor;
 }
 
-bool LogModel::entry_matches_filters(const ObservedLogLine& entry) const
+LogModelMemoryUsage LogModel::memory_usage() const
 {
-    const std::string searchable_text = entry.source_label + "\n" + entry.text;
-    const bool matches_include        = _include_filter_patterns.empty() || matches_any_pattern(searchable_text, _include_filter_patterns);
-    const bool matches_exclude        = matches_any_pattern(searchable_text, _exclude_filter_patterns);
-    return matches_include && !matches_exclude;
+    LogModelMemoryUsage usage;
+    usage.entry_count                = _all_entries.size();
+    usage.entry_bytes                = _all_entries.memory_bytes() + _line_lengths.size() * sizeof(LineLengths) + _line_numbers.memory_bytes();
+    usage.visible_index_bytes        = _visible_entry_indices.capacity() * sizeof(AllLineIndex);
+    usage.find_index_bytes           = _find_match_entry_indices.capacity() * sizeof(AllLineIndex);
+    usage.field_column_bytes         = _structured_fields.memory_bytes();
+    usage.level_index_bytes          = _level_bitmaps.memory_bytes();
+    usage.timeline_bytes             = _line_rates.memory_bytes();
+    usage.template_bytes             = _template_miner.memory_bytes() + _line_templates.size() * sizeof(TemplateId) + _visible_repeat_counts.capacity() * sizeof(std::uint32_t);
+    usage.paused_entry_count         = _paused_updates.size();
+    usage.paused_bytes               = _paused_updates.memory_bytes();
+    usage.paused_dropped_entry_count = _paused_dropped_line_count;
+    usage.evicted_entry_count        = _all_entries.first_index().value;
+    usage.spilled_bytes              = _all_entries.spilled_bytes() + _paused_updates.spilled_bytes();
+    return usage;
 }
 
-LogModel::SearchPattern LogModel::compile_search_pattern(std::string_view text)
+void LogModel::set_retention_limits(LogRetentionLimits limits)
 {
-    const std::string trimmed_text = trim_filter_text(text);
-    if (trimmed_text.empty())
-    {
-        throw std::invalid_argument("Search text must not be empty");
-    }
+    _retention_limits = limits;
 
-    constexpr std::string_view regex_prefix {"re:"};
-    if (trimmed_text.rfind(regex_prefix.data(), 0) != 0)
+    std::size_t chunk_line_capacity = LogLineStore::default_chunk_line_capacity;
+    std::size_t chunk_byte_capacity = LogLineStore::default_chunk_byte_capacity;
+    if (limits.max_lines > 0)
     {
-        return SearchPattern {
-            trimmed_text,
-            trimmed_text,
-            std::nullopt,
-        };
+        chunk_line_capacity = std::clamp<std::size_t>(limits.max_lines / retention_chunk_divisor, 1, chunk_line_capacity);
     }
 
-    std::string regex_text = trimmed_text.substr(regex_prefix.size());
-    if (regex_text.empty())
+    if (limits.max_memory_bytes > 0)
     {
-        throw std::invalid_argument("Regex pattern after re: must not be empty");
+        chunk_byte_capacity = std::clamp<std::size_t>(limits.max_memory_bytes / retention_chunk_divisor, minimum_chunk_bytes, chunk_byte_capacity);
     }
 
-    try
-    {
-        return SearchPattern {
-            trimmed_text,
-            regex_text,
-            std::regex(regex_text),
-        };
-    }
-    catch (const std::regex_error& error)
-    {
-        throw std::invalid_argument("Invalid regex: " + std::string(error.what()));
-    }
-}
+    _all_entries.set_chunk_capacity(chunk_line_capacity, chunk_byte_capacity);
+    enforce_retention_limits();
 
-bool LogModel::matches_pattern(std::string_view haystack, const SearchPattern& pattern) const
-{
-    if (!pattern.regex.has_value())
+    if (limits.max_paused_memory_bytes > 0)
     {
-        return haystack.find(pattern.needle) != std::string_view::npos;
+        chunk_byte_capacity = std::clamp<std::size_t>(limits.max_paused_memory_bytes / retention_chunk_divisor, minimum_chunk_bytes, chunk_byte_capacity);
     }
 
-    return std::regex_search(haystack.begin(), haystack.end(), *pattern.regex);
+    _paused_updates.set_chunk_capacity(chunk_line_capacity, chunk_byte_capacity);
+    enforce_paused_limits();
 }
 
-bool LogModel::matches_any_pattern(std::string_view haystack, const std::vector<SearchPattern>& patterns) const
+LogRetentionLimits LogModel::retention_limits() const
 {
-    return std::any_of(patterns.begin(), patterns.end(), [&](const SearchPattern& pattern) { return matches_pattern(haystack, pattern); });
+    return _retention_limits;
 }
 
-std::string LogModel::trim_filter_text(std::string_view text)
+void LogModel::set_cold_storage(ColdStorageOptions options)
 {
-    return trim_text(text);
+    _all_entries.set_cold_storage(options);
+    _paused_updates.set_cold_storage(options);
+    enforce_retention_limits();
 }
 
-std::string LogModel::apply_hidden_columns(std::string text) const
+std::uint64_t LogModel::evicted_visible_line_count() const
+{
+    return _evicted_visible_line_count;
+}
+
+void LogModel::set_long_line_limits(LongLineLimits limits)
+{
+    const bool display_limit_changed = limits.max_display_bytes != _long_line_limits.max_display_bytes;
+    const bool search_prefix_changed = limits.search_prefix_bytes != _long_line_limits.search_prefix_bytes;
+    _long_line_limits                = limits;
+    _max_rendered_line_width.reset();
+    if (display_limit_changed)
+    {
+        rebuild_line_lengths();
+    }
+
+    if (search_prefix_changed)
+    {
+        rebuild_visible_entries();
+        rebuild_find_matches();
+    }
+}
+
+LongLineLimits LogModel::long_line_limits() const
+{
+    return _long_line_limits;
+}
+
+void LogModel::append_rendered_line(int index, std::string& output) const
+{
+    const VisibleLineIndex visible_line_index {index};
+    append_rendered_entry(_visible_entry_indices[visible_line_index], repeat_count(visible_line_index), output);
+}
+
+void LogModel::append_rendered_entry(AllLineIndex entry_index, std::uint32_t repeats, std::string& output) const
+{
+    const std::size_t line_start = output.size();
+    const auto entry             = _all_entries.line(entry_index);
+    append_line_prefix(entry_index, repeats, entry.source_label, output);
+    output.append(entry.text);
+    erase_hidden_columns(output, line_start);
+}
+
+void LogModel::append_line_prefix(AllLineIndex entry_index, std::uint32_t repeats, std::string_view source_label, std::string& output) const
+{
+    append_decimal(output, _line_numbers.line_number(entry_index));
+    output.push_back(' ');
+    if (repeats > 1)
+    {
+        output.push_back('(');
+        append_decimal(output, repeats);
+        output.append("x) ");
+    }
+
+    if (_show_source_labels)
+    {
+        output.push_back('[');
+        output.append(source_label);
+        output.append("] ");
+    }
+}
+
+void LogModel::append_rendered_window(VisibleLineIndex visible_line_index, int first_col, int col_count, std::string& output) const
+{
+    const AllLineIndex entry_index = _visible_entry_indices[visible_line_index];
+    const auto entry               = _all_entries.line(entry_index);
+    const auto& lengths            = line_lengths(entry_index);
+
+    std::string prefix;
+    append_line_prefix(entry_index, repeat_count(visible_line_index), entry.source_label, prefix);
+    const std::string_view text = shown_text(entry.text);
+    std::string marker;
+    if (lengths.hidden_bytes > 0)
+    {
+        marker.append(truncation_marker_start);
+        append_decimal(marker, lengths.hidden_bytes);
+        marker.append(truncation_marker_end);
+    }
+
+    // Only the text of a line outside printable ASCII needs its column index; the prefix is short enough to measure here.
+    const TextColumnIndex prefix_columns(prefix);
+    const TextColumnIndex plain_text_columns = TextColumnIndex::plain(text.size());
+    const TextColumnIndex& text_columns      = lengths.plain_text ? plain_text_columns : cached_text_columns(entry_index, text);
+    const TextColumnIndex marker_columns     = TextColumnIndex::plain(marker.size());
+    const std::array<std::pair<std::string_view, const TextColumnIndex*>, 3> pieces {{
+        {prefix, &prefix_columns},
+        {text, &text_columns},
+        {marker, &marker_columns},
+    }};
+    const auto append_range = [&](int from, int to)
+    {
+        int piece_start = 0;
+        for (const auto& [piece, columns] : pieces)
+        {
+            columns->append_columns(piece, from - piece_start, to - piece_start, output);
+            piece_start += columns->width();
+        }
+    };
+
+    // Displayed columns at or after the hidden range come from that many columns further right in the unhidden line.
+    const int line_width                    = prefix_columns.width() + text_columns.width() + marker_columns.width();
+    const auto [hidden_start, hidden_width] = hidden_span(line_width);
+    const int last_col                      = first_col + std::min(col_count, line_width);
+    if (first_col < hidden_start)
+    {
+        append_range(first_col, std::min(last_col, hidden_start));
+    }
+
+    if (last_col > hidden_start)
+    {
+        append_range(std::max(first_col, hidden_start) + hidden_width, last_col + hidden_width);
+    }
+}
+
+int LogModel::unhidden_line_width(VisibleLineIndex visible_line_index) const
+{
+    const AllLineIndex entry_index = _visible_entry_indices[visible_line_index];
+    const auto& lengths            = line_lengths(entry_index);
+    const std::uint32_t repeats    = repeat_count(visible_line_index);
+    std::size_t width              = decimal_width(static_cast<std::uint64_t>(_line_numbers.line_number(entry_index))) + 1 + lengths.text_width;
+    if (lengths.hidden_bytes > 0)
+    {
+        width += truncation_marker_width(lengths.hidden_bytes);
+    }
+
+    if (repeats > 1)
+    {
+        width += decimal_width(repeats) + 4;
+    }
+
+    if (_show_source_labels)
+    {
+        width += _source_label_widths[lengths.source_id] + 3U;
+    }
+
+    return static_cast<int>(width);
+}
+
+std::pair<int, int> LogModel::hidden_span(int line_width) const
 {
     if (!_hidden_columns.has_value())
     {
-        return text;
+        return {line_width, 0};
     }
 
-    const int clamped_start = std::clamp(_hidden_columns->start, 0, static_cast<int>(text.size()));
-    const int clamped_end   = std::clamp(_hidden_columns->end, clamped_start, static_cast<int>(text.size()));
-    if (clamped_start == clamped_end)
+    const int start = std::min(_hidden_columns->start, line_width);
+    const int end   = std::min(_hidden_columns->end, line_width);
+    return {start, end - start};
+}
+
+std::string_view LogModel::shown_text(std::string_view text) const
+{
+    const std::size_t max_display_bytes = _long_line_limits.max_display_bytes;
+    if (max_display_bytes == 0 || text.size() <= max_display_bytes)
     {
         return text;
     }
 
-    text.erase(static_cast<std::size_t>(clamped_start), static_cast<std::size_t>(clamped_end - clamped_start));
-    return text;
+    std::size_t cut = max_display_bytes;
+    while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80)
+    {
+        --cut;
+    }
+
+    return text.substr(0, cut);
+}
+
+LogModel::LineLengths LogModel::measure_line(std::uint32_t source_id, std::string_view text) const
+{
+    const std::string_view shown = shown_text(text);
+    LineLengths lengths;
+    lengths.plain_text   = text_is_plain_ascii(shown);
+    lengths.text_width   = saturate_length(lengths.plain_text ? shown.size() : static_cast<std::size_t>(text_display_width(shown)));
+    lengths.hidden_bytes = saturate_length(text.size() - shown.size());
+    lengths.source_id    = source_id;
+    return lengths;
+}
+
+void LogModel::measure_source_labels()
+{
+    _source_label_widths.clear();
+    for (std::uint32_t source_id = 0; source_id < _all_entries.source_count(); ++source_id)
+    {
+        _source_label_widths.push_back(label_display_width(_all_entries.source_label(source_id)));
+    }
+
+    _max_rendered_line_width.reset();
+}
+
+const TextColumnIndex& LogModel::cached_text_columns(AllLineIndex entry_index, std::string_view shown) const
+{
+    const auto cached = _text_columns.find(entry_index.value);
+    if (cached != _text_columns.end())
+    {
+        return cached->second;
+    }
+
+    if (_text_columns_bytes > max_text_column_bytes)
+    {
+        _text_columns.clear();
+        _text_columns_bytes = 0;
+    }
+
+    const auto& columns = _text_columns.emplace(entry_index.value, TextColumnIndex(shown)).first->second;
+    _text_columns_bytes += sizeof(TextColumnIndex) + columns.memory_bytes();
+    return columns;
+}
+
+void LogModel::append_lines_immediately(const std::vector<ObservedLogLine>& lines)
+{
+    const AllLineIndex first_new_entry_index = _all_entries.end_index();
+
+    for (const auto& line : lines)
+    {
+        store_line(line.source_label, line.text, line.timestamp_parsed ? line.timestamp : parse_log_timestamp(line.text), line.skipped_before);
+    }
+
+    expand_visible_entries(first_new_entry_index);
+    expand_find_matches(first_new_entry_index);
+    enforce_retention_limits();
+}
+
+void LogModel::store_line(std::string_view source_label, std::string_view text, std::optional<LogTimePoint> timestamp, std::uint64_t skipped_before)
+{
+    const AllLineIndex entry_index = _all_entries.end_index();
+    const auto level               = _level_detector.detect(text);
+    const std::uint32_t source_id  = _all_entries.append(source_label, text, timestamp, skipped_before);
+    _line_numbers.skip_before(entry_index, skipped_before);
+    if (source_id == _source_label_widths.size())
+    {
+        _source_label_widths.push_back(label_display_width(source_label));
+    }
+
+    _line_lengths.push_back(measure_line(source_id, text));
+    _structured_fields.append(text);
+    _level_bitmaps.append(level);
+    _line_rates.append(entry_index, timestamp, level.has_value() && *level >= LogLevel::Error);
+    if (_collapse_repeats)
+    {
+        _line_templates.push_back(_template_miner.add(text));
+    }
+}
+
+void LogModel::enforce_paused_limits()
+{
+    // Held lines are only read again once, in order, when they are drained, so beyond the paused limit they go to the
+    // spill file instead of being dropped.
+    const auto over_paused_limit = [this] { return _retention_limits.max_paused_memory_bytes > 0 && _paused_updates.memory_bytes() > _retention_limits.max_paused_memory_bytes; };
+    if (over_paused_limit() && _paused_updates.cold_storage().mode != ColdStorageMode::Spilled && !_paused_spill_failed)
+    {
+        try
+        {
+            _paused_updates.set_cold_storage(ColdStorageOptions {ColdStorageMode::Spilled, 0, 1});
+        }
+        catch (const std::runtime_error& ex)
+        {
+            _paused_spill_failed = true;
+            SLAYERLOG_LOG_WARNING("Cannot spill held lines, dropping the oldest instead error=" << ex.what());
+        }
+    }
+
+    // Lines beyond the retention limits would be evicted right after the resume, so they are not worth holding either.
+    const auto exceeded = [&]
+    {
+        return over_paused_limit() || (_retention_limits.max_memory_bytes > 0 && _paused_updates.memory_bytes() + _paused_updates.spilled_bytes() > _retention_limits.max_memory_bytes)
+               || (_retention_limits.max_lines > 0 && _paused_updates.size() > _retention_limits.max_lines);
+    };
+
+    while (_paused_updates.chunk_count() > 1 && exceeded())
+    {
+        _paused_dropped_line_count += _paused_updates.evict_oldest_chunk();
+    }
+}
+
+void LogModel::merge_into_store(std::vector<ObservedLogLine> added_lines, std::optional<ReplacedLines> replaced)
+{
+    const ScopedStageTimer timer(_performance_monitor, PerformanceStage::Merge);
+    for (auto& line : added_lines)
+    {
+        if (!line.timestamp_parsed)
+        {
+            line.timestamp        = parse_log_timestamp(line.text);
+            line.timestamp_parsed = true;
+        }
+    }
+
+    // Every index kept next to the store is refilled as the lines are stored again; the filters, the find query and
+    // the template miner stay as they are.
+    ++_store_generation;
+    LogLineStore previous = std::exchange(_all_entries, _all_entries.empty_copy(_all_entries.first_index()));
+    const LineNumbering previous_numbers = _line_numbers;
+    _line_numbers.truncate(_all_entries.first_index());
+    _level_bitmaps.clear(_all_entries.first_index());
+    _line_rates.clear();
+    _line_templates.clear();
+    _line_lengths.clear();
+    _source_label_widths.clear();
+    _structured_fields.clear_rows();
+    _text_columns.clear();
+    _text_columns_bytes = 0;
+
+    // A cutoff at or before the first stored line hides nothing and stays as it is.
+    std::optional<std::int64_t> hidden_before;
+    if (_hidden_before_line_number.has_value() && *_hidden_before_line_number > previous_numbers.line_number(previous.first_index()))
+    {
+        hidden_before = std::exchange(_hidden_before_line_number, std::nullopt);
+    }
+
+    // The same order merge_log_batch gives the sources' batches: lines without a timestamp stay right after the line
+    // before them, and a stored line goes first when both have the same time.
+    std::size_t added_index = 0;
+    AllLineIndex index      = previous.first_index();
+    while (true)
+    {
+        // Lines of closed sources and replaced lines are left behind, and each chunk is released once read, so the
+        // memory they held is freed without ever holding both stores in full.
+        while (previous.oldest_chunk_size() > 0 && index.value >= previous.first_index().value + static_cast<std::int64_t>(previous.oldest_chunk_size()))
+        {
+            previous.evict_oldest_chunk();
+        }
+
+        while (index < previous.end_index() && !line_kept(previous, index, replaced))
+        {
+            ++index.value;
+        }
+
+        const bool previous_left = index < previous.end_index();
+        const bool added_left    = added_index < added_lines.size();
+        if (!previous_left && !added_left)
+        {
+            break;
+        }
+
+        bool take_previous = previous_left;
+        if (previous_left && added_left)
+        {
+            const auto stored_timestamp = previous.line(index).timestamp;
+            const auto& added_timestamp = added_lines[added_index].timestamp;
+            take_previous               = !stored_timestamp.has_value() || (added_timestamp.has_value() && !(*added_timestamp < *stored_timestamp));
+        }
+
+        if (take_previous)
+        {
+            // The cutoff moves with the line it was set at, or with the first line after it that is still kept.
+            const bool moves_cutoff = hidden_before.has_value() && !_hidden_before_line_number.has_value() && previous_numbers.line_number(index) >= *hidden_before;
+            const auto line         = previous.line(index);
+            store_line(line.source_label, line.text, line.timestamp, line.skipped_before);
+            ++index.value;
+            if (moves_cutoff)
+            {
+                _hidden_before_line_number = last_line_number();
+            }
+        }
+        else
+        {
+            const auto& line = added_lines[added_index];
+            store_line(line.source_label, line.text, line.timestamp, line.skipped_before);
+            ++added_index;
+        }
+    }
+
+    if (hidden_before.has_value() && !_hidden_before_line_number.has_value())
+    {
+        _hidden_before_line_number = last_line_number() + 1;
+    }
+
+    rebuild_visible_entries();
+    rebuild_find_matches();
+    enforce_retention_limits();
+}
+
+LogLineStore LogModel::kept_lines(const LogLineStore& store, std::optional<ReplacedLines> replaced)
+{
+    LogLineStore kept = store.empty_copy(store.first_index());
+    for (AllLineIndex index = store.first_index(); index < store.end_index(); ++index.value)
+    {
+        if (line_kept(store, index, replaced))
+        {
+            const auto line = store.line(index);
+            kept.append(line.source_label, line.text, line.timestamp, line.skipped_before);
+        }
+    }
+
+    return kept;
+}
+
+bool LogModel::line_kept(const LogLineStore& store, AllLineIndex index, const std::optional<ReplacedLines>& replaced)
+{
+    const std::uint32_t source_id = store.line(index).source_id;
+    if (replaced.has_value() && source_id == replaced->source_id && !(index < replaced->first_index))
+    {
+        return false;
+    }
+
+    return !store.source_closed(source_id);
+}
+
+std::optional<LogModel::ReplacedLines> LogModel::newest_source_lines(const LogLineStore& store, std::string_view source_label, std::uint64_t& line_count)
+{
+    std::optional<ReplacedLines> found;
+    for (AllLineIndex index = store.end_index(); line_count > 0 && store.first_index() < index;)
+    {
+        --index.value;
+        const auto line = store.line(index);
+        if (line.source_label == source_label && !store.source_closed(line.source_id))
+        {
+            found = ReplacedLines {line.source_id, index};
+            --line_count;
+        }
+    }
+
+    return found;
+}
+
+void LogModel::rebuild_visible_entries()
+{
+    const ScopedStageTimer timer(_performance_monitor, PerformanceStage::FilterRebuild);
+    _visible_entry_indices.clear();
+    _visible_repeat_counts.clear();
+    _max_rendered_line_width.reset();
+    _visible_entry_indices.reserve(_all_entries.size());
+    std::int64_t index = _all_entries.first_index().value;
+    if (_hidden_before_line_number.has_value())
+    {
+        index = std::max(index, _line_numbers.first_index_at_or_after(*_hidden_before_line_number).value);
+    }
+
+    append_visible_entries(index);
+}
+
+void LogModel::expand_visible_entries(AllLineIndex first_new_entry_index)
+{
+    std::int64_t index = first_new_entry_index.value;
+    if (_hidden_before_line_number.has_value())
+    {
+        index = std::max(index, _line_numbers.first_index_at_or_after(*_hidden_before_line_number).value);
+    }
+
+    append_visible_entries(index);
+}
+
+void LogModel::append_visible_entries(std::int64_t first_index)
+{
+    const auto append_if_matching = [this](AllLineIndex entry_index)
+    {
+        if (!entry_matches_filters(entry_index))
+        {
+            return;
+        }
+
+        if (continues_collapsed_run(entry_index))
+        {
+            ++_visible_repeat_counts.back();
+            return;
+        }
+
+        _visible_entry_indices.push_back(entry_index);
+        if (_collapse_repeats)
+        {
+            _visible_repeat_counts.push_back(1);
+        }
+    };
+
+    // With a level filter, only the set bits of the level bitmaps are candidates, so other lines are never looked at.
+    if (_level_filter_mask.has_value())
+    {
+        _level_bitmaps.for_each(*_level_filter_mask, AllLineIndex {first_index}, append_if_matching);
+        return;
+    }
+
+    for (std::int64_t index = first_index; index < _all_entries.end_index().value; ++index)
+    {
+        append_if_matching(AllLineIndex {index});
+    }
+}
+
+bool LogModel::continues_collapsed_run(AllLineIndex entry_index) const
+{
+    if (!_collapse_repeats || _visible_entry_indices.empty())
+    {
+        return false;
+    }
+
+    const TemplateId id = line_template(entry_index);
+    return id == line_template(_visible_entry_indices.back()) && _expanded_templates.count(id) == 0;
+}
+
+void LogModel::rebuild_find_matches()
+{
+    const ScopedStageTimer timer(_performance_monitor, PerformanceStage::FindRebuild);
+    _find_match_entry_indices.clear();
+    if (_find_query.empty())
+    {
+        return;
+    }
+
+    _find_match_entry_indices.reserve(_all_entries.size());
+    for (std::int64_t index = _all_entries.first_index().value; index < _all_entries.end_index().value; ++index)
+    {
+        const AllLineIndex entry_index {index};
+        if (entry_matches_find_query(_all_entries.line(entry_index)))
+        {
+            _find_match_entry_indices.push_back(entry_index);
+        }
+    }
+}
+
+void LogModel::expand_find_matches(AllLineIndex first_new_entry_index)
+{
+    if (_find_query.empty())
+    {
+        return;
+    }
+
+    for (std::int64_t index = first_new_entry_index.value; index < _all_entries.end_index().value; ++index)
+    {
+        const AllLineIndex entry_index {index};
+        if (entry_matches_find_query(_all_entries.line(entry_index)))
+        {
+            _find_match_entry_indices.push_back(entry_index);
+        }
+    }
+}
+
+void LogModel::enforce_retention_limits()
+{
+    // The newest chunk is still being filled, so it is never a candidate for eviction.
+    while (_all_entries.chunk_count() > 1 && retention_limits_exceeded())
+    {
+        const AllLineIndex evicted_end {_all_entries.first_index().value + static_cast<std::int64_t>(_all_entries.oldest_chunk_size())};
+        const std::uint32_t evicted_repeats = evicted_repeat_count(evicted_end);
+        const std::size_t evicted_count     = _all_entries.evict_oldest_chunk();
+        _structured_fields.erase_front(evicted_count);
+        _level_bitmaps.erase_before(_all_entries.first_index());
+        _line_rates.erase_before(_all_entries.first_index());
+        _line_numbers.erase_before(_all_entries.first_index());
+        _line_templates.erase(_line_templates.begin(), _line_templates.begin() + static_cast<std::ptrdiff_t>(std::min(evicted_count, _line_templates.size())));
+        _line_lengths.erase(_line_lengths.begin(), _line_lengths.begin() + static_cast<std::ptrdiff_t>(std::min(evicted_count, _line_lengths.size())));
+        drop_evicted_indices(evicted_repeats);
+    }
+}
+
+bool LogModel::retention_limits_exceeded() const
+{
+    if (_retention_limits.max_lines > 0 && _all_entries.size() > _retention_limits.max_lines)
+    {
+        return true;
+    }
+
+    if (_retention_limits.max_memory_bytes == 0)
+    {
+        return false;
+    }
+
+    const std::size_t index_bytes    = (_visible_entry_indices.size() + _find_match_entry_indices.size()) * sizeof(AllLineIndex);
+    const std::size_t template_bytes = _template_miner.memory_bytes() + _line_templates.size() * sizeof(TemplateId);
+    const std::size_t length_bytes   = _line_lengths.size() * sizeof(LineLengths) + _line_numbers.memory_bytes();
+    return _all_entries.memory_bytes() + length_bytes + index_bytes + _structured_fields.memory_bytes() + _level_bitmaps.memory_bytes() + _line_rates.memory_bytes() + template_bytes > _retention_limits.max_memory_bytes;
+}
+
+std::uint32_t LogModel::evicted_repeat_count(AllLineIndex evicted_end) const
+{
+    if (!_collapse_repeats)
+    {
+        return 0;
+    }
+
+    const auto next_row = std::lower_bound(_visible_entry_indices.begin(), _visible_entry_indices.end(), evicted_end);
+    if (next_row == _visible_entry_indices.begin())
+    {
+        return 0;
+    }
+
+    const VisibleLineIndex row {static_cast<int>(std::distance(_visible_entry_indices.begin(), next_row)) - 1};
+    const std::uint32_t count = _visible_repeat_counts[row];
+    if (count == 1)
+    {
+        return 0;
+    }
+
+    // Only the lines between the row and evicted_end are looked at, which is at most one chunk.
+    std::uint32_t evicted = 0;
+    for (AllLineIndex index = _visible_entry_indices[row]; index < evicted_end; ++index.value)
+    {
+        if (entry_matches_filters(index))
+        {
+            ++evicted;
+        }
+    }
+
+    return evicted < count ? evicted : 0;
+}
+
+void LogModel::drop_evicted_indices(std::uint32_t evicted_repeats)
+{
+    const AllLineIndex first_retained_index = _all_entries.first_index();
+
+    const auto first_visible   = std::lower_bound(_visible_entry_indices.begin(), _visible_entry_indices.end(), first_retained_index);
+    auto evicted_visible_count = static_cast<std::size_t>(std::distance(_visible_entry_indices.begin(), first_visible));
+    if (evicted_repeats > 0 && evicted_visible_count > 0)
+    {
+        // The collapsed run the eviction cut into keeps its row, which now starts at the first retained line of the run.
+        --evicted_visible_count;
+        const VisibleLineIndex row {static_cast<int>(evicted_visible_count)};
+        AllLineIndex first_member = first_retained_index;
+        while (!entry_matches_filters(first_member))
+        {
+            ++first_member.value;
+        }
+
+        _visible_entry_indices[row] = first_member;
+        _visible_repeat_counts[row] -= evicted_repeats;
+    }
+
+    _visible_entry_indices.erase_front(evicted_visible_count);
+    _visible_repeat_counts.erase_front(evicted_visible_count);
+    _max_rendered_line_width.reset();
+    _evicted_visible_line_count += evicted_visible_count;
+
+    const auto first_find_match         = std::lower_bound(_find_match_entry_indices.begin(), _find_match_entry_indices.end(), first_retained_index);
+    const auto evicted_find_match_count = static_cast<std::size_t>(std::distance(_find_match_entry_indices.begin(), first_find_match));
+    _find_match_entry_indices.erase_front(evicted_find_match_count);
+}
+
+bool LogModel::entry_matches_find_query(const LogLineView& entry) const
+{
+    return _find_pattern.has_value() && matches_pattern(searched_text(entry.text), *_find_pattern);
+}
+
+bool LogModel::entry_matches_filters(AllLineIndex entry_index) const
+{
+    if (_level_filter_mask.has_value() && !_level_bitmaps.contains(*_level_filter_mask, entry_index))
+    {
+        return false;
+    }
+
+    // Field filters only compare column values, so they run first and spare the text filters most of the rejected lines.
+    if (_structured_fields.has_filters() && !_structured_fields.matches_filters(static_cast<std::size_t>(entry_index.value - _all_entries.first_index().value)))
+    {
+        return false;
+    }
+
+    if (_include_filter_patterns.empty() && _exclude_filter_patterns.empty())
+    {
+        return true;
+    }
+
+    const auto entry = _all_entries.line(entry_index);
+    const auto text  = searched_text(entry.text);
+    // Plain text cannot match across the newline between label and text, so only regex filters need the two joined
+    // into a copy; plain filters search them in place.
+    std::string joined_text;
+    const auto matches = [&](const SearchPattern& pattern)
+    {
+        if (!pattern.regex.has_value())
+        {
+            return entry.source_label.find(pattern.needle) != std::string_view::npos || text.find(pattern.needle) != std::string_view::npos;
+        }
+
+        if (joined_text.empty())
+        {
+            joined_text.reserve(entry.source_label.size() + 1 + text.size());
+            joined_text.append(entry.source_label);
+            joined_text.push_back('\n');
+            joined_text.append(text);
+        }
+
+        return matches_pattern(joined_text, pattern);
+    };
+
+    const bool matches_include = _include_filter_patterns.empty() || std::any_of(_include_filter_patterns.begin(), _include_filter_patterns.end(), matches);
+    const bool matches_exclude = std::any_of(_exclude_filter_patterns.begin(), _exclude_filter_patterns.end(), matches);
+    return matches_include && !matches_exclude;
+}
+
+std::string_view LogModel::searched_text(std::string_view text) const
+{
+    return _long_line_limits.search_prefix_bytes > 0 ? text.substr(0, _long_line_limits.search_prefix_bytes) : text;
+}
+
+void LogModel::rebuild_structured_fields()
+{
+    _structured_fields.clear_rows();
+    if (!_structured_fields.enabled())
+    {
+        return;
+    }
+
+    for (AllLineIndex index = _all_entries.first_index(); index < _all_entries.end_index(); ++index.value)
+    {
+        _structured_fields.append(_all_entries.line(index).text);
+    }
+}
+
+void LogModel::rebuild_level_bitmaps()
+{
+    _level_bitmaps.clear(_all_entries.first_index());
+    for (AllLineIndex index = _all_entries.first_index(); index < _all_entries.end_index(); ++index.value)
+    {
+        _level_bitmaps.append(_level_detector.detect(_all_entries.line(index).text));
+    }
+}
+
+void LogModel::rebuild_line_templates()
+{
+    _line_templates.clear();
+    if (!_collapse_repeats)
+    {
+        return;
+    }
+
+    for (AllLineIndex index = _all_entries.first_index(); index < _all_entries.end_index(); ++index.value)
+    {
+        _line_templates.push_back(_template_miner.add(_all_entries.line(index).text));
+    }
+}
+
+TemplateId LogModel::line_template(AllLineIndex entry_index) const
+{
+    return _line_templates[static_cast<std::size_t>(entry_index.value - _all_entries.first_index().value)];
+}
+
+void LogModel::rebuild_line_lengths()
+{
+    _line_lengths.clear();
+    _text_columns.clear();
+    _text_columns_bytes = 0;
+    for (AllLineIndex index = _all_entries.first_index(); index < _all_entries.end_index(); ++index.value)
+    {
+        const auto entry = _all_entries.line(index);
+        _line_lengths.push_back(measure_line(entry.source_id, entry.text));
+    }
+}
+
+const LogModel::LineLengths& LogModel::line_lengths(AllLineIndex entry_index) const
+{
+    return _line_lengths[static_cast<std::size_t>(entry_index.value - _all_entries.first_index().value)];
+}
+
+LogModel::SearchPattern LogModel::compile_search_pattern(std::string_view text)
+{
+    const std::string trimmed_text = trim_filter_text(text);
+    if (trimmed_text.empty())
+    {
+        throw std::invalid_argument("Search text must not be empty");
+    }
+
+    constexpr std::string_view regex_prefix {"re:"};
+    if (trimmed_text.rfind(regex_prefix.data(), 0) != 0)
+    {
+        return SearchPattern {
+            trimmed_text,
+            trimmed_text,
+            std::nullopt,
+        };
+    }
+
+    std::string regex_text = trimmed_text.substr(regex_prefix.size());
+    if (regex_text.empty())
+    {
+        throw std::invalid_argument("Regex pattern after re: must not be empty");
+    }
+
+    try
+    {
+        return SearchPattern {
+            trimmed_text,
+            regex_text,
+            std::regex(regex_text),
+        };
+    }
+    catch (const std::regex_error& error)
+    {
+        throw std::invalid_argument("Invalid regex: " + std::string(error.what()));
+    }
+}
+
+bool LogModel::matches_pattern(std::string_view haystack, const SearchPattern& pattern) const
+{
+    if (!pattern.regex.has_value())
+    {
+        return haystack.find(pattern.needle) != std::string_view::npos;
+    }
+
+    return std::regex_search(haystack.begin(), haystack.end(), *pattern.regex);
+}
+
+std::string LogModel::trim_filter_text(std::string_view text)
+{
+    return trim_text(text);
+}
+
+void LogModel::erase_hidden_columns(std::string& output, std::size_t line_start) const
+{
+    if (!_hidden_columns.has_value())
+    {
+        return;
+    }
+
+    const std::string_view line(output.data() + line_start, output.size() - line_start);
+    const TextColumnIndex columns(line);
+    const auto [hidden_start, hidden_width] = hidden_span(columns.width());
+    const std::size_t erase_start           = columns.byte_offset(line, hidden_start);
+    const std::size_t erase_end             = columns.byte_offset(line, hidden_start + hidden_width);
+    output.erase(line_start + erase_start, erase_end - erase_start);
 }
 
 } // namespace slayerlog
@@ -1,14 +1,29 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <optional>
 #include <regex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include <ftxui_components/text_width.hpp>
+
 #include "log_batch.hpp"
+#include "line_numbering.hpp"
+#include "line_rate_histogram.hpp"
+#include "line_templates.hpp"
+#include "log_levels.hpp"
+#include "log_line_store.hpp"
+#include "performance_monitor.hpp"
+#include "structured_fields.hpp"
 
 namespace slayerlog
 {
@@ -28,21 +43,6 @@ inline bool operator<(VisibleLineIndex lhs, VisibleLineIndex rhs)
     return lhs.value < rhs.value;
 }
 
-struct AllLineIndex
-{
-    int value = 0;
-};
-
-inline bool operator==(AllLineIndex lhs, AllLineIndex rhs)
-{
-    return lhs.value == rhs.value;
-}
-
-inline bool operator<(AllLineIndex lhs, AllLineIndex rhs)
-{
-    return lhs.value < rhs.value;
-}
-
 struct FindResultIndex
 {
     int value = 0;
@@ -58,6 +58,12 @@ inline bool operator<(FindResultIndex lhs, FindResultIndex rhs)
     return lhs.value < rhs.value;
 }
 
+/**
+ * @brief Vector addressed by a strong index type.
+ *
+ * erase_front() only advances a head offset and compacts once the dead prefix outgrows the live items,
+ * so dropping evicted entries costs amortized O(1) per entry.
+ */
 template <typename T, typename Index>
 class IndexedVector
 {
@@ -65,36 +71,57 @@ public:
     using iterator       = typename std::vector<T>::iterator;
     using const_iterator = typename std::vector<T>::const_iterator;
 
-    T& operator[](Index index) { return _items[static_cast<std::size_t>(index.value)]; }
+    T& operator[](Index index) { return _items[_head + static_cast<std::size_t>(index.value)]; }
 
-    const T& operator[](Index index) const { return _items[static_cast<std::size_t>(index.value)]; }
+    const T& operator[](Index index) const { return _items[_head + static_cast<std::size_t>(index.value)]; }
 
-    void clear() { _items.clear(); }
+    void clear()
+    {
+        _items.clear();
+        _head = 0;
+    }
 
-    void reserve(std::size_t count) { _items.reserve(count); }
+    void reserve(std::size_t count) { _items.reserve(_head + count); }
+
+    [[nodiscard]] std::size_t capacity() const { return _items.capacity(); }
 
     void push_back(const T& value) { _items.push_back(value); }
 
     void push_back(T&& value) { _items.push_back(std::move(value)); }
 
-    [[nodiscard]] std::size_t size() const { return _items.size(); }
+    T& back() { return _items.back(); }
+
+    const T& back() const { return _items.back(); }
+
+    void erase_front(std::size_t count)
+    {
+        _head += std::min(count, size());
+        if (_head > 0 && _head >= size())
+        {
+            _items.erase(_items.begin(), _items.begin() + static_cast<std::ptrdiff_t>(_head));
+            _head = 0;
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const { return _items.size() - _head; }
 
-    [[nodiscard]] bool empty() const { return _items.empty(); }
+    [[nodiscard]] bool empty() const { return size() == 0; }
 
-    iterator begin() { return _items.begin(); }
+    iterator begin() { return _items.begin() + static_cast<std::ptrdiff_t>(_head); }
 
     iterator end() { return _items.end(); }
 
-    const_iterator begin() const { return _items.begin(); }
+    const_iterator begin() const { return _items.begin() + static_cast<std::ptrdiff_t>(_head); }
 
     const_iterator end() const { return _items.end(); }
 
-    const_iterator cbegin() const { return _items.cbegin(); }
+    const_iterator cbegin() const { return begin(); }
 
     const_iterator cend() const { return _items.cend(); }
 
 private:
     std::vector<T> _items;
+    std::size_t _head = 0;
 };
 
 struct TextPosition
@@ -116,34 +143,137 @@ inline bool operator==(const HiddenColumnRange& lhs, const HiddenColumnRange& rh
 
 std::optional<HiddenColumnRange> parse_hidden_column_range(std::string_view text);
 
+/** @brief Upper bounds on retained lines; zero disables a limit. */
+struct LogRetentionLimits
+{
+    std::size_t max_lines        = 0;
+    std::size_t max_memory_bytes = 0;
+    /** @brief Bounds the held lines kept in memory while paused; older held chunks are spilled to a temp file beyond it. */
+    std::size_t max_paused_memory_bytes = 0;
+};
+
+/** @brief Bounds the work done per frame and per search on very long lines; zero disables a limit. */
+struct LongLineLimits
+{
+    /** @brief Longer lines are shown cut off after this many bytes; copying and exporting still get the whole line. */
+    std::size_t max_display_bytes = 64 * 1024;
+    /** @brief Filters and find only look at this many leading bytes of each line. */
+    std::size_t search_prefix_bytes = 0;
+};
+
+/** @brief Approximate heap footprint of the model, split by the containers that usually dominate it. */
+struct LogModelMemoryUsage
+{
+    std::size_t entry_count                  = 0;
+    std::size_t entry_bytes                  = 0;
+    std::size_t visible_index_bytes          = 0;
+    std::size_t find_index_bytes             = 0;
+    std::size_t field_column_bytes           = 0;
+    std::size_t level_index_bytes            = 0;
+    std::size_t timeline_bytes               = 0;
+    std::size_t template_bytes               = 0;
+    std::size_t paused_entry_count           = 0;
+    std::size_t paused_bytes                 = 0;
+    std::uint64_t paused_dropped_entry_count = 0;
+    std::int64_t evicted_entry_count         = 0;
+    std::size_t spilled_bytes                = 0;
+
+    /** @brief Resident bytes only; spilled_bytes live in the temp file. */
+    std::size_t total_bytes() const { return entry_bytes + visible_index_bytes + find_index_bytes + field_column_bytes + level_index_bytes + timeline_bytes + template_bytes + paused_bytes; }
+};
+
 class LogModel
 {
 public:
+    /** @brief Time spent adding held lines per drain call, so the UI keeps redrawing while a long pause is caught up. */
+    static constexpr std::chrono::milliseconds resume_slice_budget {8};
+
     /** @brief Resets the model to its initial empty state. */
     void reset();
 
+    /** @brief Numbers the first line as if count lines came before it, for lines the sources skipped on open; only applies while the model is empty. */
+    void skip_line_numbers(std::uint64_t count);
     /** @brief Appends already ordered lines to the rendered log view. */
-    void append_lines(const std::vector<ObservedLogLine>& lines);
-    /** @brief Toggles update buffering so users can inspect the view without live movement. */
+    void append_lines(std::vector<ObservedLogLine> lines);
+    /**
+     * @brief Applies an opened or closed source without re-reading the other sources.
+     *
+     * Stored lines are relabelled. added_lines, already in order among themselves, are merged into the stored lines by
+     * timestamp, and the lines of a closed source are dropped, held ones included, which frees their memory. Either
+     * renumbers the stored lines and refills every index kept next to them; the filters, the find query and the
+     * hidden-before cutoff, which moves with its line, are kept. Added lines join the store even while paused.
+     */
+    void update_sources(std::vector<ObservedLogLine> added_lines, const SourceRelabel& relabel);
+    /**
+     * @brief Merges lines a source read again from an earlier point into the stored lines by timestamp.
+     *
+     * The replaced_line_count newest lines of the source, held ones included, are dropped first, since the lines read
+     * again stand in for them; a remote source does this after its filter was widened. Like update_sources, the lines
+     * join the store even while paused and the cutoff moves with its line.
+     */
+    void merge_refetched_lines(std::string_view source_label, std::uint64_t replaced_line_count, std::vector<ObservedLogLine> lines);
+    /** @brief Toggles update buffering so users can inspect the view without live movement; resuming adds the first chunk of held lines. */
     void toggle_pause();
     /** @brief Returns whether incoming updates are currently buffered instead of rendered immediately. */
     bool updates_paused() const;
+    /** @brief Returns whether lines held during a pause are still waiting to be added after a resume. */
+    bool resume_pending() const;
+    /**
+     * @brief Adds held lines to the view a chunk at a time until budget is spent; returns true when lines were added.
+     *
+     * New lines keep queueing behind the held ones until the buffer is empty, so their order is preserved.
+     */
+    bool drain_paused_updates(std::chrono::nanoseconds budget = resume_slice_budget);
     /** @brief Enables source labels when multiple files are shown in the same view. */
     void set_show_source_labels(bool show_source_labels);
     /** @brief Adds an include filter and rebuilds the visible log. */
     void add_include_filter(std::string filter_text);
     /** @brief Adds an exclude filter and rebuilds the visible log. */
     void add_exclude_filter(std::string filter_text);
+    /**
+     * @brief Adds a "field=value" style filter on a top-level JSON field and rebuilds the visible log.
+     *
+     * The field is extracted into a column on first use, after which it is parsed once per appended line. Throws
+     * std::invalid_argument when filter_text is not a field filter.
+     */
+    void add_field_filter(std::string filter_text);
+    /** @brief Extracts the JSON fields on ingest so later field filters need not re-parse the stored lines. */
+    void set_structured_fields(const std::vector<std::string>& field_names);
+    /**
+     * @brief Keeps only lines whose detected level is in filter_text, e.g. "error,warn" or "warn+", and rebuilds the visible log.
+     *
+     * Successive level filters intersect. Throws std::invalid_argument on an unknown level.
+     */
+    void add_level_filter(std::string filter_text);
+    /** @brief Adds level words to the defaults and detects the level of every stored line again, also for the timeline's error counts. */
+    void set_level_tokens(const std::vector<LogLevelToken>& tokens);
+    /**
+     * @brief Folds consecutive visible lines of the same template into one row that shows the first of them and the count.
+     *
+     * Templates are mined from every appended line while this is enabled; enabling it mines the stored lines once.
+     */
+    void set_collapse_repeats(bool collapse_repeats);
+    bool collapse_repeats() const;
+    /** @brief Expands, or folds again, every run of the template of the visible line with this 1-based number; returns false when it is not visible. */
+    bool toggle_repeat_expansion(std::int64_t line_number);
+    /** @brief Returns how many lines the visible row stands for, which is 1 unless repeats are collapsed. */
+    std::uint32_t repeat_count(VisibleLineIndex visible_line_index) const;
+    /** @brief Returns the number of templates mined so far. */
+    std::size_t template_count() const;
     /** @brief Removes every active filter and restores the full log view. */
     void reset_filters();
     /** @brief Returns active include filters in registration order. */
     const std::vector<std::string>& include_filters() const;
     /** @brief Returns active exclude filters in registration order. */
     const std::vector<std::string>& exclude_filters() const;
+    /** @brief Returns active field filters in registration order. */
+    const std::vector<std::string>& field_filters() const;
+    /** @brief Returns active level filters in registration order. */
+    const std::vector<std::string>& level_filters() const;
     /** @brief Hides all raw lines before the provided 1-based line number. */
-    void hide_before_line_number(int line_number);
+    void hide_before_line_number(std::int64_t line_number);
     /** @brief Returns the active raw-line cutoff, if any. */
-    std::optional<int> hidden_before_line_number() const;
+    std::optional<std::int64_t> hidden_before_line_number() const;
     /** @brief Hides displayed columns in the half-open range [start_column, end_column). */
     void hide_columns(int start_column, int end_column);
     /** @brief Clears the active displayed-column hide range. */
@@ -167,12 +297,14 @@ public:
     std::optional<AllLineIndex> find_match_entry_index(FindResultIndex find_result_index) const;
     /** @brief Returns the find result position for an entry index. */
     std::optional<FindResultIndex> find_match_position_for_entry_index(AllLineIndex entry_index) const;
-    /** @brief Returns the visible index for an entry index, if currently visible. */
+    /** @brief Returns the visible index for an entry index, if currently visible; a line folded into a collapsed row maps to that row. */
     std::optional<VisibleLineIndex> visible_line_index_for_entry(AllLineIndex entry_index) const;
     /** @brief Returns the 1-based raw line number for a visible line index. */
-    std::optional<int> line_number_for_visible_line(VisibleLineIndex visible_line_index) const;
+    std::optional<std::int64_t> line_number_for_visible_line(VisibleLineIndex visible_line_index) const;
     /** @brief Returns the visible index for a 1-based raw line number, if currently visible. */
-    std::optional<VisibleLineIndex> visible_line_index_for_line_number(int line_number) const;
+    std::optional<VisibleLineIndex> visible_line_index_for_line_number(std::int64_t line_number) const;
+    /** @brief Returns whether a retained line has this number, rather than it falling on lines a remote filter left out. */
+    bool line_number_stored(std::int64_t line_number) const;
     /** @brief Returns whether a visible line index is a find match. */
     bool visible_line_matches_find(int visible_index) const;
     /** @brief Returns whether an entry index is currently visible. */
@@ -180,15 +312,53 @@ public:
 
     /** @brief Returns the total number of rendered log lines in the model. */
     int line_count() const;
-    /** @brief Returns the total number of observed log lines before filtering. */
+    /** @brief Returns the number of retained log lines before filtering. */
     int total_line_count() const;
+    /** @brief Returns the 1-based raw line number of the oldest retained line. */
+    std::int64_t first_line_number() const;
+    /** @brief Returns the 1-based raw line number of the newest line, or 0 when nothing was observed. */
+    std::int64_t last_line_number() const;
 
-    /** @brief Returns a fully rendered line including line number and optional source label. */
+    /** @brief Returns a rendered line including line number and optional source label, cut off at the display limit. */
     std::string rendered_line(int index) const;
-    /** @brief Returns a contiguous slice of fully rendered visible lines. */
+    /** @brief Appends the whole rendered line, ignoring the display limit, to output without building a separate string for it. */
+    void append_rendered_line(int index, std::string& output) const;
+    /** @brief Returns a contiguous slice of rendered visible lines. */
     std::vector<std::string> rendered_lines(int first_index, int count) const;
-    /** @brief Returns the maximum width of the fully rendered visible lines. */
+    /** @brief Returns only the columns [first_col, first_col + col_count) of each line of the slice, so long lines are never rendered whole. */
+    std::vector<std::string> rendered_lines(int first_index, int count, int first_col, int col_count) const;
+    /** @brief Returns the width of rendered_line(index), computed from the stored line lengths. */
+    int rendered_line_width(int index) const;
+    /** @brief Returns the maximum width of the rendered visible lines. */
     int max_rendered_line_width() const;
+    /** @brief Returns every line the view stands for, including the lines folded into collapsed rows, or only the visible find matches. */
+    std::vector<AllLineIndex> export_entry_indices(bool find_matches_only) const;
+    /** @brief Appends the stored line, after its source label when labels are shown, and a newline; returns false when it was evicted. */
+    bool append_export_line(AllLineIndex entry_index, std::string& output) const;
+    /** @brief Returns how many held lines were dropped since the last reset, because they were beyond the retention limits or could not be spilled. */
+    std::uint64_t paused_dropped_line_count() const;
+    /** @brief Changes whenever the stored lines are numbered afresh, after which an AllLineIndex taken before names another line. */
+    std::uint64_t store_generation() const;
+    /** @brief Returns the line and error rates over time of the retained lines. */
+    const LineRateHistogram& line_rates() const;
+    /** @brief Returns the first visible line at or after entry_index, if any. */
+    std::optional<VisibleLineIndex> first_visible_line_at_or_after(AllLineIndex entry_index) const;
+
+    /** @brief Reports filter and find rebuild durations to the monitor; pass nullptr to stop reporting. */
+    void set_performance_monitor(PerformanceMonitor* performance_monitor);
+    /** @brief Returns the current memory footprint without walking the stored lines. */
+    LogModelMemoryUsage memory_usage() const;
+
+    /** @brief Bounds the retained lines; the oldest chunks are evicted whenever a limit is exceeded. */
+    void set_retention_limits(LogRetentionLimits limits);
+    LogRetentionLimits retention_limits() const;
+    /** @brief Compresses older line chunks, optionally spilling them to a temp file, while keeping the query API unchanged. */
+    void set_cold_storage(ColdStorageOptions options);
+    /** @brief Returns how many visible lines eviction has removed from the front since the last reset. */
+    std::uint64_t evicted_visible_line_count() const;
+    /** @brief Sets the display cut-off and search prefix for long lines; a changed search prefix rebuilds the visible log and find results. */
+    void set_long_line_limits(LongLineLimits limits);
+    LongLineLimits long_line_limits() const;
 
 private:
     struct SearchPattern
@@ -198,44 +368,132 @@ private:
         std::optional<std::regex> regex;
     };
 
-    std::string render_entry(AllLineIndex entry_index) const;
+    /** @brief Display widths of a stored line, kept so rendered widths are known without reading the line. */
+    struct LineLengths
+    {
+        /** @brief Width of the part of the text shown before the display limit. */
+        std::uint32_t text_width   = 0;
+        std::uint32_t hidden_bytes = 0;
+        std::uint32_t source_id    = 0;
+        /** @brief The shown text is printable ASCII, so its columns are its bytes and it needs no column index. */
+        bool plain_text = true;
+    };
+
+    /** @brief Appends the rendered line to output, so many lines can be rendered into one buffer. */
+    void append_rendered_entry(AllLineIndex entry_index, std::uint32_t repeats, std::string& output) const;
+    void append_line_prefix(AllLineIndex entry_index, std::uint32_t repeats, std::string_view source_label, std::string& output) const;
+    /** @brief Appends the displayed columns [first_col, first_col + col_count) of a visible line, reading only the bytes they show. */
+    void append_rendered_window(VisibleLineIndex visible_line_index, int first_col, int col_count, std::string& output) const;
+    /** @brief Returns the width of a visible line as displayed, before the hidden columns are removed. */
+    int unhidden_line_width(VisibleLineIndex visible_line_index) const;
+    /** @brief Returns where the hidden columns start in a line of line_width and how many of them it has. */
+    std::pair<int, int> hidden_span(int line_width) const;
+    /** @brief Returns the part of text shown before the display limit, cut at the start of a UTF-8 sequence. */
+    std::string_view shown_text(std::string_view text) const;
+    LineLengths measure_line(std::uint32_t source_id, std::string_view text) const;
+    /** @brief Measures the labels of every source again after they were renamed. */
+    void measure_source_labels();
+    /** @brief Returns the column index of the shown text of a line that is not plain ASCII, building it on first use. */
+    const TextColumnIndex& cached_text_columns(AllLineIndex entry_index, std::string_view shown) const;
 
     void append_lines_immediately(const std::vector<ObservedLogLine>& lines);
+    /** @brief Appends one line to the store and to every index kept next to it. */
+    void store_line(std::string_view source_label, std::string_view text, std::optional<LogTimePoint> timestamp, std::uint64_t skipped_before);
 
-    void flush_paused_updates();
+    void enforce_paused_limits();
+    // The newest lines of one source from first_index on, which lines read again stand in for.
+    struct ReplacedLines
+    {
+        std::uint32_t source_id = 0;
+        AllLineIndex first_index;
+    };
+
+    /** @brief Stores the retained lines of the open sources again, without replaced ones, with added_lines merged in by timestamp. */
+    void merge_into_store(std::vector<ObservedLogLine> added_lines, std::optional<ReplacedLines> replaced = std::nullopt);
+    /** @brief Returns the store without the lines of closed sources and, when given, without the replaced ones. */
+    static LogLineStore kept_lines(const LogLineStore& store, std::optional<ReplacedLines> replaced = std::nullopt);
+    static bool line_kept(const LogLineStore& store, AllLineIndex index, const std::optional<ReplacedLines>& replaced);
+    /** @brief Finds up to line_count newest lines of the open source with this label, lowering line_count by those found. */
+    static std::optional<ReplacedLines> newest_source_lines(const LogLineStore& store, std::string_view source_label, std::uint64_t& line_count);
 
     void rebuild_visible_entries();
     void expand_visible_entries(AllLineIndex first_new_entry_index);
+    void append_visible_entries(std::int64_t first_index);
+    bool continues_collapsed_run(AllLineIndex entry_index) const;
 
     void rebuild_find_matches();
     void expand_find_matches(AllLineIndex first_new_entry_index);
 
     static SearchPattern compile_search_pattern(std::string_view text);
-    bool entry_matches_find_query(const ObservedLogLine& entry) const;
-    bool entry_matches_filters(const ObservedLogLine& entry) const;
+    void enforce_retention_limits();
+    bool retention_limits_exceeded() const;
+    /** @brief Returns how many lines of a collapsed run that starts before evicted_end and continues after it are about to be evicted. */
+    std::uint32_t evicted_repeat_count(AllLineIndex evicted_end) const;
+    void drop_evicted_indices(std::uint32_t evicted_repeats);
+
+    bool entry_matches_find_query(const LogLineView& entry) const;
+    bool entry_matches_filters(AllLineIndex entry_index) const;
+    /** @brief Returns the part of a line filters and find look at. */
+    std::string_view searched_text(std::string_view text) const;
+    void rebuild_structured_fields();
+    void rebuild_level_bitmaps();
+    void rebuild_line_templates();
+    TemplateId line_template(AllLineIndex entry_index) const;
+    void rebuild_line_lengths();
+    const LineLengths& line_lengths(AllLineIndex entry_index) const;
     bool matches_pattern(std::string_view haystack, const SearchPattern& pattern) const;
-    bool matches_any_pattern(std::string_view haystack, const std::vector<SearchPattern>& patterns) const;
     static std::string trim_filter_text(std::string_view text);
-    std::string apply_hidden_columns(std::string text) const;
+    /** @brief Removes the hidden columns from the line that starts at line_start in output. */
+    void erase_hidden_columns(std::string& output, std::size_t line_start) const;
 
-    IndexedVector<ObservedLogLine, AllLineIndex> _all_entries;
+    LogLineStore _all_entries;
+    LineNumbering _line_numbers;
     IndexedVector<AllLineIndex, VisibleLineIndex> _visible_entry_indices;
-    std::vector<ObservedLogLine> _paused_updates;
+    // Lines each visible row stands for; kept next to _visible_entry_indices only while repeats are collapsed.
+    IndexedVector<std::uint32_t, VisibleLineIndex> _visible_repeat_counts;
+    LogLineStore _paused_updates;
 
     std::vector<std::string> _include_filters;
     std::vector<std::string> _exclude_filters;
     std::vector<SearchPattern> _include_filter_patterns;
     std::vector<SearchPattern> _exclude_filter_patterns;
+    StructuredFields _structured_fields;
+    std::vector<std::string> _level_filters;
+    std::optional<LogLevelMask> _level_filter_mask;
+    LogLevelDetector _level_detector;
+    LevelBitmaps _level_bitmaps;
+    LineRateHistogram _line_rates;
+    bool _collapse_repeats = false;
+    TemplateMiner _template_miner;
+    std::deque<TemplateId> _line_templates;
+    std::unordered_set<TemplateId> _expanded_templates;
+    LongLineLimits _long_line_limits;
+    std::deque<LineLengths> _line_lengths;
+    // Display width of each source label, by the source id the store interned it under.
+    std::vector<std::uint16_t> _source_label_widths;
+    // Column indexes of the non-ASCII lines rendered lately, dropped together once they grow too large.
+    mutable std::unordered_map<std::int64_t, TextColumnIndex> _text_columns;
+    mutable std::size_t _text_columns_bytes = 0;
+    // Asked for every frame, so it is kept until the visible lines or their rendering change; appended lines only extend it.
+    mutable std::optional<int> _max_rendered_line_width;
+    mutable int _max_width_line_count = 0;
 
     std::string _find_query;
     std::optional<SearchPattern> _find_pattern;
     IndexedVector<AllLineIndex, FindResultIndex> _find_match_entry_indices;
 
-    std::optional<int> _hidden_before_line_number;
+    std::optional<std::int64_t> _hidden_before_line_number;
     std::optional<HiddenColumnRange> _hidden_columns;
 
-    bool _updates_paused     = false;
-    bool _show_source_labels = false;
+    bool _updates_paused      = false;
+    bool _show_source_labels  = false;
+    bool _paused_spill_failed = false;
+
+    std::uint64_t _store_generation           = 0;
+    std::uint64_t _paused_dropped_line_count  = 0;
+    std::uint64_t _evicted_visible_line_count = 0;
+    PerformanceMonitor* _performance_monitor  = nullptr;
+    LogRetentionLimits _retention_limits;
 };
 
 } // namespace slayerlog
@@ -2,10 +2,14 @@
 
 #include <algorithm>
 #include <cctype>
+#include <array>
 #include <filesystem>
+#include <fstream>
+#include <optional>
 #include <stdexcept>
 #include <system_error>
 #include <unordered_map>
+#include <utility>
 
 namespace slayerlog
 {
@@ -72,6 +76,120 @@ std::string normalize_remote_path_for_comparison(std::string_view remote_path)
     return std::filesystem::path(remote_path).lexically_normal().generic_string();
 }
 
+/** @brief Parses the N of a ".N", ".N.gz" or ".N.zst" rotation suffix. */
+std::optional<unsigned long> parse_rotation_index(std::string_view suffix)
+{
+    if (suffix.size() < 2 || suffix.front() != '.')
+    {
+        return std::nullopt;
+    }
+
+    suffix.remove_prefix(1);
+    for (const std::string_view extension : {std::string_view(".gz"), std::string_view(".zst")})
+    {
+        if (suffix.size() > extension.size() && suffix.substr(suffix.size() - extension.size()) == extension)
+        {
+            suffix.remove_suffix(extension.size());
+            break;
+        }
+    }
+
+    if (suffix.empty() || suffix.size() > 9 || !std::all_of(suffix.begin(), suffix.end(), [](unsigned char value) { return std::isdigit(value) != 0; }))
+    {
+        return std::nullopt;
+    }
+
+    return std::stoul(std::string(suffix));
+}
+
+bool has_glob_wildcards(std::string_view text)
+{
+    return text.find_first_of("*?") != std::string_view::npos;
+}
+
+/** @brief "app.log*" asks for a rotation chain; any other use of wildcards is a glob. */
+bool is_rotation_chain_spec(std::string_view spec)
+{
+    return spec.size() > 1 && spec.back() == '*' && spec[spec.size() - 2] != '/' && spec[spec.size() - 2] != '\\' && !has_glob_wildcards(spec.substr(0, spec.size() - 1));
+}
+
+std::vector<std::string_view> split_glob_segments(std::string_view text)
+{
+    std::vector<std::string_view> segments;
+    std::size_t start = 0;
+    while (true)
+    {
+        const std::size_t separator = text.find('/', start);
+        segments.push_back(text.substr(start, separator == std::string_view::npos ? std::string_view::npos : separator - start));
+        if (separator == std::string_view::npos)
+        {
+            return segments;
+        }
+
+        start = separator + 1;
+    }
+}
+
+bool matches_glob_segment(std::string_view pattern, std::string_view text)
+{
+    std::size_t pattern_index = 0;
+    std::size_t text_index    = 0;
+    std::size_t star_index    = std::string_view::npos;
+    std::size_t star_text     = 0;
+    while (text_index < text.size())
+    {
+        if (pattern_index < pattern.size() && (pattern[pattern_index] == '?' || pattern[pattern_index] == text[text_index]))
+        {
+            ++pattern_index;
+            ++text_index;
+        }
+        else if (pattern_index < pattern.size() && pattern[pattern_index] == '*')
+        {
+            star_index = pattern_index++;
+            star_text  = text_index;
+        }
+        else if (star_index != std::string_view::npos)
+        {
+            pattern_index = star_index + 1;
+            text_index    = ++star_text;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (pattern_index < pattern.size() && pattern[pattern_index] == '*')
+    {
+        ++pattern_index;
+    }
+
+    return pattern_index == pattern.size();
+}
+
+bool matches_glob_segments(const std::vector<std::string_view>& pattern, std::size_t pattern_index, const std::vector<std::string_view>& path, std::size_t path_index)
+{
+    if (pattern_index == pattern.size())
+    {
+        return path_index == path.size();
+    }
+
+    if (pattern[pattern_index] == "**")
+    {
+        for (std::size_t next_index = path_index; next_index <= path.size(); ++next_index)
+        {
+            if (matches_glob_segments(pattern, pattern_index + 1, path, next_index))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    return path_index < path.size() && matches_glob_segment(pattern[pattern_index], path[path_index]) && matches_glob_segments(pattern, pattern_index + 1, path, path_index + 1);
+}
+
 std::string source_identity(const LogSource& source)
 {
     if (source.kind == LogSourceKind::SshRemoteFile)
@@ -80,6 +198,11 @@ std::string source_identity(const LogSource& source)
                normalize_remote_path_for_comparison(source.remote_path);
     }
 
+    if (source.kind == LogSourceKind::StandardInput || source.kind == LogSourceKind::Command)
+    {
+        return source.spec;
+    }
+
     return normalize_local_path_for_comparison(source.local_path);
 }
 
@@ -93,11 +216,57 @@ LogSource parse_log_source(std::string_view text)
         throw std::invalid_argument("Source path must not be empty");
     }
 
+    if (spec == "-")
+    {
+        return LogSource {
+            LogSourceKind::StandardInput, spec, {}, {}, {}, {}, {},
+        };
+    }
+
+    constexpr std::string_view command_scheme = "cmd:";
+    if (spec.rfind(command_scheme, 0) == 0)
+    {
+        std::string command = trim_text(std::string_view(spec).substr(command_scheme.size()));
+        if (command.empty())
+        {
+            throw std::invalid_argument("Command source must include a command, for example cmd:journalctl -f");
+        }
+
+        std::string normalized_spec = std::string(command_scheme) + command;
+        return LogSource {
+            LogSourceKind::Command, std::move(normalized_spec), {}, {}, {}, {}, std::move(command),
+        };
+    }
+
     constexpr std::string_view ssh_scheme = "ssh://";
     if (spec.rfind(ssh_scheme, 0) != 0)
     {
+        std::error_code error_code;
+        if (std::filesystem::is_directory(spec, error_code))
+        {
+            const std::string pattern = (std::filesystem::path(spec) / "*").string();
+            return LogSource {
+                LogSourceKind::FileGlob, spec, pattern, {}, {}, {}, {},
+            };
+        }
+
+        if (has_glob_wildcards(spec) && !is_rotation_chain_spec(spec))
+        {
+            return LogSource {
+                LogSourceKind::FileGlob, spec, spec, {}, {}, {}, {},
+            };
+        }
+
+        if (is_rotation_chain_spec(spec))
+        {
+            const std::string live_path = spec.substr(0, spec.size() - 1);
+            return LogSource {
+                LogSourceKind::LocalFile, spec, live_path, {}, {}, find_rotated_log_paths(live_path), {},
+            };
+        }
+
         return LogSource {
-            LogSourceKind::LocalFile, spec, spec, {}, {},
+            LogSourceKind::LocalFile, spec, spec, {}, {}, {}, {},
         };
     }
 
@@ -117,13 +286,96 @@ LogSource parse_log_source(std::string_view text)
     }
 
     return LogSource {
-        LogSourceKind::SshRemoteFile, spec, {}, ssh_target, remote_path,
+        LogSourceKind::SshRemoteFile, spec, {}, ssh_target, remote_path, {}, {},
     };
 }
 
+LogGlob split_log_glob(std::string_view pattern)
+{
+    const std::string generic_pattern = std::filesystem::path(pattern).generic_string();
+    const std::size_t wildcard        = generic_pattern.find_first_of("*?");
+    const std::size_t separator       = wildcard == std::string::npos ? generic_pattern.rfind('/') : generic_pattern.rfind('/', wildcard);
+    if (separator == std::string::npos)
+    {
+        return LogGlob {".", generic_pattern};
+    }
+
+    return LogGlob {
+        separator == 0 ? std::string("/") : generic_pattern.substr(0, separator),
+        generic_pattern.substr(separator + 1),
+    };
+}
+
+bool matches_log_glob(std::string_view pattern, std::string_view path)
+{
+    return matches_glob_segments(split_glob_segments(pattern), 0, split_glob_segments(path), 0);
+}
+
+LogCompression detect_log_compression(const std::string& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    std::array<unsigned char, 4> magic {};
+    if (!input.read(reinterpret_cast<char*>(magic.data()), static_cast<std::streamsize>(magic.size())))
+    {
+        return LogCompression::None;
+    }
+
+    if (magic[0] == 0x1F && magic[1] == 0x8B)
+    {
+        return LogCompression::Gzip;
+    }
+
+    if (magic == std::array<unsigned char, 4> {0x28, 0xB5, 0x2F, 0xFD})
+    {
+        return LogCompression::Zstd;
+    }
+
+    return LogCompression::None;
+}
+
+std::vector<std::string> find_rotated_log_paths(const std::string& live_path)
+{
+    const std::filesystem::path live(live_path);
+    const std::string live_name           = live.filename().string();
+    const std::filesystem::path directory = live.has_parent_path() ? live.parent_path() : std::filesystem::path(".");
+
+    std::vector<std::pair<unsigned long, std::string>> rotated;
+    std::error_code error_code;
+    for (std::filesystem::directory_iterator entry(directory, error_code), end; !error_code && entry != end; entry.increment(error_code))
+    {
+        const std::string name = entry->path().filename().string();
+        if (name.size() <= live_name.size() || name.compare(0, live_name.size(), live_name) != 0 || !entry->is_regular_file(error_code))
+        {
+            continue;
+        }
+
+        const auto rotation_index = parse_rotation_index(std::string_view(name).substr(live_name.size()));
+        if (rotation_index.has_value())
+        {
+            rotated.emplace_back(*rotation_index, (live.has_parent_path() ? directory / name : std::filesystem::path(name)).string());
+        }
+    }
+
+    std::sort(rotated.begin(), rotated.end(), [](const auto& lhs, const auto& rhs) { return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second; });
+
+    std::vector<std::string> paths;
+    paths.reserve(rotated.size());
+    for (auto& [rotation_index, path] : rotated)
+    {
+        paths.push_back(std::move(path));
+    }
+
+    return paths;
+}
+
 std::string source_display_path(const LogSource& source)
 {
-    if (source.kind == LogSourceKind::SshRemoteFile)
+    if (source.kind == LogSourceKind::StandardInput)
+    {
+        return "stdin";
+    }
+
+    if (source.kind == LogSourceKind::SshRemoteFile || source.kind == LogSourceKind::Command)
     {
         return source.spec;
     }
@@ -133,6 +385,24 @@ std::string source_display_path(const LogSource& source)
 
 std::string source_basename(const LogSource& source)
 {
+    if (source.kind == LogSourceKind::StandardInput)
+    {
+        return "stdin";
+    }
+
+    if (source.kind == LogSourceKind::Command)
+    {
+        // Label by program name, e.g. "kubectl"; several commands of one program fall back to their full spec.
+        const std::string program = source.command.substr(0, source.command.find_first_of(" \t"));
+        return std::filesystem::path(program).filename().string();
+    }
+
+    if (source.kind == LogSourceKind::FileGlob)
+    {
+        // The file name of a glob is usually just "*.log", which says little about where the files come from.
+        return source.spec;
+    }
+
     if (source.kind == LogSourceKind::SshRemoteFile)
     {
         return std::filesystem::path(source.remote_path).filename().string();
@@ -11,6 +11,19 @@ enum class LogSourceKind
 {
     LocalFile,
     SshRemoteFile,
+    /** @brief "-": lines piped into slayerlog. */
+    StandardInput,
+    /** @brief "cmd:<command>": output of a local shell command such as "kubectl logs -f pod". */
+    Command,
+    /** @brief A directory or a glob of local files, which may use a recursive "**" segment; local_path holds the glob and a directory becomes a glob over the files directly inside it. */
+    FileGlob,
+};
+
+enum class LogCompression
+{
+    None,
+    Gzip,
+    Zstd,
 };
 
 struct LogSource
@@ -20,9 +33,26 @@ struct LogSource
     std::string local_path;
     std::string ssh_target;
     std::string remote_path;
+    /** @brief Rotated predecessors of local_path, oldest first; set when the spec ends in '*', e.g. "app.log*". */
+    std::vector<std::string> rotated_paths;
+    std::string command;
+};
+
+/** @brief A glob split into the deepest directory without wildcards and the pattern for paths relative to it. */
+struct LogGlob
+{
+    std::string base_directory;
+    std::string relative_pattern;
 };
 
 LogSource parse_log_source(std::string_view text);
+LogGlob split_log_glob(std::string_view pattern);
+/** @brief Matches a '/'-separated path; '*' and '?' stay within one path segment and a "**" segment spans any number of segments. */
+bool matches_log_glob(std::string_view pattern, std::string_view path);
+/** @brief Identifies gzip and zstd files by their magic bytes; unreadable files count as uncompressed. */
+LogCompression detect_log_compression(const std::string& path);
+/** @brief Returns the existing live_path.N, live_path.N.gz and live_path.N.zst files, highest N (oldest) first. */
+std::vector<std::string> find_rotated_log_paths(const std::string& live_path);
 std::string source_display_path(const LogSource& source);
 std::string source_basename(const LogSource& source);
 bool same_source(const LogSource& lhs, const LogSource& rhs);
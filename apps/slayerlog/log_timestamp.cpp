@@ -18,7 +18,7 @@ bool is_digit(char character)
     return std::isdigit(static_cast<unsigned char>(character)) != 0;
 }
 
-bool parse_fixed_digits(const std::string& text, std::size_t position, int digit_count, int& value)
+bool parse_fixed_digits(std::string_view text, std::size_t position, int digit_count, int& value)
 {
     if ((position + static_cast<std::size_t>(digit_count)) > text.size())
     {
@@ -141,7 +141,7 @@ std::optional<LogTimePoint> build_time_point(
     return LogTimePoint(std::chrono::duration_cast<LogTimePoint::duration>(duration));
 }
 
-void consume_leading_whitespace(const std::string& line, ParseState& state)
+void consume_leading_whitespace(std::string_view line, ParseState& state)
 {
     while (state.position < line.size() && std::isspace(static_cast<unsigned char>(line[state.position])) != 0)
     {
@@ -149,7 +149,7 @@ void consume_leading_whitespace(const std::string& line, ParseState& state)
     }
 }
 
-void parse_optional_brackets(const std::string& line, ParseState& state)
+void parse_optional_brackets(std::string_view line, ParseState& state)
 {
     state.bracketed = state.position < line.size() && line[state.position] == '[';
     if (state.bracketed)
@@ -158,7 +158,7 @@ void parse_optional_brackets(const std::string& line, ParseState& state)
     }
 }
 
-bool consume_separator(const std::string& line, ParseState& state, char separator)
+bool consume_separator(std::string_view line, ParseState& state, char separator)
 {
     if (state.position >= line.size() || line[state.position] != separator)
     {
@@ -169,7 +169,7 @@ bool consume_separator(const std::string& line, ParseState& state, char separato
     return true;
 }
 
-bool parse_date(const std::string& line, ParseState& state, ParsedTimestamp& parsed)
+bool parse_date(std::string_view line, ParseState& state, ParsedTimestamp& parsed)
 {
     if (!parse_fixed_digits(line, state.position, 4, parsed.year))
     {
@@ -202,7 +202,7 @@ bool parse_date(const std::string& line, ParseState& state, ParsedTimestamp& par
     return is_valid_date(parsed.year, parsed.month, parsed.day);
 }
 
-bool parse_time(const std::string& line, ParseState& state, ParsedTimestamp& parsed)
+bool parse_time(std::string_view line, ParseState& state, ParsedTimestamp& parsed)
 {
     if (state.position >= line.size() || (line[state.position] != 'T' && line[state.position] != ' '))
     {
@@ -241,7 +241,7 @@ bool parse_time(const std::string& line, ParseState& state, ParsedTimestamp& par
     return is_valid_time(parsed.hour, parsed.minute, parsed.second);
 }
 
-bool parse_fractional_seconds(const std::string& line, ParseState& state, ParsedTimestamp& parsed)
+bool parse_fractional_seconds(std::string_view line, ParseState& state, ParsedTimestamp& parsed)
 {
     if (state.position >= line.size() || line[state.position] != '.')
     {
@@ -275,7 +275,7 @@ bool parse_fractional_seconds(const std::string& line, ParseState& state, Parsed
     return true;
 }
 
-bool parse_timezone(const std::string& line, ParseState& state, ParsedTimestamp& parsed)
+bool parse_timezone(std::string_view line, ParseState& state, ParsedTimestamp& parsed)
 {
     if (state.position >= line.size() || (line[state.position] != 'Z' && line[state.position] != '+' && line[state.position] != '-'))
     {
@@ -312,7 +312,7 @@ bool parse_timezone(const std::string& line, ParseState& state, ParsedTimestamp&
     return parsed.timezone_hour <= 23 && parsed.timezone_minute <= 59;
 }
 
-bool validate_trailing_boundary(const std::string& line, ParseState& state)
+bool validate_trailing_boundary(std::string_view line, ParseState& state)
 {
     if (state.bracketed)
     {
@@ -331,7 +331,7 @@ bool validate_trailing_boundary(const std::string& line, ParseState& state)
 
 } // namespace
 
-std::optional<LogTimePoint> parse_log_timestamp(const std::string& line)
+std::optional<LogTimePoint> parse_log_timestamp(std::string_view line)
 {
     ParseState state;
     ParsedTimestamp parsed;
@@ -2,13 +2,13 @@
 
 #include <chrono>
 #include <optional>
-#include <string>
+#include <string_view>
 
 namespace slayerlog
 {
 
 using LogTimePoint = std::chrono::system_clock::time_point;
 
-std::optional<LogTimePoint> parse_log_timestamp(const std::string& line);
+std::optional<LogTimePoint> parse_log_timestamp(std::string_view line);
 
 } // namespace slayerlog
@@ -1,6 +1,8 @@
 #include "log_view.hpp"
 #include "view_theme.hpp"
 
+#include <ftxui_components/text_width.hpp>
+
 #include <algorithm>
 #include <cstddef>
 #include <string>
@@ -17,28 +19,12 @@ int max_line_width(const std::vector<std::string>& lines)
     int width = 0;
     for (const auto& line : lines)
     {
-        width = std::max(width, static_cast<int>(line.size()));
+        width = std::max(width, text_display_width(line));
     }
 
     return width;
 }
 
-std::vector<std::string> clip_lines_horizontally(std::vector<std::string> lines, int first_visible_col, int viewport_col_count)
-{
-    for (auto& line : lines)
-    {
-        if (first_visible_col >= static_cast<int>(line.size()))
-        {
-            line.clear();
-            continue;
-        }
-
-        line = line.substr(static_cast<std::size_t>(first_visible_col), static_cast<std::size_t>(viewport_col_count));
-    }
-
-    return lines;
-}
-
 // Approximate viewport size for the first render before FTXUI's reflect() has measured
 // the actual box. Breakdown: window border (2) + header (1) + separators (2) + status lines (3).
 // The value 7 slightly underestimates, which is acceptable as a fallback for a single frame.
@@ -76,7 +62,8 @@ ftxui::Element build_filter_status(const LogModel& model)
     const auto hidden_before  = model.hidden_before_line_number();
     const auto hidden_columns = model.hidden_columns();
 
-    if (model.include_filters().empty() && model.exclude_filters().empty() && !hidden_before.has_value() && !hidden_columns.has_value())
+    if (model.include_filters().empty() && model.exclude_filters().empty() && model.field_filters().empty() && model.level_filters().empty() && !hidden_before.has_value() && !hidden_columns.has_value()
+        && !model.collapse_repeats())
     {
         parts.push_back(ftxui::text(" none") | ftxui::color(theme::muted));
         return ftxui::hbox(std::move(parts));
@@ -92,6 +79,16 @@ ftxui::Element build_filter_status(const LogModel& model)
         parts.push_back(ftxui::text(" out(" + join(model.exclude_filters()) + ")"));
     }
 
+    if (!model.level_filters().empty())
+    {
+        parts.push_back(ftxui::text(" level(" + join(model.level_filters()) + ")"));
+    }
+
+    if (!model.field_filters().empty())
+    {
+        parts.push_back(ftxui::text(" fields(" + join(model.field_filters()) + ")"));
+    }
+
     if (hidden_before.has_value())
     {
         parts.push_back(ftxui::text(" | before line " + std::to_string(*hidden_before)) | ftxui::color(theme::muted));
@@ -102,6 +99,11 @@ ftxui::Element build_filter_status(const LogModel& model)
         parts.push_back(ftxui::text(" | columns " + std::to_string(hidden_columns->start) + "-" + std::to_string(hidden_columns->end)) | ftxui::color(theme::muted));
     }
 
+    if (model.collapse_repeats())
+    {
+        parts.push_back(ftxui::text(" | repeats collapsed (" + std::to_string(model.template_count()) + " templates)") | ftxui::color(theme::muted));
+    }
+
     return ftxui::hbox(std::move(parts));
 }
 
@@ -175,7 +177,7 @@ TextViewRenderData build_text_view_data(const LogModel& model, const LogControll
     }
 
     data.total_lines    = model.line_count();
-    data.visible_lines  = clip_lines_horizontally(model.rendered_lines(data.first_visible_line, viewport_line_count), data.first_visible_col, data.viewport_col_count);
+    data.visible_lines  = model.rendered_lines(data.first_visible_line, viewport_line_count, data.first_visible_col, data.viewport_col_count);
     data.max_line_width = model.max_rendered_line_width();
 
     if (hidden_column_preview.has_value())
@@ -215,11 +217,11 @@ TextViewRenderData build_text_view_data(const LogModel& model, const LogControll
             continue;
         }
 
-        const auto rendered_line  = model.rendered_line(line_index);
+        const int line_width      = model.rendered_line_width(line_index);
         const int selection_start = (line_index == selected_range->first.line) ? selected_range->first.column : 0;
-        const int selection_end   = (line_index == selected_range->second.line) ? selected_range->second.column : static_cast<int>(rendered_line.size());
-        const int clamped_start   = std::clamp(selection_start, 0, static_cast<int>(rendered_line.size()));
-        const int clamped_end     = std::clamp(selection_end, clamped_start, static_cast<int>(rendered_line.size()));
+        const int selection_end   = (line_index == selected_range->second.line) ? selected_range->second.column : line_width;
+        const int clamped_start   = std::clamp(selection_start, 0, line_width);
+        const int clamped_end     = std::clamp(selection_end, clamped_start, line_width);
         if (clamped_start == clamped_end)
         {
             continue;
@@ -246,14 +248,14 @@ ftxui::Element LogView::render(const LogModel& model, const LogController& contr
     const int visible_col_count  = std::max(1, _text_view.viewport_col_count());
     auto log_view                = _text_view.render(build_text_view_data(model, controller, visible_line_count, visible_col_count, hidden_column_preview)) | ftxui::flex;
 
-    // Header with optional paused indicator
+    // Header with optional paused or resuming indicator
     ftxui::Element header;
-    if (model.updates_paused())
+    if (model.updates_paused() || model.resume_pending())
     {
         header = ftxui::hbox({
             ftxui::text(header_text) | ftxui::bold,
             ftxui::text(" "),
-            theme::badge("PAUSED", theme::paused_fg),
+            theme::badge(model.updates_paused() ? "PAUSED" : "RESUMING", theme::paused_fg),
         });
     }
     else
@@ -261,6 +263,24 @@ ftxui::Element LogView::render(const LogModel& model, const LogController& contr
         header = ftxui::text(header_text) | ftxui::bold;
     }
 
+    // Held lines are only dropped when even spilling them would break the retention limits, but then the gap must show.
+    if (model.paused_dropped_line_count() > 0)
+    {
+        header = ftxui::hbox({
+            header,
+            ftxui::text(" " + std::to_string(model.paused_dropped_line_count()) + " held lines dropped") | ftxui::color(theme::paused_fg),
+        });
+    }
+
+    if (!controller.clipboard_notice().empty())
+    {
+        header = ftxui::hbox({
+            header,
+            ftxui::filler(),
+            ftxui::text(controller.clipboard_notice()) | ftxui::color(theme::muted),
+        });
+    }
+
     return ftxui::window(ftxui::text("Slayerlog"), ftxui::vbox({
                                                        header,
                                                        ftxui::separator(),
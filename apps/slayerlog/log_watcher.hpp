@@ -1,17 +1,72 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "log_batch.hpp"
+#include "log_timestamp.hpp"
+#include "remote_line_filter.hpp"
+
 namespace slayerlog
 {
 
+/** @brief How far a source has worked through the data that already existed when its current session started. */
+struct CatchUpProgress
+{
+    std::uint64_t backlog_bytes  = 0;
+    std::uint64_t received_bytes = 0;
+    std::chrono::nanoseconds elapsed {0};
+    /** @brief Set when the session refills a gap after a reconnect rather than the initial read. */
+    bool backfill = false;
+    bool complete = false;
+
+    double bytes_per_second() const
+    {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0.0 ? static_cast<double>(received_bytes) / seconds : 0.0;
+    }
+};
+
+/** @brief New lines of one file of a source that fans out over several files; member is empty for single-stream sources. */
+struct MemberLineBatch
+{
+    std::string member;
+    std::vector<std::string> lines;
+    /** @brief Source lines left out before some of the lines, in line order; only sources that filter remotely leave any out. */
+    std::vector<SkippedLines> skipped;
+    /** @brief Set when the lines were read again from an earlier point of the source, so they go back into place rather than after the stored lines. */
+    bool refetched = false;
+    /** @brief Lines sent before that the refetched ones replace, counted back from the newest line of the source. */
+    std::uint64_t replaced_line_count = 0;
+};
+
 class LogWatcher
 {
 public:
     virtual ~LogWatcher() = default;
 
     virtual bool poll(std::vector<std::string>& lines) = 0;
+    /** @brief Keeps the lines of each member file apart so they can be labelled separately; the default wraps poll(). */
+    virtual void poll_members(std::vector<MemberLineBatch>& batches)
+    {
+        MemberLineBatch batch;
+        poll(batch.lines);
+        batches.push_back(std::move(batch));
+    }
+    /** @brief Lines at the start of the source that were skipped on open because the retention limits would evict them anyway. */
+    virtual std::uint64_t skipped_line_count() const { return 0; }
+    /** @brief Timestamp of the first line read after skipping lines on open, when it is known; asked before the first poll. */
+    virtual std::optional<LogTimePoint> resume_timestamp() const { return std::nullopt; }
+    /** @brief Moves a skipping start back until it is no later than timestamp, so sources opened together start at the same time; called before the first poll. */
+    virtual void resume_no_later_than(LogTimePoint) { }
+    /** @brief Returns catch-up progress for sources that can tell their backlog size up front. */
+    virtual std::optional<CatchUpProgress> catch_up_progress() const { return std::nullopt; }
+    /** @brief Lets sources that read over a network drop filtered lines before sending them; local sources ignore it. */
+    virtual void set_remote_filter(const RemoteLineFilter&) { }
 };
 
 } // namespace slayerlog
@@ -2,16 +2,21 @@
 #include <atomic>
 #include <chrono>
 #include <cctype>
+#include <cstdint>
 #include <exception>
+#include <filesystem>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -25,7 +30,11 @@
 #include "command_manager.hpp"
 #include "command_palette_view.hpp"
 #include "debug_log.hpp"
+#include "line_index_cache.hpp"
+#include "watchers/archive_watcher.hpp"
+#include "watchers/command_watcher.hpp"
 #include "watchers/file_watcher.hpp"
+#include "watchers/glob_watcher.hpp"
 #include "log_batch.hpp"
 #include "log_controller.hpp"
 #include "log_source.hpp"
@@ -33,13 +42,25 @@
 #include "log_watcher.hpp"
 #include "master_controller.hpp"
 #include "master_view.hpp"
+#include "performance_hud_view.hpp"
+#include "performance_monitor.hpp"
+#include "pipe_reactor.hpp"
+#include "poll_scheduler.hpp"
+#include "remote_line_filter.hpp"
+#include "timeline_view.hpp"
+#include "view_exporter.hpp"
+#include "watchers/ssh_connection_pool.hpp"
 #include "watchers/ssh_tail_watcher.hpp"
+#include "watchers/stdin_watcher.hpp"
 #include "log_model.hpp"
 #include "settings_store.hpp"
 
 namespace
 {
 
+// Lets a burst of small pipe writes land before waking up, so it is appended and redrawn once.
+constexpr auto pipe_ready_coalesce_delay = std::chrono::milliseconds(2);
+
 /**
  * @brief Joins the source labels into the header text shown in the UI.
  */
@@ -64,7 +85,7 @@ std::string build_header_text(const std::vector<std::string>& labels)
     return output.str();
 }
 
-std::optional<int> parse_positive_line_number(std::string_view text)
+std::optional<std::int64_t> parse_positive_line_number(std::string_view text)
 {
     if (text.empty())
     {
@@ -73,10 +94,10 @@ std::optional<int> parse_positive_line_number(std::string_view text)
 
     const std::string line_text(text);
     std::size_t parsed_length = 0;
-    int line_number           = 0;
+    std::int64_t line_number  = 0;
     try
     {
-        line_number = std::stoi(line_text, &parsed_length);
+        line_number = std::stoll(line_text, &parsed_length);
     }
     catch (const std::exception&)
     {
@@ -108,7 +129,7 @@ std::string trim_text(std::string_view text)
     return std::string(text.substr(start, end - start));
 }
 
-std::optional<int> highest_shown_line_number(const slayerlog::LogModel& model, const slayerlog::LogController& controller, int viewport_line_count)
+std::optional<std::int64_t> highest_shown_line_number(const slayerlog::LogModel& model, const slayerlog::LogController& controller, int viewport_line_count)
 {
     if (model.line_count() == 0)
     {
@@ -138,24 +159,86 @@ bool contains_tracked_source(const std::vector<slayerlog::LogSource>& tracked_so
     return std::any_of(tracked_sources.begin(), tracked_sources.end(), [&](const slayerlog::LogSource& tracked_source) { return slayerlog::same_source(tracked_source, candidate_source); });
 }
 
+/** @brief Labels are needed once lines can come from more than one file, which a single glob source already does. */
+bool shows_source_labels(const std::vector<slayerlog::LogSource>& sources)
+{
+    return sources.size() > 1 || std::any_of(sources.begin(), sources.end(), [](const slayerlog::LogSource& source) { return source.kind == slayerlog::LogSourceKind::FileGlob; });
+}
+
 struct WatchedFile
 {
     slayerlog::LogSource source;
     std::string source_label;
     std::unique_ptr<slayerlog::LogWatcher> watcher;
+    /** @brief Labels of the member files a glob source has reported, so their lines can be dropped when it is closed. */
+    std::set<std::string> member_labels;
 };
 
-std::unique_ptr<slayerlog::LogWatcher> create_watcher_for_source(const slayerlog::LogSource& source)
+/** @brief Shared state handed to every watcher; outlives the watchers created from it. */
+struct WatcherResources
+{
+    slayerlog::PipeReactor reactor;
+    slayerlog::SshConnectionPool ssh_connections;
+    bool remote_filtering = false;
+    /** @brief Piped stdin, detached from the terminal the first time a "-" source is opened. */
+    int standard_input_handle = -1;
+    /** @brief Sidecar line indexes of plain local files; unset with --no-index-cache. */
+    std::optional<slayerlog::LineIndexCache> line_index_cache;
+    std::uint64_t initial_max_lines = 0;
+    std::uint64_t initial_max_bytes = 0;
+};
+
+std::unique_ptr<slayerlog::LogWatcher> create_watcher_for_source(const slayerlog::LogSource& source, WatcherResources& resources)
 {
     if (source.kind == slayerlog::LogSourceKind::SshRemoteFile)
     {
-        return std::make_unique<slayerlog::SshTailWatcher>(source);
+        return std::make_unique<slayerlog::SshTailWatcher>(source, &resources.reactor, &resources.ssh_connections);
+    }
+
+    if (source.kind == slayerlog::LogSourceKind::Command)
+    {
+        return std::make_unique<slayerlog::CommandWatcher>(source.command, &resources.reactor);
+    }
+
+    if (source.kind == slayerlog::LogSourceKind::StandardInput)
+    {
+        if (resources.standard_input_handle < 0)
+        {
+            resources.standard_input_handle = slayerlog::detach_standard_input();
+        }
+
+        return std::make_unique<slayerlog::StdinWatcher>(resources.standard_input_handle, &resources.reactor);
     }
 
-    return std::make_unique<slayerlog::FileWatcher>(source.local_path);
+    if (source.kind == slayerlog::LogSourceKind::FileGlob)
+    {
+        return std::make_unique<slayerlog::GlobWatcher>(source.local_path, &resources.reactor);
+    }
+
+    const bool live_file_compressed = slayerlog::detect_log_compression(source.local_path) != slayerlog::LogCompression::None;
+    if (source.rotated_paths.empty() && !live_file_compressed)
+    {
+        const slayerlog::LineIndexCache* line_index_cache = resources.line_index_cache.has_value() ? &*resources.line_index_cache : nullptr;
+        return std::make_unique<slayerlog::FileWatcher>(source.local_path, slayerlog::FileWatcherOptions {line_index_cache, resources.initial_max_lines, resources.initial_max_bytes});
+    }
+
+    // Rotation chains and compressed files are read once through the archive watcher; a plain live file is tailed afterwards.
+    std::vector<std::string> archive_paths = source.rotated_paths;
+    std::unique_ptr<slayerlog::LogWatcher> live_watcher;
+    std::error_code error_code;
+    if (live_file_compressed)
+    {
+        archive_paths.push_back(source.local_path);
+    }
+    else if (std::filesystem::exists(source.local_path, error_code))
+    {
+        live_watcher = std::make_unique<slayerlog::FileWatcher>(source.local_path);
+    }
+
+    return std::make_unique<slayerlog::ArchiveWatcher>(std::move(archive_paths), std::move(live_watcher), &resources.reactor);
 }
 
-std::vector<WatchedFile> create_file_watchers(const std::vector<slayerlog::LogSource>& sources, const std::vector<std::string>& source_labels)
+std::vector<WatchedFile> create_file_watchers(const std::vector<slayerlog::LogSource>& sources, const std::vector<std::string>& source_labels, WatcherResources& resources)
 {
     std::vector<WatchedFile> watched_files;
     watched_files.reserve(sources.size());
@@ -165,68 +248,200 @@ std::vector<WatchedFile> create_file_watchers(const std::vector<slayerlog::LogSo
         watched_files.push_back(WatchedFile {
             sources[index],
             source_labels[index],
-            create_watcher_for_source(sources[index]),
+            create_watcher_for_source(sources[index], resources),
+            {},
         });
     }
 
     return watched_files;
 }
 
-std::vector<slayerlog::WatcherLineBatch> collect_watcher_batches(std::vector<WatchedFile>& watched_files)
+/**
+ * @brief Moves the sources that skipped lines on open back to the earliest of their start times and returns how many lines they skipped.
+ *
+ * A source starting later would leave a stretch in which only the others show lines. Sources without timestamps are
+ * left alone, since their lines merge in ahead of the timestamped ones anyway.
+ */
+std::uint64_t align_resumed_sources(std::vector<WatchedFile>& watched_files)
 {
-    std::vector<slayerlog::WatcherLineBatch> watcher_batches;
-    watcher_batches.reserve(watched_files.size());
+    std::optional<slayerlog::LogTimePoint> earliest;
+    for (const auto& watched_file : watched_files)
+    {
+        const auto timestamp = watched_file.watcher->resume_timestamp();
+        if (timestamp.has_value() && (!earliest.has_value() || *timestamp < *earliest))
+        {
+            earliest = timestamp;
+        }
+    }
+
+    std::uint64_t skipped_line_count = 0;
+    for (auto& watched_file : watched_files)
+    {
+        if (earliest.has_value())
+        {
+            watched_file.watcher->resume_no_later_than(*earliest);
+        }
+
+        skipped_line_count += watched_file.watcher->skipped_line_count();
+    }
+
+    return skipped_line_count;
+}
+
+void apply_remote_filter(WatchedFile& watched_file, const slayerlog::LogModel& model, const WatcherResources& resources)
+{
+    if (resources.remote_filtering)
+    {
+        watched_file.watcher->set_remote_filter(slayerlog::build_remote_line_filter(model.include_filters(), model.exclude_filters(), watched_file.source_label));
+    }
+}
 
+/** @brief Pushes the literal part of the view filters down to remote sources when remote filtering is enabled. */
+void apply_remote_filters(std::vector<WatchedFile>& watched_files, const slayerlog::LogModel& model, const WatcherResources& resources)
+{
     for (auto& watched_file : watched_files)
     {
-        slayerlog::WatcherLineBatch watcher_batch;
-        watched_file.watcher->poll(watcher_batch);
-        SLAYERLOG_LOG_TRACE("Initial poll source=" << slayerlog::source_display_path(watched_file.source) << " returned_lines=" << watcher_batch.size());
-        watcher_batches.push_back(std::move(watcher_batch));
+        apply_remote_filter(watched_file, model, resources);
     }
+}
+
+/** @brief Lines read from the sources in one pass; a glob source contributes one batch per file, labelled by its relative path. */
+struct PolledBatches
+{
+    std::vector<slayerlog::WatcherLineBatch> batches;
+    std::vector<std::string> labels;
+    std::vector<std::vector<slayerlog::SkippedLines>> skipped_lines;
+    // Lines a source read again from an earlier point, with member set to their label; they go back into place instead of being appended.
+    std::vector<slayerlog::MemberLineBatch> refetched;
+};
 
-    return watcher_batches;
+void poll_watched_file(WatchedFile& watched_file, PolledBatches& polled)
+{
+    std::vector<slayerlog::MemberLineBatch> member_batches;
+    watched_file.watcher->poll_members(member_batches);
+    for (auto& member_batch : member_batches)
+    {
+        if (!member_batch.member.empty())
+        {
+            watched_file.member_labels.insert(member_batch.member);
+        }
+
+        std::string label = member_batch.member.empty() ? watched_file.source_label : std::move(member_batch.member);
+        if (member_batch.refetched)
+        {
+            member_batch.member = std::move(label);
+            polled.refetched.push_back(std::move(member_batch));
+            continue;
+        }
+
+        polled.labels.push_back(std::move(label));
+        polled.batches.push_back(std::move(member_batch.lines));
+        polled.skipped_lines.push_back(std::move(member_batch.skipped));
+    }
 }
 
-void append_batch_to_model(const std::vector<slayerlog::WatcherLineBatch>& watcher_batches, const std::vector<std::string>& source_labels, slayerlog::LogModel& model, ftxui::ScreenInteractive& screen)
+PolledBatches collect_watcher_batches(std::vector<WatchedFile>& watched_files)
 {
-    const auto merged_lines = slayerlog::merge_log_batch(watcher_batches, source_labels);
-    SLAYERLOG_LOG_TRACE("Merging watcher batches watcher_count=" << watcher_batches.size() << " merged_lines=" << merged_lines.size());
+    PolledBatches polled;
+    polled.batches.reserve(watched_files.size());
+    polled.labels.reserve(watched_files.size());
+
+    for (auto& watched_file : watched_files)
+    {
+        const std::size_t first_batch = polled.batches.size();
+        poll_watched_file(watched_file, polled);
+        SLAYERLOG_LOG_TRACE("Initial poll source=" << slayerlog::source_display_path(watched_file.source) << " returned_batches=" << polled.batches.size() - first_batch);
+    }
+
+    return polled;
+}
+
+std::size_t batch_byte_count(const slayerlog::WatcherLineBatch& watcher_batch)
+{
+    std::size_t byte_count = 0;
+    for (const auto& line : watcher_batch)
+    {
+        byte_count += line.size() + 1;
+    }
+
+    return byte_count;
+}
+
+/** @brief Returns true when lines were appended, so the caller can schedule a redraw. */
+bool append_batch_to_model(PolledBatches polled, slayerlog::LogModel& model, slayerlog::PerformanceMonitor& performance_monitor)
+{
+    // Lines read again belong among the stored ones, so they are merged in before anything new is appended after them.
+    for (auto& refetched : polled.refetched)
+    {
+        std::vector<slayerlog::WatcherLineBatch> batches;
+        batches.push_back(std::move(refetched.lines));
+        auto lines = slayerlog::merge_log_batch(std::move(batches), {refetched.member}, {std::move(refetched.skipped)});
+        model.merge_refetched_lines(refetched.member, refetched.replaced_line_count, std::move(lines));
+    }
+
+    std::vector<slayerlog::ObservedLogLine> merged_lines;
+    {
+        const slayerlog::ScopedStageTimer timer(&performance_monitor, slayerlog::PerformanceStage::Merge);
+        merged_lines = slayerlog::merge_log_batch(std::move(polled.batches), polled.labels, polled.skipped_lines);
+    }
+
+    SLAYERLOG_LOG_TRACE("Merging watcher batches batch_count=" << polled.labels.size() << " merged_lines=" << merged_lines.size() << " refetched_batches=" << polled.refetched.size());
     if (merged_lines.empty())
     {
-        return;
+        return !polled.refetched.empty();
     }
 
-    model.append_lines(merged_lines);
+    {
+        const slayerlog::ScopedStageTimer timer(&performance_monitor, slayerlog::PerformanceStage::AppendLines);
+        model.append_lines(std::move(merged_lines));
+    }
 
-    screen.PostEvent(ftxui::Event::Custom);
+    return true;
 }
 
-std::thread start_watcher_thread(int poll_interval_ms, std::vector<WatchedFile>& watched_files, const std::vector<std::string>& source_labels, std::mutex& model_mutex, slayerlog::LogModel& model, ftxui::ScreenInteractive& screen,
-                                 std::atomic<bool>& keep_running)
+std::thread start_watcher_thread(int poll_interval_ms, int max_fps, std::vector<WatchedFile>& watched_files, std::mutex& model_mutex, slayerlog::LogModel& model, ftxui::ScreenInteractive& screen,
+                                 slayerlog::PerformanceMonitor& performance_monitor, slayerlog::PipeReactor& reactor, std::atomic<bool>& keep_running)
 {
     return std::thread(
-        [poll_interval_ms, watched_files = &watched_files, source_labels = &source_labels, model_mutex = &model_mutex, model = &model, screen = &screen, keep_running = &keep_running]
+        [poll_interval_ms, max_fps, watched_files = &watched_files, model_mutex = &model_mutex, model = &model, screen = &screen, performance_monitor = &performance_monitor, reactor = &reactor,
+         keep_running = &keep_running]
         {
+            slayerlog::AdaptivePollInterval poll_interval {std::chrono::milliseconds(poll_interval_ms)};
+            slayerlog::RedrawThrottle redraw_throttle(max_fps);
             while (*keep_running)
             {
-                std::this_thread::sleep_for(std::chrono::milliseconds(poll_interval_ms));
+                // Wake up in time for a redraw that was held back by the frame cap.
+                auto wait = poll_interval.current();
+                if (const auto redraw_due = redraw_throttle.time_until_due())
+                {
+                    wait = std::min(wait, std::chrono::ceil<std::chrono::milliseconds>(*redraw_due));
+                }
+
+                // Pipe-backed sources and glob directories wake the thread as soon as they have output; files are still checked every interval.
+                if (reactor->wait(wait))
+                {
+                    std::this_thread::sleep_for(pipe_ready_coalesce_delay);
+                }
+
                 if (!*keep_running)
                 {
                     break;
                 }
 
                 {
-                    std::lock_guard lock(*model_mutex);
-                    std::vector<slayerlog::WatcherLineBatch> watcher_batches;
-                    watcher_batches.reserve(watched_files->size());
+                    const slayerlog::MonitoredLockGuard lock(*model_mutex, *performance_monitor, slayerlog::LockHolder::Watcher);
+                    PolledBatches polled;
+                    polled.batches.reserve(watched_files->size());
+                    polled.labels.reserve(watched_files->size());
 
-                    for (auto& watched_file : *watched_files)
+                    for (std::size_t source_index = 0; source_index < watched_files->size(); ++source_index)
                     {
-                        slayerlog::WatcherLineBatch watcher_batch;
+                        auto& watched_file                = (*watched_files)[source_index];
+                        const std::size_t first_batch     = polled.batches.size();
+                        const std::size_t first_refetched = polled.refetched.size();
                         try
                         {
-                            watched_file.watcher->poll(watcher_batch);
+                            poll_watched_file(watched_file, polled);
                         }
                         catch (const std::exception& ex)
                         {
@@ -239,52 +454,140 @@ std::thread start_watcher_thread(int poll_interval_ms, std::vector<WatchedFile>&
                             SLAYERLOG_LOG_WARNING("Watcher poll threw for source=" << slayerlog::source_display_path(watched_file.source) << " error=<unknown>");
                         }
 
-                        SLAYERLOG_LOG_TRACE("Live poll source=" << slayerlog::source_display_path(watched_file.source) << " returned_lines=" << watcher_batch.size());
-                        watcher_batches.push_back(std::move(watcher_batch));
+                        std::size_t line_count = 0;
+                        std::size_t byte_count = 0;
+                        for (std::size_t batch_index = first_batch; batch_index < polled.batches.size(); ++batch_index)
+                        {
+                            line_count += polled.batches[batch_index].size();
+                            byte_count += batch_byte_count(polled.batches[batch_index]);
+                        }
+
+                        for (std::size_t batch_index = first_refetched; batch_index < polled.refetched.size(); ++batch_index)
+                        {
+                            line_count += polled.refetched[batch_index].lines.size();
+                            byte_count += batch_byte_count(polled.refetched[batch_index].lines);
+                        }
+
+                        SLAYERLOG_LOG_TRACE("Live poll source=" << slayerlog::source_display_path(watched_file.source) << " returned_lines=" << line_count);
+                        performance_monitor->record_poll(source_index, line_count, byte_count);
+                        if (const auto catch_up = watched_file.watcher->catch_up_progress())
+                        {
+                            performance_monitor->record_catch_up(source_index, *catch_up);
+                        }
                     }
 
-                    append_batch_to_model(watcher_batches, *source_labels, *model, *screen);
+                    bool appended = append_batch_to_model(std::move(polled), *model, *performance_monitor);
+                    // A resume adds the held lines in slices, one per pass, so input keeps being handled in between.
+                    appended = model->drain_paused_updates() || appended;
+                    poll_interval.record_poll(appended);
+                    if (appended ? redraw_throttle.request() : redraw_throttle.take_due())
+                    {
+                        screen->PostEvent(ftxui::Event::Custom);
+                    }
                 }
             }
         });
 }
 
-std::optional<std::string> reload_tracked_sources(std::vector<slayerlog::LogSource> candidate_sources, std::vector<slayerlog::LogSource>& tracked_sources, std::vector<std::string>& source_labels, std::string& header_text,
-                                                  std::vector<WatchedFile>& watched_files, slayerlog::LogModel& model, slayerlog::LogController& controller, ftxui::ScreenInteractive& screen)
+slayerlog::SourceRelabel relabel_from(std::unordered_map<std::string, std::optional<std::string>> relabels)
+{
+    return [relabels = std::move(relabels)](std::string_view source_label)
+    {
+        const auto relabel = relabels.find(std::string(source_label));
+        return relabel == relabels.end() ? std::optional<std::string>(source_label) : relabel->second;
+    };
+}
+
+/** @brief Stores the rebuilt labels; adding or removing a source can change how the others are labelled. */
+void update_source_labels(std::vector<std::string> labels, const std::vector<slayerlog::LogSource>& tracked_sources, std::vector<std::string>& source_labels, std::string& header_text,
+                          std::vector<WatchedFile>& watched_files, slayerlog::LogModel& model, slayerlog::PerformanceMonitor& performance_monitor)
+{
+    source_labels = std::move(labels);
+    header_text   = build_header_text(source_labels);
+    for (std::size_t index = 0; index < watched_files.size(); ++index)
+    {
+        watched_files[index].source_label = source_labels[index];
+    }
+
+    model.set_show_source_labels(shows_source_labels(tracked_sources));
+    performance_monitor.set_sources(source_labels);
+}
+
+/** @brief Starts watching one more source and merges its existing lines into the model by timestamp without re-reading the others. */
+std::optional<std::string> open_tracked_source(const slayerlog::LogSource& candidate_source, std::vector<slayerlog::LogSource>& tracked_sources, std::vector<std::string>& source_labels, std::string& header_text,
+                                               std::vector<WatchedFile>& watched_files, slayerlog::LogModel& model, slayerlog::PerformanceMonitor& performance_monitor, WatcherResources& resources)
 {
+    std::vector<slayerlog::LogSource> candidate_sources = tracked_sources;
+    candidate_sources.push_back(candidate_source);
     auto candidate_source_labels = slayerlog::build_source_labels(candidate_sources);
-    std::string candidate_header = build_header_text(candidate_source_labels);
-    std::vector<WatchedFile> candidate_watchers;
-    std::vector<slayerlog::WatcherLineBatch> candidate_batches;
 
+    WatchedFile watched_file {candidate_source, candidate_source_labels.back(), nullptr, {}};
+    PolledBatches initial_batches;
     try
     {
-        candidate_watchers = create_file_watchers(candidate_sources, candidate_source_labels);
-        candidate_batches  = collect_watcher_batches(candidate_watchers);
+        watched_file.watcher = create_watcher_for_source(candidate_source, resources);
+        apply_remote_filter(watched_file, model, resources);
+        poll_watched_file(watched_file, initial_batches);
     }
     catch (const std::exception& ex)
     {
         return ex.what();
     }
 
-    tracked_sources = std::move(candidate_sources);
-    source_labels   = std::move(candidate_source_labels);
-    header_text     = std::move(candidate_header);
-    watched_files   = std::move(candidate_watchers);
+    std::unordered_map<std::string, std::optional<std::string>> relabels;
+    for (std::size_t index = 0; index < source_labels.size(); ++index)
+    {
+        relabels.emplace(source_labels[index], candidate_source_labels[index]);
+    }
 
-    model.reset();
-    controller.reset();
-    model.set_show_source_labels(tracked_sources.size() > 1);
-    append_batch_to_model(candidate_batches, source_labels, model, screen);
+    std::vector<slayerlog::ObservedLogLine> added_lines;
+    {
+        const slayerlog::ScopedStageTimer timer(&performance_monitor, slayerlog::PerformanceStage::Merge);
+        added_lines = slayerlog::merge_log_batch(std::move(initial_batches.batches), initial_batches.labels, initial_batches.skipped_lines);
+    }
 
+    model.update_sources(std::move(added_lines), relabel_from(std::move(relabels)));
+    tracked_sources = std::move(candidate_sources);
+    watched_files.push_back(std::move(watched_file));
+    update_source_labels(std::move(candidate_source_labels), tracked_sources, source_labels, header_text, watched_files, model, performance_monitor);
+    apply_remote_filters(watched_files, model, resources);
     return std::nullopt;
 }
 
+/** @brief Stops watching a source and drops its lines; the other sources keep their lines, filters and find state without being read again. */
+void close_tracked_source(std::size_t index, std::vector<slayerlog::LogSource>& tracked_sources, std::vector<std::string>& source_labels, std::string& header_text, std::vector<WatchedFile>& watched_files,
+                          slayerlog::LogModel& model, slayerlog::PerformanceMonitor& performance_monitor, const WatcherResources& resources)
+{
+    std::unordered_map<std::string, std::optional<std::string>> relabels;
+    relabels.emplace(source_labels[index], std::nullopt);
+    for (const auto& member_label : watched_files[index].member_labels)
+    {
+        relabels.emplace(member_label, std::nullopt);
+    }
+
+    std::vector<std::string> remaining_labels = source_labels;
+    remaining_labels.erase(remaining_labels.begin() + static_cast<std::ptrdiff_t>(index));
+    tracked_sources.erase(tracked_sources.begin() + static_cast<std::ptrdiff_t>(index));
+    watched_files.erase(watched_files.begin() + static_cast<std::ptrdiff_t>(index));
+
+    auto new_source_labels = slayerlog::build_source_labels(tracked_sources);
+    for (std::size_t remaining_index = 0; remaining_index < remaining_labels.size(); ++remaining_index)
+    {
+        relabels.emplace(remaining_labels[remaining_index], new_source_labels[remaining_index]);
+    }
+
+    model.update_sources({}, relabel_from(std::move(relabels)));
+    update_source_labels(std::move(new_source_labels), tracked_sources, source_labels, header_text, watched_files, model, performance_monitor);
+    apply_remote_filters(watched_files, model, resources);
+}
+
 void register_commands(slayerlog::CommandManager& command_manager, slayerlog::LogModel& model, slayerlog::LogController& controller, std::function<int()> viewport_line_count,
-                       std::function<slayerlog::CommandResult(std::string_view)> open_file_command, std::function<slayerlog::CommandResult()> close_open_file_command)
+                       std::function<slayerlog::CommandResult(std::string_view)> open_file_command, std::function<slayerlog::CommandResult()> close_open_file_command,
+                       std::function<slayerlog::CommandResult()> toggle_performance_hud_command, std::function<slayerlog::CommandResult()> toggle_timeline_command,
+                       std::function<slayerlog::CommandResult(std::string_view, bool)> save_view_command, std::function<void()> filters_changed)
 {
     command_manager.register_command({"filter-in", "Show lines matching text or regex", "filter-in <text|re:regex>"},
-                                     [&](std::string_view arguments)
+                                     [&, filters_changed](std::string_view arguments)
                                      {
                                          if (arguments.empty())
                                          {
@@ -300,11 +603,12 @@ void register_commands(slayerlog::CommandManager& command_manager, slayerlog::Lo
                                              return slayerlog::CommandResult {false, "Invalid filter-in pattern: " + std::string(error.what())};
                                          }
 
+                                         filters_changed();
                                          return slayerlog::CommandResult {true, "Added include filter: " + std::string(arguments)};
                                      });
 
     command_manager.register_command({"filter-out", "Hide lines matching text or regex", "filter-out <text|re:regex>"},
-                                     [&](std::string_view arguments)
+                                     [&, filters_changed](std::string_view arguments)
                                      {
                                          if (arguments.empty())
                                          {
@@ -320,11 +624,54 @@ void register_commands(slayerlog::CommandManager& command_manager, slayerlog::Lo
                                              return slayerlog::CommandResult {false, "Invalid filter-out pattern: " + std::string(error.what())};
                                          }
 
+                                         filters_changed();
                                          return slayerlog::CommandResult {true, "Added exclude filter: " + std::string(arguments)};
                                      });
 
+    command_manager.register_command({"filter-field", "Show JSON lines whose top-level field compares true", "filter-field <field>(=|!=|<|<=|>|>=)<value>"},
+                                     [&, filters_changed](std::string_view arguments)
+                                     {
+                                         if (arguments.empty())
+                                         {
+                                             return slayerlog::CommandResult {false, "Usage: filter-field <field>(=|!=|<|<=|>|>=)<value>"};
+                                         }
+
+                                         try
+                                         {
+                                             model.add_field_filter(std::string(arguments));
+                                         }
+                                         catch (const std::invalid_argument& error)
+                                         {
+                                             return slayerlog::CommandResult {false, "Invalid filter-field: " + std::string(error.what())};
+                                         }
+
+                                         filters_changed();
+                                         return slayerlog::CommandResult {true, "Added field filter: " + std::string(arguments)};
+                                     });
+
+    command_manager.register_command({"filter-level", "Show lines of the given levels; warn+ includes every more severe level", "filter-level <level>[,<level>...]|<level>+"},
+                                     [&, filters_changed](std::string_view arguments)
+                                     {
+                                         if (arguments.empty())
+                                         {
+                                             return slayerlog::CommandResult {false, "Usage: filter-level <level>[,<level>...]|<level>+"};
+                                         }
+
+                                         try
+                                         {
+                                             model.add_level_filter(std::string(arguments));
+                                         }
+                                         catch (const std::invalid_argument& error)
+                                         {
+                                             return slayerlog::CommandResult {false, "Invalid filter-level: " + std::string(error.what())};
+                                         }
+
+                                         filters_changed();
+                                         return slayerlog::CommandResult {true, "Added level filter: " + std::string(arguments)};
+                                     });
+
     command_manager.register_command({"reset-filters", "Clear all active filters", "reset-filters"},
-                                     [&](std::string_view arguments)
+                                     [&, filters_changed](std::string_view arguments)
                                      {
                                          if (!arguments.empty())
                                          {
@@ -332,11 +679,12 @@ void register_commands(slayerlog::CommandManager& command_manager, slayerlog::Lo
                                          }
 
                                          model.reset_filters();
+                                         filters_changed();
                                          return slayerlog::CommandResult {true, "Cleared all filters"};
                                      });
 
     command_manager.register_command({"clear-filters", "Alias for reset-filters", "clear-filters"},
-                                     [&](std::string_view arguments)
+                                     [&, filters_changed](std::string_view arguments)
                                      {
                                          if (!arguments.empty())
                                          {
@@ -344,6 +692,7 @@ void register_commands(slayerlog::CommandManager& command_manager, slayerlog::Lo
                                          }
 
                                          model.reset_filters();
+                                         filters_changed();
                                          return slayerlog::CommandResult {true, "Cleared all filters"};
                                      });
 
@@ -387,7 +736,7 @@ void register_commands(slayerlog::CommandManager& command_manager, slayerlog::Lo
                                          return slayerlog::CommandResult {true, "Cleared hidden column filter"};
                                      });
 
-    command_manager.register_command({"open-file", "Open file and reload all tracked logs", "open-file <path>"},
+    command_manager.register_command({"open-file", "Open a log source next to the tracked ones", "open-file <path>"},
                                      [&, open_file_command](std::string_view arguments)
                                      {
                                          const std::string file_path = trim_text(arguments);
@@ -410,6 +759,57 @@ void register_commands(slayerlog::CommandManager& command_manager, slayerlog::Lo
                                          return close_open_file_command();
                                      });
 
+    command_manager.register_command({"toggle-perf-hud", "Show or hide the performance overlay", "toggle-perf-hud"},
+                                     [toggle_performance_hud_command](std::string_view arguments)
+                                     {
+                                         if (!trim_text(arguments).empty())
+                                         {
+                                             return slayerlog::CommandResult {false, "Usage: toggle-perf-hud"};
+                                         }
+
+                                         return toggle_performance_hud_command();
+                                     });
+
+    command_manager.register_command({"toggle-timeline", "Show or hide the lines-per-second timeline; click it to jump, scroll it to zoom", "toggle-timeline"},
+                                     [toggle_timeline_command](std::string_view arguments)
+                                     {
+                                         if (!trim_text(arguments).empty())
+                                         {
+                                             return slayerlog::CommandResult {false, "Usage: toggle-timeline"};
+                                         }
+
+                                         return toggle_timeline_command();
+                                     });
+
+    command_manager.register_command({"save-view", "Write the lines the view shows to a file", "save-view <path>"},
+                                     [save_view_command](std::string_view arguments)
+                                     {
+                                         const std::string path = trim_text(arguments);
+                                         if (path.empty())
+                                         {
+                                             return slayerlog::CommandResult {false, "Usage: save-view <path>"};
+                                         }
+
+                                         return save_view_command(path, false);
+                                     });
+
+    command_manager.register_command({"save-matches", "Write the visible find matches to a file", "save-matches <path>"},
+                                     [&model, save_view_command](std::string_view arguments)
+                                     {
+                                         const std::string path = trim_text(arguments);
+                                         if (path.empty())
+                                         {
+                                             return slayerlog::CommandResult {false, "Usage: save-matches <path>"};
+                                         }
+
+                                         if (!model.find_active())
+                                         {
+                                             return slayerlog::CommandResult {false, "No active find query"};
+                                         }
+
+                                         return save_view_command(path, true);
+                                     });
+
     command_manager.register_command({"go-to-line", "Center the view on a line number", "go-to-line <line-number>"},
                                      [&, viewport_line_count](std::string_view arguments)
                                      {
@@ -419,11 +819,21 @@ void register_commands(slayerlog::CommandManager& command_manager, slayerlog::Lo
                                              return slayerlog::CommandResult {false, "Usage: go-to-line <line-number>"};
                                          }
 
-                                         if (*line_number > model.total_line_count())
+                                         if (*line_number > model.last_line_number())
                                          {
                                              return slayerlog::CommandResult {false, "Line " + std::to_string(*line_number) + " is out of range"};
                                          }
 
+                                         if (*line_number < model.first_line_number())
+                                         {
+                                             return slayerlog::CommandResult {false, "Line " + std::to_string(*line_number) + " was evicted by the retention limit"};
+                                         }
+
+                                         if (!model.line_number_stored(*line_number))
+                                         {
+                                             return slayerlog::CommandResult {false, "Line " + std::to_string(*line_number) + " was left out by the remote filter"};
+                                         }
+
                                          if (!controller.go_to_line(model, *line_number, viewport_line_count()))
                                          {
                                              return slayerlog::CommandResult {
@@ -438,6 +848,40 @@ void register_commands(slayerlog::CommandManager& command_manager, slayerlog::Lo
                                          };
                                      });
 
+    command_manager.register_command({"collapse-repeats", "Fold runs of lines with the same message template into one row", "collapse-repeats"},
+                                     [&](std::string_view arguments)
+                                     {
+                                         if (!trim_text(arguments).empty())
+                                         {
+                                             return slayerlog::CommandResult {false, "Usage: collapse-repeats"};
+                                         }
+
+                                         model.set_collapse_repeats(!model.collapse_repeats());
+                                         return slayerlog::CommandResult {true, model.collapse_repeats() ? "Repeated lines collapsed" : "Repeated lines shown"};
+                                     });
+
+    command_manager.register_command({"expand-repeats", "Expand or fold again the runs of a line's template", "expand-repeats <line-number>"},
+                                     [&](std::string_view arguments)
+                                     {
+                                         const auto line_number = parse_positive_line_number(arguments);
+                                         if (!line_number.has_value())
+                                         {
+                                             return slayerlog::CommandResult {false, "Usage: expand-repeats <line-number>"};
+                                         }
+
+                                         if (!model.collapse_repeats())
+                                         {
+                                             return slayerlog::CommandResult {false, "Repeated lines are not collapsed"};
+                                         }
+
+                                         if (!model.toggle_repeat_expansion(*line_number))
+                                         {
+                                             return slayerlog::CommandResult {false, "Line " + std::to_string(*line_number) + " is not visible"};
+                                         }
+
+                                         return slayerlog::CommandResult {true, "Toggled repeats of line " + std::to_string(*line_number)};
+                                     });
+
     command_manager.register_command({"hide-before-line", "Hide all raw lines before a line number", "hide-before-line <line-number>"},
                                      [&](std::string_view arguments)
                                      {
@@ -524,7 +968,11 @@ int main(int argc, char** argv)
     std::vector<slayerlog::LogSource> tracked_sources = parse_log_sources(config.file_paths);
     auto source_labels                                = slayerlog::build_source_labels(tracked_sources);
     std::string header_text                           = build_header_text(source_labels);
-    SLAYERLOG_LOG_INFO("Starting slayerlog poll_interval_ms=" << config.poll_interval_ms << " watched_files=" << config.file_paths.size());
+    SLAYERLOG_LOG_INFO("Starting slayerlog poll_interval_ms=" << config.poll_interval_ms << " watched_files=" << config.file_paths.size() << " max_lines=" << config.max_lines
+                                                              << " max_memory_bytes=" << config.max_memory_bytes << " max_paused_memory_bytes=" << config.max_paused_memory_bytes
+                                                              << " cold_storage=" << static_cast<int>(config.cold_storage) << " ssh_compression=" << config.ssh_compression << " remote_filter=" << config.remote_filter
+                                                              << " max_fps=" << config.max_fps << " line_index_cache=" << config.line_index_cache
+                                                              << " max_line_display_bytes=" << config.max_line_display_bytes << " search_prefix_bytes=" << config.search_prefix_bytes);
     for (std::size_t index = 0; index < tracked_sources.size(); ++index)
     {
         SLAYERLOG_LOG_INFO("Configured watcher[" << index << "] source=" << slayerlog::source_display_path(tracked_sources[index]) << " label=" << source_labels[index]);
@@ -534,8 +982,17 @@ int main(int argc, char** argv)
     screen.TrackMouse();
 
     std::mutex model_mutex;
+    slayerlog::PerformanceMonitor performance_monitor;
+    performance_monitor.set_sources(source_labels);
+    bool performance_hud_visible = false;
     slayerlog::LogModel model;
-    model.set_show_source_labels(tracked_sources.size() > 1);
+    model.set_show_source_labels(shows_source_labels(tracked_sources));
+    model.set_performance_monitor(&performance_monitor);
+    model.set_retention_limits(slayerlog::LogRetentionLimits {config.max_lines, config.max_memory_bytes, config.max_paused_memory_bytes});
+    model.set_cold_storage(slayerlog::ColdStorageOptions {config.cold_storage});
+    model.set_long_line_limits(slayerlog::LongLineLimits {config.max_line_display_bytes, config.search_prefix_bytes});
+    model.set_structured_fields(config.json_fields);
+    model.set_level_tokens(config.level_tokens);
 
     slayerlog::SettingsStore settings_store(slayerlog::default_settings_file_path());
     slayerlog::CommandHistory command_history(settings_store);
@@ -549,9 +1006,23 @@ int main(int argc, char** argv)
     slayerlog::CommandManager command_manager;
     slayerlog::LogView view;
     slayerlog::CommandPaletteView command_palette_view;
-    slayerlog::MasterView master_view(view, command_palette_view);
+    slayerlog::PerformanceHudView performance_hud_view;
+    slayerlog::TimelineView timeline_view;
+    slayerlog::MasterView master_view(view, timeline_view, command_palette_view, performance_hud_view);
     slayerlog::LogController controller;
-    auto watched_files = create_file_watchers(tracked_sources, source_labels);
+    slayerlog::ViewExporter view_exporter(model, model_mutex);
+    WatcherResources watcher_resources;
+    watcher_resources.ssh_connections.set_compression(config.ssh_compression);
+    watcher_resources.remote_filtering = config.remote_filter;
+    if (config.line_index_cache)
+    {
+        watcher_resources.line_index_cache.emplace(slayerlog::default_cache_directory() / "line-index");
+    }
+
+    // Retention evicts lines as soon as they exceed a limit, so lines a limit would drop need not be read from an indexed file.
+    watcher_resources.initial_max_lines = config.max_lines;
+    watcher_resources.initial_max_bytes = config.max_memory_bytes;
+    auto watched_files = create_file_watchers(tracked_sources, source_labels, watcher_resources);
 
     slayerlog::CommandPaletteController command_palette_controller(command_palette_model, command_manager, command_history);
 
@@ -574,10 +1045,7 @@ int main(int argc, char** argv)
                 return slayerlog::CommandResult {false, "File already open: " + std::string(file_path)};
             }
 
-            std::vector<slayerlog::LogSource> candidate_sources = tracked_sources;
-            candidate_sources.push_back(candidate_source);
-
-            const auto error = reload_tracked_sources(candidate_sources, tracked_sources, source_labels, header_text, watched_files, model, controller, screen);
+            const auto error = open_tracked_source(candidate_source, tracked_sources, source_labels, header_text, watched_files, model, performance_monitor, watcher_resources);
             if (error.has_value())
             {
                 SLAYERLOG_LOG_ERROR("open-file failed file=" << file_path << " error=" << *error);
@@ -601,29 +1069,51 @@ int main(int argc, char** argv)
                                                                            return slayerlog::CommandResult {false, "Invalid open file selection"};
                                                                        }
 
-                                                                       const std::string closed_label                      = source_labels[selected_index];
-                                                                       std::vector<slayerlog::LogSource> candidate_sources = tracked_sources;
-                                                                       candidate_sources.erase(candidate_sources.begin() + static_cast<std::ptrdiff_t>(selected_index));
-
-                                                                       const auto error = reload_tracked_sources(candidate_sources, tracked_sources, source_labels, header_text, watched_files, model, controller, screen);
-                                                                       if (error.has_value())
-                                                                       {
-                                                                           SLAYERLOG_LOG_ERROR("close-open-file failed selected_index=" << selected_index << " error=" << *error);
-                                                                           return slayerlog::CommandResult {false, *error};
-                                                                       }
-
+                                                                       const std::string closed_label = source_labels[selected_index];
+                                                                       close_tracked_source(selected_index, tracked_sources, source_labels, header_text, watched_files, model, performance_monitor, watcher_resources);
                                                                        return slayerlog::CommandResult {true, "Closed file: " + closed_label};
                                                                    });
 
             return slayerlog::CommandResult {true, "Select a file to close", false};
-        });
+        },
+        [&]()
+        {
+            performance_hud_visible = !performance_hud_visible;
+            return slayerlog::CommandResult {true, performance_hud_visible ? "Performance HUD shown" : "Performance HUD hidden"};
+        },
+        [&]()
+        {
+            timeline_view.toggle_visible();
+            return slayerlog::CommandResult {true, timeline_view.visible() ? "Timeline shown" : "Timeline hidden"};
+        },
+        [&](std::string_view path, bool find_matches_only)
+        {
+            // Commands run with the model locked, so the snapshot of the view is consistent.
+            auto entries             = model.export_entry_indices(find_matches_only);
+            const std::string detail = "Saving " + std::to_string(entries.size()) + " lines to " + std::string(path);
+            try
+            {
+                view_exporter.start(std::filesystem::path(std::string(path)), std::move(entries), [&screen] { screen.PostEvent(ftxui::Event::Custom); });
+            }
+            catch (const std::exception& ex)
+            {
+                return slayerlog::CommandResult {false, ex.what()};
+            }
 
-    slayerlog::MasterController master_controller(model, controller, view, screen, command_palette_controller);
+            return slayerlog::CommandResult {true, detail};
+        },
+        [&] { apply_remote_filters(watched_files, model, watcher_resources); });
+
+    slayerlog::MasterController master_controller(model, controller, view, timeline_view, screen, command_palette_controller);
 
     try
     {
         std::lock_guard lock(model_mutex);
-        append_batch_to_model(collect_watcher_batches(watched_files), source_labels, model, screen);
+        // Line numbers count the lines of every source together; once the sources start at the same time, the lines they skipped come before the ones read,
+        // up to the lines around the shared start.
+        model.skip_line_numbers(align_resumed_sources(watched_files));
+
+        append_batch_to_model(collect_watcher_batches(watched_files), model, performance_monitor);
     }
     catch (const std::exception& ex)
     {
@@ -633,25 +1123,32 @@ int main(int argc, char** argv)
     }
 
     std::atomic<bool> keep_running = true;
-    std::thread watcher_thread     = start_watcher_thread(config.poll_interval_ms, watched_files, source_labels, model_mutex, model, screen, keep_running);
+    std::thread watcher_thread     = start_watcher_thread(config.poll_interval_ms, config.max_fps, watched_files, model_mutex, model, screen, performance_monitor, watcher_resources.reactor, keep_running);
 
     auto viewer = ftxui::Renderer(
         [&]
         {
-            std::lock_guard lock(model_mutex);
-            return master_view.render(model, controller, header_text, screen.dimy(), command_palette_controller.model());
+            const auto frame_start = slayerlog::PerformanceMonitor::Clock::now();
+            const slayerlog::MonitoredLockGuard lock(model_mutex, performance_monitor, slayerlog::LockHolder::Ui);
+            const auto performance_snapshot = performance_hud_visible ? std::optional<slayerlog::PerformanceSnapshot>(performance_monitor.snapshot()) : std::nullopt;
+            const auto export_status        = slayerlog::describe_view_export(view_exporter.progress(), std::chrono::steady_clock::now());
+            const std::string shown_header  = export_status.empty() ? header_text : header_text + " | " + export_status;
+            // Layout and paint run after this returns and the lock is released, so the frame is timed by the element itself.
+            return slayerlog::record_frame_time(master_view.render(model, controller, shown_header, screen.dimy(), command_palette_controller.model(), performance_snapshot), performance_monitor, frame_start);
         });
 
     viewer |= ftxui::CatchEvent(
         [&](ftxui::Event event)
         {
-            std::lock_guard lock(model_mutex);
+            const slayerlog::MonitoredLockGuard lock(model_mutex, performance_monitor, slayerlog::LockHolder::Ui);
             return master_controller.handle_event(event);
         });
 
     screen.Loop(viewer);
     SLAYERLOG_LOG_INFO("Screen loop exited");
+    view_exporter.stop();
     keep_running = false;
+    watcher_resources.reactor.wake();
     if (watcher_thread.joinable())
     {
         watcher_thread.join();
@@ -3,8 +3,9 @@
 namespace slayerlog
 {
 
-MasterController::MasterController(LogModel& model, LogController& log_controller, LogView& log_view, ftxui::ScreenInteractive& screen, CommandPaletteController& command_palette_controller)
-    : _model(model), _log_controller(log_controller), _log_view(log_view), _screen(screen), _command_palette_controller(command_palette_controller)
+MasterController::MasterController(LogModel& model, LogController& log_controller, LogView& log_view, TimelineView& timeline_view, ftxui::ScreenInteractive& screen,
+                                   CommandPaletteController& command_palette_controller)
+    : _model(model), _log_controller(log_controller), _log_view(log_view), _timeline_view(timeline_view), _screen(screen), _command_palette_controller(command_palette_controller)
 {
 }
 
@@ -29,6 +30,15 @@ bool MasterController::handle_event(const ftxui::Event& event)
         return true;
     }
 
+    if (event.is_mouse() && _timeline_view.visible())
+    {
+        auto mouse_event = event;
+        if (handle_timeline_mouse(mouse_event.mouse()))
+        {
+            return true;
+        }
+    }
+
     const auto result = _log_controller.handle_event(_model, event, _log_view.visible_line_count(_screen.dimy()), _log_view.visible_col_count(),
                                                      [this](const ftxui::Mouse& mouse) { return _log_view.mouse_to_text_position(_model, _log_controller, mouse); });
 
@@ -46,4 +56,24 @@ bool MasterController::exit_requested() const
     return _exit_requested;
 }
 
+bool MasterController::handle_timeline_mouse(const ftxui::Mouse& mouse)
+{
+    const auto second = _timeline_view.second_at(mouse);
+    if (!second.has_value())
+    {
+        return false;
+    }
+
+    if (mouse.button == ftxui::Mouse::Left && mouse.motion == ftxui::Mouse::Pressed)
+    {
+        _log_controller.go_to_second(_model, *second, _log_view.visible_line_count(_screen.dimy()));
+    }
+    else if (mouse.button == ftxui::Mouse::WheelUp || mouse.button == ftxui::Mouse::WheelDown)
+    {
+        _timeline_view.zoom(_model.line_rates(), *second, mouse.button == ftxui::Mouse::WheelUp);
+    }
+
+    return true;
+}
+
 } // namespace slayerlog
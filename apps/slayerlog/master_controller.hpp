@@ -7,6 +7,7 @@
 #include "log_controller.hpp"
 #include "log_model.hpp"
 #include "log_view.hpp"
+#include "timeline_view.hpp"
 
 namespace slayerlog
 {
@@ -14,16 +15,20 @@ namespace slayerlog
 class MasterController
 {
 public:
-    MasterController(LogModel& model, LogController& log_controller, LogView& log_view, ftxui::ScreenInteractive& screen,
+    MasterController(LogModel& model, LogController& log_controller, LogView& log_view, TimelineView& timeline_view, ftxui::ScreenInteractive& screen,
                      CommandPaletteController& command_palette_controller);
 
     bool handle_event(const ftxui::Event& event);
     bool exit_requested() const;
 
 private:
+    /** @brief Clicking the timeline jumps to that moment and the wheel zooms it; returns false when the mouse is not over it. */
+    bool handle_timeline_mouse(const ftxui::Mouse& mouse);
+
     LogModel& _model;
     LogController& _log_controller;
     LogView& _log_view;
+    TimelineView& _timeline_view;
     ftxui::ScreenInteractive& _screen;
     CommandPaletteController& _command_palette_controller;
     bool _exit_requested = false;
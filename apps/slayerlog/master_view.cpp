@@ -3,22 +3,45 @@
 namespace slayerlog
 {
 
-MasterView::MasterView(LogView& log_view, CommandPaletteView& command_palette_view) : _log_view(log_view), _command_palette_view(command_palette_view)
+MasterView::MasterView(LogView& log_view, TimelineView& timeline_view, CommandPaletteView& command_palette_view, PerformanceHudView& performance_hud_view)
+    : _log_view(log_view), _timeline_view(timeline_view), _command_palette_view(command_palette_view), _performance_hud_view(performance_hud_view)
 {
 }
 
-ftxui::Element MasterView::render(const LogModel& model, const LogController& controller, const std::string& header_text, int screen_height, const CommandPaletteModel& command_palette) const
+ftxui::Element MasterView::render(const LogModel& model, const LogController& controller, const std::string& header_text, int screen_height, const CommandPaletteModel& command_palette,
+                                  const std::optional<PerformanceSnapshot>& performance_snapshot) const
 {
-    auto base_view = _log_view.render(model, controller, header_text, screen_height, command_palette.hidden_column_preview);
-    if (!command_palette.open)
+    const int timeline_height = _timeline_view.visible() ? TimelineView::row_count : 0;
+    auto base_view            = _log_view.render(model, controller, header_text, screen_height - timeline_height, command_palette.hidden_column_preview);
+    if (_timeline_view.visible())
+    {
+        base_view = ftxui::vbox({_timeline_view.render(model.line_rates()), base_view | ftxui::flex});
+    }
+
+    if (!command_palette.open && !performance_snapshot.has_value())
     {
         return base_view;
     }
 
-    return ftxui::dbox({
-        std::move(base_view),
-        _command_palette_view.render(command_palette),
-    });
+    ftxui::Elements layers;
+    layers.push_back(std::move(base_view));
+    if (performance_snapshot.has_value())
+    {
+        layers.push_back(ftxui::vbox({
+            ftxui::hbox({
+                ftxui::filler(),
+                _performance_hud_view.render(*performance_snapshot, model.memory_usage()),
+            }),
+            ftxui::filler(),
+        }));
+    }
+
+    if (command_palette.open)
+    {
+        layers.push_back(_command_palette_view.render(command_palette));
+    }
+
+    return ftxui::dbox(std::move(layers));
 }
 
 } // namespace slayerlog
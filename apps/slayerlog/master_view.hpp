@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 #include <ftxui/dom/elements.hpp>
@@ -9,6 +10,9 @@
 #include "log_controller.hpp"
 #include "log_model.hpp"
 #include "log_view.hpp"
+#include "performance_hud_view.hpp"
+#include "performance_monitor.hpp"
+#include "timeline_view.hpp"
 
 namespace slayerlog
 {
@@ -16,14 +20,17 @@ namespace slayerlog
 class MasterView
 {
 public:
-    MasterView(LogView& log_view, CommandPaletteView& command_palette_view);
+    MasterView(LogView& log_view, TimelineView& timeline_view, CommandPaletteView& command_palette_view, PerformanceHudView& performance_hud_view);
 
+    /** @brief Renders the log view below the timeline when it is shown, with the command palette and, when a snapshot is given, the performance HUD on top. */
     ftxui::Element render(const LogModel& model, const LogController& controller, const std::string& header_text, int screen_height,
-                          const CommandPaletteModel& command_palette) const;
+                          const CommandPaletteModel& command_palette, const std::optional<PerformanceSnapshot>& performance_snapshot = std::nullopt) const;
 
 private:
     LogView& _log_view;
+    TimelineView& _timeline_view;
     CommandPaletteView& _command_palette_view;
+    PerformanceHudView& _performance_hud_view;
 };
 
 } // namespace slayerlog
@@ -0,0 +1,270 @@
+#include "performance_hud_view.hpp"
+#include "view_theme.hpp"
+
+#include <ftxui/dom/node.hpp>
+#include <ftxui/screen/box.hpp>
+#include <ftxui/screen/screen.hpp>
+
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+class FrameTimerNode : public ftxui::Node
+{
+public:
+    FrameTimerNode(ftxui::Element frame, PerformanceMonitor& monitor, PerformanceMonitor::Clock::time_point frame_start) : Node(ftxui::Elements {std::move(frame)}), _monitor(monitor), _frame_start(frame_start)
+    {
+    }
+
+    void ComputeRequirement() override
+    {
+        Node::ComputeRequirement();
+        requirement_ = children_[0]->requirement();
+    }
+
+    void SetBox(ftxui::Box box) override
+    {
+        Node::SetBox(box);
+        children_[0]->SetBox(box);
+    }
+
+    void Render(ftxui::Screen& screen) override
+    {
+        Node::Render(screen);
+        if (!_recorded)
+        {
+            _recorded = true;
+            _monitor.record_stage(PerformanceStage::FrameRender, PerformanceMonitor::Clock::now() - _frame_start);
+        }
+    }
+
+private:
+    PerformanceMonitor& _monitor;
+    PerformanceMonitor::Clock::time_point _frame_start;
+    bool _recorded = false;
+};
+
+std::string pad_right(std::string text, std::size_t width)
+{
+    if (text.size() < width)
+    {
+        text.append(width - text.size(), ' ');
+    }
+
+    return text;
+}
+
+std::string pad_left(std::string text, std::size_t width)
+{
+    if (text.size() < width)
+    {
+        text.insert(0, width - text.size(), ' ');
+    }
+
+    return text;
+}
+
+std::string truncate_label(std::string label, std::size_t width)
+{
+    if (label.size() > width - 1)
+    {
+        label = label.substr(0, width - 2) + "~";
+    }
+
+    return label;
+}
+
+std::string format_rate(double value)
+{
+    std::ostringstream output;
+    if (value >= 1000000.0)
+    {
+        output << std::fixed << std::setprecision(2) << value / 1000000.0 << "M";
+    }
+    else if (value >= 1000.0)
+    {
+        output << std::fixed << std::setprecision(1) << value / 1000.0 << "k";
+    }
+    else
+    {
+        output << std::fixed << std::setprecision(0) << value;
+    }
+
+    return output.str();
+}
+
+constexpr std::size_t label_column_width = 18;
+constexpr std::size_t value_column_width = 10;
+
+ftxui::Element section_title(const std::string& title)
+{
+    return theme::badge(title, theme::label_filter_fg);
+}
+
+ftxui::Element build_ingest_section(const PerformanceSnapshot& snapshot)
+{
+    ftxui::Elements rows;
+    rows.push_back(section_title("INGEST"));
+    rows.push_back(ftxui::text(pad_right("source", label_column_width) + pad_left("lines/s", value_column_width) + pad_left("bytes/s", value_column_width) + pad_left("last poll", value_column_width)) |
+                   ftxui::color(theme::muted));
+    if (snapshot.sources.empty())
+    {
+        rows.push_back(ftxui::text("no sources") | ftxui::color(theme::muted));
+    }
+
+    for (const auto& source : snapshot.sources)
+    {
+        rows.push_back(ftxui::text(pad_right(truncate_label(source.label, label_column_width), label_column_width) + pad_left(format_rate(source.lines_per_second), value_column_width) +
+                                   pad_left(format_byte_size(static_cast<std::size_t>(source.bytes_per_second)), value_column_width) +
+                                   pad_left(format_byte_size(source.last_poll_bytes), value_column_width)));
+    }
+
+    return ftxui::vbox(std::move(rows));
+}
+
+/** @brief Lists sources that report a backlog; returns nullptr when none does, so the section is omitted. */
+ftxui::Element build_catch_up_section(const PerformanceSnapshot& snapshot)
+{
+    ftxui::Elements rows;
+    for (const auto& source : snapshot.sources)
+    {
+        if (!source.catch_up.has_value())
+        {
+            continue;
+        }
+
+        const auto& progress = *source.catch_up;
+        std::string state    = progress.backfill ? "backfill" : "catch-up";
+        if (progress.complete)
+        {
+            state = "done";
+        }
+
+        rows.push_back(ftxui::text(pad_right(truncate_label(source.label, label_column_width), label_column_width) + pad_left(format_byte_size(progress.received_bytes), value_column_width) +
+                                   pad_left(format_byte_size(progress.backlog_bytes), value_column_width) +
+                                   pad_left(format_byte_size(static_cast<std::size_t>(progress.bytes_per_second())), value_column_width) + pad_left(state, value_column_width)));
+    }
+
+    if (rows.empty())
+    {
+        return nullptr;
+    }
+
+    rows.insert(rows.begin(), {
+                                  section_title("CATCH-UP"),
+                                  ftxui::text(pad_right("source", label_column_width) + pad_left("received", value_column_width) + pad_left("backlog", value_column_width) +
+                                              pad_left("bytes/s", value_column_width) + pad_left("state", value_column_width)) |
+                                      ftxui::color(theme::muted),
+                              });
+    return ftxui::vbox(std::move(rows));
+}
+
+ftxui::Element build_stage_section(const PerformanceSnapshot& snapshot)
+{
+    ftxui::Elements rows;
+    rows.push_back(section_title("STAGES"));
+    rows.push_back(ftxui::text(pad_right("stage", label_column_width) + pad_left("last", value_column_width) + pad_left("avg", value_column_width) + pad_left("max", value_column_width) +
+                               pad_left("count/s", value_column_width)) |
+                   ftxui::color(theme::muted));
+
+    for (std::size_t index = 0; index < performance_stage_count; ++index)
+    {
+        const auto stage   = static_cast<PerformanceStage>(index);
+        const auto& timing = snapshot.stage(stage);
+        rows.push_back(ftxui::text(pad_right(performance_stage_name(stage), label_column_width) + pad_left(format_stage_duration(timing.last), value_column_width) +
+                                   pad_left(format_stage_duration(timing.average), value_column_width) + pad_left(format_stage_duration(timing.max), value_column_width) +
+                                   pad_left(std::to_string(timing.samples), value_column_width)));
+    }
+
+    return ftxui::vbox(std::move(rows));
+}
+
+ftxui::Element build_memory_section(const LogModelMemoryUsage& memory_usage)
+{
+    const auto row = [](const std::string& label, const std::string& count, std::size_t bytes)
+    { return ftxui::text(pad_right(label, label_column_width) + pad_left(count, value_column_width) + pad_left(format_byte_size(bytes), value_column_width)); };
+
+    return ftxui::vbox({
+        section_title("MEMORY"),
+        row("entries", std::to_string(memory_usage.entry_count), memory_usage.entry_bytes),
+        row("visible index", "", memory_usage.visible_index_bytes),
+        row("find index", "", memory_usage.find_index_bytes),
+        row("field columns", "", memory_usage.field_column_bytes),
+        row("level index", "", memory_usage.level_index_bytes),
+        row("timeline", "", memory_usage.timeline_bytes),
+        row("templates", "", memory_usage.template_bytes),
+        row("paused buffer", std::to_string(memory_usage.paused_entry_count), memory_usage.paused_bytes),
+        ftxui::text(pad_right("paused dropped", label_column_width) + pad_left(std::to_string(memory_usage.paused_dropped_entry_count), value_column_width)) | ftxui::color(theme::muted),
+        row("spilled", "", memory_usage.spilled_bytes) | ftxui::color(theme::muted),
+        ftxui::text(pad_right("evicted", label_column_width) + pad_left(std::to_string(memory_usage.evicted_entry_count), value_column_width)) | ftxui::color(theme::muted),
+        row("total", "", memory_usage.total_bytes()) | ftxui::bold,
+    });
+}
+
+} // namespace
+
+std::string format_byte_size(std::size_t bytes)
+{
+    constexpr const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+
+    double value           = static_cast<double>(bytes);
+    std::size_t unit_index = 0;
+    while (value >= 1024.0 && unit_index + 1 < std::size(units))
+    {
+        value /= 1024.0;
+        ++unit_index;
+    }
+
+    std::ostringstream output;
+    output << std::fixed << std::setprecision(unit_index == 0 ? 0 : 1) << value << " " << units[unit_index];
+    return output.str();
+}
+
+std::string format_stage_duration(std::chrono::nanoseconds duration)
+{
+    std::ostringstream output;
+    const auto microseconds = std::chrono::duration<double, std::micro>(duration).count();
+    if (microseconds < 1000.0)
+    {
+        output << std::fixed << std::setprecision(0) << microseconds << " us";
+    }
+    else if (microseconds < 1000000.0)
+    {
+        output << std::fixed << std::setprecision(2) << microseconds / 1000.0 << " ms";
+    }
+    else
+    {
+        output << std::fixed << std::setprecision(2) << microseconds / 1000000.0 << " s";
+    }
+
+    return output.str();
+}
+
+ftxui::Element record_frame_time(ftxui::Element frame, PerformanceMonitor& monitor, PerformanceMonitor::Clock::time_point frame_start)
+{
+    return std::make_shared<FrameTimerNode>(std::move(frame), monitor, frame_start);
+}
+
+ftxui::Element PerformanceHudView::render(const PerformanceSnapshot& snapshot, const LogModelMemoryUsage& memory_usage) const
+{
+    ftxui::Elements sections = {build_ingest_section(snapshot), ftxui::separator()};
+    if (auto catch_up_section = build_catch_up_section(snapshot))
+    {
+        sections.push_back(std::move(catch_up_section));
+        sections.push_back(ftxui::separator());
+    }
+
+    sections.push_back(build_stage_section(snapshot));
+    sections.push_back(ftxui::separator());
+    sections.push_back(build_memory_section(memory_usage));
+    return ftxui::clear_under(ftxui::window(ftxui::text("Performance"), ftxui::vbox(std::move(sections))));
+}
+
+} // namespace slayerlog
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include <ftxui/dom/elements.hpp>
+
+#include "log_model.hpp"
+#include "performance_monitor.hpp"
+
+namespace slayerlog
+{
+
+std::string format_byte_size(std::size_t bytes);
+std::string format_stage_duration(std::chrono::nanoseconds duration);
+
+/**
+ * @brief Wraps a frame so it records the frame render stage once FTXUI has laid it out and painted it.
+ *
+ * The sample runs from frame_start, taken before the frame's elements are built, so it covers building, layout and paint.
+ */
+ftxui::Element record_frame_time(ftxui::Element frame, PerformanceMonitor& monitor, PerformanceMonitor::Clock::time_point frame_start);
+
+class PerformanceHudView
+{
+public:
+    ftxui::Element render(const PerformanceSnapshot& snapshot, const LogModelMemoryUsage& memory_usage) const;
+};
+
+} // namespace slayerlog
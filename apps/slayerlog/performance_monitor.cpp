@@ -0,0 +1,165 @@
+#include "performance_monitor.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace slayerlog
+{
+
+const char* performance_stage_name(PerformanceStage stage)
+{
+    switch (stage)
+    {
+    case PerformanceStage::Merge:
+        return "merge";
+    case PerformanceStage::AppendLines:
+        return "append_lines";
+    case PerformanceStage::FilterRebuild:
+        return "filter rebuild";
+    case PerformanceStage::FindRebuild:
+        return "find rebuild";
+    case PerformanceStage::FrameRender:
+        return "frame render";
+    case PerformanceStage::WatcherLockWait:
+        return "watcher lock wait";
+    case PerformanceStage::WatcherLockHold:
+        return "watcher lock hold";
+    case PerformanceStage::UiLockWait:
+        return "ui lock wait";
+    case PerformanceStage::UiLockHold:
+        return "ui lock hold";
+    case PerformanceStage::Count:
+        break;
+    }
+
+    return "unknown";
+}
+
+PerformanceMonitor::PerformanceMonitor(std::function<Clock::time_point()> now, std::chrono::nanoseconds window) : _now(std::move(now)), _window(window), _window_start(_now())
+{
+}
+
+void PerformanceMonitor::set_sources(const std::vector<std::string>& source_labels)
+{
+    std::lock_guard lock(_mutex);
+    _source_windows.assign(source_labels.size(), SourceWindow {});
+    _published_sources.clear();
+    _published_sources.reserve(source_labels.size());
+    for (const auto& label : source_labels)
+    {
+        SourceIngestStats stats;
+        stats.label = label;
+        _published_sources.push_back(std::move(stats));
+    }
+}
+
+void PerformanceMonitor::record_poll(std::size_t source_index, std::size_t line_count, std::size_t byte_count)
+{
+    std::lock_guard lock(_mutex);
+    roll_window_if_due(_now());
+    if (source_index >= _source_windows.size())
+    {
+        return;
+    }
+
+    _source_windows[source_index].lines += line_count;
+    _source_windows[source_index].bytes += byte_count;
+    _published_sources[source_index].last_poll_bytes = byte_count;
+    _published_sources[source_index].total_lines += line_count;
+}
+
+void PerformanceMonitor::record_catch_up(std::size_t source_index, const CatchUpProgress& progress)
+{
+    std::lock_guard lock(_mutex);
+    if (source_index < _published_sources.size())
+    {
+        _published_sources[source_index].catch_up = progress;
+    }
+}
+
+void PerformanceMonitor::record_stage(PerformanceStage stage, std::chrono::nanoseconds duration)
+{
+    const auto index = static_cast<std::size_t>(stage);
+    std::lock_guard lock(_mutex);
+    roll_window_if_due(_now());
+
+    auto& window = _stage_windows[index];
+    window.total += duration;
+    window.max = std::max(window.max, duration);
+    ++window.samples;
+    _published_stages[index].last = duration;
+}
+
+PerformanceSnapshot PerformanceMonitor::snapshot()
+{
+    std::lock_guard lock(_mutex);
+    roll_window_if_due(_now());
+
+    PerformanceSnapshot snapshot;
+    snapshot.sources = _published_sources;
+    snapshot.stages  = _published_stages;
+    return snapshot;
+}
+
+void PerformanceMonitor::roll_window_if_due(Clock::time_point now)
+{
+    const auto elapsed = now - _window_start;
+    if (elapsed < _window)
+    {
+        return;
+    }
+
+    // Rates divide by the real elapsed time so an idle gap spanning several windows reads as zero, not as a burst.
+    const double elapsed_seconds = std::chrono::duration<double>(elapsed).count();
+    for (std::size_t index = 0; index < _source_windows.size(); ++index)
+    {
+        _published_sources[index].lines_per_second = static_cast<double>(_source_windows[index].lines) / elapsed_seconds;
+        _published_sources[index].bytes_per_second = static_cast<double>(_source_windows[index].bytes) / elapsed_seconds;
+        _source_windows[index]                     = SourceWindow {};
+    }
+
+    for (std::size_t index = 0; index < performance_stage_count; ++index)
+    {
+        auto& window    = _stage_windows[index];
+        auto& published = _published_stages[index];
+        published.average = window.samples == 0 ? std::chrono::nanoseconds(0) : window.total / static_cast<std::int64_t>(window.samples);
+        published.max     = window.max;
+        published.samples = window.samples;
+        window            = StageWindow {};
+    }
+
+    _window_start = now;
+}
+
+ScopedStageTimer::ScopedStageTimer(PerformanceMonitor* monitor, PerformanceStage stage) : _monitor(monitor), _stage(stage)
+{
+    if (_monitor != nullptr)
+    {
+        _start = PerformanceMonitor::Clock::now();
+    }
+}
+
+ScopedStageTimer::~ScopedStageTimer()
+{
+    if (_monitor != nullptr)
+    {
+        _monitor->record_stage(_stage, PerformanceMonitor::Clock::now() - _start);
+    }
+}
+
+MonitoredLockGuard::MonitoredLockGuard(std::mutex& mutex, PerformanceMonitor& monitor, LockHolder holder) : _mutex(mutex), _monitor(monitor), _holder(holder)
+{
+    const auto requested = PerformanceMonitor::Clock::now();
+    _mutex.lock();
+    _acquired = PerformanceMonitor::Clock::now();
+    _monitor.record_stage(_holder == LockHolder::Watcher ? PerformanceStage::WatcherLockWait : PerformanceStage::UiLockWait, _acquired - requested);
+}
+
+MonitoredLockGuard::~MonitoredLockGuard()
+{
+    const auto held = PerformanceMonitor::Clock::now() - _acquired;
+    _mutex.unlock();
+    _monitor.record_stage(_holder == LockHolder::Watcher ? PerformanceStage::WatcherLockHold : PerformanceStage::UiLockHold, held);
+}
+
+} // namespace slayerlog
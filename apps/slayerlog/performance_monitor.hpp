@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "log_watcher.hpp"
+
+namespace slayerlog
+{
+
+enum class PerformanceStage
+{
+    Merge,
+    AppendLines,
+    FilterRebuild,
+    FindRebuild,
+    FrameRender,
+    WatcherLockWait,
+    WatcherLockHold,
+    UiLockWait,
+    UiLockHold,
+    Count,
+};
+
+/** @brief Thread that takes the model lock, so waits and holds show which side keeps the other waiting. */
+enum class LockHolder
+{
+    Watcher,
+    Ui,
+};
+
+constexpr std::size_t performance_stage_count = static_cast<std::size_t>(PerformanceStage::Count);
+
+const char* performance_stage_name(PerformanceStage stage);
+
+struct StageTiming
+{
+    std::chrono::nanoseconds last {0};
+    std::chrono::nanoseconds average {0};
+    std::chrono::nanoseconds max {0};
+    std::uint64_t samples = 0;
+};
+
+struct SourceIngestStats
+{
+    std::string label;
+    double lines_per_second     = 0.0;
+    double bytes_per_second     = 0.0;
+    std::size_t last_poll_bytes = 0;
+    std::uint64_t total_lines   = 0;
+    std::optional<CatchUpProgress> catch_up;
+};
+
+/** @brief Values of the last completed measurement window; `last` fields are always the most recent sample. */
+struct PerformanceSnapshot
+{
+    std::vector<SourceIngestStats> sources;
+    std::array<StageTiming, performance_stage_count> stages {};
+
+    const StageTiming& stage(PerformanceStage stage) const { return stages[static_cast<std::size_t>(stage)]; }
+};
+
+/**
+ * @brief Thread-safe collector for the per-stage timings and ingest rates shown in the performance HUD.
+ *
+ * Samples are aggregated into fixed windows so the HUD shows stable per-second numbers instead of
+ * jittering with every poll.
+ */
+class PerformanceMonitor
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit PerformanceMonitor(std::function<Clock::time_point()> now = Clock::now, std::chrono::nanoseconds window = std::chrono::seconds(1));
+
+    /** @brief Replaces the tracked sources; ingest statistics restart from zero. */
+    void set_sources(const std::vector<std::string>& source_labels);
+    void record_poll(std::size_t source_index, std::size_t line_count, std::size_t byte_count);
+    void record_catch_up(std::size_t source_index, const CatchUpProgress& progress);
+    void record_stage(PerformanceStage stage, std::chrono::nanoseconds duration);
+
+    PerformanceSnapshot snapshot();
+
+private:
+    struct StageWindow
+    {
+        std::chrono::nanoseconds total {0};
+        std::chrono::nanoseconds max {0};
+        std::uint64_t samples = 0;
+    };
+
+    struct SourceWindow
+    {
+        std::uint64_t lines = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    void roll_window_if_due(Clock::time_point now);
+
+    std::function<Clock::time_point()> _now;
+    std::chrono::nanoseconds _window;
+    std::mutex _mutex;
+    Clock::time_point _window_start;
+
+    std::array<StageWindow, performance_stage_count> _stage_windows {};
+    std::array<StageTiming, performance_stage_count> _published_stages {};
+    std::vector<SourceWindow> _source_windows;
+    std::vector<SourceIngestStats> _published_sources;
+};
+
+/** @brief Records the lifetime of a scope as one sample of a stage; a null monitor disables timing. */
+class ScopedStageTimer
+{
+public:
+    ScopedStageTimer(PerformanceMonitor* monitor, PerformanceStage stage);
+    ~ScopedStageTimer();
+
+    ScopedStageTimer(const ScopedStageTimer&)            = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    PerformanceMonitor* _monitor;
+    PerformanceStage _stage;
+    PerformanceMonitor::Clock::time_point _start;
+};
+
+/** @brief Lock guard that reports how long its thread waited for the mutex and how long it held it. */
+class MonitoredLockGuard
+{
+public:
+    MonitoredLockGuard(std::mutex& mutex, PerformanceMonitor& monitor, LockHolder holder);
+    ~MonitoredLockGuard();
+
+    MonitoredLockGuard(const MonitoredLockGuard&)            = delete;
+    MonitoredLockGuard& operator=(const MonitoredLockGuard&) = delete;
+
+private:
+    std::mutex& _mutex;
+    PerformanceMonitor& _monitor;
+    LockHolder _holder;
+    PerformanceMonitor::Clock::time_point _acquired;
+};
+
+} // namespace slayerlog
@@ -0,0 +1,126 @@
+#include "pipe_reactor.hpp"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef __linux__
+#    include <cerrno>
+#    include <sys/epoll.h>
+#    include <sys/eventfd.h>
+#    include <unistd.h>
+#endif
+
+namespace slayerlog
+{
+
+#ifdef __linux__
+
+namespace
+{
+
+void close_if_valid(int& handle) noexcept
+{
+    if (handle >= 0)
+    {
+        ::close(handle);
+    }
+
+    handle = -1;
+}
+
+} // namespace
+
+PipeReactor::PipeReactor()
+{
+    _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    _wake_fd  = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (_epoll_fd < 0 || _wake_fd < 0)
+    {
+        close_if_valid(_wake_fd);
+        close_if_valid(_epoll_fd);
+        throw std::runtime_error("Failed to create pipe reactor");
+    }
+
+    add(_wake_fd);
+}
+
+PipeReactor::~PipeReactor()
+{
+    close_if_valid(_wake_fd);
+    close_if_valid(_epoll_fd);
+}
+
+void PipeReactor::add(int handle)
+{
+    epoll_event event {};
+    event.events  = EPOLLIN;
+    event.data.fd = handle;
+    if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, handle, &event) != 0 && errno != EEXIST)
+    {
+        throw std::runtime_error("epoll_ctl(EPOLL_CTL_ADD) failed");
+    }
+}
+
+void PipeReactor::remove(int handle)
+{
+    ::epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, handle, nullptr);
+}
+
+bool PipeReactor::wait(std::chrono::milliseconds timeout)
+{
+    std::array<epoll_event, 16> events {};
+    const int ready_count = ::epoll_wait(_epoll_fd, events.data(), static_cast<int>(events.size()), static_cast<int>(timeout.count()));
+    for (int index = 0; index < ready_count; ++index)
+    {
+        if (events[static_cast<std::size_t>(index)].data.fd == _wake_fd)
+        {
+            std::uint64_t wake_count = 0;
+            [[maybe_unused]] const auto bytes_read = ::read(_wake_fd, &wake_count, sizeof(wake_count));
+        }
+    }
+
+    return ready_count > 0;
+}
+
+void PipeReactor::wake()
+{
+    const std::uint64_t increment = 1;
+
+    [[maybe_unused]] const auto bytes_written = ::write(_wake_fd, &increment, sizeof(increment));
+}
+
+#else
+
+PipeReactor::PipeReactor()  = default;
+PipeReactor::~PipeReactor() = default;
+
+void PipeReactor::add(int)
+{
+}
+
+void PipeReactor::remove(int)
+{
+}
+
+bool PipeReactor::wait(std::chrono::milliseconds timeout)
+{
+    std::unique_lock lock(_mutex);
+    const bool woken = _condition.wait_for(lock, timeout, [this] { return _woken; });
+    _woken           = false;
+    return woken;
+}
+
+void PipeReactor::wake()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _woken = true;
+    }
+
+    _condition.notify_all();
+}
+
+#endif
+
+} // namespace slayerlog
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace slayerlog
+{
+
+/**
+ * @brief Lets the watcher thread sleep until a registered pipe becomes readable instead of waking on a fixed tick.
+ *
+ * Linux uses level-triggered epoll plus an eventfd for wake(); elsewhere add() and remove() are no-ops and wait()
+ * is a timed sleep that only wake() can cut short, which matches the previous interval polling.
+ */
+class PipeReactor
+{
+public:
+    PipeReactor();
+    ~PipeReactor();
+
+    PipeReactor(const PipeReactor&)            = delete;
+    PipeReactor& operator=(const PipeReactor&) = delete;
+
+    void add(int handle);
+    /** @brief Safe to call for handles that were never added or were already removed. */
+    void remove(int handle);
+    /** @brief Returns true when a registered pipe is readable or wake() was called before the timeout elapsed. */
+    bool wait(std::chrono::milliseconds timeout);
+    void wake();
+
+private:
+#ifdef __linux__
+    int _epoll_fd = -1;
+    int _wake_fd  = -1;
+#else
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _woken = false;
+#endif
+};
+
+} // namespace slayerlog
@@ -0,0 +1,72 @@
+#include "poll_scheduler.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace slayerlog
+{
+
+AdaptivePollInterval::AdaptivePollInterval(std::chrono::milliseconds idle_interval, std::chrono::milliseconds active_interval)
+    : _idle_interval(std::max(idle_interval, std::chrono::milliseconds(1))), _active_interval(std::clamp(active_interval, std::chrono::milliseconds(1), _idle_interval)), _current(_idle_interval)
+{
+}
+
+std::chrono::milliseconds AdaptivePollInterval::current() const
+{
+    return _current;
+}
+
+void AdaptivePollInterval::record_poll(bool produced_lines)
+{
+    _current = produced_lines ? _active_interval : std::min(_current * 2, _idle_interval);
+}
+
+RedrawThrottle::RedrawThrottle(int max_fps, std::function<Clock::time_point()> now)
+    : _now(std::move(now))
+{
+    if (max_fps > 0)
+    {
+        _frame_interval = std::chrono::nanoseconds(std::chrono::seconds(1)) / max_fps;
+    }
+}
+
+bool RedrawThrottle::request()
+{
+    _pending = true;
+    return take_due();
+}
+
+bool RedrawThrottle::take_due()
+{
+    if (!_pending)
+    {
+        return false;
+    }
+
+    const auto now = _now();
+    if (_last_redraw.has_value() && now - *_last_redraw < _frame_interval)
+    {
+        return false;
+    }
+
+    _pending     = false;
+    _last_redraw = now;
+    return true;
+}
+
+std::optional<std::chrono::nanoseconds> RedrawThrottle::time_until_due() const
+{
+    if (!_pending)
+    {
+        return std::nullopt;
+    }
+
+    if (!_last_redraw.has_value())
+    {
+        return std::chrono::nanoseconds(0);
+    }
+
+    return std::max(std::chrono::nanoseconds(0), _frame_interval - (_now() - *_last_redraw));
+}
+
+} // namespace slayerlog
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <optional>
+
+namespace slayerlog
+{
+
+/**
+ * @brief Wait between watcher polls: short while sources keep producing lines, doubling back up to the configured interval once they go quiet.
+ *
+ * Pipe-backed and glob sources wake the watcher thread through the PipeReactor anyway; this mainly shortens the delay for plain
+ * files that are being written to without polling idle files more often.
+ */
+class AdaptivePollInterval
+{
+public:
+    static constexpr std::chrono::milliseconds default_active_interval {20};
+
+    explicit AdaptivePollInterval(std::chrono::milliseconds idle_interval, std::chrono::milliseconds active_interval = default_active_interval);
+
+    std::chrono::milliseconds current() const;
+    void record_poll(bool produced_lines);
+
+private:
+    std::chrono::milliseconds _idle_interval;
+    std::chrono::milliseconds _active_interval;
+    std::chrono::milliseconds _current;
+};
+
+/**
+ * @brief Caps how often new lines trigger a redraw; requests inside one frame are folded into a single redraw at the frame boundary.
+ *
+ * Input events still redraw immediately, since FTXUI handles them without going through this throttle.
+ */
+class RedrawThrottle
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief max_fps of 0 disables the cap, so every request redraws. */
+    explicit RedrawThrottle(int max_fps, std::function<Clock::time_point()> now = Clock::now);
+
+    /** @brief Returns true when the caller should redraw now; otherwise the redraw stays pending until take_due() returns true. */
+    bool request();
+    /** @brief Returns true and clears the pending redraw once its frame is due. */
+    bool take_due();
+    /** @brief Returns how long until the pending redraw is due, or nullopt when nothing is pending. */
+    std::optional<std::chrono::nanoseconds> time_until_due() const;
+
+private:
+    std::function<Clock::time_point()> _now;
+    std::chrono::nanoseconds _frame_interval {0};
+    std::optional<Clock::time_point> _last_redraw;
+    bool _pending = false;
+};
+
+} // namespace slayerlog
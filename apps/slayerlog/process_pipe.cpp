@@ -1,4 +1,5 @@
 #include "process_pipe.hpp"
+#include "pipe_reactor.hpp"
 
 #include <algorithm>
 #include <stdexcept>
@@ -190,7 +191,7 @@ void set_nonblocking(int handle)
 
 } // namespace
 
-ProcessPipe::ProcessPipe(std::string executable, std::vector<std::string> arguments)
+ProcessPipe::ProcessPipe(std::string executable, std::vector<std::string> arguments, PipeReactor* reactor) : _reactor(reactor)
 {
 #ifdef _WIN32
     SECURITY_ATTRIBUTES security_attributes {};
@@ -274,6 +275,15 @@ ProcessPipe::ProcessPipe(std::string executable, std::vector<std::string> argume
 
     if (_pid == 0)
     {
+        // A group of its own lets terminate() reach every process of a shell pipeline; stdin stays with the UI.
+        ::setpgid(0, 0);
+        const int null_fd = ::open("/dev/null", O_RDONLY);
+        if (null_fd >= 0)
+        {
+            ::dup2(null_fd, STDIN_FILENO);
+            ::close(null_fd);
+        }
+
         ::dup2(stdout_pipe[1], STDOUT_FILENO);
         ::dup2(stderr_pipe[1], STDERR_FILENO);
         ::close(stdout_pipe[0]);
@@ -294,12 +304,19 @@ ProcessPipe::ProcessPipe(std::string executable, std::vector<std::string> argume
         _exit(127);
     }
 
+    // Also set from the parent so an early terminate() cannot race the child's own setpgid().
+    ::setpgid(_pid, _pid);
     _stdout_read_fd = stdout_pipe[0];
     _stderr_read_fd = stderr_pipe[0];
     ::close(stdout_pipe[1]);
     ::close(stderr_pipe[1]);
     set_nonblocking(_stdout_read_fd);
     set_nonblocking(_stderr_read_fd);
+    if (_reactor != nullptr)
+    {
+        _reactor->add(_stdout_read_fd);
+        _reactor->add(_stderr_read_fd);
+    }
 #endif
 }
 
@@ -338,8 +355,10 @@ ProcessPipe& ProcessPipe::operator=(ProcessPipe&& other) noexcept
     other._stdout_read_fd = -1;
     other._stderr_read_fd = -1;
 #endif
-    _waited    = other._waited;
-    _exit_code = other._exit_code;
+    _reactor       = other._reactor;
+    _waited        = other._waited;
+    _exit_code     = other._exit_code;
+    other._reactor = nullptr;
     return *this;
 }
 
@@ -348,7 +367,14 @@ std::size_t ProcessPipe::read_stdout(char* buffer, std::size_t buffer_size, bool
 #ifdef _WIN32
     return read_from_handle(static_cast<HANDLE>(_stdout_read_handle), buffer, buffer_size, end_of_stream);
 #else
-    return read_from_handle(_stdout_read_fd, buffer, buffer_size, end_of_stream);
+    const std::size_t bytes_read = read_from_handle(_stdout_read_fd, buffer, buffer_size, end_of_stream);
+    if (end_of_stream)
+    {
+        // A closed pipe stays readable forever; drop it so the reactor does not spin on it.
+        unregister_handle(_stdout_read_fd);
+    }
+
+    return bytes_read;
 #endif
 }
 
@@ -357,7 +383,13 @@ std::size_t ProcessPipe::read_stderr(char* buffer, std::size_t buffer_size, bool
 #ifdef _WIN32
     return read_from_handle(static_cast<HANDLE>(_stderr_read_handle), buffer, buffer_size, end_of_stream);
 #else
-    return read_from_handle(_stderr_read_fd, buffer, buffer_size, end_of_stream);
+    const std::size_t bytes_read = read_from_handle(_stderr_read_fd, buffer, buffer_size, end_of_stream);
+    if (end_of_stream)
+    {
+        unregister_handle(_stderr_read_fd);
+    }
+
+    return bytes_read;
 #endif
 }
 
@@ -435,12 +467,13 @@ void ProcessPipe::terminate()
 #else
     if (_pid > 0)
     {
+        ::kill(-_pid, SIGTERM);
         ::kill(_pid, SIGTERM);
     }
 #endif
 }
 
-void ProcessPipe::close()
+void ProcessPipe::close_output()
 {
 #ifdef _WIN32
     HANDLE stdout_handle = static_cast<HANDLE>(_stdout_read_handle);
@@ -450,7 +483,18 @@ void ProcessPipe::close()
     HANDLE stderr_handle = static_cast<HANDLE>(_stderr_read_handle);
     close_handle_if_valid(stderr_handle);
     _stderr_read_handle = nullptr;
+#else
+    unregister_handle(_stdout_read_fd);
+    unregister_handle(_stderr_read_fd);
+    close_handle_if_valid(_stdout_read_fd);
+    close_handle_if_valid(_stderr_read_fd);
+#endif
+}
 
+void ProcessPipe::close()
+{
+    close_output();
+#ifdef _WIN32
     HANDLE thread_handle = static_cast<HANDLE>(_thread_handle);
     close_handle_if_valid(thread_handle);
     _thread_handle = nullptr;
@@ -468,8 +512,6 @@ void ProcessPipe::close()
         _process_handle = nullptr;
     }
 #else
-    close_handle_if_valid(_stdout_read_fd);
-    close_handle_if_valid(_stderr_read_fd);
     if (_pid > 0)
     {
         if (!_waited)
@@ -482,4 +524,16 @@ void ProcessPipe::close()
 #endif
 }
 
+#ifndef _WIN32
+
+void ProcessPipe::unregister_handle(int handle)
+{
+    if (_reactor != nullptr && handle >= 0)
+    {
+        _reactor->remove(handle);
+    }
+}
+
+#endif
+
 } // namespace slayerlog
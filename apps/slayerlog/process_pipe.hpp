@@ -7,10 +7,13 @@
 namespace slayerlog
 {
 
+class PipeReactor;
+
 class ProcessPipe
 {
 public:
-    ProcessPipe(std::string executable, std::vector<std::string> arguments);
+    /** @brief Registers the output pipes with reactor, when given, so the watcher thread wakes as soon as output arrives. */
+    ProcessPipe(std::string executable, std::vector<std::string> arguments, PipeReactor* reactor = nullptr);
     ~ProcessPipe();
 
     ProcessPipe(const ProcessPipe&)            = delete;
@@ -24,9 +27,18 @@ public:
     bool running();
     int wait();
     void terminate();
+    /**
+     * @brief Removes both output pipes from the reactor and closes them; no reads may follow.
+     *
+     * A process that exited may leave the pipes open through a child of its own, which would keep them readable forever.
+     */
+    void close_output();
 
 private:
     void close();
+#ifndef _WIN32
+    void unregister_handle(int handle);
+#endif
 
 #ifdef _WIN32
     void* _process_handle     = nullptr;
@@ -38,8 +50,9 @@ private:
     int _stdout_read_fd = -1;
     int _stderr_read_fd = -1;
 #endif
-    bool _waited   = false;
-    int _exit_code = 0;
+    PipeReactor* _reactor = nullptr;
+    bool _waited          = false;
+    int _exit_code        = 0;
 };
 
 } // namespace slayerlog
@@ -0,0 +1,60 @@
+#include "remote_line_filter.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+bool is_literal_filter(const std::string& filter_text)
+{
+    return filter_text.rfind("re:", 0) != 0 && filter_text.find('\n') == std::string::npos;
+}
+
+bool contains_one_of(std::string_view text, const std::vector<std::string>& literals)
+{
+    return std::any_of(literals.begin(), literals.end(), [text](const std::string& literal) { return text.find(literal) != std::string_view::npos; });
+}
+
+} // namespace
+
+RemoteLineFilter build_remote_line_filter(const std::vector<std::string>& include_filters, const std::vector<std::string>& exclude_filters, std::string_view source_label)
+{
+    RemoteLineFilter filter;
+
+    // Filters also match the source label, so an include filter found there already admits every line of this source.
+    const bool includes_pushable = std::all_of(include_filters.begin(), include_filters.end(),
+                                               [&](const std::string& filter_text) { return is_literal_filter(filter_text) && source_label.find(filter_text) == std::string_view::npos; });
+    if (!include_filters.empty() && includes_pushable)
+    {
+        filter.include_literals = include_filters;
+        return filter;
+    }
+
+    std::copy_if(exclude_filters.begin(), exclude_filters.end(), std::back_inserter(filter.exclude_literals), is_literal_filter);
+    return filter;
+}
+
+bool remote_line_filter_covers(const RemoteLineFilter& filter, const RemoteLineFilter& other)
+{
+    if (filter.empty())
+    {
+        return true;
+    }
+
+    if (!filter.include_literals.empty())
+    {
+        // Every line other sends contains one of its include literals, and so one of filter's.
+        return !other.include_literals.empty()
+               && std::all_of(other.include_literals.begin(), other.include_literals.end(), [&](const std::string& literal) { return contains_one_of(literal, filter.include_literals); });
+    }
+
+    // A line containing one of filter's exclude literals then contains one of other's, so other never sent it either.
+    return other.include_literals.empty()
+           && std::all_of(filter.exclude_literals.begin(), filter.exclude_literals.end(), [&](const std::string& literal) { return contains_one_of(literal, other.exclude_literals); });
+}
+
+} // namespace slayerlog
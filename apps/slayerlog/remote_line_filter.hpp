@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace slayerlog
+{
+
+/** @brief Literal filters a remote source applies before sending lines; an empty filter sends everything. */
+struct RemoteLineFilter
+{
+    std::vector<std::string> include_literals;
+    std::vector<std::string> exclude_literals;
+
+    bool empty() const { return include_literals.empty() && exclude_literals.empty(); }
+};
+
+inline bool operator==(const RemoteLineFilter& lhs, const RemoteLineFilter& rhs)
+{
+    return lhs.include_literals == rhs.include_literals && lhs.exclude_literals == rhs.exclude_literals;
+}
+
+inline bool operator!=(const RemoteLineFilter& lhs, const RemoteLineFilter& rhs)
+{
+    return !(lhs == rhs);
+}
+
+/**
+ * @brief Derives the part of the view filters a remote source can safely apply itself.
+ *
+ * The result never drops a line the local filters would show: regex filters stay local, include filters are pushed
+ * only when all of them are literals that cannot match the source label, and exclude filters are pushed only when no
+ * include filter is, because a single remote grep stage can express one of the two.
+ */
+RemoteLineFilter build_remote_line_filter(const std::vector<std::string>& include_filters, const std::vector<std::string>& exclude_filters, std::string_view source_label);
+
+/**
+ * @brief Returns true when filter is known to send every line other sends, so switching from filter to other needs nothing read again.
+ *
+ * Like the remote grep, a filter with include literals ignores its exclude literals. Only what the literals prove
+ * counts, such as each include literal of other containing one of filter's.
+ */
+bool remote_line_filter_covers(const RemoteLineFilter& filter, const RemoteLineFilter& other);
+
+} // namespace slayerlog
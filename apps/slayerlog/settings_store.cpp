@@ -86,6 +86,39 @@ std::filesystem::path default_settings_file_path()
     return fallback_settings_file_path();
 }
 
+std::filesystem::path default_cache_directory()
+{
+#ifdef _WIN32
+    const std::string local_app_data = env_value("LOCALAPPDATA");
+    if (!local_app_data.empty())
+    {
+        return std::filesystem::path(local_app_data) / "slayerlog" / "cache";
+    }
+#elif defined(__APPLE__)
+    const std::string home = env_value("HOME");
+    if (!home.empty())
+    {
+        return std::filesystem::path(home) / "Library" / "Caches" / "slayerlog";
+    }
+#else
+    const std::string xdg_cache_home = env_value("XDG_CACHE_HOME");
+    if (!xdg_cache_home.empty())
+    {
+        return std::filesystem::path(xdg_cache_home) / "slayerlog";
+    }
+
+    const std::string home = env_value("HOME");
+    if (!home.empty())
+    {
+        return std::filesystem::path(home) / ".cache" / "slayerlog";
+    }
+#endif
+
+    std::error_code error_code;
+    const auto temp_directory = std::filesystem::temp_directory_path(error_code);
+    return error_code ? std::filesystem::path("slayerlog_cache") : temp_directory / "slayerlog_cache";
+}
+
 SettingsStore::SettingsStore(std::filesystem::path file_path) : _file_path(std::move(file_path))
 {
 }
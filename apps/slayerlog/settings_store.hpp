@@ -9,6 +9,8 @@ namespace slayerlog
 {
 
 std::filesystem::path default_settings_file_path();
+/** @brief Directory for data that can be rebuilt at any time, such as the sidecar line indexes. */
+std::filesystem::path default_cache_directory();
 
 class SettingsStore
 {
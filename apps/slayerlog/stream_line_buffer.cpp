@@ -1,5 +1,7 @@
 #include "stream_line_buffer.hpp"
 
+#include <utility>
+
 namespace slayerlog
 {
 
@@ -17,16 +19,26 @@ std::size_t StreamLineBuffer::append(std::string_view chunk, std::vector<std::st
             break;
         }
 
-        _pending_fragment.append(chunk.substr(start, newline - start));
-        std::string line = _pending_fragment;
-        if (!line.empty() && line.back() == '\r')
+        // Only a line that started in an earlier chunk goes through _pending_fragment; the rest are built straight from the chunk.
+        std::string line;
+        if (_pending_fragment.empty())
+        {
+            line.assign(chunk.substr(start, newline - start));
+        }
+        else
+        {
+            _pending_fragment.append(chunk.substr(start, newline - start));
+            line = std::move(_pending_fragment);
+            _pending_fragment.clear();
+        }
+
+        committed_bytes += line.size() + 1;
+        if (!_keep_carriage_returns && !line.empty() && line.back() == '\r')
         {
             line.pop_back();
         }
 
         lines.push_back(std::move(line));
-        committed_bytes += _pending_fragment.size() + 1;
-        _pending_fragment.clear();
         start = newline + 1;
     }
 
@@ -38,9 +50,35 @@ void StreamLineBuffer::discard_pending_fragment()
     _pending_fragment.clear();
 }
 
+void StreamLineBuffer::flush_pending_fragment(std::vector<std::string>& lines)
+{
+    if (_pending_fragment.empty())
+    {
+        return;
+    }
+
+    if (!_keep_carriage_returns && _pending_fragment.back() == '\r')
+    {
+        _pending_fragment.pop_back();
+    }
+
+    lines.push_back(std::move(_pending_fragment));
+    _pending_fragment.clear();
+}
+
 bool StreamLineBuffer::has_pending_fragment() const noexcept
 {
     return !_pending_fragment.empty();
 }
 
+std::size_t StreamLineBuffer::pending_fragment_size() const noexcept
+{
+    return _pending_fragment.size();
+}
+
+void StreamLineBuffer::set_keep_carriage_returns(bool keep_carriage_returns) noexcept
+{
+    _keep_carriage_returns = keep_carriage_returns;
+}
+
 } // namespace slayerlog
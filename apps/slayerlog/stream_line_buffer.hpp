@@ -13,10 +13,16 @@ class StreamLineBuffer
 public:
     std::size_t append(std::string_view chunk, std::vector<std::string>& lines);
     void discard_pending_fragment();
+    /** @brief Emits an unterminated trailing line, e.g. at the end of a file that lacks a final newline. */
+    void flush_pending_fragment(std::vector<std::string>& lines);
     bool has_pending_fragment() const noexcept;
+    std::size_t pending_fragment_size() const noexcept;
+    /** @brief Keeps the '\r' of CRLF line ends, for callers that need the raw length of each line. */
+    void set_keep_carriage_returns(bool keep_carriage_returns) noexcept;
 
 private:
     std::string _pending_fragment;
+    bool _keep_carriage_returns = false;
 };
 
 } // namespace slayerlog
@@ -0,0 +1,602 @@
+#include "structured_fields.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+// Dictionaries of high-cardinality fields such as trace ids are rebuilt once most of their strings belong to evicted rows.
+constexpr std::size_t dictionary_compaction_slack = 1024;
+
+class JsonCursor
+{
+public:
+    explicit JsonCursor(std::string_view text)
+        : _text(text)
+    {
+    }
+
+    void skip_whitespace()
+    {
+        while (_position < _text.size() && std::isspace(static_cast<unsigned char>(_text[_position])) != 0)
+        {
+            ++_position;
+        }
+    }
+
+    bool at_end() const { return _position >= _text.size(); }
+
+    char peek() const { return at_end() ? '\0' : _text[_position]; }
+
+    bool consume(char expected)
+    {
+        skip_whitespace();
+        if (peek() != expected)
+        {
+            return false;
+        }
+
+        ++_position;
+        return true;
+    }
+
+    bool read_string(std::string& output)
+    {
+        output.clear();
+        if (peek() != '"')
+        {
+            return false;
+        }
+
+        ++_position;
+        while (!at_end())
+        {
+            const char character = _text[_position++];
+            if (character == '"')
+            {
+                return true;
+            }
+
+            if (character != '\\')
+            {
+                output.push_back(character);
+                continue;
+            }
+
+            if (at_end())
+            {
+                return false;
+            }
+
+            const char escaped = _text[_position++];
+            switch (escaped)
+            {
+            case 'b':
+                output.push_back('\b');
+                break;
+            case 'f':
+                output.push_back('\f');
+                break;
+            case 'n':
+                output.push_back('\n');
+                break;
+            case 'r':
+                output.push_back('\r');
+                break;
+            case 't':
+                output.push_back('\t');
+                break;
+            case 'u':
+                if (!read_unicode_escape(output))
+                {
+                    return false;
+                }
+                break;
+            default:
+                output.push_back(escaped);
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    /** @brief Reads a number or true/false/null literal up to the next delimiter. */
+    std::string_view read_literal()
+    {
+        const std::size_t start = _position;
+        while (!at_end() && _text[_position] != ',' && _text[_position] != '}' && _text[_position] != ']' && std::isspace(static_cast<unsigned char>(_text[_position])) == 0)
+        {
+            ++_position;
+        }
+
+        return _text.substr(start, _position - start);
+    }
+
+    bool skip_nested()
+    {
+        int depth = 0;
+        std::string ignored;
+        while (!at_end())
+        {
+            const char character = peek();
+            if (character == '"')
+            {
+                if (!read_string(ignored))
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            ++_position;
+            if (character == '{' || character == '[')
+            {
+                ++depth;
+            }
+            else if ((character == '}' || character == ']') && --depth == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    bool read_hex4(unsigned& value)
+    {
+        if (_position + 4 > _text.size())
+        {
+            return false;
+        }
+
+        value = 0;
+        for (int digit = 0; digit < 4; ++digit)
+        {
+            const char character = _text[_position++];
+            value <<= 4;
+            if (character >= '0' && character <= '9')
+            {
+                value |= static_cast<unsigned>(character - '0');
+            }
+            else if (character >= 'a' && character <= 'f')
+            {
+                value |= static_cast<unsigned>(character - 'a' + 10);
+            }
+            else if (character >= 'A' && character <= 'F')
+            {
+                value |= static_cast<unsigned>(character - 'A' + 10);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool read_unicode_escape(std::string& output)
+    {
+        unsigned code_point = 0;
+        if (!read_hex4(code_point))
+        {
+            return false;
+        }
+
+        if (code_point >= 0xD800 && code_point <= 0xDBFF && _text.substr(_position, 2) == "\\u")
+        {
+            _position += 2;
+            unsigned low = 0;
+            if (!read_hex4(low))
+            {
+                return false;
+            }
+
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        }
+
+        if (code_point < 0x80)
+        {
+            output.push_back(static_cast<char>(code_point));
+        }
+        else if (code_point < 0x800)
+        {
+            output.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else if (code_point < 0x10000)
+        {
+            output.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+            output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+        else
+        {
+            output.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+            output.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+            output.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+        }
+
+        return true;
+    }
+
+    std::string_view _text;
+    std::size_t _position = 0;
+};
+
+std::optional<double> parse_number(std::string_view text)
+{
+    if (text.empty() || (text.front() != '-' && text.front() != '+' && text.front() != '.' && std::isdigit(static_cast<unsigned char>(text.front())) == 0))
+    {
+        return std::nullopt;
+    }
+
+    const std::string buffer(text);
+    char* end          = nullptr;
+    const double value = std::strtod(buffer.c_str(), &end);
+    if (end != buffer.c_str() + buffer.size() || !std::isfinite(value))
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())) != 0)
+    {
+        text.remove_prefix(1);
+    }
+
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())) != 0)
+    {
+        text.remove_suffix(1);
+    }
+
+    return text;
+}
+
+} // namespace
+
+bool extract_json_fields(std::string_view line, const std::vector<std::string>& names, std::vector<std::optional<JsonScalar>>& values)
+{
+    values.assign(names.size(), std::nullopt);
+
+    JsonCursor cursor(line);
+    if (!cursor.consume('{'))
+    {
+        return false;
+    }
+
+    std::string key;
+    while (true)
+    {
+        cursor.skip_whitespace();
+        if (cursor.peek() == '}' || !cursor.read_string(key) || !cursor.consume(':'))
+        {
+            return true;
+        }
+
+        cursor.skip_whitespace();
+        const auto name = std::find(names.begin(), names.end(), key);
+        const char first = cursor.peek();
+        if (first == '{' || first == '[')
+        {
+            if (!cursor.skip_nested())
+            {
+                return true;
+            }
+        }
+        else if (first == '"')
+        {
+            std::string text;
+            if (!cursor.read_string(text))
+            {
+                return true;
+            }
+
+            if (name != names.end())
+            {
+                values[static_cast<std::size_t>(name - names.begin())] = JsonScalar {std::move(text), std::nullopt};
+            }
+        }
+        else
+        {
+            const auto literal = cursor.read_literal();
+            if (literal.empty())
+            {
+                return true;
+            }
+
+            if (name != names.end())
+            {
+                values[static_cast<std::size_t>(name - names.begin())] = JsonScalar {std::string(literal), parse_number(literal)};
+            }
+        }
+
+        if (!cursor.consume(','))
+        {
+            return true;
+        }
+    }
+}
+
+FieldFilter parse_field_filter(std::string_view text)
+{
+    struct Operator
+    {
+        std::string_view token;
+        FieldComparison comparison;
+    };
+
+    // Two-character operators first, so ">=" is not read as ">" followed by "=value".
+    constexpr Operator operators[] = {
+        {">=", FieldComparison::GreaterOrEqual},
+        {"<=", FieldComparison::LessOrEqual},
+        {"!=", FieldComparison::NotEqual},
+        {"=", FieldComparison::Equal},
+        {">", FieldComparison::Greater},
+        {"<", FieldComparison::Less},
+    };
+
+    const std::string_view trimmed = trim(text);
+    std::size_t operator_position  = std::string_view::npos;
+    const Operator* found          = nullptr;
+    for (const auto& candidate : operators)
+    {
+        const auto position = trimmed.find(candidate.token);
+        if (position != std::string_view::npos && (position < operator_position || (position == operator_position && found != nullptr && candidate.token.size() > found->token.size())))
+        {
+            operator_position = position;
+            found             = &candidate;
+        }
+    }
+
+    if (found == nullptr)
+    {
+        throw std::invalid_argument("Expected <field><op><value> with one of =, !=, <, <=, >, >=");
+    }
+
+    FieldFilter filter;
+    filter.text       = std::string(trimmed);
+    filter.field      = std::string(trim(trimmed.substr(0, operator_position)));
+    filter.comparison = found->comparison;
+    auto operand      = trim(trimmed.substr(operator_position + found->token.size()));
+    if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"')
+    {
+        operand = operand.substr(1, operand.size() - 2);
+    }
+
+    filter.operand = std::string(operand);
+    filter.number  = parse_number(operand);
+    if (filter.field.empty() || filter.operand.empty())
+    {
+        throw std::invalid_argument("Field name and value must not be empty");
+    }
+
+    if (filter.comparison != FieldComparison::Equal && filter.comparison != FieldComparison::NotEqual && !filter.number.has_value())
+    {
+        throw std::invalid_argument("Ordering comparisons need a numeric value");
+    }
+
+    return filter;
+}
+
+bool StructuredFields::add_fields(const std::vector<std::string>& names)
+{
+    bool added = false;
+    for (const auto& name : names)
+    {
+        const bool known = std::any_of(_columns.begin(), _columns.end(), [&](const Column& column) { return column.name == name; });
+        if (!known && !name.empty())
+        {
+            _columns.push_back(Column {name, {}, {}, {}, {}, 0});
+            _field_names.push_back(name);
+            added = true;
+        }
+    }
+
+    return added;
+}
+
+const std::vector<std::string>& StructuredFields::field_names() const
+{
+    return _field_names;
+}
+
+bool StructuredFields::enabled() const
+{
+    return !_columns.empty();
+}
+
+void StructuredFields::append(std::string_view line)
+{
+    if (_columns.empty())
+    {
+        return;
+    }
+
+    extract_json_fields(line, _field_names, _scratch_values);
+    for (std::size_t index = 0; index < _columns.size(); ++index)
+    {
+        auto& column      = _columns[index];
+        const auto& value = _scratch_values[index];
+        column.text_ids.push_back(value.has_value() ? intern(column, value->text) : missing_id);
+        column.numbers.push_back(value.has_value() && value->number.has_value() ? *value->number : std::numeric_limits<double>::quiet_NaN());
+    }
+}
+
+void StructuredFields::clear_rows()
+{
+    for (auto& column : _columns)
+    {
+        column.text_ids.clear();
+        column.numbers.clear();
+        column.dictionary.clear();
+        column.ids.clear();
+        column.dictionary_bytes = 0;
+    }
+
+    compile_filters();
+}
+
+void StructuredFields::erase_front(std::size_t count)
+{
+    bool compacted = false;
+    for (auto& column : _columns)
+    {
+        const auto erased = static_cast<std::ptrdiff_t>(std::min(count, column.text_ids.size()));
+        column.text_ids.erase(column.text_ids.begin(), column.text_ids.begin() + erased);
+        column.numbers.erase(column.numbers.begin(), column.numbers.begin() + erased);
+        if (column.dictionary.size() > 2 * column.text_ids.size() + dictionary_compaction_slack)
+        {
+            compact_dictionary(column);
+            compacted = true;
+        }
+    }
+
+    if (compacted)
+    {
+        compile_filters();
+    }
+}
+
+std::size_t StructuredFields::row_count() const
+{
+    return _columns.empty() ? 0 : _columns.front().text_ids.size();
+}
+
+bool StructuredFields::add_filter(FieldFilter filter)
+{
+    const bool added = add_fields({filter.field});
+    _filter_texts.push_back(filter.text);
+    _filters.push_back(std::move(filter));
+    compile_filters();
+    return added;
+}
+
+void StructuredFields::clear_filters()
+{
+    _filters.clear();
+    _filter_texts.clear();
+    _compiled_filters.clear();
+}
+
+const std::vector<std::string>& StructuredFields::filter_texts() const
+{
+    return _filter_texts;
+}
+
+bool StructuredFields::has_filters() const
+{
+    return !_compiled_filters.empty();
+}
+
+bool StructuredFields::matches_filters(std::size_t row) const
+{
+    return std::all_of(_compiled_filters.begin(), _compiled_filters.end(), [&](const CompiledFilter& filter) { return matches(filter, row); });
+}
+
+std::size_t StructuredFields::memory_bytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& column : _columns)
+    {
+        bytes += column.text_ids.size() * (sizeof(std::uint32_t) + sizeof(double));
+        bytes += column.dictionary.capacity() * sizeof(std::string) + column.dictionary_bytes;
+        bytes += column.ids.size() * (sizeof(std::string) + sizeof(std::uint32_t) + sizeof(void*) * 2) + column.dictionary_bytes;
+    }
+
+    return bytes;
+}
+
+std::uint32_t StructuredFields::intern(Column& column, const std::string& text)
+{
+    const auto existing = column.ids.find(text);
+    if (existing != column.ids.end())
+    {
+        return existing->second;
+    }
+
+    column.dictionary.push_back(text);
+    column.dictionary_bytes += text.size();
+    const auto id = static_cast<std::uint32_t>(column.dictionary.size());
+    column.ids.emplace(text, id);
+    return id;
+}
+
+void StructuredFields::compact_dictionary(Column& column)
+{
+    std::vector<std::string> old_dictionary = std::move(column.dictionary);
+    column.dictionary.clear();
+    column.ids.clear();
+    column.dictionary_bytes = 0;
+    for (auto& text_id : column.text_ids)
+    {
+        if (text_id != missing_id)
+        {
+            text_id = intern(column, old_dictionary[text_id - 1]);
+        }
+    }
+}
+
+void StructuredFields::compile_filters()
+{
+    _compiled_filters.clear();
+    for (const auto& filter : _filters)
+    {
+        const auto column = std::find_if(_columns.begin(), _columns.end(), [&](const Column& candidate) { return candidate.name == filter.field; });
+        CompiledFilter compiled;
+        compiled.column     = static_cast<std::size_t>(column - _columns.begin());
+        compiled.comparison = filter.comparison;
+        compiled.number     = filter.number;
+        // An operand no row has yet still gets an id, so rows appended later compare equal to it.
+        compiled.text_id = intern(*column, filter.operand);
+        _compiled_filters.push_back(compiled);
+    }
+}
+
+bool StructuredFields::matches(const CompiledFilter& filter, std::size_t row) const
+{
+    const auto& column = _columns[filter.column];
+    if (row >= column.text_ids.size() || column.text_ids[row] == missing_id)
+    {
+        return false;
+    }
+
+    const double value = column.numbers[row];
+    const bool numeric = filter.number.has_value() && !std::isnan(value);
+    switch (filter.comparison)
+    {
+    case FieldComparison::Equal:
+        return numeric ? value == *filter.number : column.text_ids[row] == filter.text_id;
+    case FieldComparison::NotEqual:
+        return numeric ? value != *filter.number : column.text_ids[row] != filter.text_id;
+    case FieldComparison::Less:
+        return numeric && value < *filter.number;
+    case FieldComparison::LessOrEqual:
+        return numeric && value <= *filter.number;
+    case FieldComparison::Greater:
+        return numeric && value > *filter.number;
+    case FieldComparison::GreaterOrEqual:
+        return numeric && value >= *filter.number;
+    }
+
+    return false;
+}
+
+} // namespace slayerlog
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace slayerlog
+{
+
+/** @brief A top-level scalar of a JSON line: strings unescaped, numbers also parsed, true/false/null kept as their literal. */
+struct JsonScalar
+{
+    std::string text;
+    std::optional<double> number;
+};
+
+/**
+ * @brief Reads the top-level fields listed in names from a JSON object line; nested objects and arrays are skipped.
+ *
+ * values gets one entry per name, empty when the field is missing or not a scalar. Returns false when the line is not a
+ * JSON object, which is checked on the first character so plain text lines cost almost nothing.
+ */
+bool extract_json_fields(std::string_view line, const std::vector<std::string>& names, std::vector<std::optional<JsonScalar>>& values);
+
+enum class FieldComparison
+{
+    Equal,
+    NotEqual,
+    Less,
+    LessOrEqual,
+    Greater,
+    GreaterOrEqual,
+};
+
+/** @brief A parsed "field=value", "field!=value" or numeric "field>value" style filter. */
+struct FieldFilter
+{
+    std::string text;
+    std::string field;
+    FieldComparison comparison = FieldComparison::Equal;
+    std::string operand;
+    std::optional<double> number;
+};
+
+/** @brief Throws std::invalid_argument when text is not a field, a comparison and a value; ordering comparisons need a numeric value. */
+FieldFilter parse_field_filter(std::string_view text);
+
+/**
+ * @brief JSON fields of the stored lines in typed columns, one row per line, and the field filters evaluated against them.
+ *
+ * Each column keeps a number per row and a dictionary id for the text, so equality is an integer compare and ordering a
+ * double compare instead of a regex over the raw line. Rows line up with the line store and are dropped from the front
+ * when it evicts.
+ */
+class StructuredFields
+{
+public:
+    /** @brief Adds a column per name not extracted yet; returns true when one was added, after which the rows must be rebuilt. */
+    bool add_fields(const std::vector<std::string>& names);
+    const std::vector<std::string>& field_names() const;
+    bool enabled() const;
+
+    void append(std::string_view line);
+    void clear_rows();
+    void erase_front(std::size_t count);
+    std::size_t row_count() const;
+
+    /** @brief Adds a filter, extracting its field if needed; returns true when the field is new and the rows must be rebuilt. */
+    bool add_filter(FieldFilter filter);
+    void clear_filters();
+    const std::vector<std::string>& filter_texts() const;
+    bool has_filters() const;
+    bool matches_filters(std::size_t row) const;
+
+    std::size_t memory_bytes() const;
+
+private:
+    static constexpr std::uint32_t missing_id = 0;
+
+    struct Column
+    {
+        std::string name;
+        std::deque<std::uint32_t> text_ids;
+        std::deque<double> numbers;
+        std::vector<std::string> dictionary;
+        std::unordered_map<std::string, std::uint32_t> ids;
+        std::size_t dictionary_bytes = 0;
+    };
+
+    struct CompiledFilter
+    {
+        std::size_t column         = 0;
+        FieldComparison comparison = FieldComparison::Equal;
+        std::uint32_t text_id      = missing_id;
+        std::optional<double> number;
+    };
+
+    static std::uint32_t intern(Column& column, const std::string& text);
+    void compact_dictionary(Column& column);
+    void compile_filters();
+    bool matches(const CompiledFilter& filter, std::size_t row) const;
+
+    std::vector<Column> _columns;
+    std::vector<std::string> _field_names;
+    std::vector<FieldFilter> _filters;
+    std::vector<std::string> _filter_texts;
+    std::vector<CompiledFilter> _compiled_filters;
+    std::vector<std::optional<JsonScalar>> _scratch_values;
+};
+
+} // namespace slayerlog
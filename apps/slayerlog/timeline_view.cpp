@@ -0,0 +1,176 @@
+#include "timeline_view.hpp"
+#include "view_theme.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+// Width used before the first frame has measured the strip.
+constexpr int fallback_width                = 80;
+constexpr std::int64_t minimum_zoom_seconds = 16;
+
+constexpr std::array<const char*, 8> sparkline_glyphs = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+
+std::tm to_local_time(std::time_t seconds)
+{
+    std::tm local_time {};
+#ifdef _WIN32
+    localtime_s(&local_time, &seconds);
+#else
+    localtime_r(&seconds, &local_time);
+#endif
+    return local_time;
+}
+
+std::string format_second(std::int64_t second)
+{
+    const std::tm local_time = to_local_time(static_cast<std::time_t>(second));
+    std::ostringstream output;
+    output << std::put_time(&local_time, "%Y-%m-%d %H:%M:%S");
+    return output.str();
+}
+
+std::string format_rate(double rate)
+{
+    std::ostringstream output;
+    output << std::fixed << std::setprecision(rate < 10.0 ? 1 : 0) << rate;
+    return output.str();
+}
+
+/** @brief One glyph per column, scaled to peak; a column with any lines shows at least the lowest bar. */
+std::string sparkline(const std::vector<LineRate>& rates, double LineRate::*rate, double peak)
+{
+    std::string line;
+    line.reserve(rates.size() * 3);
+    for (const auto& column : rates)
+    {
+        const double value = column.*rate;
+        if (value <= 0.0 || peak <= 0.0)
+        {
+            line.push_back(' ');
+            continue;
+        }
+
+        const auto level = static_cast<std::size_t>(std::ceil(value / peak * static_cast<double>(sparkline_glyphs.size())));
+        line += sparkline_glyphs[std::clamp<std::size_t>(level, 1, sparkline_glyphs.size()) - 1];
+    }
+
+    return line;
+}
+
+} // namespace
+
+bool TimelineView::visible() const
+{
+    return _visible;
+}
+
+void TimelineView::toggle_visible()
+{
+    _visible = !_visible;
+}
+
+ftxui::Element TimelineView::render(const LineRateHistogram& histogram) const
+{
+    if (histogram.empty())
+    {
+        _box = {};
+        return ftxui::text("No timestamped lines to chart") | ftxui::color(theme::muted);
+    }
+
+    _rendered_range        = shown_range(histogram);
+    const int column_count = width();
+    if (_cached_generation != histogram.generation() || _cached_range.from_second != _rendered_range.from_second || _cached_range.to_second != _rendered_range.to_second
+        || static_cast<int>(_cached_rates.size()) != column_count)
+    {
+        _cached_rates      = histogram.resample(_rendered_range.from_second, _rendered_range.to_second, column_count);
+        _cached_generation = histogram.generation();
+        _cached_range      = _rendered_range;
+    }
+
+    double peak_lines  = 0.0;
+    double peak_errors = 0.0;
+    for (const auto& rate : _cached_rates)
+    {
+        peak_lines  = std::max(peak_lines, rate.lines_per_second);
+        peak_errors = std::max(peak_errors, rate.errors_per_second);
+    }
+
+    return ftxui::vbox({
+               ftxui::text(sparkline(_cached_rates, &LineRate::lines_per_second, peak_lines)) | ftxui::color(theme::timeline_lines_fg),
+               ftxui::text(sparkline(_cached_rates, &LineRate::errors_per_second, peak_errors)) | ftxui::color(theme::timeline_errors_fg),
+               ftxui::hbox({
+                   ftxui::text(format_second(_rendered_range.from_second)),
+                   ftxui::filler(),
+                   ftxui::text("peak " + format_rate(peak_lines) + " lines/s, " + format_rate(peak_errors) + " errors/s" + (_zoom.has_value() ? " (zoomed)" : "")),
+                   ftxui::filler(),
+                   ftxui::text(format_second(_rendered_range.to_second)),
+               }) | ftxui::color(theme::muted),
+           })
+           | ftxui::reflect(_box);
+}
+
+std::optional<std::int64_t> TimelineView::second_at(const ftxui::Mouse& mouse) const
+{
+    // Only the two sparkline rows are clickable; the caption row below them is not.
+    if (_box.x_max <= _box.x_min || mouse.x < _box.x_min || mouse.x > _box.x_max || mouse.y < _box.y_min || mouse.y > _box.y_min + 1)
+    {
+        return std::nullopt;
+    }
+
+    const double fraction = static_cast<double>(mouse.x - _box.x_min) / static_cast<double>(_box.x_max - _box.x_min + 1);
+    const auto span       = static_cast<double>(_rendered_range.to_second - _rendered_range.from_second);
+    return _rendered_range.from_second + static_cast<std::int64_t>(fraction * span);
+}
+
+void TimelineView::zoom(const LineRateHistogram& histogram, std::int64_t center_second, bool zoom_in)
+{
+    if (histogram.empty())
+    {
+        return;
+    }
+
+    const TimeRange current = shown_range(histogram);
+    const std::int64_t span = current.to_second - current.from_second;
+    const std::int64_t full = histogram.end_second() - histogram.first_second();
+    const std::int64_t next = zoom_in ? std::max(minimum_zoom_seconds, span / 2) : span * 2;
+    if (next >= full)
+    {
+        _zoom.reset();
+        return;
+    }
+
+    // The second under the mouse keeps its position in the strip, as in map zooming.
+    const double anchor      = span > 0 ? static_cast<double>(center_second - current.from_second) / static_cast<double>(span) : 0.5;
+    std::int64_t from_second = center_second - static_cast<std::int64_t>(anchor * static_cast<double>(next));
+    from_second              = std::clamp(from_second, histogram.first_second(), histogram.end_second() - next);
+    _zoom                    = TimeRange {from_second, from_second + next};
+}
+
+TimelineView::TimeRange TimelineView::shown_range(const LineRateHistogram& histogram) const
+{
+    if (_zoom.has_value())
+    {
+        return *_zoom;
+    }
+
+    return TimeRange {histogram.first_second(), std::max(histogram.end_second(), histogram.first_second() + 1)};
+}
+
+int TimelineView::width() const
+{
+    return _box.x_max > _box.x_min ? _box.x_max - _box.x_min + 1 : fallback_width;
+}
+
+} // namespace slayerlog
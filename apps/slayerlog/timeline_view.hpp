@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <ftxui/component/mouse.hpp>
+#include <ftxui/dom/elements.hpp>
+
+#include "line_rate_histogram.hpp"
+
+namespace slayerlog
+{
+
+/** @brief Sparklines of lines and errors per second over the retained time range, shown above the log when toggled on. */
+class TimelineView
+{
+public:
+    /** @brief Rows the strip takes: the line sparkline, the error sparkline and the caption. */
+    static constexpr int row_count = 3;
+
+    bool visible() const;
+    void toggle_visible();
+
+    ftxui::Element render(const LineRateHistogram& histogram) const;
+    /** @brief Returns the second under the mouse when it is over the sparklines of the last render. */
+    std::optional<std::int64_t> second_at(const ftxui::Mouse& mouse) const;
+    /** @brief Halves or doubles the shown time span around center_second; zooming out to the whole range follows new lines again. */
+    void zoom(const LineRateHistogram& histogram, std::int64_t center_second, bool zoom_in);
+
+private:
+    struct TimeRange
+    {
+        std::int64_t from_second = 0;
+        std::int64_t to_second   = 0;
+    };
+
+    TimeRange shown_range(const LineRateHistogram& histogram) const;
+    int width() const;
+
+    bool _visible = false;
+    std::optional<TimeRange> _zoom;
+
+    mutable ftxui::Box _box;
+    mutable TimeRange _rendered_range;
+    // Resampling walks the buckets of the shown range, so it is only redone when the buckets, the range or the width change.
+    mutable std::optional<std::uint64_t> _cached_generation;
+    mutable TimeRange _cached_range;
+    mutable std::vector<LineRate> _cached_rates;
+};
+
+} // namespace slayerlog
@@ -0,0 +1,228 @@
+#include "view_exporter.hpp"
+#include "debug_log.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+// How long the header keeps showing the outcome of a finished export.
+constexpr std::chrono::seconds finished_status_duration {10};
+
+} // namespace
+
+ViewExporter::ViewExporter(const LogModel& model, std::mutex& model_mutex) : _model(model), _model_mutex(model_mutex)
+{
+}
+
+ViewExporter::~ViewExporter()
+{
+    stop();
+}
+
+void ViewExporter::start(std::filesystem::path path, std::vector<AllLineIndex> entries, std::function<void()> on_progress)
+{
+    if (progress().running)
+    {
+        throw std::invalid_argument("An export is already running");
+    }
+
+    wait();
+    _output = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    if (!_output)
+    {
+        throw std::invalid_argument("Cannot create file: " + path.string());
+    }
+
+    {
+        const std::lock_guard lock(_progress_mutex);
+        _progress             = ViewExportProgress {};
+        _progress.path        = std::move(path);
+        _progress.total_lines = entries.size();
+        _progress.running     = true;
+    }
+
+    SLAYERLOG_LOG_INFO("Export started file=" << _progress.path.string() << " lines=" << entries.size());
+    _on_progress      = std::move(on_progress);
+    _stop_requested   = false;
+    _store_generation = _model.store_generation();
+    _thread           = std::thread([this, entries = std::move(entries)]() mutable { run(std::move(entries)); });
+}
+
+ViewExportProgress ViewExporter::progress() const
+{
+    const std::lock_guard lock(_progress_mutex);
+    return _progress;
+}
+
+void ViewExporter::stop()
+{
+    _stop_requested = true;
+    wait();
+}
+
+void ViewExporter::wait()
+{
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
+void ViewExporter::run(std::vector<AllLineIndex> entries)
+{
+    std::string block;
+    block.reserve(write_block_bytes);
+    std::size_t evicted_lines = 0;
+    auto last_report          = std::chrono::steady_clock::now();
+    for (std::size_t first = 0; first < entries.size(); first += slice_line_count)
+    {
+        if (_stop_requested)
+        {
+            finish("cancelled");
+            return;
+        }
+
+        const std::size_t end = std::min(entries.size(), first + slice_line_count);
+        bool renumbered       = false;
+        {
+            // Only copying into the block happens under the lock; the file is written after it is released.
+            const std::lock_guard lock(_model_mutex);
+            renumbered = _model.store_generation() != _store_generation;
+            for (std::size_t index = first; !renumbered && index < end; ++index)
+            {
+                if (!_model.append_export_line(entries[index], block))
+                {
+                    ++evicted_lines;
+                }
+            }
+        }
+
+        if (renumbered)
+        {
+            finish("the log was reloaded while saving");
+            return;
+        }
+
+        if (block.size() >= write_block_bytes && !write_block(block))
+        {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_report >= progress_interval)
+        {
+            last_report = now;
+            report(end - evicted_lines, evicted_lines);
+        }
+    }
+
+    if (!write_block(block))
+    {
+        return;
+    }
+
+    _output.close();
+    if (!_output)
+    {
+        finish("failed to close the file");
+        return;
+    }
+
+    report(entries.size() - evicted_lines, evicted_lines);
+    finish({});
+}
+
+bool ViewExporter::write_block(std::string& block)
+{
+    _output.write(block.data(), static_cast<std::streamsize>(block.size()));
+    block.clear();
+    if (!_output)
+    {
+        finish("failed to write the file");
+        return false;
+    }
+
+    return true;
+}
+
+void ViewExporter::report(std::size_t written_lines, std::size_t evicted_lines)
+{
+    {
+        const std::lock_guard lock(_progress_mutex);
+        _progress.written_lines = written_lines;
+        _progress.evicted_lines = evicted_lines;
+    }
+
+    if (_on_progress)
+    {
+        _on_progress();
+    }
+}
+
+void ViewExporter::finish(std::string error)
+{
+    if (_output.is_open())
+    {
+        _output.close();
+    }
+
+    {
+        const std::lock_guard lock(_progress_mutex);
+        if (!error.empty())
+        {
+            // A partial export would look like a complete one, so it is not left behind.
+            std::error_code error_code;
+            std::filesystem::remove(_progress.path, error_code);
+            SLAYERLOG_LOG_WARNING("Export failed file=" << _progress.path.string() << " error=" << error);
+        }
+        else
+        {
+            SLAYERLOG_LOG_INFO("Export finished file=" << _progress.path.string() << " lines=" << _progress.written_lines << " evicted=" << _progress.evicted_lines);
+        }
+
+        _progress.error       = std::move(error);
+        _progress.running     = false;
+        _progress.finished_at = std::chrono::steady_clock::now();
+    }
+
+    if (_on_progress)
+    {
+        _on_progress();
+    }
+}
+
+std::string describe_view_export(const ViewExportProgress& progress, std::chrono::steady_clock::time_point now)
+{
+    if (progress.running)
+    {
+        const std::size_t percent = progress.total_lines == 0 ? 100 : progress.written_lines * 100 / progress.total_lines;
+        return "saving " + progress.path.string() + " " + std::to_string(percent) + "%";
+    }
+
+    if (!progress.finished_at.has_value() || now - *progress.finished_at > finished_status_duration)
+    {
+        return {};
+    }
+
+    if (!progress.error.empty())
+    {
+        return "saving " + progress.path.string() + " failed: " + progress.error;
+    }
+
+    std::string status = "saved " + std::to_string(progress.written_lines) + " lines to " + progress.path.string();
+    if (progress.evicted_lines > 0)
+    {
+        status += " (" + std::to_string(progress.evicted_lines) + " evicted before they were written)";
+    }
+
+    return status;
+}
+
+} // namespace slayerlog
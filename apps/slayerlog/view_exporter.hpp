@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log_model.hpp"
+
+namespace slayerlog
+{
+
+/** @brief State of the running or the last finished export. */
+struct ViewExportProgress
+{
+    std::filesystem::path path;
+    std::size_t total_lines   = 0;
+    std::size_t written_lines = 0;
+    /** @brief Lines evicted by the retention limits before the export reached them. */
+    std::size_t evicted_lines = 0;
+    bool running              = false;
+    std::string error;
+    std::optional<std::chrono::steady_clock::time_point> finished_at;
+};
+
+/**
+ * @brief Writes a snapshot of the view's lines to a file on a background thread.
+ *
+ * The lines are copied out of the model a slice at a time while holding the model mutex, so ingest and input go on
+ * between slices, and are written to the file in blocks of about write_block_bytes. The export fails if the model
+ * numbers its lines afresh in between, since the snapshot indices would then name other lines.
+ */
+class ViewExporter
+{
+public:
+    static constexpr std::size_t slice_line_count  = 16384;
+    static constexpr std::size_t write_block_bytes = 4 * 1024 * 1024;
+    static constexpr std::chrono::milliseconds progress_interval {100};
+
+    ViewExporter(const LogModel& model, std::mutex& model_mutex);
+    ~ViewExporter();
+
+    ViewExporter(const ViewExporter&)            = delete;
+    ViewExporter& operator=(const ViewExporter&) = delete;
+
+    /**
+     * @brief Starts writing the lines of entries to path; on_progress is called from the export thread as it advances and once when done.
+     *
+     * Call it with the model mutex held, as when entries were taken. Throws std::invalid_argument when an export is
+     * running or path cannot be created.
+     */
+    void start(std::filesystem::path path, std::vector<AllLineIndex> entries, std::function<void()> on_progress);
+    ViewExportProgress progress() const;
+    /** @brief Abandons a running export and waits for its thread. */
+    void stop();
+    /** @brief Waits for a running export to finish. */
+    void wait();
+
+private:
+    void run(std::vector<AllLineIndex> entries);
+    bool write_block(std::string& block);
+    void report(std::size_t written_lines, std::size_t evicted_lines);
+    void finish(std::string error);
+
+    const LogModel& _model;
+    std::mutex& _model_mutex;
+    std::function<void()> _on_progress;
+    std::ofstream _output;
+
+    mutable std::mutex _progress_mutex;
+    ViewExportProgress _progress;
+    std::atomic<bool> _stop_requested {false};
+    // Store generation the entries were taken in.
+    std::uint64_t _store_generation = 0;
+    std::thread _thread;
+};
+
+/** @brief Short status for the header, such as "saving out.log 45%"; empty when no export ran within the last few seconds. */
+std::string describe_view_export(const ViewExportProgress& progress, std::chrono::steady_clock::time_point now);
+
+} // namespace slayerlog
@@ -27,6 +27,10 @@ inline const auto label_find_fg   = ftxui::Color::Yellow;
 inline const auto label_key_fg    = ftxui::Color::White;
 inline const auto paused_fg       = ftxui::Color::Yellow;
 
+// Timeline
+inline const auto timeline_lines_fg  = ftxui::Color::GreenLight;
+inline const auto timeline_errors_fg = ftxui::Color::Red;
+
 // Scrollbar
 inline const auto scrollbar_thumb_fg = ftxui::Color::GrayLight;
 inline const auto scrollbar_track_fg = ftxui::Color::GrayDark;
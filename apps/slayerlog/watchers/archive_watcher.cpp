@@ -0,0 +1,214 @@
+#include "archive_watcher.hpp"
+#include "debug_log.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string_view>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+constexpr std::size_t read_buffer_size = 1 << 16;
+// Upper bound on decompressed bytes per poll; the rest of the archive follows on later ticks.
+constexpr std::size_t poll_byte_budget = 16 << 20;
+
+constexpr int missing_executable_exit_code = 127;
+
+} // namespace
+
+ArchiveWatcher::ArchiveWatcher(std::vector<std::string> archive_paths, std::unique_ptr<LogWatcher> live_watcher, PipeReactor* reactor)
+    : _archive_paths(std::move(archive_paths)), _live_watcher(std::move(live_watcher)), _reactor(reactor), _read_buffer(read_buffer_size)
+{
+    SLAYERLOG_LOG_INFO("Created archive watcher archives=" << _archive_paths.size() << " live=" << (_live_watcher != nullptr));
+}
+
+bool ArchiveWatcher::poll(std::vector<std::string>& lines)
+{
+    lines.clear();
+
+    std::lock_guard lock(_mutex);
+    std::size_t byte_budget = poll_byte_budget;
+    while (byte_budget > 0)
+    {
+        if (!_plain_input.is_open() && _decompressor == nullptr)
+        {
+            if (_next_archive_index >= _archive_paths.size())
+            {
+                break;
+            }
+
+            open_next_archive(lines);
+            if (!_plain_input.is_open() && _decompressor == nullptr)
+            {
+                continue;
+            }
+        }
+
+        const bool finished = _decompressor != nullptr ? read_compressed_archive(lines, byte_budget) : read_plain_archive(lines, byte_budget);
+        if (finished && !finish_archive(lines))
+        {
+            break;
+        }
+        else if (_decompressor != nullptr && byte_budget > 0)
+        {
+            // The decompressor has not produced more output yet; pick it up on the next tick.
+            break;
+        }
+    }
+
+    const bool archives_done = _next_archive_index >= _archive_paths.size() && !_plain_input.is_open() && _decompressor == nullptr;
+    if (archives_done && lines.empty() && _live_watcher != nullptr)
+    {
+        return _live_watcher->poll(lines);
+    }
+
+    return !lines.empty();
+}
+
+std::vector<std::string> ArchiveWatcher::build_decompressor_arguments(LogCompression compression, const std::string& path)
+{
+    if (compression == LogCompression::Zstd)
+    {
+        // -q keeps progress output off stderr.
+        return {"zstd", "-dcq", "--", path};
+    }
+
+    return {"gzip", "-dc", "--", path};
+}
+
+void ArchiveWatcher::open_next_archive(std::vector<std::string>& lines)
+{
+    _current_path          = _archive_paths[_next_archive_index++];
+    const auto compression = detect_log_compression(_current_path);
+    _decompressor_stderr.clear();
+
+    if (compression == LogCompression::None)
+    {
+        _plain_input.open(_current_path, std::ios::binary);
+        if (!_plain_input.is_open())
+        {
+            SLAYERLOG_LOG_WARNING("Failed to open rotated log " << _current_path);
+            lines.push_back("[slayerlog] failed to open " + _current_path);
+        }
+
+        return;
+    }
+
+    auto arguments         = build_decompressor_arguments(compression, _current_path);
+    std::string executable = arguments.front();
+    arguments.erase(arguments.begin());
+    try
+    {
+        _decompressor = std::make_unique<ProcessPipe>(std::move(executable), std::move(arguments), _reactor);
+    }
+    catch (const std::exception& ex)
+    {
+        SLAYERLOG_LOG_WARNING("Failed to start decompressor for " << _current_path << ": " << ex.what());
+        lines.push_back("[slayerlog] failed to decompress " + _current_path + ": " + ex.what());
+    }
+}
+
+bool ArchiveWatcher::read_plain_archive(std::vector<std::string>& lines, std::size_t& byte_budget)
+{
+    while (byte_budget > 0)
+    {
+        _plain_input.read(_read_buffer.data(), static_cast<std::streamsize>(_read_buffer.size()));
+        const auto byte_count = static_cast<std::size_t>(_plain_input.gcount());
+        _line_buffer.append(std::string_view(_read_buffer.data(), byte_count), lines);
+        byte_budget -= std::min(byte_budget, byte_count);
+        if (!_plain_input)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ArchiveWatcher::read_compressed_archive(std::vector<std::string>& lines, std::size_t& byte_budget)
+{
+    bool stdout_ended = false;
+    bool stderr_ended = false;
+    while (byte_budget > 0)
+    {
+        const std::size_t stdout_bytes = _decompressor->read_stdout(_read_buffer.data(), _read_buffer.size(), stdout_ended);
+        _line_buffer.append(std::string_view(_read_buffer.data(), stdout_bytes), lines);
+        byte_budget -= std::min(byte_budget, stdout_bytes);
+
+        // Drain stderr as we go so a chatty decompressor can never block on a full pipe.
+        const std::size_t stderr_bytes = _decompressor->read_stderr(_read_buffer.data(), _read_buffer.size(), stderr_ended);
+        _decompressor_stderr.append(_read_buffer.data(), stderr_bytes);
+
+        if (stdout_ended)
+        {
+            return true;
+        }
+
+        if (stdout_bytes == 0)
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool ArchiveWatcher::finish_archive(std::vector<std::string>& lines)
+{
+    if (_plain_input.is_open())
+    {
+        _line_buffer.flush_pending_fragment(lines);
+        _plain_input.close();
+        _plain_input.clear();
+        return true;
+    }
+
+    // Never block on the decompressor while the model lock is held: take whatever stderr it has written and come back
+    // on a later poll until it has exited. Its stderr stays registered with the reactor, so more output wakes that poll.
+    const bool exited        = !_decompressor->running();
+    bool stderr_ended        = false;
+    std::size_t stderr_bytes = 0;
+    do
+    {
+        stderr_bytes = _decompressor->read_stderr(_read_buffer.data(), _read_buffer.size(), stderr_ended);
+        _decompressor_stderr.append(_read_buffer.data(), stderr_bytes);
+    } while (stderr_bytes > 0);
+
+    if (!exited)
+    {
+        return false;
+    }
+
+    const int exit_code = _decompressor->wait();
+    _decompressor.reset();
+    if (exit_code == 0)
+    {
+        _line_buffer.flush_pending_fragment(lines);
+        return true;
+    }
+
+    // A truncated or corrupt member usually ends mid-line; keep the complete lines but drop the torn one.
+    _line_buffer.discard_pending_fragment();
+
+    std::ostringstream message;
+    message << "[slayerlog] failed to decompress " << _current_path;
+    if (exit_code == missing_executable_exit_code)
+    {
+        message << ": decompressor not found on PATH";
+    }
+    else
+    {
+        std::string first_error_line = _decompressor_stderr.substr(0, _decompressor_stderr.find('\n'));
+        message << " (exit code " << exit_code << ")" << (first_error_line.empty() ? "" : ": " + first_error_line);
+    }
+
+    SLAYERLOG_LOG_WARNING(message.str());
+    lines.push_back(message.str());
+    return true;
+}
+
+} // namespace slayerlog
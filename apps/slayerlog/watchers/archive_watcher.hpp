@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "log_source.hpp"
+#include "log_watcher.hpp"
+#include "pipe_reactor.hpp"
+#include "process_pipe.hpp"
+#include "stream_line_buffer.hpp"
+
+namespace slayerlog
+{
+
+/**
+ * @brief Streams rotated and compressed log files once, oldest first, then hands over to an optional live watcher.
+ *
+ * gzip and zstd members are decompressed by the system gzip/zstd tools through a ProcessPipe, so nothing is written
+ * to disk and decompression overlaps with line splitting. Each poll reads a bounded amount so large archives do
+ * not hold the model lock for long.
+ */
+class ArchiveWatcher : public LogWatcher
+{
+public:
+    ArchiveWatcher(std::vector<std::string> archive_paths, std::unique_ptr<LogWatcher> live_watcher, PipeReactor* reactor = nullptr);
+
+    ArchiveWatcher(const ArchiveWatcher&)            = delete;
+    ArchiveWatcher& operator=(const ArchiveWatcher&) = delete;
+
+    bool poll(std::vector<std::string>& lines) override;
+
+    static std::vector<std::string> build_decompressor_arguments(LogCompression compression, const std::string& path);
+
+private:
+    void open_next_archive(std::vector<std::string>& lines);
+    bool read_plain_archive(std::vector<std::string>& lines, std::size_t& byte_budget);
+    bool read_compressed_archive(std::vector<std::string>& lines, std::size_t& byte_budget);
+    /** @brief Returns false while the decompressor is still exiting; its stderr keeps being collected on later polls. */
+    bool finish_archive(std::vector<std::string>& lines);
+
+    std::vector<std::string> _archive_paths;
+    std::size_t _next_archive_index = 0;
+    std::string _current_path;
+    std::unique_ptr<LogWatcher> _live_watcher;
+    PipeReactor* _reactor = nullptr;
+
+    StreamLineBuffer _line_buffer;
+    std::ifstream _plain_input;
+    std::unique_ptr<ProcessPipe> _decompressor;
+    std::string _decompressor_stderr;
+    std::vector<char> _read_buffer;
+    std::mutex _mutex;
+};
+
+} // namespace slayerlog
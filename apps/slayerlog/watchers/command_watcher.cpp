@@ -0,0 +1,100 @@
+#include "command_watcher.hpp"
+#include "debug_log.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+constexpr std::size_t read_buffer_size = 1 << 16;
+// Upper bound on bytes per poll so a command that floods output cannot hold the model lock for long.
+constexpr std::size_t poll_byte_budget = 16 << 20;
+
+constexpr int missing_executable_exit_code = 127;
+
+ProcessPipe start_shell(const std::string& command, PipeReactor* reactor)
+{
+    auto arguments         = CommandWatcher::build_shell_arguments(command);
+    std::string executable = arguments.front();
+    arguments.erase(arguments.begin());
+    return ProcessPipe(std::move(executable), std::move(arguments), reactor);
+}
+
+} // namespace
+
+CommandWatcher::CommandWatcher(std::string command, PipeReactor* reactor)
+    : _command(std::move(command)), _process(start_shell(_command, reactor)), _read_buffer(read_buffer_size)
+{
+    SLAYERLOG_LOG_INFO("Started command source command=" << _command);
+}
+
+bool CommandWatcher::poll(std::vector<std::string>& lines)
+{
+    lines.clear();
+
+    std::lock_guard lock(_mutex);
+    if (_finished)
+    {
+        return false;
+    }
+
+    bool stdout_ended       = false;
+    bool stderr_ended       = false;
+    std::size_t byte_budget = poll_byte_budget;
+    while (byte_budget > 0)
+    {
+        const std::size_t stdout_bytes = _process.read_stdout(_read_buffer.data(), _read_buffer.size(), stdout_ended);
+        _stdout_lines.append(std::string_view(_read_buffer.data(), stdout_bytes), lines);
+
+        const std::size_t stderr_bytes = _process.read_stderr(_read_buffer.data(), _read_buffer.size(), stderr_ended);
+        _stderr_lines.append(std::string_view(_read_buffer.data(), stderr_bytes), lines);
+
+        byte_budget -= std::min(byte_budget, stdout_bytes + stderr_bytes);
+        if (stdout_bytes == 0 && stderr_bytes == 0)
+        {
+            break;
+        }
+    }
+
+    // Output still buffered in the pipes is read before the exit is reported, even after the process is gone. The exit
+    // is only checked without blocking, so a command that closed its output but keeps running is picked up on a later poll.
+    const bool output_drained = (stdout_ended && stderr_ended) || byte_budget == poll_byte_budget;
+    if (output_drained && !_process.running())
+    {
+        _stdout_lines.flush_pending_fragment(lines);
+        _stderr_lines.flush_pending_fragment(lines);
+
+        // A child the command left behind may still hold the pipes; nothing is read from them again, so they must not
+        // stay in the level-triggered reactor.
+        _process.close_output();
+        const int exit_code = _process.wait();
+        _finished           = true;
+        SLAYERLOG_LOG_INFO("Command source exited command=" << _command << " exit_code=" << exit_code);
+        if (exit_code == missing_executable_exit_code)
+        {
+            lines.push_back("[slayerlog] command not found: " + _command);
+        }
+        else
+        {
+            lines.push_back("[slayerlog] command exited with code " + std::to_string(exit_code) + ": " + _command);
+        }
+    }
+
+    return !lines.empty();
+}
+
+std::vector<std::string> CommandWatcher::build_shell_arguments(const std::string& command)
+{
+#ifdef _WIN32
+    return {"cmd.exe", "/d", "/s", "/c", command};
+#else
+    return {"sh", "-c", command};
+#endif
+}
+
+} // namespace slayerlog
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "log_watcher.hpp"
+#include "pipe_reactor.hpp"
+#include "process_pipe.hpp"
+#include "stream_line_buffer.hpp"
+
+namespace slayerlog
+{
+
+/**
+ * @brief Streams the output of a local shell command, e.g. "kubectl logs -f pod", without a temp file in between.
+ *
+ * stdout and stderr are both treated as log lines because tools like docker logs replay a container's stderr there.
+ * The command runs once; when it exits its last partial line is flushed and the exit code is reported.
+ */
+class CommandWatcher : public LogWatcher
+{
+public:
+    explicit CommandWatcher(std::string command, PipeReactor* reactor = nullptr);
+
+    CommandWatcher(const CommandWatcher&)            = delete;
+    CommandWatcher& operator=(const CommandWatcher&) = delete;
+
+    bool poll(std::vector<std::string>& lines) override;
+
+    static std::vector<std::string> build_shell_arguments(const std::string& command);
+
+private:
+    std::string _command;
+    ProcessPipe _process;
+    StreamLineBuffer _stdout_lines;
+    StreamLineBuffer _stderr_lines;
+    std::vector<char> _read_buffer;
+    bool _finished = false;
+    std::mutex _mutex;
+};
+
+} // namespace slayerlog
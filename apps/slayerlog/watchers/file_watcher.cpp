@@ -1,5 +1,6 @@
 #include "debug_log.hpp"
 #include "file_watcher.hpp"
+#include "log_timestamp.hpp"
 
 #include <cctype>
 #include <filesystem>
@@ -8,6 +9,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string_view>
+#include <system_error>
 #include <utility>
 
 namespace slayerlog
@@ -17,6 +19,8 @@ namespace
 {
 
 constexpr std::size_t tail_verification_window_size = 256;
+// Lines searched for a checkpoint's timestamp, so a file without timestamps is not parsed line by line.
+constexpr std::uint32_t checkpoint_timestamp_search_lines = 64;
 
 std::string quote_for_log(std::string_view text)
 {
@@ -88,39 +92,64 @@ std::string describe_lines_for_log(const std::vector<std::string>& lines)
 
 } // namespace
 
-void FileWatcher::parse_lines_from_chunk(std::string chunk, FileWatcher::State& state, std::vector<std::string>& lines)
+void FileWatcher::parse_lines_from_chunk(std::string_view chunk, std::uint64_t chunk_offset, FileWatcher::State& state, std::vector<std::string>& lines)
 {
     SLAYERLOG_LOG_TRACE(
         "parse_lines_from_chunk begin chunk_bytes=" << chunk.size() << " chunk=" << quote_for_log(chunk)
                                                    << " pending_fragment_bytes=" << state.pending_fragment.size()
                                                    << " pending_fragment=" << quote_for_log(state.pending_fragment));
 
-    if (!state.pending_fragment.empty())
-    {
-        SLAYERLOG_LOG_TRACE("Prepending pending fragment " << quote_for_log(state.pending_fragment) << " to new chunk");
-        chunk.insert(0, state.pending_fragment);
-        state.pending_fragment.clear();
-    }
-
     std::size_t start = 0;
     while (start < chunk.size())
     {
         const auto newline = chunk.find('\n', start);
-        if (newline == std::string::npos)
+        if (newline == std::string_view::npos)
         {
-            state.pending_fragment = chunk.substr(start);
+            state.pending_fragment.append(chunk.substr(start));
             SLAYERLOG_LOG_TRACE(
                 "Stored trailing pending fragment bytes=" << state.pending_fragment.size()
                                                           << " fragment=" << quote_for_log(state.pending_fragment));
             break;
         }
 
-        auto line = chunk.substr(start, newline - start);
+        // Only the first line can continue a fragment from the previous chunk; joining it alone avoids copying the whole chunk.
+        std::string line;
+        if (state.pending_fragment.empty())
+        {
+            line.assign(chunk.substr(start, newline - start));
+        }
+        else
+        {
+            SLAYERLOG_LOG_TRACE("Joining pending fragment " << quote_for_log(state.pending_fragment) << " with new chunk");
+            line = std::move(state.pending_fragment);
+            state.pending_fragment.clear();
+            line.append(chunk.substr(start, newline - start));
+        }
+
         if (!line.empty() && line.back() == '\r')
         {
             line.pop_back();
         }
 
+        if (state.line_count % LineIndex::checkpoint_interval == 0)
+        {
+            state.checkpoints.push_back({state.line_start, state.line_count, std::nullopt});
+            state.timestamp_search_lines = checkpoint_timestamp_search_lines;
+        }
+
+        if (state.timestamp_search_lines > 0)
+        {
+            --state.timestamp_search_lines;
+            state.checkpoints.back().timestamp = parse_log_timestamp(line);
+            if (state.checkpoints.back().timestamp.has_value())
+            {
+                state.timestamp_search_lines = 0;
+            }
+        }
+
+        ++state.line_count;
+        state.line_start = chunk_offset + newline + 1;
+
         SLAYERLOG_LOG_TRACE("Parsed complete line " << quote_for_log(line));
         lines.push_back(std::move(line));
         start = newline + 1;
@@ -205,10 +234,119 @@ std::uintmax_t FileWatcher::get_file_size(const std::string& path)
     return std::filesystem::file_size(std::filesystem::path(path));
 }
 
-FileWatcher::FileWatcher(std::string file_path)
-    : _file_path(std::move(file_path))
+FileWatcher::FileWatcher(std::string file_path, FileWatcherOptions options)
+    : _file_path(std::move(file_path)), _options(options)
+{
+    // Without a retention limit every line is read anyway, so an index would only be written and never used.
+    if (_options.initial_max_lines == 0 && _options.initial_max_bytes == 0)
+    {
+        _options.line_index_cache = nullptr;
+    }
+
+    if (_options.line_index_cache != nullptr)
+    {
+        std::error_code error_code;
+        _index_path = std::filesystem::absolute(_file_path, error_code).lexically_normal().string();
+        if (const auto index = _options.line_index_cache->load(_index_path))
+        {
+            _stored_line_count = index->line_count;
+            resume_from_line_index(*index);
+        }
+    }
+
+    SLAYERLOG_LOG_INFO("Created file watcher for file=" << _file_path << " skipped_lines=" << _skipped_line_count);
+}
+
+FileWatcher::~FileWatcher()
 {
-    SLAYERLOG_LOG_INFO("Created file watcher for file=" << _file_path);
+    std::lock_guard lock(_mutex);
+    store_line_index_locked();
+}
+
+std::uint64_t FileWatcher::skipped_line_count() const
+{
+    return _skipped_line_count;
+}
+
+std::optional<LogTimePoint> FileWatcher::resume_timestamp() const
+{
+    return _resume_checkpoint == 0 ? std::nullopt : _index_checkpoints[_resume_checkpoint].timestamp;
+}
+
+void FileWatcher::resume_no_later_than(LogTimePoint timestamp)
+{
+    std::lock_guard lock(_mutex);
+    const auto current = resume_timestamp();
+    if (!current.has_value() || *current <= timestamp)
+    {
+        return;
+    }
+
+    // The lines before a checkpoint are no later than its timestamp, so the last such checkpoint skips only earlier lines.
+    std::size_t start = _resume_checkpoint;
+    while (start > 0 && !(_index_checkpoints[start].timestamp.has_value() && *_index_checkpoints[start].timestamp <= timestamp))
+    {
+        --start;
+    }
+
+    resume_from_checkpoint(start);
+}
+
+void FileWatcher::resume_from_line_index(const LineIndex& index)
+{
+    std::error_code error_code;
+    const std::uint64_t file_size = std::filesystem::file_size(_file_path, error_code);
+    if (error_code || index.checkpoints.empty())
+    {
+        return;
+    }
+
+    // Start at the last checkpoint that still leaves enough lines or bytes for a limit to evict everything before it.
+    std::size_t start = 0;
+    for (std::size_t checkpoint = 1; checkpoint < index.checkpoints.size(); ++checkpoint)
+    {
+        const auto& candidate = index.checkpoints[checkpoint];
+        if ((_options.initial_max_lines > 0 && index.line_count - candidate.line_number >= _options.initial_max_lines)
+            || (_options.initial_max_bytes > 0 && file_size - candidate.offset >= _options.initial_max_bytes))
+        {
+            start = checkpoint;
+        }
+    }
+
+    _index_checkpoints = index.checkpoints;
+    resume_from_checkpoint(start);
+}
+
+void FileWatcher::resume_from_checkpoint(std::size_t start)
+{
+    // Checkpoint 0 is the start of the file, so resuming there reads it whole.
+    const auto& checkpoint = _index_checkpoints[start];
+    _resume_checkpoint     = start;
+    _state.offset          = checkpoint.offset;
+    _state.line_start      = checkpoint.offset;
+    _state.line_count      = checkpoint.line_number;
+    _state.checkpoints.assign(_index_checkpoints.begin(), _index_checkpoints.begin() + static_cast<std::ptrdiff_t>(start));
+    _state.offset_tail_bytes = read_window_ending_at(_file_path, checkpoint.offset);
+    _skipped_line_count      = checkpoint.line_number;
+    SLAYERLOG_LOG_DEBUG("Resuming from line index file=" << _file_path << " offset=" << checkpoint.offset << " skipped_lines=" << checkpoint.line_number);
+}
+
+void FileWatcher::store_line_index_locked()
+{
+    // Files shorter than one checkpoint interval are read in full anyway, so they get no sidecar.
+    if (_options.line_index_cache == nullptr || _state.checkpoints.size() < 2 || _state.line_count <= _stored_line_count)
+    {
+        return;
+    }
+
+    LineIndex index;
+    index.indexed_size = _state.line_start;
+    index.line_count   = _state.line_count;
+    index.checkpoints  = _state.checkpoints;
+    if (_options.line_index_cache->store(_index_path, std::move(index)))
+    {
+        _stored_line_count = _state.line_count;
+    }
 }
 
 bool FileWatcher::poll(std::vector<std::string>& lines)
@@ -222,11 +360,24 @@ bool FileWatcher::poll(std::vector<std::string>& lines)
                                 << " state.pending_fragment_bytes=" << _state.pending_fragment.size()
                                 << " state.awaiting_regrowth_after_shrink=" << _state.awaiting_regrowth_after_shrink
                                 << " state.shrink_candidate_size=" << _state.shrink_candidate_size);
+
+        // Once reading has started the start can no longer move, so the loaded checkpoints are not needed.
+        _resume_checkpoint = 0;
+        _index_checkpoints.clear();
+        _index_checkpoints.shrink_to_fit();
+
         if (!collect_update_locked(lines))
         {
             SLAYERLOG_LOG_TRACE("poll end file=" << _file_path << " returned=false");
             return false;
         }
+
+        // Saved once after the initial read so the next launch benefits even if this one does not exit cleanly.
+        if (!_index_stored_after_open)
+        {
+            _index_stored_after_open = true;
+            store_line_index_locked();
+        }
     }
 
     SLAYERLOG_LOG_DEBUG(
@@ -268,8 +419,9 @@ bool FileWatcher::collect_update_locked(std::vector<std::string>& lines)
         }
 
         SLAYERLOG_LOG_DEBUG("Confirmed rollover after stable shrink file=" << _file_path << "; resetting state");
-        _state    = State{};
-        file_size = get_file_size(_file_path);
+        _state             = State{};
+        _stored_line_count = 0;
+        file_size          = get_file_size(_file_path);
         SLAYERLOG_LOG_TRACE("After rollover reset file=" << _file_path << " reloaded_file_size=" << file_size);
     }
     else if (_state.awaiting_regrowth_after_shrink)
@@ -283,8 +435,9 @@ bool FileWatcher::collect_update_locked(std::vector<std::string>& lines)
         if (window != _state.offset_tail_bytes)
         {
             SLAYERLOG_LOG_DEBUG("Regrowth no longer matches previous tail file=" << _file_path << "; treating as rollover");
-            _state = State{};
-            file_size = get_file_size(_file_path);
+            _state             = State{};
+            _stored_line_count = 0;
+            file_size          = get_file_size(_file_path);
             SLAYERLOG_LOG_TRACE("After regrowth mismatch reset file=" << _file_path << " reloaded_file_size=" << file_size);
         }
         else
@@ -300,7 +453,8 @@ bool FileWatcher::collect_update_locked(std::vector<std::string>& lines)
         return false;
     }
 
-    auto chunk = read_file_tail(_file_path, _state.offset);
+    const std::uint64_t chunk_offset = _state.offset;
+    auto chunk                       = read_file_tail(_file_path, _state.offset);
     SLAYERLOG_LOG_TRACE(
         "Read file tail file=" << _file_path << " previous_offset=" << _state.offset << " new_file_size=" << file_size
                                << " chunk_bytes=" << chunk.size() << " chunk=" << quote_for_log(chunk));
@@ -312,7 +466,7 @@ bool FileWatcher::collect_update_locked(std::vector<std::string>& lines)
         return false;
     }
 
-    parse_lines_from_chunk(std::move(chunk), _state, lines);
+    parse_lines_from_chunk(chunk, chunk_offset, _state, lines);
     if (lines.empty())
     {
         SLAYERLOG_LOG_DEBUG(
@@ -2,24 +2,42 @@
 
 #include <cstdint>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "line_index_cache.hpp"
 #include "log_watcher.hpp"
 
 namespace slayerlog
 {
 
+/**
+ * @brief Lets a reopened file start near its end when the retention limits would evict its older lines right away.
+ *
+ * Without a cached line index for the file the whole file is read. With both limits at zero no index is used or written.
+ */
+struct FileWatcherOptions
+{
+    const LineIndexCache* line_index_cache = nullptr;
+    std::uint64_t initial_max_lines        = 0;
+    std::uint64_t initial_max_bytes        = 0;
+};
+
 class FileWatcher : public LogWatcher
 {
 public:
-    explicit FileWatcher(std::string file_path);
+    explicit FileWatcher(std::string file_path, FileWatcherOptions options = {});
+    ~FileWatcher() override;
 
     FileWatcher(const FileWatcher&)            = delete;
     FileWatcher& operator=(const FileWatcher&) = delete;
 
     bool poll(std::vector<std::string>& lines) override;
+    std::uint64_t skipped_line_count() const override;
+    std::optional<LogTimePoint> resume_timestamp() const override;
+    void resume_no_later_than(LogTimePoint timestamp) override;
 
 private:
     struct State
@@ -29,17 +47,35 @@ private:
         std::string offset_tail_bytes;
         bool awaiting_regrowth_after_shrink  = false;
         std::uintmax_t shrink_candidate_size = 0;
+
+        // Where the next complete line starts and how many came before it, for the line index.
+        std::uint64_t line_start = 0;
+        std::uint64_t line_count = 0;
+        std::vector<LineIndexCheckpoint> checkpoints;
+        // Lines left to search for the timestamp of the newest checkpoint.
+        std::uint32_t timestamp_search_lines = 0;
     };
 
-    static void parse_lines_from_chunk(std::string chunk, State& state, std::vector<std::string>& lines);
+    static void parse_lines_from_chunk(std::string_view chunk, std::uint64_t chunk_offset, State& state, std::vector<std::string>& lines);
     static void update_offset_tail_bytes(std::string_view chunk, State& state);
     static std::string read_file_tail(const std::string& path, std::uintmax_t offset);
     static std::string read_window_ending_at(const std::string& path, std::uintmax_t offset);
     static std::uintmax_t get_file_size(const std::string& path);
 
     bool collect_update_locked(std::vector<std::string>& lines);
+    void resume_from_line_index(const LineIndex& index);
+    void resume_from_checkpoint(std::size_t start);
+    void store_line_index_locked();
 
     std::string _file_path;
+    FileWatcherOptions _options;
+    std::string _index_path;
+    std::uint64_t _skipped_line_count = 0;
+    std::uint64_t _stored_line_count  = 0;
+    bool _index_stored_after_open     = false;
+    // The loaded index's checkpoints and the one reading starts at, kept until the first poll so the start can still move back.
+    std::vector<LineIndexCheckpoint> _index_checkpoints;
+    std::size_t _resume_checkpoint = 0;
     State _state;
     std::mutex _mutex;
 };
@@ -0,0 +1,295 @@
+#include "glob_watcher.hpp"
+#include "debug_log.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace slayerlog
+{
+
+namespace
+{
+
+// Without change notifications, new and deleted files are only noticed by walking the tree again.
+constexpr auto polling_rescan_interval = std::chrono::seconds(2);
+
+std::string change_path_for(const std::filesystem::path& path)
+{
+    std::error_code error_code;
+    const auto canonical_path = std::filesystem::canonical(path, error_code);
+    return error_code ? path.lexically_normal().string() : canonical_path.string();
+}
+
+} // namespace
+
+GlobWatcher::GlobWatcher(const std::string& pattern, PipeReactor* reactor)
+    : _glob(split_log_glob(pattern)), _reactor(reactor)
+{
+    std::error_code error_code;
+    if (!std::filesystem::is_directory(_glob.base_directory, error_code))
+    {
+        throw std::runtime_error("Directory not found: " + _glob.base_directory);
+    }
+
+    std::size_t segment_start = 0;
+    while (true)
+    {
+        const std::size_t separator = _glob.relative_pattern.find('/', segment_start);
+        _recursive                  = _recursive || _glob.relative_pattern.compare(segment_start, separator - segment_start, "**") == 0;
+        if (separator == std::string::npos)
+        {
+            break;
+        }
+
+        segment_start = separator + 1;
+        ++_max_depth;
+    }
+
+    _event_driven = _notifier.available();
+    if (_event_driven && _reactor != nullptr)
+    {
+        _reactor->add(_notifier.handle());
+    }
+
+    SLAYERLOG_LOG_INFO("Created glob watcher base=" << _glob.base_directory << " pattern=" << _glob.relative_pattern << " event_driven=" << _event_driven);
+}
+
+GlobWatcher::~GlobWatcher()
+{
+    stop_event_delivery();
+}
+
+bool GlobWatcher::poll(std::vector<std::string>& lines)
+{
+    lines.clear();
+    std::vector<MemberLineBatch> batches;
+    poll_members(batches);
+    for (auto& batch : batches)
+    {
+        lines.insert(lines.end(), std::make_move_iterator(batch.lines.begin()), std::make_move_iterator(batch.lines.end()));
+    }
+
+    return !lines.empty();
+}
+
+void GlobWatcher::poll_members(std::vector<MemberLineBatch>& batches)
+{
+    std::lock_guard lock(_mutex);
+    collect_changes();
+    if (!_event_driven && std::chrono::steady_clock::now() - _last_rescan >= polling_rescan_interval)
+    {
+        _rescan_pending = true;
+    }
+
+    if (_rescan_pending)
+    {
+        rescan();
+    }
+
+    std::set<std::string> targets;
+    if (_event_driven)
+    {
+        // A file that was just written is looked at once more, so FileWatcher can confirm a truncation without another write.
+        targets = _recheck_paths;
+        targets.insert(_dirty_paths.begin(), _dirty_paths.end());
+        _recheck_paths.clear();
+        _recheck_paths.swap(_dirty_paths);
+    }
+    else
+    {
+        _dirty_paths.clear();
+        for (const auto& [path, member] : _members)
+        {
+            targets.insert(path);
+        }
+    }
+
+    for (const auto& path : targets)
+    {
+        const auto member = _members.find(path);
+        if (member == _members.end())
+        {
+            continue;
+        }
+
+        MemberLineBatch batch;
+        batch.member = member->second.name;
+        try
+        {
+            member->second.watcher->poll(batch.lines);
+        }
+        catch (const std::exception& ex)
+        {
+            // Usually the file was deleted since the last scan; the rescan drops it.
+            SLAYERLOG_LOG_DEBUG("Glob member poll failed path=" << path << " error=" << ex.what());
+            _rescan_pending = true;
+            continue;
+        }
+
+        if (!batch.lines.empty())
+        {
+            batches.push_back(std::move(batch));
+        }
+    }
+}
+
+std::size_t GlobWatcher::file_count() const
+{
+    std::lock_guard lock(_mutex);
+    return _members.size();
+}
+
+bool GlobWatcher::event_driven() const
+{
+    std::lock_guard lock(_mutex);
+    return _event_driven;
+}
+
+void GlobWatcher::collect_changes()
+{
+    if (!_event_driven)
+    {
+        return;
+    }
+
+    const auto changes = _notifier.read_changes();
+    if (changes.structure_changed)
+    {
+        _rescan_pending = true;
+    }
+
+    if (changes.overflowed)
+    {
+        for (const auto& [path, member] : _members)
+        {
+            _dirty_paths.insert(path);
+        }
+    }
+
+    for (const auto& change_path : changes.modified_paths)
+    {
+        const auto path = _paths_by_change_path.find(change_path);
+        if (path != _paths_by_change_path.end())
+        {
+            _dirty_paths.insert(path->second);
+        }
+    }
+}
+
+void GlobWatcher::rescan()
+{
+    _rescan_pending = false;
+    _last_rescan    = std::chrono::steady_clock::now();
+
+    const std::filesystem::path base(_glob.base_directory);
+    watch_directory(base);
+
+    std::set<std::string> found_paths;
+    std::error_code error_code;
+    for (std::filesystem::recursive_directory_iterator entry(base, std::filesystem::directory_options::skip_permission_denied, error_code), end; !error_code && entry != end; entry.increment(error_code))
+    {
+        std::error_code status_error;
+        if (entry->is_directory(status_error))
+        {
+            if (!_recursive && static_cast<std::size_t>(entry.depth()) >= _max_depth)
+            {
+                entry.disable_recursion_pending();
+            }
+            else if (!entry->is_symlink(status_error))
+            {
+                watch_directory(entry->path());
+            }
+
+            continue;
+        }
+
+        if (!entry->is_regular_file(status_error))
+        {
+            continue;
+        }
+
+        const std::string name = entry->path().lexically_relative(base).generic_string();
+        if (!matches_log_glob(_glob.relative_pattern, name))
+        {
+            continue;
+        }
+
+        const std::string path = entry->path().string();
+        found_paths.insert(path);
+        if (_members.count(path) != 0 || _skipped_paths.count(path) != 0)
+        {
+            continue;
+        }
+
+        if (detect_log_compression(path) != LogCompression::None)
+        {
+            _skipped_paths.insert(path);
+            continue;
+        }
+
+        Member member {name, change_path_for(entry->path()), std::make_unique<FileWatcher>(path)};
+        // Symlinked files (e.g. /var/log/containers) are written through their target, so watch the target's directory.
+        watch_directory(std::filesystem::path(member.change_path).parent_path());
+        _paths_by_change_path[member.change_path] = path;
+        _dirty_paths.insert(path);
+        _members.emplace(path, std::move(member));
+        SLAYERLOG_LOG_DEBUG("Glob watcher added file=" << path);
+    }
+
+    if (error_code)
+    {
+        SLAYERLOG_LOG_WARNING("Glob watcher scan stopped base=" << _glob.base_directory << " error=" << error_code.message());
+        return;
+    }
+
+    for (auto member = _members.begin(); member != _members.end();)
+    {
+        if (found_paths.count(member->first) != 0)
+        {
+            ++member;
+            continue;
+        }
+
+        SLAYERLOG_LOG_DEBUG("Glob watcher dropped file=" << member->first);
+        _paths_by_change_path.erase(member->second.change_path);
+        _dirty_paths.erase(member->first);
+        _recheck_paths.erase(member->first);
+        member = _members.erase(member);
+    }
+
+    for (auto skipped = _skipped_paths.begin(); skipped != _skipped_paths.end();)
+    {
+        skipped = found_paths.count(*skipped) != 0 ? std::next(skipped) : _skipped_paths.erase(skipped);
+    }
+}
+
+void GlobWatcher::watch_directory(const std::filesystem::path& directory)
+{
+    if (!_event_driven)
+    {
+        return;
+    }
+
+    const std::string change_path = change_path_for(directory);
+    if (_notifier.watching(change_path) || _notifier.watch_directory(change_path))
+    {
+        return;
+    }
+
+    SLAYERLOG_LOG_WARNING("Glob watcher could not watch directory=" << change_path << "; polling every matching file instead");
+    stop_event_delivery();
+    _event_driven = false;
+}
+
+void GlobWatcher::stop_event_delivery()
+{
+    if (_event_driven && _reactor != nullptr)
+    {
+        _reactor->remove(_notifier.handle());
+    }
+}
+
+} // namespace slayerlog
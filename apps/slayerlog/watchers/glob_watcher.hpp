@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "file_change_notifier.hpp"
+#include "file_watcher.hpp"
+#include "log_source.hpp"
+#include "log_watcher.hpp"
+#include "pipe_reactor.hpp"
+
+namespace slayerlog
+{
+
+/**
+ * @brief Tails every local file matching a glob, picking up files as they appear and dropping deleted ones.
+ *
+ * Each match gets its own FileWatcher and is reported as a separate member named by its path relative to the glob's
+ * base directory. With inotify, a poll only reads files that were written to and rescans the tree only after
+ * directory changes, so thousands of idle files cost nothing; otherwise every file is polled and the tree is
+ * rescanned every few seconds. Compressed files are skipped.
+ */
+class GlobWatcher : public LogWatcher
+{
+public:
+    explicit GlobWatcher(const std::string& pattern, PipeReactor* reactor = nullptr);
+    ~GlobWatcher() override;
+
+    GlobWatcher(const GlobWatcher&)            = delete;
+    GlobWatcher& operator=(const GlobWatcher&) = delete;
+
+    bool poll(std::vector<std::string>& lines) override;
+    void poll_members(std::vector<MemberLineBatch>& batches) override;
+
+    std::size_t file_count() const;
+    /** @brief True while file changes are reported by the OS instead of found by polling every file. */
+    bool event_driven() const;
+
+private:
+    struct Member
+    {
+        std::string name;
+        std::string change_path;
+        std::unique_ptr<FileWatcher> watcher;
+    };
+
+    void collect_changes();
+    void rescan();
+    void watch_directory(const std::filesystem::path& directory);
+    void stop_event_delivery();
+
+    LogGlob _glob;
+    bool _recursive        = false;
+    std::size_t _max_depth = 0;
+    PipeReactor* _reactor  = nullptr;
+    FileChangeNotifier _notifier;
+    bool _event_driven = false;
+
+    std::map<std::string, Member> _members;
+    std::unordered_map<std::string, std::string> _paths_by_change_path;
+    std::set<std::string> _skipped_paths;
+    std::set<std::string> _dirty_paths;
+    std::set<std::string> _recheck_paths;
+    bool _rescan_pending = true;
+    std::chrono::steady_clock::time_point _last_rescan;
+    mutable std::mutex _mutex;
+};
+
+} // namespace slayerlog
@@ -0,0 +1,173 @@
+#include "ssh_connection_pool.hpp"
+#include "debug_log.hpp"
+
+#include <system_error>
+#include <utility>
+
+#ifndef _WIN32
+#    include <unistd.h>
+#endif
+
+namespace slayerlog
+{
+
+namespace
+{
+
+// Waiting longer than this for the master socket means the handshake is stuck; sessions then connect directly.
+constexpr auto master_start_timeout = std::chrono::seconds(10);
+constexpr auto master_retry_delay   = std::chrono::seconds(30);
+
+} // namespace
+
+SshConnectionPool::SshConnectionPool(std::filesystem::path control_directory) : _control_directory(std::move(control_directory))
+{
+#ifndef _WIN32
+    std::error_code error_code;
+    std::filesystem::create_directories(_control_directory, error_code);
+    if (!error_code)
+    {
+        // The sockets grant shell access to the remote hosts, so only the owner may reach them.
+        std::filesystem::permissions(_control_directory, std::filesystem::perms::owner_all, std::filesystem::perm_options::replace, error_code);
+    }
+
+    _enabled = !error_code;
+    if (!_enabled)
+    {
+        SLAYERLOG_LOG_WARNING("ssh connection sharing disabled; cannot prepare " << _control_directory.string() << ": " << error_code.message());
+    }
+#endif
+}
+
+SshConnectionPool::~SshConnectionPool()
+{
+    // Terminating the masters also closes any session still multiplexed over them.
+    _masters.clear();
+    if (_enabled)
+    {
+        std::error_code error_code;
+        std::filesystem::remove_all(_control_directory, error_code);
+    }
+}
+
+void SshConnectionPool::set_compression(bool enabled)
+{
+    std::lock_guard lock(_mutex);
+    _compression = enabled;
+}
+
+bool SshConnectionPool::compression() const
+{
+    std::lock_guard lock(_mutex);
+    return _compression;
+}
+
+bool SshConnectionPool::ready(const std::string& ssh_target)
+{
+    std::lock_guard lock(_mutex);
+    if (!_enabled)
+    {
+        return true;
+    }
+
+    Master& master = master_for(ssh_target);
+    const auto now = std::chrono::steady_clock::now();
+    std::error_code error_code;
+    if (master.process != nullptr && master.process->running())
+    {
+        return std::filesystem::exists(master.control_path, error_code) || now - master.started_at >= master_start_timeout;
+    }
+
+    if (master.process != nullptr)
+    {
+        SLAYERLOG_LOG_WARNING("ssh master for " << ssh_target << " exited with code " << master.process->wait() << "; using direct connections for now");
+        master.process.reset();
+        master.retry_at = now + master_retry_delay;
+    }
+
+    if (now < master.retry_at)
+    {
+        return true;
+    }
+
+    std::filesystem::remove(master.control_path, error_code);
+    try
+    {
+        master.process    = std::make_unique<ProcessPipe>("ssh", build_master_arguments(ssh_target, master.control_path, _compression));
+        master.started_at = now;
+        SLAYERLOG_LOG_INFO("Started shared ssh connection target=" << ssh_target << " control_path=" << master.control_path.string());
+    }
+    catch (const std::exception& ex)
+    {
+        SLAYERLOG_LOG_WARNING("Failed to start shared ssh connection for " << ssh_target << ": " << ex.what());
+        master.retry_at = now + master_retry_delay;
+        return true;
+    }
+
+    return false;
+}
+
+std::vector<std::string> SshConnectionPool::session_arguments(const std::string& ssh_target)
+{
+    std::lock_guard lock(_mutex);
+    std::vector<std::string> arguments;
+    // Multiplexed sessions inherit the master's compression; the flag only matters when a session connects directly.
+    if (_compression)
+    {
+        arguments.push_back("-C");
+    }
+
+    if (_enabled)
+    {
+        // ControlMaster=no never lets a session become a master itself; without a live socket it simply connects directly.
+        arguments.insert(arguments.end(), {"-o", "ControlMaster=no", "-o", "ControlPath=" + master_for(ssh_target).control_path.string()});
+    }
+
+    return arguments;
+}
+
+std::filesystem::path SshConnectionPool::default_control_directory()
+{
+    std::error_code error_code;
+    auto directory = std::filesystem::temp_directory_path(error_code);
+    if (error_code)
+    {
+        directory = std::filesystem::current_path();
+    }
+
+#ifdef _WIN32
+    return directory / "slayerlog-ssh";
+#else
+    return directory / ("slayerlog-ssh-" + std::to_string(::getpid()));
+#endif
+}
+
+std::vector<std::string> SshConnectionPool::build_master_arguments(const std::string& ssh_target, const std::filesystem::path& control_path, bool compression)
+{
+    std::vector<std::string> arguments = {
+        "-n", "-N", "-T", "-M", "-o", "BatchMode=yes", "-o", "ControlPath=" + control_path.string(), "-o", "ControlPersist=no", "-o", "ServerAliveInterval=15", "-o", "ServerAliveCountMax=3",
+    };
+    if (compression)
+    {
+        arguments.push_back("-C");
+    }
+
+    arguments.push_back(ssh_target);
+    return arguments;
+}
+
+SshConnectionPool::Master& SshConnectionPool::master_for(const std::string& ssh_target)
+{
+    auto existing = _masters.find(ssh_target);
+    if (existing != _masters.end())
+    {
+        return existing->second;
+    }
+
+    // Socket paths are length limited, so name them by index rather than by host.
+    Master master;
+    master.control_path = _control_directory / ("m" + std::to_string(_masters.size()));
+    return _masters.emplace(ssh_target, std::move(master)).first->second;
+}
+
+} // namespace slayerlog
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "process_pipe.hpp"
+
+namespace slayerlog
+{
+
+/**
+ * @brief Shares one ssh connection per host between remote sources through an OpenSSH ControlMaster socket.
+ *
+ * The pool runs a background `ssh -N -M` per host and routes every tail session through its socket, so only the
+ * first source on a host pays for the TCP and key exchange. When the master cannot be started the sessions fall
+ * back to direct connections. Windows OpenSSH has no ControlMaster support, so the pool is a no-op there.
+ */
+class SshConnectionPool
+{
+public:
+    explicit SshConnectionPool(std::filesystem::path control_directory = default_control_directory());
+    ~SshConnectionPool();
+
+    SshConnectionPool(const SshConnectionPool&)            = delete;
+    SshConnectionPool& operator=(const SshConnectionPool&) = delete;
+
+    /** @brief Enables ssh stream compression for connections started afterwards; worthwhile when catching up over slow links. */
+    void set_compression(bool enabled);
+    bool compression() const;
+
+    /** @brief Starts the shared connection for ssh_target if needed; returns false while it is still being established. */
+    bool ready(const std::string& ssh_target);
+    /** @brief Returns the ssh options that route a session for ssh_target through the shared connection. */
+    std::vector<std::string> session_arguments(const std::string& ssh_target);
+
+    static std::filesystem::path default_control_directory();
+    static std::vector<std::string> build_master_arguments(const std::string& ssh_target, const std::filesystem::path& control_path, bool compression = false);
+
+private:
+    struct Master
+    {
+        std::filesystem::path control_path;
+        std::unique_ptr<ProcessPipe> process;
+        std::chrono::steady_clock::time_point started_at;
+        std::chrono::steady_clock::time_point retry_at;
+    };
+
+    Master& master_for(const std::string& ssh_target);
+
+    std::filesystem::path _control_directory;
+    bool _enabled     = false;
+    bool _compression = false;
+    std::map<std::string, Master> _masters;
+    mutable std::mutex _mutex;
+};
+
+} // namespace slayerlog
@@ -1,7 +1,10 @@
 #include "ssh_tail_watcher.hpp"
+#include "debug_log.hpp"
 
-#include <array>
+#include <algorithm>
+#include <charconv>
 #include <sstream>
+#include <system_error>
 #include <stdexcept>
 #include <utility>
 
@@ -13,17 +16,50 @@ namespace slayerlog
 namespace
 {
 
-constexpr auto reconnect_delay         = std::chrono::seconds(1);
-constexpr std::size_t read_buffer_size = 4096;
+constexpr auto initial_reconnect_delay = std::chrono::milliseconds(500);
+constexpr auto max_reconnect_delay     = std::chrono::milliseconds(60000);
+constexpr std::size_t read_buffer_size = 1 << 16;
+// Upper bound on bytes per poll so a burst from ssh cannot hold the model lock for long; the rest follows on later ticks.
+constexpr std::size_t poll_byte_budget = 16 << 20;
+// The remote script reports on stderr where it resumed ("<marker> <inode> <offset> <backlog bytes>") before any data,
+// and announces when the followed file was replaced.
+constexpr std::string_view resume_marker  = "slayerlog-resume";
+constexpr std::string_view rotated_marker = "slayerlog-rotated";
 
-std::string build_disconnect_message(const LogSource& source)
+std::string build_disconnect_message(const LogSource& source, std::chrono::milliseconds delay)
 {
-    return "[slayerlog] remote stream disconnected: " + source_display_path(source) + "; retrying";
+    std::ostringstream message;
+    message << "[slayerlog] remote stream disconnected: " << source_display_path(source) << "; retrying in " << std::chrono::duration<double>(delay).count() << " s";
+    return message.str();
+}
+
+/** @brief Finds a line starting with marker; ssh may print host key warnings before the remote script runs. */
+std::size_t find_marker_line(const std::string& text, std::string_view marker)
+{
+    std::size_t line_start = 0;
+    while (line_start < text.size())
+    {
+        if (text.compare(line_start, marker.size(), marker) == 0)
+        {
+            return line_start;
+        }
+
+        const auto line_end = text.find('\n', line_start);
+        if (line_end == std::string::npos)
+        {
+            break;
+        }
+
+        line_start = line_end + 1;
+    }
+
+    return std::string::npos;
 }
 
 } // namespace
 
-SshTailWatcher::SshTailWatcher(LogSource source) : _source(std::move(source))
+SshTailWatcher::SshTailWatcher(LogSource source, PipeReactor* reactor, SshConnectionPool* connections)
+    : _source(std::move(source)), _reactor(reactor), _connections(connections), _read_buffer(read_buffer_size)
 {
     if (_source.kind != LogSourceKind::SshRemoteFile)
     {
@@ -33,9 +69,33 @@ SshTailWatcher::SshTailWatcher(LogSource source) : _source(std::move(source))
 
 bool SshTailWatcher::poll(std::vector<std::string>& lines)
 {
-    lines.clear();
+    std::lock_guard lock(_mutex);
+    return read_lines(lines);
+}
 
+void SshTailWatcher::poll_members(std::vector<MemberLineBatch>& batches)
+{
     std::lock_guard lock(_mutex);
+    MemberLineBatch batch;
+    const bool refetching = _refetch_end_line.has_value();
+    read_lines(batch.lines);
+    batch.skipped = std::move(_skipped_lines);
+    _skipped_lines.clear();
+    // The replaced lines are only dropped together with the first lines that stand in for them.
+    if (refetching && !batch.lines.empty())
+    {
+        batch.refetched           = true;
+        batch.replaced_line_count = std::exchange(_replaced_line_count, 0);
+    }
+
+    batches.push_back(std::move(batch));
+}
+
+bool SshTailWatcher::read_lines(std::vector<std::string>& lines)
+{
+    lines.clear();
+    _skipped_lines.clear();
+
     const auto now = std::chrono::steady_clock::now();
     if (_pipe == nullptr && now < _next_retry_at)
     {
@@ -44,44 +104,95 @@ bool SshTailWatcher::poll(std::vector<std::string>& lines)
 
     if (_pipe == nullptr)
     {
-        _pipe = std::make_unique<ProcessPipe>("ssh", build_ssh_arguments(_source, _offset));
-    }
+        // Hold off until the shared connection is up so a host with many sources performs a single handshake.
+        if (_connections != nullptr && !_connections->ready(_source.ssh_target))
+        {
+            return false;
+        }
 
-    std::array<char, read_buffer_size> buffer {};
-    bool stdout_ended = false;
-    bool stderr_ended = false;
+        const auto connection_arguments = _connections != nullptr ? _connections->session_arguments(_source.ssh_target) : std::vector<std::string> {};
+        _pipe                           = std::make_unique<ProcessPipe>("ssh", build_ssh_arguments(_source, _inode, _offset, connection_arguments, _remote_filter), _reactor);
+        _session_started_at             = std::chrono::steady_clock::now();
+        _session_bytes                  = 0;
+        _session_resumed                = false;
+        _session_rotated                = false;
+        _session_filtered               = !_remote_filter.empty();
+        _line_buffer.set_keep_carriage_returns(_session_filtered);
+        _catch_up.reset();
+        _stderr_text.clear();
+        ++_session_count;
+    }
 
-    std::string stderr_text;
+    char* const buffer             = _read_buffer.data();
+    bool stdout_ended              = false;
+    bool stderr_ended              = false;
+    std::size_t byte_budget        = poll_byte_budget;
+    std::size_t first_counted_line = 0;
 
-    while (true)
+    while (byte_budget > 0)
     {
         bool made_progress = false;
 
-        const std::size_t stdout_bytes = _pipe->read_stdout(buffer.data(), buffer.size(), stdout_ended);
-        if (stdout_bytes > 0)
+        // The resume marker decides whether the kept fragment continues in this session, so stdout waits until it was seen.
+        const std::size_t stderr_bytes = _pipe->read_stderr(buffer, _read_buffer.size(), stderr_ended);
+        if (stderr_bytes > 0)
         {
             made_progress = true;
-            _offset += _line_buffer.append(std::string_view(buffer.data(), stdout_bytes), lines);
+            byte_budget -= std::min(byte_budget, stderr_bytes);
+            _stderr_text.append(buffer, stderr_bytes);
+            consume_stderr_markers(lines, first_counted_line);
         }
 
-        const std::size_t stderr_bytes = _pipe->read_stderr(buffer.data(), buffer.size(), stderr_ended);
-        if (stderr_bytes > 0)
+        if (_session_resumed)
         {
-            made_progress = true;
-            stderr_text.append(buffer.data(), stderr_bytes);
+            const std::size_t stdout_bytes = _pipe->read_stdout(buffer, _read_buffer.size(), stdout_ended);
+            if (stdout_bytes > 0)
+            {
+                made_progress = true;
+                byte_budget -= std::min(byte_budget, stdout_bytes);
+
+                const auto first_line = lines.size();
+                _line_buffer.append(std::string_view(buffer, stdout_bytes), lines);
+                if (_session_filtered)
+                {
+                    strip_remote_positions(lines, first_line);
+                }
+                else
+                {
+                    _offset += stdout_bytes;
+                    _line_number += lines.size() - first_line;
+                    record_received_bytes(stdout_bytes);
+                }
+            }
         }
 
-        if (stdout_ended || !_pipe->running())
+        if (stdout_ended || (!made_progress && !_pipe->running()))
         {
             const bool had_stdout_output = !lines.empty();
             const int exit_code          = _pipe->wait();
             _pipe.reset();
-            _line_buffer.discard_pending_fragment();
-            _next_retry_at = std::chrono::steady_clock::now() + reconnect_delay;
+            if (_session_filtered)
+            {
+                // _offset only advances per complete filtered line, so a torn one is fetched again on resume.
+                _line_buffer.discard_pending_fragment();
+            }
+
+            if (_session_rotated)
+            {
+                // The remote side saw the file replaced; reconnect right away to pick up the new file from its start.
+                _next_retry_at   = std::chrono::steady_clock::now();
+                _reconnect_delay = initial_reconnect_delay;
+                SLAYERLOG_LOG_INFO("Remote file rotated source=" << source_display_path(_source));
+                break;
+            }
 
-            if (!stderr_text.empty())
+            _next_retry_at   = std::chrono::steady_clock::now() + _reconnect_delay;
+            const auto delay = _reconnect_delay;
+            _reconnect_delay = std::min(_reconnect_delay * 2, max_reconnect_delay);
+
+            if (!_stderr_text.empty())
             {
-                std::istringstream stderr_stream(stderr_text);
+                std::istringstream stderr_stream(_stderr_text);
                 std::string line;
                 while (std::getline(stderr_stream, line))
                 {
@@ -95,6 +206,8 @@ bool SshTailWatcher::poll(std::vector<std::string>& lines)
                         lines.push_back("[slayerlog] ssh stderr: " + line);
                     }
                 }
+
+                _stderr_text.clear();
             }
 
             if (!had_stdout_output && exit_code != 0 && lines.empty())
@@ -102,7 +215,7 @@ bool SshTailWatcher::poll(std::vector<std::string>& lines)
                 lines.push_back("[slayerlog] failed to connect to remote stream: " + source_display_path(_source));
             }
 
-            lines.push_back(build_disconnect_message(_source));
+            lines.push_back(build_disconnect_message(_source, delay));
             break;
         }
 
@@ -112,9 +225,237 @@ bool SshTailWatcher::poll(std::vector<std::string>& lines)
         }
     }
 
+    if (!_filter_spans.empty())
+    {
+        _filter_spans.back().sent_line_count += lines.size() - first_counted_line;
+    }
+
+    if (_refetch_end_line.has_value() && _line_number >= *_refetch_end_line)
+    {
+        _refetch_end_line.reset();
+        SLAYERLOG_LOG_INFO("Remote stream read again up to where it was source=" << source_display_path(_source) << " line=" << _line_number);
+    }
+
     return !lines.empty();
 }
 
+std::optional<CatchUpProgress> SshTailWatcher::catch_up_progress() const
+{
+    std::lock_guard lock(_mutex);
+    if (!_catch_up.has_value() || _catch_up->complete)
+    {
+        return _catch_up;
+    }
+
+    auto progress    = *_catch_up;
+    progress.elapsed = std::chrono::steady_clock::now() - _session_started_at;
+    return progress;
+}
+
+void SshTailWatcher::consume_stderr_markers(std::vector<std::string>& lines, std::size_t& first_counted_line)
+{
+    while (true)
+    {
+        const auto marker_start = find_marker_line(_stderr_text, _session_resumed ? rotated_marker : resume_marker);
+        if (marker_start == std::string::npos)
+        {
+            return;
+        }
+
+        const auto line_end = _stderr_text.find('\n', marker_start);
+        if (line_end == std::string::npos)
+        {
+            return;
+        }
+
+        std::istringstream fields(_stderr_text.substr(marker_start, line_end - marker_start));
+        _stderr_text.erase(marker_start, line_end + 1 - marker_start);
+        if (_session_resumed)
+        {
+            _session_rotated = true;
+            return;
+        }
+
+        std::string marker;
+        std::string inode;
+        std::uintmax_t offset       = 0;
+        std::uint64_t backlog_bytes = 0;
+        if (!(fields >> marker >> inode >> offset >> backlog_bytes))
+        {
+            continue;
+        }
+
+        // A different inode or a shorter file means the remote side started over; the kept fragment was the old file's last line.
+        if (inode != _inode || offset != _offset)
+        {
+            _line_buffer.flush_pending_fragment(lines);
+            first_counted_line = lines.size();
+            _inode             = inode;
+            _offset            = offset;
+            _line_number       = 0;
+            _filter_spans.clear();
+            _refetch_end_line.reset();
+            _replaced_line_count = 0;
+        }
+
+        if (_filter_spans.empty() || _filter_spans.back().filter != _remote_filter)
+        {
+            _filter_spans.push_back(FilterSpan {offset, _line_number, _remote_filter, 0});
+        }
+
+        _session_resumed      = true;
+        _session_start_offset = offset;
+        _session_start_line   = _line_number;
+        _reconnect_delay      = initial_reconnect_delay;
+        if (_session_filtered)
+        {
+            // Filtered sessions send only part of the backlog, so byte counts cannot tell when they caught up.
+            continue;
+        }
+
+        CatchUpProgress progress;
+        progress.backlog_bytes = backlog_bytes;
+        progress.backfill      = _session_count > 1;
+        _catch_up              = progress;
+        record_received_bytes(0);
+    }
+}
+
+void SshTailWatcher::set_remote_filter(const RemoteLineFilter& filter)
+{
+    std::lock_guard lock(_mutex);
+    if (filter == _remote_filter)
+    {
+        return;
+    }
+
+    _remote_filter = filter;
+
+    // Read again from the first span whose filter may have dropped lines the new one lets through, or from where an
+    // unfinished read-again started, since the lines it still has to send were already replaced.
+    const auto refetch_from = std::find_if(_filter_spans.begin(), _filter_spans.end(),
+                                           [&](const FilterSpan& span)
+                                           { return !remote_line_filter_covers(span.filter, filter) || (_refetch_end_line.has_value() && span.line_number >= _refetch_start_line); });
+    if (refetch_from != _filter_spans.end())
+    {
+        for (auto span = refetch_from; span != _filter_spans.end(); ++span)
+        {
+            _replaced_line_count += span->sent_line_count;
+        }
+
+        _refetch_end_line   = std::max(_refetch_end_line.value_or(0), _line_number);
+        _refetch_start_line = refetch_from->line_number;
+        _offset             = refetch_from->offset;
+        _line_number        = refetch_from->line_number;
+        _filter_spans.erase(refetch_from, _filter_spans.end());
+        _line_buffer.discard_pending_fragment();
+        SLAYERLOG_LOG_INFO("Reading remote stream again for a wider filter source=" << source_display_path(_source) << " from_line=" << _line_number
+                                                                                   << " replaced_lines=" << _replaced_line_count);
+    }
+    else if (_pipe == nullptr)
+    {
+        return;
+    }
+    else if (!_session_filtered)
+    {
+        // Rewind to the start of the torn line so a filtered session sees it whole.
+        _offset -= _line_buffer.pending_fragment_size();
+    }
+
+    _pipe.reset();
+    _line_buffer.discard_pending_fragment();
+    _catch_up.reset();
+    _next_retry_at = std::chrono::steady_clock::now();
+    SLAYERLOG_LOG_INFO("Restarting remote stream for new filter source=" << source_display_path(_source) << " includes=" << filter.include_literals.size()
+                                                                         << " excludes=" << filter.exclude_literals.size());
+}
+
+void SshTailWatcher::strip_remote_positions(std::vector<std::string>& lines, std::size_t first_line)
+{
+    // grep -n -b prefixes every line with its line number and byte offset, both relative to where this session started
+    // reading. Filtered sessions keep the '\r' of CRLF lines until here, so the resume offset counts it and lands after the '\n'.
+    for (std::size_t index = first_line; index < lines.size(); ++index)
+    {
+        auto& line                     = lines[index];
+        const char* const end          = line.data() + line.size();
+        std::uint64_t relative_line    = 0;
+        std::uintmax_t relative_offset = 0;
+        const auto line_field          = std::from_chars(line.data(), end, relative_line);
+        if (line_field.ec == std::errc() && line_field.ptr != end && *line_field.ptr == ':')
+        {
+            const auto offset_field = std::from_chars(line_field.ptr + 1, end, relative_offset);
+            if (offset_field.ec == std::errc() && offset_field.ptr != end && *offset_field.ptr == ':')
+            {
+                // The lines the filter dropped since the last sent line still count towards the line numbers.
+                const std::uint64_t line_number = _session_start_line + relative_line;
+                if (line_number > _line_number + 1)
+                {
+                    _skipped_lines.push_back(SkippedLines {index, line_number - _line_number - 1});
+                }
+
+                // Resume after the last line that was sent; skipped lines in between are simply filtered again.
+                const auto prefix_size = static_cast<std::size_t>(offset_field.ptr + 1 - line.data());
+                _line_number           = line_number;
+                _offset                = _session_start_offset + relative_offset + (line.size() - prefix_size) + 1;
+                line.erase(0, prefix_size);
+            }
+        }
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+    }
+}
+
+void SshTailWatcher::record_received_bytes(std::size_t byte_count)
+{
+    // Bytes that arrive before the marker was parsed still belong to the backlog, so they are counted once it is known.
+    _session_bytes += byte_count;
+    if (!_catch_up.has_value() || _catch_up->complete)
+    {
+        return;
+    }
+
+    _catch_up->received_bytes = std::min<std::uint64_t>(_session_bytes, _catch_up->backlog_bytes);
+    if (_catch_up->received_bytes < _catch_up->backlog_bytes)
+    {
+        return;
+    }
+
+    _catch_up->complete = true;
+    _catch_up->elapsed  = std::chrono::steady_clock::now() - _session_started_at;
+    SLAYERLOG_LOG_INFO((_catch_up->backfill ? "Backfilled " : "Caught up on ") << source_display_path(_source) << " bytes=" << _catch_up->backlog_bytes
+                                                                               << " seconds=" << std::chrono::duration<double>(_catch_up->elapsed).count()
+                                                                               << " bytes_per_second=" << _catch_up->bytes_per_second());
+}
+
+std::string SshTailWatcher::build_remote_reader(const RemoteLineFilter& filter)
+{
+    if (filter.empty())
+    {
+        return "gpid=; tail -c +$((off + 1)) -f -- \"$f\" & pid=$!; trap 'kill $pid 2>/dev/null' EXIT; trap 'exit 1' HUP TERM PIPE; ";
+    }
+
+    // One grep stage reports line numbers and byte offsets of the original stream, which keeps resuming and numbering exact. A fifo instead of a
+    // pipeline keeps both pids known, so neither tail nor grep outlives the session.
+    std::ostringstream reader;
+    reader << "d=$(mktemp -d) || exit 1; mkfifo \"$d/p\" || exit 1; LC_ALL=C grep -n -b --line-buffered -F";
+    if (filter.include_literals.empty())
+    {
+        reader << " -v";
+    }
+
+    for (const auto& literal : filter.include_literals.empty() ? filter.exclude_literals : filter.include_literals)
+    {
+        reader << " -e " << quote_for_posix_shell(literal);
+    }
+
+    reader << " < \"$d/p\" & gpid=$!; tail -c +$((off + 1)) -f -- \"$f\" > \"$d/p\" & pid=$!; "
+           << "trap 'kill $pid $gpid 2>/dev/null; rm -rf \"$d\"' EXIT; trap 'exit 1' HUP TERM PIPE; ";
+    return reader.str();
+}
+
 std::string SshTailWatcher::quote_for_posix_shell(std::string_view text)
 {
     std::string quoted;
@@ -135,22 +476,29 @@ std::string SshTailWatcher::quote_for_posix_shell(std::string_view text)
     return quoted;
 }
 
-std::vector<std::string> SshTailWatcher::build_ssh_arguments(const LogSource& source, std::uintmax_t offset)
+std::vector<std::string> SshTailWatcher::build_ssh_arguments(const LogSource& source, std::string_view inode, std::uintmax_t offset, const std::vector<std::string>& connection_arguments,
+                                                         const RemoteLineFilter& filter)
 {
-    const std::uintmax_t start_byte = offset + 1;
-    const std::string quoted_path   = quote_for_posix_shell(source.remote_path);
-
     std::ostringstream remote_script;
-    remote_script << "size=$(wc -c < " << quoted_path << " 2>/dev/null) || exit 1; "
-                  << "start=" << start_byte << "; "
-                  << "if [ \"$size\" -lt \"$start\" ]; then start=1; fi; "
-                  << "tail -c +\"$start\" -F -- " << quoted_path << " 2>/dev/null || "
-                  << "exec tail -c +\"$start\" -f -- " << quoted_path;
+    remote_script << "f=" << quote_for_posix_shell(source.remote_path) << "; want=" << quote_for_posix_shell(inode) << "; off=" << offset << "; "
+                  << "set -- $(ls -di -- \"$f\" 2>/dev/null); ino=$1; [ -n \"$ino\" ] || exit 1; "
+                  << "size=$(wc -c < \"$f\") || exit 1; "
+                  // Resume inside the same file only; a new inode or a shorter file is read from the start.
+                  << "if [ \"$ino\" != \"$want\" ] || [ \"$size\" -lt \"$off\" ]; then off=0; fi; "
+                  << "echo \"" << resume_marker << " $ino $off $((size - off))\" >&2; "
+                  << build_remote_reader(filter)
+                  // tail -f keeps the opened inode, so rotation is detected here and answered with a fresh session.
+                  << "while kill -0 $pid $gpid 2>/dev/null; do sleep 1; set -- $(ls -di -- \"$f\" 2>/dev/null); "
+                  << "if [ \"$1\" != \"$ino\" ]; then sleep 1; echo " << rotated_marker << " >&2; exit 0; fi; done";
 
-    return {
+    std::vector<std::string> arguments = {
         // This watcher is read-only; prevent ssh from stealing terminal input from the UI.
-        "-n", "-T", "-o", "BatchMode=yes", "-o", "ServerAliveInterval=15", "-o", "ServerAliveCountMax=3", source.ssh_target, "sh", "-lc", remote_script.str(),
+        "-n", "-T", "-o", "BatchMode=yes", "-o", "ServerAliveInterval=15", "-o", "ServerAliveCountMax=3",
     };
+    arguments.insert(arguments.end(), connection_arguments.begin(), connection_arguments.end());
+    // ssh joins its command arguments with spaces for the remote login shell, so the script has to travel as one quoted word.
+    arguments.insert(arguments.end(), {source.ssh_target, "sh -lc " + quote_for_posix_shell(remote_script.str())});
+    return arguments;
 }
 
 } // namespace slayerlog
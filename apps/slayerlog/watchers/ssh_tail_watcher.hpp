@@ -4,12 +4,16 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "log_source.hpp"
 #include "log_watcher.hpp"
+#include "pipe_reactor.hpp"
+#include "remote_line_filter.hpp"
 #include "process_pipe.hpp"
+#include "ssh_connection_pool.hpp"
 #include "stream_line_buffer.hpp"
 
 namespace slayerlog
@@ -18,19 +22,73 @@ namespace slayerlog
 class SshTailWatcher : public LogWatcher
 {
 public:
-    explicit SshTailWatcher(LogSource source);
+    /** @brief Routes the session through connections, when given, so sources on one host share a single ssh login. */
+    explicit SshTailWatcher(LogSource source, PipeReactor* reactor = nullptr, SshConnectionPool* connections = nullptr);
     bool poll(std::vector<std::string>& lines) override;
+    /** @brief Also tells how many remote lines the filter dropped before each line, and which lines were read again. */
+    void poll_members(std::vector<MemberLineBatch>& batches) override;
+    std::optional<CatchUpProgress> catch_up_progress() const override;
+    /**
+     * @brief Restarts the session when the filter changed.
+     *
+     * A filter that may let through lines an earlier one dropped reads again from where that filter took effect, and
+     * the lines it sends replace the ones sent from there on; otherwise the session goes on from the current offset.
+     */
+    void set_remote_filter(const RemoteLineFilter& filter) override;
+
+    /** @brief Builds a session that resumes at offset when the remote file still has inode, and reads from the start otherwise. */
+    static std::vector<std::string> build_ssh_arguments(const LogSource& source, std::string_view inode, std::uintmax_t offset, const std::vector<std::string>& connection_arguments = {},
+                                                        const RemoteLineFilter& filter = {});
 
 private:
-    static std::vector<std::string> build_ssh_arguments(const LogSource& source, std::uintmax_t offset);
+    // Where the current file was first read under a filter, with the lines sent while that filter applied.
+    struct FilterSpan
+    {
+        std::uintmax_t offset     = 0;
+        std::uint64_t line_number = 0;
+        RemoteLineFilter filter;
+        std::uint64_t sent_line_count = 0;
+    };
+
     static std::string quote_for_posix_shell(std::string_view text);
+    static std::string build_remote_reader(const RemoteLineFilter& filter);
+    bool read_lines(std::vector<std::string>& lines);
+    /** @brief Parses the resume marker; lines before first_counted_line belong to a file read earlier. */
+    void consume_stderr_markers(std::vector<std::string>& lines, std::size_t& first_counted_line);
+    void record_received_bytes(std::size_t byte_count);
+    void strip_remote_positions(std::vector<std::string>& lines, std::size_t first_line);
 
     LogSource _source;
+    PipeReactor* _reactor           = nullptr;
+    SshConnectionPool* _connections = nullptr;
     StreamLineBuffer _line_buffer;
+    std::vector<char> _read_buffer;
+    // Bytes of the current remote file received so far, including the kept unterminated fragment.
     std::uintmax_t _offset = 0;
-    std::mutex _mutex;
+    // Lines of the current remote file before _offset, filtered ones included, which line numbers are counted from.
+    std::uint64_t _line_number = 0;
+    std::string _inode;
+    std::string _stderr_text;
+    std::size_t _session_count           = 0;
+    std::uint64_t _session_bytes         = 0;
+    bool _session_resumed                = false;
+    bool _session_rotated                = false;
+    bool _session_filtered               = false;
+    std::uintmax_t _session_start_offset = 0;
+    std::uint64_t _session_start_line    = 0;
+    RemoteLineFilter _remote_filter;
+    std::vector<FilterSpan> _filter_spans;
+    std::vector<SkippedLines> _skipped_lines;
+    // Set while a session reads again over lines sent before, up to the last line read before it started.
+    std::optional<std::uint64_t> _refetch_end_line;
+    std::uint64_t _refetch_start_line  = 0;
+    std::uint64_t _replaced_line_count = 0;
+    std::chrono::steady_clock::time_point _session_started_at;
+    std::optional<CatchUpProgress> _catch_up;
+    mutable std::mutex _mutex;
     std::unique_ptr<ProcessPipe> _pipe;
     std::chrono::steady_clock::time_point _next_retry_at = std::chrono::steady_clock::time_point::min();
+    std::chrono::milliseconds _reconnect_delay {500};
 };
 
 } // namespace slayerlog
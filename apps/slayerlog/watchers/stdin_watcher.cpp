@@ -0,0 +1,149 @@
+#include "stdin_watcher.hpp"
+#include "debug_log.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#ifndef _WIN32
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+namespace slayerlog
+{
+
+namespace
+{
+
+constexpr std::size_t read_buffer_size = 1 << 16;
+// Upper bound on bytes per poll so a fast producer cannot hold the model lock for long.
+constexpr std::size_t poll_byte_budget = 16 << 20;
+
+} // namespace
+
+int detach_standard_input()
+{
+#ifdef _WIN32
+    throw std::runtime_error("Reading logs from stdin is not supported on Windows");
+#else
+    if (::isatty(STDIN_FILENO) != 0)
+    {
+        throw std::runtime_error("stdin is a terminal; pipe a log into slayerlog to use '-'");
+    }
+
+    const int terminal = ::open("/dev/tty", O_RDONLY);
+    if (terminal < 0)
+    {
+        throw std::runtime_error("Reading logs from stdin needs a controlling terminal for the UI");
+    }
+
+    const int handle = ::fcntl(STDIN_FILENO, F_DUPFD_CLOEXEC, 3);
+    if (handle < 0 || ::dup2(terminal, STDIN_FILENO) < 0)
+    {
+        ::close(terminal);
+        if (handle >= 0)
+        {
+            ::close(handle);
+        }
+
+        throw std::runtime_error("Failed to detach stdin from the terminal");
+    }
+
+    ::close(terminal);
+    const int flags = ::fcntl(handle, F_GETFL, 0);
+    if (flags >= 0)
+    {
+        ::fcntl(handle, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    SLAYERLOG_LOG_INFO("Detached piped stdin handle=" << handle);
+    return handle;
+#endif
+}
+
+StdinWatcher::StdinWatcher([[maybe_unused]] int handle, PipeReactor* reactor) : _reactor(reactor), _read_buffer(read_buffer_size)
+{
+#ifdef _WIN32
+    throw std::runtime_error("Reading logs from stdin is not supported on Windows");
+#else
+    _handle = ::fcntl(handle, F_DUPFD_CLOEXEC, 3);
+    if (_handle < 0)
+    {
+        throw std::runtime_error("Failed to duplicate the stdin pipe");
+    }
+
+    if (_reactor != nullptr)
+    {
+        _reactor->add(_handle);
+    }
+#endif
+}
+
+StdinWatcher::~StdinWatcher()
+{
+    stop_watching();
+#ifndef _WIN32
+    if (_handle >= 0)
+    {
+        ::close(_handle);
+    }
+#endif
+}
+
+bool StdinWatcher::poll(std::vector<std::string>& lines)
+{
+    lines.clear();
+
+    std::lock_guard lock(_mutex);
+    if (_finished)
+    {
+        return false;
+    }
+
+#ifndef _WIN32
+    std::size_t byte_budget = poll_byte_budget;
+    while (byte_budget > 0)
+    {
+        const ssize_t bytes_read = ::read(_handle, _read_buffer.data(), _read_buffer.size());
+        if (bytes_read > 0)
+        {
+            _line_buffer.append(std::string_view(_read_buffer.data(), static_cast<std::size_t>(bytes_read)), lines);
+            byte_budget -= std::min(byte_budget, static_cast<std::size_t>(bytes_read));
+            continue;
+        }
+
+        if (bytes_read < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+
+        // End of input or a broken pipe: keep what was read and stop, the writer is gone for good.
+        _line_buffer.flush_pending_fragment(lines);
+        lines.push_back("[slayerlog] stdin closed");
+        stop_watching();
+        break;
+    }
+#endif
+
+    return !lines.empty();
+}
+
+void StdinWatcher::stop_watching()
+{
+    // A closed pipe stays readable forever, so it must leave the reactor or the watcher thread would spin.
+    if (!_finished && _reactor != nullptr)
+    {
+        _reactor->remove(_handle);
+    }
+
+    _finished = true;
+}
+
+} // namespace slayerlog
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "log_watcher.hpp"
+#include "pipe_reactor.hpp"
+#include "stream_line_buffer.hpp"
+
+namespace slayerlog
+{
+
+/**
+ * @brief Moves piped stdin to a new descriptor and reattaches the controlling terminal as stdin.
+ *
+ * The UI reads keys from stdin, so a log piped into slayerlog has to be taken out of its way first.
+ * Throws std::runtime_error when stdin is a terminal, the terminal cannot be opened, or on Windows.
+ */
+int detach_standard_input();
+
+/**
+ * @brief Streams lines from a pipe descriptor such as the one returned by detach_standard_input().
+ *
+ * The watcher reads through its own duplicate of handle, so a replacement watcher can take over the same pipe
+ * while the old one is still being torn down.
+ */
+class StdinWatcher : public LogWatcher
+{
+public:
+    explicit StdinWatcher(int handle, PipeReactor* reactor = nullptr);
+    ~StdinWatcher() override;
+
+    StdinWatcher(const StdinWatcher&)            = delete;
+    StdinWatcher& operator=(const StdinWatcher&) = delete;
+
+    bool poll(std::vector<std::string>& lines) override;
+
+private:
+    void stop_watching();
+
+    int _handle           = -1;
+    PipeReactor* _reactor = nullptr;
+    StreamLineBuffer _line_buffer;
+    std::vector<char> _read_buffer;
+    bool _finished = false;
+    std::mutex _mutex;
+};
+
+} // namespace slayerlog
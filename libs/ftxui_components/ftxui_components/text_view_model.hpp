@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 
+#include <ftxui_components/text_width.hpp>
+
 class TextViewModel
 {
 public:
@@ -11,8 +13,12 @@ public:
 
     [[nodiscard]] int line_count() const;
     [[nodiscard]] const std::string& line_at(int index) const;
+    [[nodiscard]] const TextColumnIndex& columns_at(int index) const;
     [[nodiscard]] int max_line_width() const;
 
 private:
     std::vector<std::string> _lines;
+    // Display widths are measured once per appended line, so rendering and scrolling never rescan the lines.
+    std::vector<TextColumnIndex> _line_columns;
+    int _max_line_width = 0;
 };
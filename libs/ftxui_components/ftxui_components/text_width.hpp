@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Display width of UTF-8 text as FTXUI lays it out in cells: control characters, invalid bytes and combining marks take
+// no cell, East Asian wide characters and most emoji take two, everything else one.
+
+struct TextColumnPosition
+{
+    std::size_t byte = 0;
+    int column       = 0;
+};
+
+// Returns whether text only holds printable ASCII, where display columns and bytes coincide. Checks eight bytes at a time.
+[[nodiscard]] bool text_is_plain_ascii(std::string_view text);
+
+[[nodiscard]] int text_display_width(std::string_view text);
+
+// Maps the display columns of one line to byte offsets, so clipping and selecting by column need not rescan the line.
+// Plain ASCII lines keep no table; other lines keep the position of one glyph every checkpoint_stride columns.
+class TextColumnIndex
+{
+public:
+    static constexpr int checkpoint_stride = 64;
+
+    TextColumnIndex() = default;
+    explicit TextColumnIndex(std::string_view text);
+
+    // Index of a line already known to be plain ASCII, built without reading it.
+    [[nodiscard]] static TextColumnIndex plain(std::size_t byte_count);
+
+    [[nodiscard]] int width() const;
+    // Returns the byte offset of the glyph that covers column, or the size of text past its end.
+    [[nodiscard]] std::size_t byte_offset(std::string_view text, int column) const;
+    // Appends the columns [first_col, last_col) of text; a wide glyph cut by either edge is replaced by spaces.
+    void append_columns(std::string_view text, int first_col, int last_col, std::string& output) const;
+    [[nodiscard]] std::size_t memory_bytes() const;
+
+private:
+    [[nodiscard]] TextColumnPosition seek(int column) const;
+
+    bool _plain = true;
+    int _width  = 0;
+    std::vector<TextColumnPosition> _checkpoints;
+};
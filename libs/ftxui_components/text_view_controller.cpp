@@ -239,17 +239,8 @@ TextViewRenderData TextViewController::render_data(int viewport_line_count) cons
     data.visible_lines.reserve(static_cast<std::size_t>(std::max(0, end - first)));
     for (int index = first; index < end; ++index)
     {
-        const std::string& line = _model.line_at(index);
-        const int line_len      = static_cast<int>(line.size());
-        if (first_col >= line_len)
-        {
-            data.visible_lines.emplace_back();
-        }
-        else
-        {
-            const int visible = std::min(line_len - first_col, safe_col_viewport);
-            data.visible_lines.push_back(line.substr(static_cast<std::size_t>(first_col), static_cast<std::size_t>(visible)));
-        }
+        std::string& visible_line = data.visible_lines.emplace_back();
+        _model.columns_at(index).append_columns(_model.line_at(index), first_col, first_col + safe_col_viewport, visible_line);
     }
 
     return data;
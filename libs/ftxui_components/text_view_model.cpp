@@ -6,12 +6,17 @@
 
 void TextViewModel::append_line(std::string line)
 {
+    _line_columns.emplace_back(line);
+    _max_line_width = std::max(_max_line_width, _line_columns.back().width());
     _lines.push_back(std::move(line));
 }
 
 void TextViewModel::append_lines(const std::vector<std::string>& lines)
 {
-    _lines.insert(_lines.end(), lines.begin(), lines.end());
+    for (const auto& line : lines)
+    {
+        append_line(line);
+    }
 }
 
 int TextViewModel::line_count() const
@@ -29,12 +34,17 @@ const std::string& TextViewModel::line_at(int index) const
     return _lines[static_cast<std::size_t>(index)];
 }
 
-int TextViewModel::max_line_width() const
+const TextColumnIndex& TextViewModel::columns_at(int index) const
 {
-    int max_width = 0;
-    for (const auto& line : _lines)
+    if (index < 0 || index >= line_count())
     {
-        max_width = std::max(max_width, static_cast<int>(line.size()));
+        throw std::out_of_range("TextViewModel::columns_at index out of range");
     }
-    return max_width;
+
+    return _line_columns[static_cast<std::size_t>(index)];
+}
+
+int TextViewModel::max_line_width() const
+{
+    return _max_line_width;
 }
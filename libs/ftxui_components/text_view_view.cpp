@@ -1,4 +1,5 @@
 #include <ftxui_components/text_view_view.hpp>
+#include <ftxui_components/text_width.hpp>
 
 #include <ftxui/component/mouse.hpp>
 #include <ftxui/dom/elements.hpp>
@@ -90,7 +91,7 @@ void style_line_decorations(ftxui::Canvas& canvas, int row, const TextViewRender
 {
     const int line_index = data.first_visible_line + row;
     const auto& line     = data.visible_lines[static_cast<std::size_t>(row)];
-    const int line_width = std::min(static_cast<int>(line.size()), effective_viewport_col_count(data));
+    const int line_width = std::min(text_display_width(line), effective_viewport_col_count(data));
     if (line_width <= 0)
     {
         return;
@@ -297,6 +298,6 @@ std::optional<TextViewPosition> TextViewView::mouse_to_text_position(const TextV
 
     TextViewPosition position;
     position.line_index = line_index;
-    position.column     = std::clamp(column, data.first_visible_col, data.first_visible_col + static_cast<int>(line.size()));
+    position.column     = std::clamp(column, data.first_visible_col, data.first_visible_col + text_display_width(line));
     return position;
 }
@@ -0,0 +1,297 @@
+#include <ftxui_components/text_width.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+namespace
+{
+
+struct CodepointRange
+{
+    std::uint32_t first = 0;
+    std::uint32_t last  = 0;
+};
+
+// The common zero-width ranges: combining marks, zero-width spaces and joiners, variation selectors and emoji skin tones.
+constexpr std::array<CodepointRange, 27> zero_width_ranges = {{
+    {0x0300, 0x036F},   {0x0483, 0x0489},   {0x0591, 0x05BD},   {0x05BF, 0x05BF},   {0x05C1, 0x05C2},   {0x05C4, 0x05C5},   {0x05C7, 0x05C7},
+    {0x0610, 0x061A},   {0x064B, 0x065F},   {0x0670, 0x0670},   {0x06D6, 0x06DC},   {0x06DF, 0x06E4},   {0x06E7, 0x06E8},   {0x06EA, 0x06ED},
+    {0x0900, 0x0902},   {0x093C, 0x093C},   {0x0941, 0x0948},   {0x094D, 0x094D},   {0x0E31, 0x0E31},   {0x0E34, 0x0E3A},   {0x1AB0, 0x1AFF},
+    {0x1DC0, 0x1DFF},   {0x200B, 0x200F},   {0x20D0, 0x20FF},   {0xFE00, 0xFE0F},   {0x1F3FB, 0x1F3FF}, {0xE0100, 0xE01EF},
+}};
+
+// East Asian wide and fullwidth characters and the emoji blocks terminals draw two cells wide.
+constexpr std::array<CodepointRange, 24> wide_ranges = {{
+    {0x1100, 0x115F},   {0x231A, 0x231B},   {0x2329, 0x232A},   {0x23E9, 0x23EC},   {0x2614, 0x2615},   {0x2648, 0x2653},
+    {0x26AA, 0x26AB},   {0x26BD, 0x26BE},   {0x2705, 0x2705},   {0x274C, 0x274C},   {0x2B1B, 0x2B1C},   {0x2E80, 0x303E},
+    {0x3041, 0xA4CF},   {0xA960, 0xA97F},   {0xAC00, 0xD7A3},   {0xF900, 0xFAFF},   {0xFE10, 0xFE19},   {0xFE30, 0xFE6F},
+    {0xFF00, 0xFF60},   {0xFFE0, 0xFFE6},   {0x1F300, 0x1F64F}, {0x1F680, 0x1F6FF}, {0x1F900, 0x1F9FF}, {0x20000, 0x3FFFD},
+}};
+
+template <std::size_t Size>
+bool in_ranges(const std::array<CodepointRange, Size>& ranges, std::uint32_t codepoint)
+{
+    const auto range = std::upper_bound(ranges.begin(), ranges.end(), codepoint, [](std::uint32_t value, const CodepointRange& candidate) { return value < candidate.first; });
+    return range != ranges.begin() && codepoint <= std::prev(range)->last;
+}
+
+int codepoint_width(std::uint32_t codepoint)
+{
+    if (codepoint < 0x20 || (codepoint >= 0x7F && codepoint < 0xA0))
+    {
+        return 0;
+    }
+
+    if (codepoint < 0x300)
+    {
+        return 1;
+    }
+
+    if (in_ranges(zero_width_ranges, codepoint))
+    {
+        return 0;
+    }
+
+    return in_ranges(wide_ranges, codepoint) ? 2 : 1;
+}
+
+struct DecodedCodepoint
+{
+    std::size_t end = 0;
+    int width       = 0;
+};
+
+// Invalid bytes are skipped one at a time and take no cell, as FTXUI drops them.
+DecodedCodepoint decode_at(std::string_view text, std::size_t byte)
+{
+    const auto lead = static_cast<unsigned char>(text[byte]);
+    if (lead < 0x80)
+    {
+        return {byte + 1, codepoint_width(lead)};
+    }
+
+    std::size_t length      = 0;
+    std::uint32_t codepoint = 0;
+    std::uint32_t min_value = 0;
+    if ((lead & 0xE0) == 0xC0)
+    {
+        length    = 2;
+        codepoint = lead & 0x1F;
+        min_value = 0x80;
+    }
+    else if ((lead & 0xF0) == 0xE0)
+    {
+        length    = 3;
+        codepoint = lead & 0x0F;
+        min_value = 0x800;
+    }
+    else if ((lead & 0xF8) == 0xF0)
+    {
+        length    = 4;
+        codepoint = lead & 0x07;
+        min_value = 0x10000;
+    }
+    else
+    {
+        return {byte + 1, 0};
+    }
+
+    if (byte + length > text.size())
+    {
+        return {byte + 1, 0};
+    }
+
+    for (std::size_t offset = 1; offset < length; ++offset)
+    {
+        const auto continuation = static_cast<unsigned char>(text[byte + offset]);
+        if ((continuation & 0xC0) != 0x80)
+        {
+            return {byte + 1, 0};
+        }
+
+        codepoint = (codepoint << 6) | (continuation & 0x3F);
+    }
+
+    if (codepoint < min_value || codepoint > 0x10FFFF)
+    {
+        return {byte + 1, 0};
+    }
+
+    return {byte + length, codepoint_width(codepoint)};
+}
+
+} // namespace
+
+bool text_is_plain_ascii(std::string_view text)
+{
+    constexpr std::uint64_t ones      = 0x0101010101010101ULL;
+    constexpr std::uint64_t high_bits = 0x8080808080808080ULL;
+
+    std::size_t index = 0;
+    for (; index + sizeof(std::uint64_t) <= text.size(); index += sizeof(std::uint64_t))
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, text.data() + index, sizeof(word));
+        // Sets a byte's high bit when the byte is not ASCII, is below a space or is DEL; only exact for words of ASCII
+        // bytes, but any other word is rejected by its own high bits anyway.
+        const std::uint64_t below_space = (word - ones * 0x20) & ~word;
+        const std::uint64_t xor_delete  = word ^ (ones * 0x7F);
+        const std::uint64_t is_delete   = (xor_delete - ones) & ~xor_delete;
+        if (((word | below_space | is_delete) & high_bits) != 0)
+        {
+            return false;
+        }
+    }
+
+    for (; index < text.size(); ++index)
+    {
+        const auto byte = static_cast<unsigned char>(text[index]);
+        if (byte < 0x20 || byte >= 0x7F)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int text_display_width(std::string_view text)
+{
+    if (text_is_plain_ascii(text))
+    {
+        return static_cast<int>(std::min<std::size_t>(text.size(), std::numeric_limits<int>::max()));
+    }
+
+    int width = 0;
+    for (std::size_t byte = 0; byte < text.size();)
+    {
+        const auto decoded = decode_at(text, byte);
+        width += decoded.width;
+        byte = decoded.end;
+    }
+
+    return width;
+}
+
+TextColumnIndex::TextColumnIndex(std::string_view text)
+{
+    if (text_is_plain_ascii(text))
+    {
+        *this = plain(text.size());
+        return;
+    }
+
+    _plain = false;
+    for (std::size_t byte = 0; byte < text.size();)
+    {
+        const auto decoded = decode_at(text, byte);
+        if (decoded.width > 0 && (_checkpoints.empty() || _width >= _checkpoints.back().column + checkpoint_stride))
+        {
+            _checkpoints.push_back(TextColumnPosition {byte, _width});
+        }
+
+        _width += decoded.width;
+        byte = decoded.end;
+    }
+}
+
+TextColumnIndex TextColumnIndex::plain(std::size_t byte_count)
+{
+    TextColumnIndex index;
+    index._width = static_cast<int>(std::min<std::size_t>(byte_count, std::numeric_limits<int>::max()));
+    return index;
+}
+
+int TextColumnIndex::width() const
+{
+    return _width;
+}
+
+std::size_t TextColumnIndex::byte_offset(std::string_view text, int column) const
+{
+    if (_plain)
+    {
+        return std::min(static_cast<std::size_t>(std::max(0, column)), text.size());
+    }
+
+    TextColumnPosition position = seek(column);
+    while (position.byte < text.size())
+    {
+        const auto decoded = decode_at(text, position.byte);
+        if (decoded.width > 0 && position.column + decoded.width > column)
+        {
+            return position.byte;
+        }
+
+        position.column += decoded.width;
+        position.byte = decoded.end;
+    }
+
+    return text.size();
+}
+
+void TextColumnIndex::append_columns(std::string_view text, int first_col, int last_col, std::string& output) const
+{
+    first_col = std::max(0, first_col);
+    last_col  = std::min(last_col, _width);
+    if (first_col >= last_col)
+    {
+        return;
+    }
+
+    if (_plain)
+    {
+        output.append(text.substr(static_cast<std::size_t>(first_col), static_cast<std::size_t>(last_col - first_col)));
+        return;
+    }
+
+    TextColumnPosition position = seek(first_col);
+    bool previous_appended      = false;
+    while (position.byte < text.size())
+    {
+        const auto decoded  = decode_at(text, position.byte);
+        const auto glyph    = text.substr(position.byte, decoded.end - position.byte);
+        const int glyph_end = position.column + decoded.width;
+        if (decoded.width == 0)
+        {
+            // Combining marks stay with the glyph before them.
+            if (previous_appended)
+            {
+                output.append(glyph);
+            }
+        }
+        else if (position.column >= last_col)
+        {
+            break;
+        }
+        else if (position.column >= first_col && glyph_end <= last_col)
+        {
+            output.append(glyph);
+            previous_appended = true;
+        }
+        else
+        {
+            const int covered = std::min(glyph_end, last_col) - std::max(position.column, first_col);
+            output.append(static_cast<std::size_t>(std::max(0, covered)), ' ');
+            previous_appended = false;
+        }
+
+        position.column = glyph_end;
+        position.byte   = decoded.end;
+    }
+}
+
+std::size_t TextColumnIndex::memory_bytes() const
+{
+    return _checkpoints.capacity() * sizeof(TextColumnPosition);
+}
+
+TextColumnPosition TextColumnIndex::seek(int column) const
+{
+    const auto checkpoint = std::upper_bound(_checkpoints.begin(), _checkpoints.end(), column, [](int value, const TextColumnPosition& candidate) { return value < candidate.column; });
+    return checkpoint == _checkpoints.begin() ? TextColumnPosition {} : *std::prev(checkpoint);
+}
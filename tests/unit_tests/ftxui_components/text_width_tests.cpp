@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <ftxui_components/text_width.hpp>
+
+#include <string>
+
+TEST(TextWidthTest, MeasuresAsciiWideAndCombiningCharacters)
+{
+    EXPECT_TRUE(text_is_plain_ascii("plain ascii text, longer than one word"));
+    EXPECT_FALSE(text_is_plain_ascii("tab\tinside a long enough line"));
+    EXPECT_FALSE(text_is_plain_ascii("caf\xC3\xA9"));
+
+    EXPECT_EQ(text_display_width("hello"), 5);
+    EXPECT_EQ(text_display_width("\xE6\x97\xA5\xE6\x9C\xAC"), 4);
+    EXPECT_EQ(text_display_width("e\xCC\x81"), 1);
+    EXPECT_EQ(text_display_width("a\tb"), 2);
+    EXPECT_EQ(text_display_width("\xFF"), 0);
+}
+
+TEST(TextWidthTest, ColumnIndexMapsColumnsToBytes)
+{
+    std::string text = "ab\xE6\x97\xA5" "cd";
+    for (int index = 0; index < 100; ++index)
+    {
+        text += "\xC3\xA9";
+    }
+
+    const TextColumnIndex columns(text);
+    EXPECT_EQ(columns.width(), 106);
+    EXPECT_EQ(columns.byte_offset(text, 0), 0U);
+    EXPECT_EQ(columns.byte_offset(text, 2), 2U);
+    EXPECT_EQ(columns.byte_offset(text, 3), 2U);
+    EXPECT_EQ(columns.byte_offset(text, 4), 5U);
+    EXPECT_EQ(columns.byte_offset(text, 6 + 90), 7U + 180U);
+    EXPECT_EQ(columns.byte_offset(text, 106), text.size());
+}
+
+TEST(TextWidthTest, AppendColumnsPadsWideGlyphsCutByTheWindow)
+{
+    const std::string text = "a\xE6\x97\xA5" "be\xCC\x81";
+    const TextColumnIndex columns(text);
+    ASSERT_EQ(columns.width(), 5);
+
+    std::string output;
+    columns.append_columns(text, 0, 5, output);
+    EXPECT_EQ(output, text);
+
+    output.clear();
+    columns.append_columns(text, 2, 5, output);
+    EXPECT_EQ(output, " be\xCC\x81");
+
+    output.clear();
+    columns.append_columns(text, 0, 2, output);
+    EXPECT_EQ(output, "a ");
+
+    output.clear();
+    columns.append_columns(text, 4, 5, output);
+    EXPECT_EQ(output, "e\xCC\x81");
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "process_pipe.hpp"
+#include "watchers/archive_watcher.hpp"
+#include "watchers/file_watcher.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+// gzip -n of "rotated two a\nrotated two b\n".
+const std::vector<unsigned char> gzip_member {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x2b, 0xca, 0x2f, 0x49, 0x2c, 0x49, 0x4d, 0x51, 0x28, 0x29, 0xcf,
+    0x57, 0x48, 0xe4, 0x2a, 0x42, 0xe2, 0x25, 0x71, 0x01, 0x00, 0xad, 0x5c, 0x60, 0xde, 0x1c, 0x00, 0x00, 0x00,
+};
+
+// zstd of "rotated one a\nrotated one b", deliberately without a final newline.
+const std::vector<unsigned char> zstd_member {
+    0x28, 0xb5, 0x2f, 0xfd, 0x00, 0x68, 0xad, 0x00, 0x00, 0x78, 0x72, 0x6f, 0x74, 0x61, 0x74, 0x65, 0x64,
+    0x20, 0x6f, 0x6e, 0x65, 0x20, 0x61, 0x0a, 0x62, 0x01, 0x00, 0xc1, 0x4d, 0x25,
+};
+
+class ScopedTestDirectory
+{
+public:
+    ScopedTestDirectory()
+    {
+        const auto unique_suffix = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        _path                    = std::filesystem::temp_directory_path() / ("slayerlog_archive_watcher_" + unique_suffix);
+        std::filesystem::create_directories(_path);
+    }
+
+    ~ScopedTestDirectory()
+    {
+        std::error_code error;
+        std::filesystem::remove_all(_path, error);
+    }
+
+    std::string write(const std::string& name, const std::string& content) const
+    {
+        const auto file_path = _path / name;
+        std::ofstream output(file_path, std::ios::binary | std::ios::trunc);
+        output << content;
+        return file_path.string();
+    }
+
+    std::string write(const std::string& name, const std::vector<unsigned char>& content) const
+    {
+        return write(name, std::string(content.begin(), content.end()));
+    }
+
+private:
+    std::filesystem::path _path;
+};
+
+bool decompressor_available(const std::string& executable)
+{
+    try
+    {
+        ProcessPipe pipe(executable, {"--version"});
+        return pipe.wait() == 0;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+std::vector<std::string> poll_until(LogWatcher& watcher, std::size_t expected_line_count)
+{
+    std::vector<std::string> collected;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (collected.size() < expected_line_count && std::chrono::steady_clock::now() < deadline)
+    {
+        std::vector<std::string> lines;
+        watcher.poll(lines);
+        collected.insert(collected.end(), lines.begin(), lines.end());
+        if (lines.empty())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    return collected;
+}
+
+} // namespace
+
+TEST(ArchiveWatcherTest, BuildsDecompressorCommands)
+{
+    EXPECT_EQ(ArchiveWatcher::build_decompressor_arguments(LogCompression::Gzip, "app.log.1.gz"), (std::vector<std::string> {"gzip", "-dc", "--", "app.log.1.gz"}));
+    EXPECT_EQ(ArchiveWatcher::build_decompressor_arguments(LogCompression::Zstd, "app.log.2.zst"), (std::vector<std::string> {"zstd", "-dcq", "--", "app.log.2.zst"}));
+}
+
+TEST(ArchiveWatcherTest, ReadsRotationChainOldestFirstThenTailsLiveFile)
+{
+    if (!decompressor_available("gzip") || !decompressor_available("zstd"))
+    {
+        GTEST_SKIP() << "gzip and zstd are required on PATH";
+    }
+
+    ScopedTestDirectory directory;
+    const auto oldest  = directory.write("app.log.3", "rotated three\n");
+    const auto gzipped = directory.write("app.log.2.gz", gzip_member);
+    const auto zstd    = directory.write("app.log.1.zst", zstd_member);
+    const auto live    = directory.write("app.log", "live one\n");
+
+    ArchiveWatcher watcher({oldest, gzipped, zstd}, std::make_unique<FileWatcher>(live));
+
+    EXPECT_EQ(poll_until(watcher, 6), (std::vector<std::string> {"rotated three", "rotated two a", "rotated two b", "rotated one a", "rotated one b", "live one"}));
+
+    directory.write("app.log", "live one\nlive two\n");
+    EXPECT_EQ(poll_until(watcher, 1), (std::vector<std::string> {"live two"}));
+}
+
+TEST(ArchiveWatcherTest, ReportsCorruptArchiveAndContinues)
+{
+    if (!decompressor_available("gzip"))
+    {
+        GTEST_SKIP() << "gzip is required on PATH";
+    }
+
+    ScopedTestDirectory directory;
+    std::vector<unsigned char> corrupt(gzip_member.begin(), gzip_member.begin() + 12);
+    const auto broken = directory.write("app.log.2.gz", corrupt);
+    const auto plain  = directory.write("app.log.1", "after corrupt\n");
+
+    ArchiveWatcher watcher({broken, plain}, nullptr);
+    const auto lines = poll_until(watcher, 2);
+
+    ASSERT_GE(lines.size(), 2U);
+    EXPECT_EQ(lines.front().rfind("[slayerlog] failed to decompress " + broken, 0), 0U);
+    EXPECT_EQ(lines.back(), "after corrupt");
+
+    std::vector<std::string> idle_lines;
+    EXPECT_FALSE(watcher.poll(idle_lines));
+}
+
+} // namespace slayerlog
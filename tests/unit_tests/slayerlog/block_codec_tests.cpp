@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "block_codec.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+std::string round_trip(const std::string& input)
+{
+    const std::string compressed = compress_block(input);
+    std::string output           = "stale";
+    decompress_block(compressed, input.size(), output);
+    return output;
+}
+
+} // namespace
+
+TEST(BlockCodecTest, RoundTripsShortAndEmptyBlocks)
+{
+    EXPECT_EQ(round_trip(""), "");
+    EXPECT_EQ(round_trip("a"), "a");
+    EXPECT_EQ(round_trip("abcdabcdabcd"), "abcdabcdabcd");
+}
+
+TEST(BlockCodecTest, CompressesRepetitiveLogText)
+{
+    std::string input;
+    for (int index = 0; index < 2000; ++index)
+    {
+        input += "2024-05-01 12:00:" + std::to_string(index % 60) + " INFO worker[" + std::to_string(index % 7) + "] processed request id=" + std::to_string(index) + "\n";
+    }
+
+    const std::string compressed = compress_block(input);
+    EXPECT_LT(compressed.size() * 4, input.size());
+
+    std::string output;
+    decompress_block(compressed, input.size(), output);
+    EXPECT_EQ(output, input);
+}
+
+TEST(BlockCodecTest, RoundTripsIncompressibleAndOverlappingData)
+{
+    std::mt19937 generator(7);
+    std::string random_bytes(100000, '\0');
+    for (char& byte : random_bytes)
+    {
+        byte = static_cast<char>(generator() & 0xFF);
+    }
+
+    EXPECT_EQ(round_trip(random_bytes), random_bytes);
+    EXPECT_EQ(round_trip(std::string(70000, 'x')), std::string(70000, 'x'));
+}
+
+TEST(BlockCodecTest, RejectsCorruptBlocks)
+{
+    const std::string input      = std::string(1000, 'a') + "tail of the block";
+    const std::string compressed = compress_block(input);
+    std::string output;
+
+    EXPECT_THROW(decompress_block(compressed, input.size() + 1, output), std::runtime_error);
+    EXPECT_THROW(decompress_block(compressed.substr(0, compressed.size() / 2), input.size(), output), std::runtime_error);
+}
+
+} // namespace slayerlog
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "clipboard.hpp"
+
+namespace slayerlog
+{
+
+TEST(ClipboardTest, TextAboveTheClipboardLimitIsSavedToATempFile)
+{
+    ClipboardLimits limits;
+    limits.osc52_max_bytes     = 4;
+    limits.clipboard_max_bytes = 4;
+
+    const std::string text = "first line\nsecond line";
+    const auto result      = copy_text_to_clipboard(text, limits);
+
+    EXPECT_FALSE(result.copied);
+    ASSERT_TRUE(result.saved_path.has_value());
+
+    std::ifstream input(*result.saved_path, std::ios::binary);
+    std::ostringstream content;
+    content << input.rdbuf();
+    input.close();
+    EXPECT_EQ(content.str(), text);
+
+    std::filesystem::remove(*result.saved_path);
+}
+
+} // namespace slayerlog
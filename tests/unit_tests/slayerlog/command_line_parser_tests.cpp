@@ -50,6 +50,8 @@ TEST(CommandLineParserTest, AllowsStartingWithoutAnyFiles)
 
     EXPECT_TRUE(config.file_paths.empty());
     EXPECT_EQ(config.poll_interval_ms, 250);
+    EXPECT_EQ(config.max_lines, 0U);
+    EXPECT_EQ(config.max_memory_bytes, 0U);
 }
 
 TEST(CommandLineParserTest, ParsesProvidedFilesAndPollInterval)
@@ -75,6 +77,123 @@ TEST(CommandLineParserTest, ParsesPositionalFiles)
     EXPECT_EQ(config.file_paths[1], "second.log");
 }
 
+TEST(CommandLineParserTest, AcceptsStdinAndCommandSources)
+{
+    ArgumentBuffer arguments {"slayerlog", "-", "-f", "cmd:journalctl -f"};
+
+    const auto config = parse_command_line(arguments.argc(), arguments.argv());
+
+    EXPECT_EQ(config.file_paths, (std::vector<std::string> {"-", "cmd:journalctl -f"}));
+}
+
+TEST(CommandLineParserTest, ParsesRetentionLimits)
+{
+    ArgumentBuffer arguments {"slayerlog", "--max-lines", "100000", "--max-memory", "512M", "app.log"};
+
+    const auto config = parse_command_line(arguments.argc(), arguments.argv());
+
+    EXPECT_EQ(config.max_lines, 100000U);
+    EXPECT_EQ(config.max_memory_bytes, 512U * 1024U * 1024U);
+}
+
+TEST(CommandLineParserTest, ParsesMaxPausedMemory)
+{
+    ArgumentBuffer defaults {"slayerlog"};
+    EXPECT_EQ(parse_command_line(defaults.argc(), defaults.argv()).max_paused_memory_bytes, 256U * 1024U * 1024U);
+
+    ArgumentBuffer arguments {"slayerlog", "--max-paused-memory", "64M"};
+    EXPECT_EQ(parse_command_line(arguments.argc(), arguments.argv()).max_paused_memory_bytes, 64U * 1024U * 1024U);
+
+    ArgumentBuffer invalid {"slayerlog", "--max-paused-memory", "lots"};
+    EXPECT_THROW(parse_command_line(invalid.argc(), invalid.argv()), boost::program_options::error);
+}
+
+TEST(CommandLineParserTest, ParsesJsonFields)
+{
+    ArgumentBuffer defaults {"slayerlog"};
+    EXPECT_TRUE(parse_command_line(defaults.argc(), defaults.argv()).json_fields.empty());
+
+    ArgumentBuffer arguments {"slayerlog", "--json-fields", "level,,trace_id,latency_ms"};
+    EXPECT_EQ(parse_command_line(arguments.argc(), arguments.argv()).json_fields, (std::vector<std::string> {"level", "trace_id", "latency_ms"}));
+}
+
+TEST(CommandLineParserTest, ParsesLevelTokens)
+{
+    ArgumentBuffer arguments {"slayerlog", "--level-token", "error=E", "--level-token", "warn=W"};
+    const auto config = parse_command_line(arguments.argc(), arguments.argv());
+    ASSERT_EQ(config.level_tokens.size(), 2U);
+    EXPECT_EQ(config.level_tokens[0].level, LogLevel::Error);
+    EXPECT_EQ(config.level_tokens[1].token, "W");
+
+    ArgumentBuffer invalid {"slayerlog", "--level-token", "loud=L"};
+    EXPECT_THROW(parse_command_line(invalid.argc(), invalid.argv()), boost::program_options::error);
+}
+
+TEST(CommandLineParserTest, ParsesLongLineLimits)
+{
+    ArgumentBuffer defaults {"slayerlog"};
+    const auto default_config = parse_command_line(defaults.argc(), defaults.argv());
+    EXPECT_EQ(default_config.max_line_display_bytes, 64U * 1024U);
+    EXPECT_EQ(default_config.search_prefix_bytes, 0U);
+
+    ArgumentBuffer arguments {"slayerlog", "--max-line-display", "0", "--search-prefix", "4K"};
+    const auto config = parse_command_line(arguments.argc(), arguments.argv());
+    EXPECT_EQ(config.max_line_display_bytes, 0U);
+    EXPECT_EQ(config.search_prefix_bytes, 4U * 1024U);
+
+    ArgumentBuffer invalid {"slayerlog", "--search-prefix", "some"};
+    EXPECT_THROW(parse_command_line(invalid.argc(), invalid.argv()), boost::program_options::error);
+}
+
+TEST(CommandLineParserTest, ThrowsOnInvalidMaxMemory)
+{
+    ArgumentBuffer arguments {"slayerlog", "--max-memory", "12X"};
+
+    EXPECT_THROW(parse_command_line(arguments.argc(), arguments.argv()), boost::program_options::error);
+}
+
+TEST(CommandLineParserTest, ParsesColdStorageMode)
+{
+    ArgumentBuffer arguments {"slayerlog", "--cold-storage", "spill", "app.log"};
+
+    const auto config = parse_command_line(arguments.argc(), arguments.argv());
+
+    EXPECT_EQ(config.cold_storage, ColdStorageMode::Spilled);
+
+    ArgumentBuffer invalid_arguments {"slayerlog", "--cold-storage", "zip"};
+    EXPECT_THROW(parse_command_line(invalid_arguments.argc(), invalid_arguments.argv()), boost::program_options::error);
+}
+
+TEST(CommandLineParserTest, ParsesSshCompressionSwitch)
+{
+    ArgumentBuffer default_arguments {"slayerlog", "app.log"};
+    EXPECT_FALSE(parse_command_line(default_arguments.argc(), default_arguments.argv()).ssh_compression);
+
+    ArgumentBuffer arguments {"slayerlog", "--ssh-compression", "ssh://host/var/log/app.log"};
+    EXPECT_TRUE(parse_command_line(arguments.argc(), arguments.argv()).ssh_compression);
+}
+
+TEST(CommandLineParserTest, ParsesRemoteFilterSwitch)
+{
+    ArgumentBuffer default_arguments {"slayerlog", "app.log"};
+    EXPECT_FALSE(parse_command_line(default_arguments.argc(), default_arguments.argv()).remote_filter);
+
+    ArgumentBuffer arguments {"slayerlog", "--remote-filter", "ssh://host/var/log/app.log"};
+    EXPECT_TRUE(parse_command_line(arguments.argc(), arguments.argv()).remote_filter);
+}
+
+TEST(CommandLineParserTest, ParsesMaxFps)
+{
+    ArgumentBuffer default_arguments {"slayerlog", "app.log"};
+    EXPECT_EQ(parse_command_line(default_arguments.argc(), default_arguments.argv()).max_fps, 30);
+
+    ArgumentBuffer arguments {"slayerlog", "--max-fps", "0", "app.log"};
+    EXPECT_EQ(parse_command_line(arguments.argc(), arguments.argv()).max_fps, 0);
+
+    ArgumentBuffer negative_arguments {"slayerlog", "--max-fps=-1"};
+    EXPECT_THROW(parse_command_line(negative_arguments.argc(), negative_arguments.argv()), boost::program_options::error);
+}
+
 TEST(CommandLineParserTest, ThrowsOnNonPositivePollInterval)
 {
     ArgumentBuffer arguments {"slayerlog", "--poll-interval-ms", "0"};
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pipe_reactor.hpp"
+#include "watchers/command_watcher.hpp"
+#include "watchers/stdin_watcher.hpp"
+
+#ifndef _WIN32
+#    include <unistd.h>
+#endif
+
+namespace slayerlog
+{
+
+namespace
+{
+
+std::vector<std::string> poll_until(LogWatcher& watcher, const std::function<bool(const std::vector<std::string>&)>& done)
+{
+    std::vector<std::string> collected;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline && !done(collected))
+    {
+        std::vector<std::string> lines;
+        watcher.poll(lines);
+        collected.insert(collected.end(), lines.begin(), lines.end());
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return collected;
+}
+
+bool ends_with_exit_message(const std::vector<std::string>& lines)
+{
+    return !lines.empty() && lines.back().rfind("[slayerlog] command", 0) == 0;
+}
+
+} // namespace
+
+#ifndef _WIN32
+
+TEST(CommandWatcherTest, StreamsStdoutAndStderrUntilExit)
+{
+    PipeReactor reactor;
+    CommandWatcher watcher("printf 'first\\nsecond\\n'; printf 'problem\\n' >&2; printf 'tail'", &reactor);
+
+    EXPECT_TRUE(reactor.wait(std::chrono::seconds(5)));
+    const auto lines = poll_until(watcher, ends_with_exit_message);
+
+    ASSERT_EQ(lines.size(), 5U);
+    EXPECT_EQ(lines[0], "first");
+    EXPECT_EQ(lines[1], "second");
+    EXPECT_EQ(lines[2], "problem");
+    EXPECT_EQ(lines[3], "tail");
+    EXPECT_EQ(lines[4], "[slayerlog] command exited with code 0: printf 'first\\nsecond\\n'; printf 'problem\\n' >&2; printf 'tail'");
+
+    std::vector<std::string> after_exit;
+    EXPECT_FALSE(watcher.poll(after_exit));
+}
+
+TEST(CommandWatcherTest, ReportsMissingCommand)
+{
+    CommandWatcher watcher("slayerlog-command-that-does-not-exist");
+
+    const auto lines = poll_until(watcher, ends_with_exit_message);
+
+    ASSERT_FALSE(lines.empty());
+    EXPECT_EQ(lines.back(), "[slayerlog] command not found: slayerlog-command-that-does-not-exist");
+}
+
+TEST(CommandWatcherTest, FinishedCommandLeavesTheReactorWhenAChildKeepsItsOutputOpen)
+{
+    PipeReactor reactor;
+    CommandWatcher watcher("(sleep 0.2; echo late) & echo done", &reactor);
+
+    const auto lines = poll_until(watcher, ends_with_exit_message);
+    ASSERT_FALSE(lines.empty());
+    EXPECT_EQ(lines.front(), "done");
+    EXPECT_EQ(lines.back(), "[slayerlog] command exited with code 0: (sleep 0.2; echo late) & echo done");
+
+    // The background child writes after the command exited; the pipe would stay readable and wake the reactor forever.
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    EXPECT_FALSE(reactor.wait(std::chrono::milliseconds(20)));
+}
+
+TEST(StdinWatcherTest, ReadsPipeUntilWriterCloses)
+{
+    int pipe_handles[2] {-1, -1};
+    ASSERT_EQ(::pipe(pipe_handles), 0);
+
+    PipeReactor reactor;
+    {
+        StdinWatcher watcher(pipe_handles[0], &reactor);
+        ::close(pipe_handles[0]);
+
+        const std::string input = "alpha\nbeta\ngam";
+        ASSERT_EQ(::write(pipe_handles[1], input.data(), input.size()), static_cast<ssize_t>(input.size()));
+        EXPECT_TRUE(reactor.wait(std::chrono::seconds(5)));
+        ::close(pipe_handles[1]);
+
+        const auto lines = poll_until(watcher, [](const std::vector<std::string>& collected) { return !collected.empty() && collected.back() == "[slayerlog] stdin closed"; });
+        EXPECT_EQ(lines, (std::vector<std::string> {"alpha", "beta", "gam", "[slayerlog] stdin closed"}));
+    }
+
+    // The closed pipe left the reactor, so waiting times out instead of reporting it readable forever.
+    EXPECT_FALSE(reactor.wait(std::chrono::milliseconds(20)));
+}
+
+#endif
+
+} // namespace slayerlog
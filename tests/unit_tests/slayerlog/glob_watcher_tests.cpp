@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pipe_reactor.hpp"
+#include "watchers/glob_watcher.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+class GlobWatcherTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        _directory            = std::filesystem::temp_directory_path() / (std::string("slayerlog_glob_watcher_") + test_info->name());
+        std::filesystem::remove_all(_directory);
+        std::filesystem::create_directories(_directory);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(_directory); }
+
+    void append(const std::string& relative_path, const std::string& text) const
+    {
+        const auto path = _directory / relative_path;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream output(path, std::ios::binary | std::ios::app);
+        output << text;
+    }
+
+    std::string pattern(const std::string& relative_pattern) const { return (_directory / relative_pattern).string(); }
+
+    std::filesystem::path _directory;
+};
+
+std::map<std::string, std::vector<std::string>> poll_by_member(GlobWatcher& watcher)
+{
+    std::vector<MemberLineBatch> batches;
+    watcher.poll_members(batches);
+
+    std::map<std::string, std::vector<std::string>> lines_by_member;
+    for (auto& batch : batches)
+    {
+        auto& lines = lines_by_member[batch.member];
+        lines.insert(lines.end(), batch.lines.begin(), batch.lines.end());
+    }
+
+    return lines_by_member;
+}
+
+} // namespace
+
+TEST_F(GlobWatcherTest, ReadsMatchingFilesAsSeparateMembers)
+{
+    append("pod-a/api/0.log", "a1\na2\n");
+    append("pod-b/api/0.log", "b1\n");
+    append("pod-b/api/notes.txt", "ignored\n");
+
+    GlobWatcher watcher(pattern("**/*.log"));
+    const auto lines = poll_by_member(watcher);
+
+    EXPECT_EQ(watcher.file_count(), 2U);
+    ASSERT_EQ(lines.size(), 2U);
+    EXPECT_EQ(lines.at("pod-a/api/0.log"), (std::vector<std::string> {"a1", "a2"}));
+    EXPECT_EQ(lines.at("pod-b/api/0.log"), (std::vector<std::string> {"b1"}));
+
+    append("pod-b/api/0.log", "b2\n");
+    const auto appended = poll_by_member(watcher);
+    ASSERT_EQ(appended.size(), 1U);
+    EXPECT_EQ(appended.at("pod-b/api/0.log"), (std::vector<std::string> {"b2"}));
+}
+
+TEST_F(GlobWatcherTest, PicksUpNewFilesAndDropsDeletedOnes)
+{
+    append("first.log", "one\n");
+    GlobWatcher watcher(pattern("*.log"));
+    EXPECT_EQ(poll_by_member(watcher).size(), 1U);
+
+    append("second.log", "two\n");
+    append("nested/third.log", "not matched by a single-level glob\n");
+    const auto lines = poll_by_member(watcher);
+    ASSERT_EQ(lines.size(), 1U);
+    EXPECT_EQ(lines.at("second.log"), (std::vector<std::string> {"two"}));
+    EXPECT_EQ(watcher.file_count(), 2U);
+
+    std::filesystem::remove(_directory / "first.log");
+    EXPECT_TRUE(poll_by_member(watcher).empty());
+    poll_by_member(watcher);
+    EXPECT_EQ(watcher.file_count(), 1U);
+}
+
+TEST_F(GlobWatcherTest, WakesReactorOnlyForChanges)
+{
+    append("app.log", "first\n");
+    PipeReactor reactor;
+    GlobWatcher watcher(pattern("*.log"), &reactor);
+    if (!watcher.event_driven())
+    {
+        GTEST_SKIP() << "file change notifications are not available on this platform";
+    }
+
+    poll_by_member(watcher);
+    poll_by_member(watcher);
+    EXPECT_FALSE(reactor.wait(std::chrono::milliseconds(20)));
+
+    append("app.log", "second\n");
+    EXPECT_TRUE(reactor.wait(std::chrono::seconds(5)));
+    EXPECT_EQ(poll_by_member(watcher).at("app.log"), (std::vector<std::string> {"second"}));
+}
+
+TEST_F(GlobWatcherTest, RejectsMissingBaseDirectory)
+{
+    EXPECT_THROW(GlobWatcher(pattern("missing/*.log")), std::runtime_error);
+}
+
+} // namespace slayerlog
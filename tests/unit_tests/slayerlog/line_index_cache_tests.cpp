@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "line_index_cache.hpp"
+#include "log_timestamp.hpp"
+#include "watchers/file_watcher.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+class LineIndexCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        _directory            = std::filesystem::temp_directory_path() / (std::string("slayerlog_line_index_") + test_info->name());
+        std::filesystem::remove_all(_directory);
+        std::filesystem::create_directories(_directory);
+        _log_path = (_directory / "app.log").string();
+    }
+
+    void TearDown() override { std::filesystem::remove_all(_directory); }
+
+    void append_numbered_lines(int first, int count) const
+    {
+        std::ofstream output(_log_path, std::ios::binary | std::ios::app);
+        for (int number = first; number < first + count; ++number)
+        {
+            output << "line " << number << '\n';
+        }
+    }
+
+    /** @brief Writes one line per second of the day, starting at first_second. */
+    void append_timed_lines(int first_second, int count) const
+    {
+        std::ofstream output(_log_path, std::ios::binary | std::ios::app);
+        for (int second = first_second; second < first_second + count; ++second)
+        {
+            output << "2026-04-01 " << std::setw(2) << std::setfill('0') << second / 3600 << ':' << std::setw(2) << second / 60 % 60 << ':' << std::setw(2) << second % 60
+                   << " line " << second << '\n';
+        }
+    }
+
+    static std::size_t read_lines(FileWatcher& watcher)
+    {
+        std::vector<std::string> lines;
+        watcher.poll(lines);
+        return lines.size();
+    }
+
+    std::filesystem::path _directory;
+    std::string _log_path;
+};
+
+LineIndex numbered_index(const std::string& file_path)
+{
+    LineIndex index;
+    index.indexed_size = std::filesystem::file_size(file_path);
+    index.line_count   = 2;
+    index.checkpoints  = {{0, 0, std::nullopt}, {7, 1, LogTimePoint(std::chrono::seconds(1'775'000'000))}};
+    return index;
+}
+
+} // namespace
+
+TEST_F(LineIndexCacheTest, LoadsIndexOnlyWhileTheIndexedBytesAreUnchanged)
+{
+    append_numbered_lines(1, 2);
+    LineIndexCache cache(_directory / "cache");
+    ASSERT_TRUE(cache.store(_log_path, numbered_index(_log_path)));
+
+    append_numbered_lines(3, 1);
+    const auto loaded = cache.load(_log_path);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->line_count, 2U);
+    EXPECT_EQ(loaded->indexed_size, std::string("line 1\nline 2\n").size());
+    ASSERT_EQ(loaded->checkpoints.size(), 2U);
+    EXPECT_FALSE(loaded->checkpoints[0].timestamp.has_value());
+    EXPECT_EQ(loaded->checkpoints[1].timestamp, LogTimePoint(std::chrono::seconds(1'775'000'000)));
+    EXPECT_FALSE(cache.load((_directory / "other.log").string()).has_value());
+
+    std::ofstream(_log_path, std::ios::binary | std::ios::trunc) << "LINE 1\nline 2\nline 3\n";
+    EXPECT_FALSE(cache.load(_log_path).has_value());
+}
+
+TEST_F(LineIndexCacheTest, ReopenWithLineLimitReadsOnlyTheEndOfAnIndexedFile)
+{
+    append_numbered_lines(1, 10000);
+    LineIndexCache cache(_directory / "cache");
+    {
+        FileWatcher first_open(_log_path, FileWatcherOptions {&cache, 100});
+        std::vector<std::string> lines;
+        ASSERT_TRUE(first_open.poll(lines));
+        EXPECT_EQ(lines.size(), 10000U);
+        EXPECT_EQ(first_open.skipped_line_count(), 0U);
+    }
+
+    append_numbered_lines(10001, 3);
+    FileWatcher reopened(_log_path, FileWatcherOptions {&cache, 100});
+    EXPECT_EQ(reopened.skipped_line_count(), 2 * LineIndex::checkpoint_interval);
+
+    std::vector<std::string> lines;
+    ASSERT_TRUE(reopened.poll(lines));
+    ASSERT_EQ(lines.size(), 10003U - 2 * LineIndex::checkpoint_interval);
+    EXPECT_EQ(lines.front(), "line " + std::to_string(2 * LineIndex::checkpoint_interval + 1));
+    EXPECT_EQ(lines.back(), "line 10003");
+}
+
+TEST_F(LineIndexCacheTest, OpenWithoutLimitsNeitherUsesNorWritesAnIndex)
+{
+    append_numbered_lines(1, 5000);
+    LineIndexCache cache(_directory / "cache");
+    const auto index_path = std::filesystem::absolute(_log_path).lexically_normal().string();
+    {
+        FileWatcher first_open(_log_path, FileWatcherOptions {&cache});
+        EXPECT_EQ(read_lines(first_open), 5000U);
+    }
+
+    EXPECT_FALSE(cache.load(index_path).has_value());
+    {
+        FileWatcher limited_open(_log_path, FileWatcherOptions {&cache, 100});
+        EXPECT_EQ(read_lines(limited_open), 5000U);
+    }
+
+    ASSERT_TRUE(cache.load(index_path).has_value());
+    FileWatcher reopened(_log_path, FileWatcherOptions {&cache});
+    EXPECT_EQ(reopened.skipped_line_count(), 0U);
+    EXPECT_EQ(read_lines(reopened), 5000U);
+}
+
+TEST_F(LineIndexCacheTest, ResumedFileMovesBackToTheLastCheckpointNoLaterThanAGivenTime)
+{
+    append_timed_lines(3600, 10000);
+    LineIndexCache cache(_directory / "cache");
+    {
+        FileWatcher first_open(_log_path, FileWatcherOptions {&cache, 100});
+        read_lines(first_open);
+    }
+
+    FileWatcher reopened(_log_path, FileWatcherOptions {&cache, 100});
+    ASSERT_EQ(reopened.skipped_line_count(), 2 * LineIndex::checkpoint_interval);
+    EXPECT_EQ(reopened.resume_timestamp(), parse_log_timestamp("2026-04-01 03:16:32"));
+
+    reopened.resume_no_later_than(*parse_log_timestamp("2026-04-01 02:30:00"));
+    EXPECT_EQ(reopened.skipped_line_count(), LineIndex::checkpoint_interval);
+    EXPECT_EQ(reopened.resume_timestamp(), parse_log_timestamp("2026-04-01 02:08:16"));
+
+    reopened.resume_no_later_than(*parse_log_timestamp("2026-04-01 02:08:15"));
+    EXPECT_EQ(reopened.skipped_line_count(), 0U);
+    EXPECT_FALSE(reopened.resume_timestamp().has_value());
+    EXPECT_EQ(read_lines(reopened), 10000U);
+}
+
+} // namespace slayerlog
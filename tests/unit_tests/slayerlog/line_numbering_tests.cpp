@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "line_numbering.hpp"
+
+namespace slayerlog
+{
+
+TEST(LineNumberingTest, NumbersLinesByIndexUntilLinesAreLeftOut)
+{
+    LineNumbering numbering;
+    EXPECT_EQ(numbering.line_number(AllLineIndex {0}), 1);
+    EXPECT_EQ(numbering.line_number(AllLineIndex {9}), 10);
+    EXPECT_EQ(numbering.first_index_at_or_after(10).value, 9);
+}
+
+TEST(LineNumberingTest, CountsLeftOutLinesTowardsTheLinesAfterThem)
+{
+    LineNumbering numbering;
+    numbering.skip_before(AllLineIndex {1}, 3);
+    numbering.skip_before(AllLineIndex {3}, 2);
+
+    EXPECT_EQ(numbering.line_number(AllLineIndex {0}), 1);
+    EXPECT_EQ(numbering.line_number(AllLineIndex {1}), 5);
+    EXPECT_EQ(numbering.line_number(AllLineIndex {2}), 6);
+    EXPECT_EQ(numbering.line_number(AllLineIndex {3}), 9);
+    EXPECT_EQ(numbering.line_number(AllLineIndex {4}), 10);
+
+    EXPECT_EQ(numbering.first_index_at_or_after(1).value, 0);
+    EXPECT_EQ(numbering.first_index_at_or_after(2).value, 1);
+    EXPECT_EQ(numbering.first_index_at_or_after(5).value, 1);
+    EXPECT_EQ(numbering.first_index_at_or_after(6).value, 2);
+    EXPECT_EQ(numbering.first_index_at_or_after(7).value, 3);
+    EXPECT_EQ(numbering.first_index_at_or_after(9).value, 3);
+    EXPECT_EQ(numbering.first_index_at_or_after(11).value, 5);
+}
+
+TEST(LineNumberingTest, KeepsNumbersOfRetainedLinesWhenEarlierGapsAreErased)
+{
+    LineNumbering numbering;
+    numbering.skip_before(AllLineIndex {1}, 3);
+    numbering.skip_before(AllLineIndex {3}, 2);
+    numbering.skip_before(AllLineIndex {6}, 1);
+
+    numbering.erase_before(AllLineIndex {5});
+    EXPECT_EQ(numbering.line_number(AllLineIndex {5}), 11);
+    EXPECT_EQ(numbering.line_number(AllLineIndex {6}), 13);
+    EXPECT_EQ(numbering.first_index_at_or_after(12).value, 6);
+    EXPECT_EQ(numbering.first_index_at_or_after(11).value, 5);
+}
+
+TEST(LineNumberingTest, TruncatesGapsOfLinesThatAreStoredAgain)
+{
+    LineNumbering numbering;
+    numbering.skip_before(AllLineIndex {1}, 3);
+    numbering.skip_before(AllLineIndex {3}, 2);
+
+    numbering.truncate(AllLineIndex {3});
+    EXPECT_EQ(numbering.line_number(AllLineIndex {3}), 7);
+
+    numbering.skip_before(AllLineIndex {3}, 1);
+    EXPECT_EQ(numbering.line_number(AllLineIndex {3}), 8);
+}
+
+} // namespace slayerlog
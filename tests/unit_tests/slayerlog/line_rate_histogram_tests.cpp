@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+#include "line_rate_histogram.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+LogTimePoint at_second(std::int64_t second)
+{
+    return LogTimePoint {std::chrono::seconds(second)};
+}
+
+} // namespace
+
+TEST(LineRateHistogramTest, ResamplesCountsIntoAverageRatesPerColumn)
+{
+    LineRateHistogram histogram;
+    histogram.append(AllLineIndex {0}, at_second(100), false);
+    histogram.append(AllLineIndex {1}, std::nullopt, true);
+    histogram.append(AllLineIndex {2}, at_second(101), false);
+    histogram.append(AllLineIndex {3}, at_second(103), true);
+
+    EXPECT_EQ(histogram.first_second(), 100);
+    EXPECT_EQ(histogram.end_second(), 104);
+
+    const auto per_second = histogram.resample(100, 104, 4);
+    ASSERT_EQ(per_second.size(), 4U);
+    EXPECT_DOUBLE_EQ(per_second[0].lines_per_second, 2.0);
+    EXPECT_DOUBLE_EQ(per_second[0].errors_per_second, 1.0);
+    EXPECT_DOUBLE_EQ(per_second[1].lines_per_second, 1.0);
+    EXPECT_DOUBLE_EQ(per_second[2].lines_per_second, 0.0);
+    EXPECT_DOUBLE_EQ(per_second[3].errors_per_second, 1.0);
+
+    const auto halves = histogram.resample(100, 104, 2);
+    ASSERT_EQ(halves.size(), 2U);
+    EXPECT_DOUBLE_EQ(halves[0].lines_per_second, 1.5);
+    EXPECT_DOUBLE_EQ(halves[1].lines_per_second, 0.5);
+
+    const auto zoomed = histogram.resample(100, 101, 2);
+    EXPECT_DOUBLE_EQ(zoomed[0].lines_per_second, 2.0);
+    EXPECT_DOUBLE_EQ(zoomed[1].lines_per_second, 2.0);
+}
+
+TEST(LineRateHistogramTest, CoarsensBucketsToStayBoundedAndKeepsTotals)
+{
+    LineRateHistogram histogram;
+    const auto span = static_cast<std::int64_t>(LineRateHistogram::max_bucket_count) * 3;
+    histogram.append(AllLineIndex {0}, at_second(0), false);
+    histogram.append(AllLineIndex {1}, at_second(span), true);
+
+    EXPECT_GE(histogram.bucket_seconds(), 4);
+    EXPECT_LE(static_cast<std::size_t>((histogram.end_second() - histogram.first_second()) / histogram.bucket_seconds()), LineRateHistogram::max_bucket_count);
+
+    const auto whole   = histogram.resample(histogram.first_second(), histogram.end_second(), 1);
+    const auto seconds = static_cast<double>(histogram.end_second() - histogram.first_second());
+    EXPECT_DOUBLE_EQ(whole[0].lines_per_second * seconds, 2.0);
+    EXPECT_DOUBLE_EQ(whole[0].errors_per_second * seconds, 1.0);
+}
+
+TEST(LineRateHistogramTest, IgnoresALoneFarTimestampButFollowsOneTheNextLineConfirms)
+{
+    LineRateHistogram histogram;
+    histogram.append(AllLineIndex {0}, at_second(1'000'000'000), false);
+    histogram.append(AllLineIndex {1}, at_second(0), true);
+    histogram.append(AllLineIndex {2}, at_second(1'000'000'001), false);
+
+    EXPECT_EQ(histogram.bucket_seconds(), 1);
+    EXPECT_EQ(histogram.first_second(), 1'000'000'000);
+    const auto whole = histogram.resample(histogram.first_second(), histogram.end_second(), 1);
+    EXPECT_DOUBLE_EQ(whole[0].lines_per_second * 2.0, 3.0);
+    EXPECT_DOUBLE_EQ(whole[0].errors_per_second * 2.0, 1.0);
+
+    // Line 3 still counts at the last accepted second; line 4 confirms the jump back.
+    histogram.append(AllLineIndex {3}, at_second(0), false);
+    histogram.append(AllLineIndex {4}, at_second(1), false);
+    histogram.append(AllLineIndex {5}, at_second(2), false);
+    EXPECT_GT(histogram.bucket_seconds(), 1);
+    EXPECT_EQ(histogram.first_second(), 0);
+    EXPECT_EQ(histogram.first_line_at_or_after(1'000'000'001), std::optional<AllLineIndex>(AllLineIndex {2}));
+
+    // Once the far lines leave, the buckets go back to the finest width.
+    histogram.erase_before(AllLineIndex {4});
+    EXPECT_EQ(histogram.bucket_seconds(), 1);
+    EXPECT_EQ(histogram.first_second(), 1);
+    EXPECT_EQ(histogram.end_second(), 3);
+    EXPECT_EQ(histogram.first_line_at_or_after(2), std::optional<AllLineIndex>(AllLineIndex {5}));
+}
+
+TEST(LineRateHistogramTest, EvictionDropsWholeRunsAndMapsSecondsToLines)
+{
+    LineRateHistogram histogram;
+    histogram.append(AllLineIndex {10}, at_second(50), false);
+    histogram.append(AllLineIndex {11}, at_second(50), false);
+    histogram.append(AllLineIndex {12}, at_second(52), false);
+    histogram.append(AllLineIndex {13}, at_second(51), false);
+
+    EXPECT_EQ(histogram.first_line_at_or_after(51), std::optional<AllLineIndex>(AllLineIndex {12}));
+    EXPECT_EQ(histogram.first_line_at_or_after(49), std::optional<AllLineIndex>(AllLineIndex {10}));
+    EXPECT_FALSE(histogram.first_line_at_or_after(53).has_value());
+
+    histogram.erase_before(AllLineIndex {11});
+    EXPECT_EQ(histogram.first_second(), 50);
+
+    histogram.erase_before(AllLineIndex {12});
+    EXPECT_EQ(histogram.first_second(), 51);
+    EXPECT_EQ(histogram.first_line_at_or_after(0), std::optional<AllLineIndex>(AllLineIndex {12}));
+
+    histogram.erase_before(AllLineIndex {14});
+    EXPECT_TRUE(histogram.empty());
+    EXPECT_EQ(histogram.memory_bytes(), 0U);
+}
+
+} // namespace slayerlog
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "line_templates.hpp"
+
+namespace slayerlog
+{
+
+TEST(TemplateMinerTest, MasksNumbersAndGeneralizesSimilarLines)
+{
+    TemplateMiner miner;
+
+    const TemplateId closed = miner.add("connection from 10.0.0.7 closed after 5s");
+    EXPECT_EQ(miner.add("connection  from 10.0.0.9 closed after 12s"), closed);
+    EXPECT_EQ(miner.template_text(closed), "connection from <*> closed after <*>");
+
+    EXPECT_EQ(miner.add("connection from gateway closed after 7s"), closed);
+    EXPECT_EQ(miner.template_text(closed), "connection from <*> closed after <*>");
+
+    const TemplateId reset = miner.add("connection from 10.0.0.7 reset by peer");
+    EXPECT_NE(reset, closed);
+    EXPECT_EQ(miner.template_text(reset), "connection from <*> reset by peer");
+    EXPECT_NE(miner.add("cache warmed"), closed);
+    EXPECT_EQ(miner.add(""), miner.add("   "));
+    EXPECT_EQ(miner.template_count(), 4U);
+}
+
+TEST(TemplateMinerTest, FullGroupRetiresLeastRecentlyMatchedTemplate)
+{
+    TemplateMiner miner;
+    const auto word = [](std::size_t index, char suffix) { return std::string {static_cast<char>('a' + index % 26), static_cast<char>('a' + index / 26), suffix}; };
+    const auto line = [&word](std::size_t index) { return "job runs " + word(index, 'p') + " " + word(index, 'q') + " " + word(index, 'r') + " " + word(index, 's'); };
+    for (std::size_t index = 0; index < TemplateMiner::max_templates_per_group; ++index)
+    {
+        EXPECT_EQ(miner.add(line(index)), index);
+    }
+
+    // Matching the first template makes the second the least recently matched one.
+    EXPECT_EQ(miner.add(line(0)), 0U);
+    const TemplateId added = miner.add(line(TemplateMiner::max_templates_per_group));
+    EXPECT_EQ(added, TemplateMiner::max_templates_per_group);
+    EXPECT_EQ(miner.template_count(), TemplateMiner::max_templates_per_group);
+    EXPECT_EQ(miner.template_text(1), "");
+    EXPECT_EQ(miner.template_text(0), line(0));
+
+    // A retired template is not matched again; the line starts a new one instead of joining an unrelated template.
+    EXPECT_EQ(miner.add(line(1)), TemplateMiner::max_templates_per_group + 1);
+    EXPECT_EQ(miner.add(line(TemplateMiner::max_templates_per_group)), added);
+    EXPECT_GT(miner.memory_bytes(), 0U);
+
+    miner.clear();
+    EXPECT_EQ(miner.template_count(), 0U);
+    EXPECT_EQ(miner.add("job runs"), 0U);
+}
+
+} // namespace slayerlog
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "debugging/load_generator.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+std::filesystem::path make_unique_test_path()
+{
+    const auto unique_suffix = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    return std::filesystem::temp_directory_path() / ("slayerlog_load_generator_" + unique_suffix + ".log");
+}
+
+std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+std::vector<std::string> split_lines(const std::string& text)
+{
+    std::vector<std::string> lines;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        lines.push_back(line);
+    }
+
+    return lines;
+}
+
+class ScopedOutputPaths
+{
+public:
+    explicit ScopedOutputPaths(std::size_t count)
+    {
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            _paths.push_back(make_unique_test_path().string() + "." + std::to_string(index));
+        }
+    }
+
+    ~ScopedOutputPaths()
+    {
+        std::error_code error;
+        for (const auto& path : _paths)
+        {
+            std::filesystem::remove(path, error);
+            std::filesystem::remove(path + ".1", error);
+        }
+    }
+
+    const std::vector<std::string>& paths() const { return _paths; }
+
+private:
+    std::vector<std::string> _paths;
+};
+
+} // namespace
+
+TEST(LoadGeneratorTest, ParsesEmbeddedLineStamp)
+{
+    const auto stamp = parse_load_line_stamp("2026-04-01T10:00:00.000 app.log seq=42 sent_ns=123456 padding");
+
+    ASSERT_TRUE(stamp.has_value());
+    EXPECT_EQ(stamp->sequence, 42U);
+    EXPECT_EQ(stamp->sent_ns, 123456);
+    EXPECT_FALSE(parse_load_line_stamp("plain line").has_value());
+}
+
+TEST(LoadGeneratorTest, InterleavesSequencedLinesOfRequestedSize)
+{
+    ScopedOutputPaths outputs(2);
+    LoadGeneratorConfig config;
+    config.file_paths       = outputs.paths();
+    config.line_size        = 200;
+    config.timestamp_format = LoadTimestampFormat::Bracketed;
+
+    {
+        LoadGenerator generator(config);
+        generator.write_lines(6);
+        EXPECT_EQ(generator.lines_written(), 6U);
+    }
+
+    const auto first_lines = split_lines(read_file(outputs.paths()[0]));
+    ASSERT_EQ(first_lines.size(), 3U);
+    for (std::size_t index = 0; index < first_lines.size(); ++index)
+    {
+        EXPECT_EQ(first_lines[index].size(), 200U);
+        EXPECT_EQ(first_lines[index].front(), '[');
+        const auto stamp = parse_load_line_stamp(first_lines[index]);
+        ASSERT_TRUE(stamp.has_value());
+        EXPECT_EQ(stamp->sequence, index);
+    }
+
+    EXPECT_EQ(split_lines(read_file(outputs.paths()[1])).size(), 3U);
+}
+
+TEST(LoadGeneratorTest, PartialWritesLeaveIncompleteTrailingLineUntilNextBatch)
+{
+    ScopedOutputPaths outputs(1);
+    LoadGeneratorConfig config;
+    config.file_paths     = outputs.paths();
+    config.partial_writes = true;
+
+    LoadGenerator generator(config);
+    generator.write_lines(2);
+
+    const std::string after_first_batch = read_file(outputs.paths()[0]);
+    ASSERT_FALSE(after_first_batch.empty());
+    EXPECT_NE(after_first_batch.back(), '\n');
+    EXPECT_EQ(split_lines(after_first_batch).size(), 2U);
+
+    generator.finish();
+    const std::string finished = read_file(outputs.paths()[0]);
+    EXPECT_EQ(finished.back(), '\n');
+    EXPECT_EQ(split_lines(finished).size(), 2U);
+}
+
+TEST(LoadGeneratorTest, RenameRotationMovesFullFileAside)
+{
+    ScopedOutputPaths outputs(1);
+    LoadGeneratorConfig config;
+    config.file_paths         = outputs.paths();
+    config.rotation_mode      = LoadRotationMode::Rename;
+    config.rotate_every_lines = 3;
+
+    LoadGenerator generator(config);
+    generator.write_lines(5);
+
+    EXPECT_EQ(generator.rotations(), 1U);
+    EXPECT_EQ(split_lines(read_file(outputs.paths()[0] + ".1")).size(), 3U);
+
+    const auto current_lines = split_lines(read_file(outputs.paths()[0]));
+    ASSERT_EQ(current_lines.size(), 2U);
+    EXPECT_EQ(parse_load_line_stamp(current_lines[0])->sequence, 3U);
+}
+
+} // namespace slayerlog
@@ -103,6 +103,26 @@ TEST(LogBatchTest, EmitsUntimestampedLinesWhenTheyReachTheFront)
     EXPECT_EQ(merged[4].text, "2026-04-01T10:05:00 alpha later");
 }
 
+TEST(LogBatchTest, CarriesSkippedLineCountsToTheLinesTheyPrecede)
+{
+    const auto merged = merge_log_batch({
+        WatcherLineBatch{
+            "2026-04-01T10:01:00 alpha first",
+            "2026-04-01T10:04:00 alpha after gap",
+        },
+        WatcherLineBatch{
+            "2026-04-01T10:02:00 beta after gap",
+        },
+    }, {"alpha.log", "beta.log"}, {{SkippedLines {1, 3}}, {SkippedLines {0, 2}}});
+
+    ASSERT_EQ(merged.size(), 3U);
+    EXPECT_EQ(merged[0].skipped_before, 0U);
+    EXPECT_EQ(merged[1].text, "2026-04-01T10:02:00 beta after gap");
+    EXPECT_EQ(merged[1].skipped_before, 2U);
+    EXPECT_EQ(merged[2].text, "2026-04-01T10:04:00 alpha after gap");
+    EXPECT_EQ(merged[2].skipped_before, 3U);
+}
+
 #if !defined(NDEBUG)
 TEST(LogBatchTest, AssertsWhenSourceLabelCountDoesNotMatchWatcherCount)
 {
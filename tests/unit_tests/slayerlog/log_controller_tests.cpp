@@ -47,6 +47,30 @@ TEST(LogControllerTest, ScrollStateTracksViewportAndFollowBottom)
     EXPECT_EQ(controller.first_visible_line_index(model, 3).value, 9);
 }
 
+TEST(LogControllerTest, ScrolledViewStaysOnSameLinesWhenOldLinesAreEvicted)
+{
+    LogModel model;
+    LogController controller;
+    model.set_retention_limits(LogRetentionLimits {32, 0});
+    model.append_lines(numbered_lines(30));
+
+    controller.scroll_up(model, 3, 10);
+    const auto anchored_line_number = model.line_number_for_visible_line(controller.first_visible_line_index(model, 3));
+    ASSERT_TRUE(anchored_line_number.has_value());
+    controller.begin_selection(model, TextPosition {controller.first_visible_line_index(model, 3).value, 0});
+    controller.end_selection(model, TextPosition {controller.first_visible_line_index(model, 3).value, 4});
+    const auto selected_text = controller.selection_text(model);
+
+    model.append_lines(numbered_lines(6));
+    ASSERT_GT(model.evicted_visible_line_count(), 0U);
+
+    EXPECT_EQ(model.line_number_for_visible_line(controller.first_visible_line_index(model, 3)), anchored_line_number);
+    EXPECT_EQ(controller.selection_text(model), selected_text);
+
+    controller.scroll_down(model, 3, 1);
+    EXPECT_EQ(model.line_number_for_visible_line(controller.first_visible_line_index(model, 3)), *anchored_line_number + 1);
+}
+
 TEST(LogControllerTest, GoToLineCentersVisibleContentAndFailsForHiddenLine)
 {
     LogModel model;
@@ -66,6 +90,28 @@ TEST(LogControllerTest, GoToLineCentersVisibleContentAndFailsForHiddenLine)
     EXPECT_FALSE(controller.go_to_line(model, 1, 1));
 }
 
+TEST(LogControllerTest, GoToSecondCentersFirstVisibleLineAtThatTime)
+{
+    LogModel model;
+    LogController controller;
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "2026-04-01T12:00:00Z info one"},
+        ObservedLogLine {"alpha.log", "2026-04-01T12:00:05Z info two"},
+        ObservedLogLine {"alpha.log", "2026-04-01T12:00:05Z error three"},
+        ObservedLogLine {"alpha.log", "2026-04-01T12:00:09Z error four"},
+    });
+    model.add_include_filter("error");
+    const auto second = epoch_second(*parse_log_timestamp("2026-04-01T12:00:05Z"));
+
+    EXPECT_TRUE(controller.go_to_second(model, second, 1));
+    EXPECT_EQ(controller.first_visible_line_index(model, 1).value, 0);
+
+    EXPECT_TRUE(controller.go_to_second(model, second + 1, 1));
+    EXPECT_EQ(controller.first_visible_line_index(model, 1).value, 1);
+
+    EXPECT_FALSE(controller.go_to_second(model, second + 10, 1));
+}
+
 TEST(LogControllerTest, FindNavigationUsesVisibleMatchesAndWraps)
 {
     LogModel model;
@@ -216,6 +262,20 @@ TEST(LogControllerTest, SelectionTracksBoundsAndExtractsText)
     EXPECT_TRUE(controller.selection_text(model).empty());
 }
 
+TEST(LogControllerTest, SelectionOfWideCharactersCopiesWholeGlyphs)
+{
+    LogModel model;
+    LogController controller;
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E"},
+    });
+
+    controller.begin_selection(model, TextPosition {0, 4});
+    controller.end_selection(model, TextPosition {0, 6});
+
+    EXPECT_EQ(controller.selection_text(model), "\xE6\x9C\xAC");
+}
+
 TEST(LogControllerTest, ResetClearsControllerState)
 {
     LogModel model;
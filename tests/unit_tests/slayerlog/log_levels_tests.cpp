@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "log_levels.hpp"
+
+namespace slayerlog
+{
+
+TEST(LogLevelsTest, DetectsTheFirstLevelWordNearTheStart)
+{
+    LogLevelDetector detector;
+
+    EXPECT_EQ(detector.detect("2024-01-01T10:00:00Z [WARN] disk almost full, error budget low"), LogLevel::Warn);
+    EXPECT_EQ(detector.detect("2024-01-01 10:00:00.123 ERR connection refused"), LogLevel::Error);
+    EXPECT_EQ(detector.detect(R"({"level":"debug","msg":"tick"})"), LogLevel::Debug);
+    EXPECT_EQ(detector.detect("I0101 10:00:00 started"), std::nullopt);
+    EXPECT_EQ(detector.detect("errors=0 informational"), std::nullopt);
+    EXPECT_EQ(detector.detect(std::string(LogLevelDetector::detection_window_bytes, '.') + " ERROR"), std::nullopt);
+
+    detector.add_token(parse_log_level_token("info=I0101"));
+    EXPECT_EQ(detector.detect("I0101 10:00:00 started"), LogLevel::Info);
+}
+
+TEST(LogLevelsTest, ParsesLevelFiltersAndTokens)
+{
+    EXPECT_EQ(parse_log_level_filter("error,WARN"), log_level_bit(LogLevel::Error) | log_level_bit(LogLevel::Warn));
+    EXPECT_EQ(parse_log_level_filter("warning+"), log_level_bit(LogLevel::Warn) | log_level_bit(LogLevel::Error) | log_level_bit(LogLevel::Fatal));
+    EXPECT_THROW(parse_log_level_filter("loud"), std::invalid_argument);
+    EXPECT_THROW(parse_log_level_filter(" , "), std::invalid_argument);
+
+    const auto token = parse_log_level_token("critical = F");
+    EXPECT_EQ(token.level, LogLevel::Fatal);
+    EXPECT_EQ(token.token, "F");
+    EXPECT_THROW(parse_log_level_token("error"), std::invalid_argument);
+    EXPECT_THROW(parse_log_level_token("error=[E]"), std::invalid_argument);
+}
+
+TEST(LogLevelsTest, BitmapsVisitMatchingLinesAcrossWordsAndEviction)
+{
+    LevelBitmaps bitmaps;
+    bitmaps.clear(AllLineIndex {10});
+    for (int index = 0; index < 200; ++index)
+    {
+        bitmaps.append(index % 50 == 0 ? std::optional<LogLevel> {LogLevel::Error} : (index % 7 == 0 ? std::optional<LogLevel> {LogLevel::Warn} : std::nullopt));
+    }
+
+    std::vector<std::int64_t> errors;
+    bitmaps.for_each(log_level_bit(LogLevel::Error), AllLineIndex {11}, [&](AllLineIndex index) { errors.push_back(index.value); });
+    EXPECT_EQ(errors, (std::vector<std::int64_t> {60, 110, 160}));
+    EXPECT_TRUE(bitmaps.contains(log_level_bit(LogLevel::Warn) | log_level_bit(LogLevel::Error), AllLineIndex {17}));
+    EXPECT_FALSE(bitmaps.contains(log_level_bit(LogLevel::Error), AllLineIndex {17}));
+
+    bitmaps.erase_before(AllLineIndex {150});
+    errors.clear();
+    bitmaps.for_each(log_level_bit(LogLevel::Error), AllLineIndex {150}, [&](AllLineIndex index) { errors.push_back(index.value); });
+    EXPECT_EQ(errors, (std::vector<std::int64_t> {160}));
+    EXPECT_EQ(bitmaps.end_index().value, 210);
+}
+
+} // namespace slayerlog
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "log_line_store.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+void append_numbered_lines(LogLineStore& store, int count)
+{
+    for (int index = 0; index < count; ++index)
+    {
+        store.append(index % 2 == 0 ? "alpha.log" : "beta.log", "2024-05-01 12:00:00 INFO request " + std::to_string(index) + " completed successfully");
+    }
+}
+
+void expect_numbered_lines(const LogLineStore& store)
+{
+    for (auto index = store.first_index().value; index < store.end_index().value; ++index)
+    {
+        const auto line = store.line(AllLineIndex {index});
+        ASSERT_EQ(line.text, "2024-05-01 12:00:00 INFO request " + std::to_string(index) + " completed successfully");
+        ASSERT_EQ(line.source_label, index % 2 == 0 ? "alpha.log" : "beta.log");
+    }
+}
+
+} // namespace
+
+TEST(LogLineStoreTest, ReturnsAppendedLinesWithInternedLabels)
+{
+    LogLineStore store;
+
+    store.append("alpha.log", "first");
+    store.append("beta.log", "");
+    store.append("alpha.log", "third");
+
+    ASSERT_EQ(store.size(), 3U);
+    EXPECT_EQ(store.line(AllLineIndex {0}).source_label, "alpha.log");
+    EXPECT_EQ(store.line(AllLineIndex {0}).text, "first");
+    EXPECT_EQ(store.line(AllLineIndex {1}).source_label, "beta.log");
+    EXPECT_EQ(store.line(AllLineIndex {1}).text, "");
+    EXPECT_EQ(store.line(AllLineIndex {2}).text, "third");
+    EXPECT_THROW(store.line(AllLineIndex {3}), std::out_of_range);
+}
+
+TEST(LogLineStoreTest, SealsChunksByLineAndByteCapacity)
+{
+    LogLineStore store(3, 16);
+
+    store.append("a", "1");
+    store.append("a", "2");
+    store.append("a", "3");
+    store.append("a", "4");
+    EXPECT_EQ(store.chunk_count(), 2U);
+
+    store.append("a", "a line longer than the byte capacity");
+    store.append("a", "6");
+    EXPECT_EQ(store.chunk_count(), 4U);
+    EXPECT_EQ(store.line(AllLineIndex {4}).text, "a line longer than the byte capacity");
+    EXPECT_EQ(store.line(AllLineIndex {5}).text, "6");
+}
+
+TEST(LogLineStoreTest, EvictionKeepsSequenceNumbersStable)
+{
+    LogLineStore store(2, 1024);
+    for (int index = 0; index < 5; ++index)
+    {
+        store.append("a", "line " + std::to_string(index));
+    }
+
+    const auto bytes_before = store.memory_bytes();
+    EXPECT_EQ(store.evict_oldest_chunk(), 2U);
+
+    EXPECT_EQ(store.first_index(), (AllLineIndex {2}));
+    EXPECT_EQ(store.end_index(), (AllLineIndex {5}));
+    EXPECT_EQ(store.size(), 3U);
+    EXPECT_LT(store.memory_bytes(), bytes_before);
+    EXPECT_FALSE(store.contains(AllLineIndex {1}));
+    EXPECT_EQ(store.line(AllLineIndex {2}).text, "line 2");
+
+    store.append("a", "line 5");
+    EXPECT_EQ(store.line(AllLineIndex {5}).text, "line 5");
+
+    store.clear();
+    EXPECT_TRUE(store.empty());
+    EXPECT_EQ(store.first_index(), (AllLineIndex {0}));
+    EXPECT_EQ(store.memory_bytes(), 0U);
+}
+
+TEST(LogLineStoreTest, CompressedColdChunksReadBackAndShrinkMemory)
+{
+    LogLineStore plain(256, 1 << 20);
+    LogLineStore compressed(256, 1 << 20);
+    compressed.set_cold_storage(ColdStorageOptions {ColdStorageMode::Compressed, 1, 2});
+
+    append_numbered_lines(plain, 10000);
+    append_numbered_lines(compressed, 10000);
+
+    EXPECT_EQ(compressed.cold_chunk_count(), compressed.chunk_count() - 2);
+    EXPECT_EQ(compressed.spilled_bytes(), 0U);
+    EXPECT_LT(compressed.memory_bytes() * 3, plain.memory_bytes());
+    expect_numbered_lines(compressed);
+
+    // Scanning backwards revisits chunks through the bounded cache.
+    EXPECT_EQ(compressed.line(AllLineIndex {5}).text, "2024-05-01 12:00:00 INFO request 5 completed successfully");
+    EXPECT_EQ(compressed.line(AllLineIndex {9999}).text, "2024-05-01 12:00:00 INFO request 9999 completed successfully");
+}
+
+TEST(LogLineStoreTest, KeepsTimestampsThroughColdStorage)
+{
+    LogLineStore store(16, 1 << 20);
+    store.set_cold_storage(ColdStorageOptions {ColdStorageMode::Spilled, 0, 1});
+    const auto time_of = [](int index) { return LogTimePoint(std::chrono::seconds(1'714'564'800 + index / 3)); };
+    for (int index = 0; index < 100; ++index)
+    {
+        store.append("alpha.log", "line", index % 5 == 4 ? std::nullopt : std::optional<LogTimePoint>(time_of(index)));
+    }
+
+    ASSERT_GT(store.cold_chunk_count(), 0U);
+    for (int index = 0; index < 100; ++index)
+    {
+        const auto timestamp = store.line(AllLineIndex {index}).timestamp;
+        ASSERT_EQ(timestamp.has_value(), index % 5 != 4) << index;
+        if (timestamp.has_value())
+        {
+            EXPECT_EQ(*timestamp, time_of(index));
+        }
+    }
+}
+
+TEST(LogLineStoreTest, KeepsSkippedLineCountsThroughColdStorage)
+{
+    LogLineStore store(16, 1 << 20);
+    store.set_cold_storage(ColdStorageOptions {ColdStorageMode::Compressed, 0, 1});
+    for (int index = 0; index < 100; ++index)
+    {
+        store.append("alpha.log", "line", std::nullopt, index % 7 == 3 ? static_cast<std::uint64_t>(index) : 0);
+    }
+
+    ASSERT_GT(store.cold_chunk_count(), 0U);
+    for (int index = 0; index < 100; ++index)
+    {
+        EXPECT_EQ(store.line(AllLineIndex {index}).skipped_before, index % 7 == 3 ? static_cast<std::uint64_t>(index) : 0U) << index;
+    }
+}
+
+TEST(LogLineStoreTest, SpilledColdChunksSurviveEvictionAndClear)
+{
+    LogLineStore store(128, 1 << 20);
+    store.set_cold_storage(ColdStorageOptions {ColdStorageMode::Spilled, 1, 1});
+
+    append_numbered_lines(store, 2000);
+    EXPECT_GT(store.spilled_bytes(), 0U);
+    expect_numbered_lines(store);
+
+    const auto spilled_before = store.spilled_bytes();
+    EXPECT_EQ(store.evict_oldest_chunk(), 128U);
+    EXPECT_LT(store.spilled_bytes(), spilled_before);
+    EXPECT_EQ(store.cold_chunk_count(), store.chunk_count() - 2);
+    expect_numbered_lines(store);
+
+    store.clear();
+    EXPECT_EQ(store.spilled_bytes(), 0U);
+    append_numbered_lines(store, 500);
+    expect_numbered_lines(store);
+}
+
+TEST(LogLineStoreTest, EvictedSpillExtentsAreReusedSoTheSpillFileStaysBounded)
+{
+    LogLineStore store(128, 1 << 20);
+    store.set_cold_storage(ColdStorageOptions {ColdStorageMode::Spilled, 1, 1});
+    append_numbered_lines(store, 2000);
+    const auto initial_file_bytes = store.spill_file_bytes();
+    EXPECT_EQ(initial_file_bytes, store.spilled_bytes());
+
+    // A retention window that evicts a chunk for every chunk appended would otherwise grow the file by one chunk each time.
+    for (int round = 0; round < 100; ++round)
+    {
+        store.evict_oldest_chunk();
+        for (int line = 0; line < 128; ++line)
+        {
+            store.append("alpha.log", "2024-05-01 12:00:00 INFO request " + std::to_string(store.end_index().value) + " completed successfully");
+        }
+    }
+
+    EXPECT_LT(store.spill_file_bytes(), initial_file_bytes + initial_file_bytes / 4);
+    EXPECT_GE(store.spill_file_bytes(), store.spilled_bytes());
+
+    // Reused extents are overwritten in place, so every line must still read back from its own chunk.
+    for (auto index = store.first_index().value; index < store.end_index().value; ++index)
+    {
+        ASSERT_EQ(store.line(AllLineIndex {index}).text, "2024-05-01 12:00:00 INFO request " + std::to_string(index) + " completed successfully");
+    }
+}
+
+} // namespace slayerlog
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "log_model.hpp"
@@ -77,6 +80,99 @@ TEST(LogModelTest, PausedUpdatesAppendWhenResumed)
                                      }));
 }
 
+TEST(LogModelTest, HeldLinesKeepTheTimestampTheyArrivedWith)
+{
+    LogModel model;
+    model.toggle_pause();
+    const LogTimePoint parsed_by_batch {std::chrono::seconds(1'775'037'600)};
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "no timestamp in the text", true, parsed_by_batch},
+        ObservedLogLine {"alpha.log", "2026-04-01T10:00:05Z parsed while held"},
+    });
+
+    model.toggle_pause();
+    ASSERT_FALSE(model.resume_pending());
+    EXPECT_EQ(model.line_rates().first_second(), 1'775'037'600);
+    EXPECT_EQ(model.line_rates().end_second(), 1'775'037'606);
+    EXPECT_EQ(model.line_rates().first_line_at_or_after(1'775'037'601), std::optional<AllLineIndex>(AllLineIndex {1}));
+}
+
+TEST(LogModelTest, ResumeAddsHeldLinesInSlicesAheadOfNewOnes)
+{
+    LogModel model;
+    model.set_retention_limits(LogRetentionLimits {160, 0});
+    model.toggle_pause();
+    model.append_lines(numbered_lines(25));
+
+    model.toggle_pause();
+    EXPECT_FALSE(model.updates_paused());
+    EXPECT_TRUE(model.resume_pending());
+    EXPECT_EQ(model.line_count(), 10);
+
+    model.append_lines({ObservedLogLine {"alpha.log", "live"}});
+    EXPECT_EQ(model.line_count(), 10);
+
+    while (model.drain_paused_updates(std::chrono::nanoseconds::zero()))
+    {
+    }
+
+    EXPECT_FALSE(model.resume_pending());
+    const auto texts = rendered_texts(model);
+    ASSERT_EQ(texts.size(), 26U);
+    EXPECT_EQ(texts[24], "line 25");
+    EXPECT_EQ(texts.back(), "live");
+    EXPECT_EQ(model.memory_usage().paused_entry_count, 0U);
+}
+
+TEST(LogModelTest, PausedBufferSpillsLinesBeyondItsLimitInsteadOfDroppingThem)
+{
+    LogModel model;
+    model.set_retention_limits(LogRetentionLimits {0, 0, 128 * 1024});
+    model.toggle_pause();
+    for (int index = 0; index < 400; ++index)
+    {
+        model.append_lines({ObservedLogLine {"alpha.log", std::to_string(index) + std::string(500, 'x')}});
+    }
+
+    const auto usage = model.memory_usage();
+    EXPECT_EQ(model.paused_dropped_line_count(), 0U);
+    EXPECT_EQ(usage.paused_entry_count, 400U);
+    EXPECT_GT(usage.spilled_bytes, 0U);
+    EXPECT_LE(usage.paused_bytes, 128U * 1024U);
+
+    model.toggle_pause();
+    while (model.drain_paused_updates())
+    {
+    }
+
+    EXPECT_EQ(model.line_count(), 400);
+    EXPECT_EQ(rendered_texts(model).front(), "0" + std::string(500, 'x'));
+    EXPECT_EQ(rendered_texts(model).back(), "399" + std::string(500, 'x'));
+}
+
+TEST(LogModelTest, PausedBufferDropsAndCountsLinesBeyondTheRetentionLimits)
+{
+    LogModel model;
+    model.set_retention_limits(LogRetentionLimits {32, 0, 16 * 1024});
+    model.toggle_pause();
+    for (int index = 0; index < 100; ++index)
+    {
+        model.append_lines({ObservedLogLine {"alpha.log", "line " + std::to_string(index)}});
+    }
+
+    const auto usage = model.memory_usage();
+    EXPECT_GT(model.paused_dropped_line_count(), 0U);
+    EXPECT_EQ(usage.paused_dropped_entry_count, model.paused_dropped_line_count());
+    EXPECT_EQ(usage.paused_entry_count + model.paused_dropped_line_count(), 100U);
+
+    model.toggle_pause();
+    while (model.drain_paused_updates())
+    {
+    }
+
+    EXPECT_EQ(rendered_texts(model).back(), "line 99");
+}
+
 TEST(LogModelTest, ResetClearsAllLoadedAndDerivedState)
 {
     LogModel model;
@@ -178,6 +274,161 @@ TEST(LogModelTest, FiltersApplyRetroactivelyAndToNewLines)
     EXPECT_EQ(model.line_count(), 6);
 }
 
+TEST(LogModelTest, FieldFiltersCombineWithTextFiltersAndFollowEviction)
+{
+    LogModel model;
+    model.set_retention_limits(LogRetentionLimits {4, 0});
+    model.append_lines({
+        ObservedLogLine {"alpha.log", R"({"level":"ERROR","latency_ms":900,"msg":"db timeout"})"},
+        ObservedLogLine {"alpha.log", R"({"level":"INFO","latency_ms":900,"msg":"db ok"})"},
+        ObservedLogLine {"alpha.log", R"({"level":"ERROR","latency_ms":20,"msg":"cache miss"})"},
+    });
+
+    model.add_field_filter("level=ERROR");
+    EXPECT_EQ(model.line_count(), 2);
+
+    model.add_field_filter("latency_ms>500");
+    model.add_include_filter("db");
+    EXPECT_EQ(model.field_filters(), (std::vector<std::string> {"level=ERROR", "latency_ms>500"}));
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {R"({"level":"ERROR","latency_ms":900,"msg":"db timeout"})"}));
+    EXPECT_THROW(model.add_field_filter("latency_ms>slow"), std::invalid_argument);
+
+    for (int index = 0; index < 6; ++index)
+    {
+        model.append_lines({ObservedLogLine {"alpha.log", R"({"level":"ERROR","latency_ms":)" + std::to_string(index * 200) + R"(,"msg":"db call"})"}});
+    }
+
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {
+                                         R"({"level":"ERROR","latency_ms":600,"msg":"db call"})",
+                                         R"({"level":"ERROR","latency_ms":800,"msg":"db call"})",
+                                         R"({"level":"ERROR","latency_ms":1000,"msg":"db call"})",
+                                     }));
+
+    model.reset_filters();
+    EXPECT_TRUE(model.field_filters().empty());
+    EXPECT_EQ(model.line_count(), model.total_line_count());
+}
+
+TEST(LogModelTest, LevelFiltersUseDetectedLevelsAndIntersect)
+{
+    LogModel model;
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "10:00:01 INFO started"},
+        ObservedLogLine {"alpha.log", "10:00:02 WARN slow disk"},
+        ObservedLogLine {"alpha.log", "10:00:03 ERROR disk failed"},
+        ObservedLogLine {"alpha.log", "  continuation without level"},
+        ObservedLogLine {"alpha.log", "10:00:04 E retry failed"},
+    });
+
+    model.add_level_filter("warn+");
+    model.add_include_filter("disk");
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"10:00:02 WARN slow disk", "10:00:03 ERROR disk failed"}));
+
+    model.reset_filters();
+    model.add_level_filter("warn,error");
+    model.add_level_filter("error+");
+    EXPECT_EQ(model.level_filters(), (std::vector<std::string> {"warn,error", "error+"}));
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"10:00:03 ERROR disk failed"}));
+
+    model.set_level_tokens({LogLevelToken {LogLevel::Error, "E"}});
+    model.append_lines({ObservedLogLine {"alpha.log", "10:00:05 E gave up"}});
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"10:00:03 ERROR disk failed", "10:00:04 E retry failed", "10:00:05 E gave up"}));
+    EXPECT_THROW(model.add_level_filter("loud"), std::invalid_argument);
+}
+
+TEST(LogModelTest, LevelTokensAlsoRecountTheTimelineErrors)
+{
+    LogModel model;
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "2026-04-01 10:00:01 ERROR disk failed"},
+        ObservedLogLine {"alpha.log", "2026-04-01 10:00:01 E retry failed"},
+        ObservedLogLine {"alpha.log", "2026-04-01 10:00:01 INFO retrying"},
+    });
+
+    const auto& rates  = model.line_rates();
+    const auto errors  = [&rates] { return rates.resample(rates.first_second(), rates.end_second(), 1)[0].errors_per_second * static_cast<double>(rates.end_second() - rates.first_second()); };
+    const auto version = rates.generation();
+    EXPECT_DOUBLE_EQ(errors(), 1.0);
+
+    model.set_level_tokens({LogLevelToken {LogLevel::Error, "E"}});
+    EXPECT_DOUBLE_EQ(errors(), 2.0);
+    EXPECT_NE(rates.generation(), version);
+}
+
+TEST(LogModelTest, CollapsedRepeatsFoldRunsAndExpandPerTemplate)
+{
+    LogModel model;
+    model.set_collapse_repeats(true);
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "user 17 logged in"},
+        ObservedLogLine {"alpha.log", "user 18 logged in"},
+        ObservedLogLine {"alpha.log", "cache warmed"},
+        ObservedLogLine {"alpha.log", "user 19 logged in"},
+        ObservedLogLine {"alpha.log", "user 20 logged in"},
+    });
+
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"(2x) user 17 logged in", "cache warmed", "(2x) user 19 logged in"}));
+    EXPECT_EQ(model.repeat_count(VisibleLineIndex {2}), 2U);
+    EXPECT_EQ(model.visible_line_index_for_line_number(5), std::optional<VisibleLineIndex>(VisibleLineIndex {2}));
+
+    model.append_lines({ObservedLogLine {"alpha.log", "user 21 logged in"}});
+    EXPECT_EQ(model.rendered_line(2), "4 (3x) user 19 logged in");
+
+    model.add_exclude_filter("cache");
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"(5x) user 17 logged in"}));
+
+    EXPECT_TRUE(model.toggle_repeat_expansion(6));
+    EXPECT_EQ(model.line_count(), 5);
+    EXPECT_TRUE(model.toggle_repeat_expansion(6));
+    EXPECT_EQ(model.line_count(), 1);
+
+    model.set_collapse_repeats(false);
+    EXPECT_EQ(model.line_count(), 5);
+    EXPECT_EQ(model.repeat_count(VisibleLineIndex {0}), 1U);
+    EXPECT_FALSE(model.toggle_repeat_expansion(1));
+}
+
+TEST(LogModelTest, ExportEntriesUnfoldCollapsedRowsAndFollowFind)
+{
+    LogModel model;
+    model.set_collapse_repeats(true);
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "user 17 logged in"},
+        ObservedLogLine {"alpha.log", "cache warmed"},
+        ObservedLogLine {"alpha.log", "user 18 logged in"},
+        ObservedLogLine {"alpha.log", "user 19 logged in"},
+    });
+    model.add_exclude_filter("cache");
+    ASSERT_EQ(model.line_count(), 1);
+
+    const auto entries = model.export_entry_indices(false);
+    ASSERT_EQ(entries.size(), 3U);
+    EXPECT_EQ(entries[1].value, 2);
+    EXPECT_EQ(entries[2].value, 3);
+
+    model.set_find_query("19");
+    const auto matches = model.export_entry_indices(true);
+    ASSERT_EQ(matches.size(), 1U);
+    std::string output;
+    EXPECT_TRUE(model.append_export_line(matches[0], output));
+    EXPECT_EQ(output, "user 19 logged in\n");
+}
+
+TEST(LogModelTest, EvictionKeepsTheRestOfACollapsedRun)
+{
+    LogModel model;
+    model.set_collapse_repeats(true);
+    model.set_retention_limits(LogRetentionLimits {4, 0});
+    model.append_lines(numbered_lines(6));
+
+    ASSERT_EQ(model.line_count(), 1);
+    EXPECT_EQ(model.rendered_line(0), "3 (4x) line 3");
+    EXPECT_EQ(model.evicted_visible_line_count(), 0U);
+
+    model.append_lines({ObservedLogLine {"alpha.log", "done"}, ObservedLogLine {"alpha.log", "line 8"}});
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"(2x) line 5", "done", "line 8"}));
+}
+
 TEST(LogModelTest, HideBeforeLineUsesRawLineNumbers)
 {
     LogModel model;
@@ -227,6 +478,75 @@ TEST(LogModelTest, ResetHiddenColumnsRestoresRenderedText)
     EXPECT_EQ(model.rendered_line(0), "1 abcdef");
 }
 
+TEST(LogModelTest, LongLinesAreCutOffForDisplayButCopiedWhole)
+{
+    LogModel model;
+    model.set_long_line_limits(LongLineLimits {8, 0});
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "abcdefghijklmnop"},
+        ObservedLogLine {"alpha.log", "short"},
+    });
+
+    EXPECT_EQ(model.rendered_line(0), "1 abcdefgh [... 8 more bytes]");
+    EXPECT_EQ(model.rendered_line_width(0), static_cast<int>(model.rendered_line(0).size()));
+    EXPECT_EQ(model.max_rendered_line_width(), model.rendered_line_width(0));
+    EXPECT_EQ(model.rendered_lines(0, 2, 4, 6), (std::vector<std::string> {"cdefgh", "ort"}));
+
+    std::string copied;
+    model.append_rendered_line(0, copied);
+    EXPECT_EQ(copied, "1 abcdefghijklmnop");
+
+    model.hide_columns(2, 4);
+    EXPECT_EQ(model.rendered_line(0), "1 cdefgh [... 8 more bytes]");
+    EXPECT_EQ(model.rendered_lines(0, 1, 1, 4), (std::vector<std::string> {" cde"}));
+    EXPECT_EQ(model.max_rendered_line_width(), static_cast<int>(model.rendered_line(0).size()));
+}
+
+TEST(LogModelTest, WideCharactersAreMeasuredAndClippedInDisplayColumns)
+{
+    LogModel model;
+    model.set_long_line_limits(LongLineLimits {5, 0});
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "\xE6\x97\xA5\xE6\x9C\xAC"},
+        ObservedLogLine {"alpha.log", "\xC3\xA9\xC3\xA9\xC3\xA9"},
+    });
+
+    EXPECT_EQ(model.rendered_line(0), "1 \xE6\x97\xA5 [... 3 more bytes]");
+    EXPECT_EQ(model.rendered_line(1), "2 \xC3\xA9\xC3\xA9 [... 2 more bytes]");
+    EXPECT_EQ(model.rendered_line_width(0), 4 + 19);
+    EXPECT_EQ(model.rendered_line_width(1), 4 + 19);
+    EXPECT_EQ(model.rendered_lines(0, 2, 3, 3), (std::vector<std::string> {"  [", "\xC3\xA9 ["}));
+
+    model.set_long_line_limits(LongLineLimits {0, 0});
+    EXPECT_EQ(model.rendered_line_width(0), 6);
+    EXPECT_EQ(model.max_rendered_line_width(), 6);
+
+    model.hide_columns(2, 4);
+    EXPECT_EQ(model.rendered_line(0), "1 \xE6\x9C\xAC");
+    EXPECT_EQ(model.rendered_line(1), "2 \xC3\xA9");
+    EXPECT_EQ(model.rendered_line_width(0), 4);
+}
+
+TEST(LogModelTest, SearchPrefixLimitsFiltersAndFindToTheStartOfLines)
+{
+    LogModel model;
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "error at the start"},
+        ObservedLogLine {"alpha.log", "a late error"},
+    });
+    model.add_include_filter("error");
+    ASSERT_EQ(model.line_count(), 2);
+
+    model.set_long_line_limits(LongLineLimits {0, 8});
+    EXPECT_EQ(model.rendered_lines(0, 2), (std::vector<std::string> {"1 error at the start"}));
+    EXPECT_TRUE(model.set_find_query("error"));
+    EXPECT_EQ(model.total_find_match_count(), 1);
+
+    model.reset_filters();
+    model.add_include_filter("alpha");
+    EXPECT_EQ(model.line_count(), 2);
+}
+
 TEST(LogModelTest, ParseHiddenColumnRangeUsesHalfOpenZeroBasedSyntax)
 {
     const auto trimmed_range = parse_hidden_column_range(" 4 - 10 ");
@@ -381,4 +701,237 @@ TEST(LogModelTest, ClearingFindQueryRemovesAllFindState)
     EXPECT_EQ(model.visible_find_match_count(), 0);
 }
 
+TEST(LogModelTest, MaxLinesEvictsOldestChunksAndKeepsRawLineNumbers)
+{
+    LogModel model;
+    model.set_retention_limits(LogRetentionLimits {32, 0});
+
+    model.append_lines(numbered_lines(100));
+
+    EXPECT_LE(model.total_line_count(), 32);
+    EXPECT_GE(model.total_line_count(), 30);
+    EXPECT_EQ(model.last_line_number(), 100);
+    EXPECT_EQ(model.first_line_number(), 100 - model.total_line_count() + 1);
+    EXPECT_EQ(rendered_texts(model).back(), "line 100");
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {0}), model.first_line_number());
+    EXPECT_FALSE(model.visible_line_index_for_line_number(1).has_value());
+    EXPECT_EQ(model.memory_usage().evicted_entry_count, model.first_line_number() - 1);
+}
+
+TEST(LogModelTest, SkippedLineNumbersOffsetTheFirstLine)
+{
+    LogModel model;
+    model.skip_line_numbers(8192);
+    model.append_lines(numbered_lines(3));
+    model.skip_line_numbers(10);
+
+    EXPECT_EQ(model.first_line_number(), 8193);
+    EXPECT_EQ(model.last_line_number(), 8195);
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {0}), 8193);
+}
+
+TEST(LogModelTest, EvictionDropsVisibleAndFindIndicesFromTheFront)
+{
+    LogModel model;
+    model.set_retention_limits(LogRetentionLimits {16, 0});
+    model.add_exclude_filter("line 2");
+    ASSERT_FALSE(model.set_find_query("line 1"));
+
+    model.append_lines(numbered_lines(9));
+    const int visible_before = model.line_count();
+    EXPECT_EQ(model.total_find_match_count(), 1);
+    EXPECT_EQ(model.evicted_visible_line_count(), 0U);
+
+    model.append_lines(numbered_lines(40));
+
+    EXPECT_GT(model.evicted_visible_line_count(), static_cast<std::uint64_t>(visible_before - 1));
+    for (int index = 0; index < model.line_count(); ++index)
+    {
+        const auto line_number = model.line_number_for_visible_line(VisibleLineIndex {index});
+        ASSERT_TRUE(line_number.has_value());
+        EXPECT_GE(*line_number, model.first_line_number());
+    }
+
+    for (int index = 0; index < model.total_find_match_count(); ++index)
+    {
+        const auto entry_index = model.find_match_entry_index(FindResultIndex {index});
+        ASSERT_TRUE(entry_index.has_value());
+        EXPECT_GE(entry_index->value + 1, model.first_line_number());
+    }
+
+    model.reset_filters();
+    EXPECT_EQ(model.line_count(), model.total_line_count());
+}
+
+TEST(LogModelTest, HideBeforeLineKeepsWorkingAcrossEviction)
+{
+    LogModel model;
+    model.set_retention_limits(LogRetentionLimits {16, 0});
+    model.append_lines(numbered_lines(20));
+
+    model.hide_before_line_number(19);
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"line 19", "line 20"}));
+
+    model.append_lines(numbered_lines(30));
+    EXPECT_EQ(model.line_count(), model.total_line_count());
+    EXPECT_EQ(model.hidden_before_line_number(), 19);
+}
+
+TEST(LogModelTest, MaxMemoryBoundsStoredLines)
+{
+    LogModel model;
+    model.set_retention_limits(LogRetentionLimits {0, 256 * 1024});
+
+    for (int batch = 0; batch < 20; ++batch)
+    {
+        model.append_lines(numbered_lines(1000));
+    }
+
+    const auto usage = model.memory_usage();
+    EXPECT_LE(usage.entry_bytes + static_cast<std::size_t>(model.line_count()) * sizeof(AllLineIndex), 256U * 1024U);
+    EXPECT_GT(usage.evicted_entry_count, 0);
+    EXPECT_EQ(model.last_line_number(), 20000);
+}
+
+TEST(LogModelTest, UpdateSourcesMergesAddedLinesByTimestampAndRelabelsStoredOnes)
+{
+    LogModel model;
+    model.set_show_source_labels(true);
+    model.append_lines({
+        {"app.log", "2026-04-01 10:00:01 start"},
+        {"app.log", "  continuation"},
+        {"app.log", "2026-04-01 10:00:03 ready"},
+    });
+    model.add_exclude_filter("continuation");
+    model.set_find_query("ready");
+
+    model.update_sources(
+        {
+            {"db.log", "2026-04-01 10:00:02 connected"},
+            {"db.log", "2026-04-01 10:00:04 ready"},
+        },
+        [](std::string_view source_label) { return std::optional<std::string>(source_label == "app.log" ? "a/app.log" : std::string(source_label)); });
+
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {
+                                         "[a/app.log] 2026-04-01 10:00:01 start",
+                                         "[db.log] 2026-04-01 10:00:02 connected",
+                                         "[a/app.log] 2026-04-01 10:00:03 ready",
+                                         "[db.log] 2026-04-01 10:00:04 ready",
+                                     }));
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {1}), 3);
+    EXPECT_EQ(model.rendered_line_width(0), static_cast<int>(model.rendered_line(0).size()));
+    EXPECT_EQ(model.total_line_count(), 5);
+    EXPECT_EQ(model.exclude_filters(), (std::vector<std::string> {"continuation"}));
+    EXPECT_EQ(model.total_find_match_count(), 2);
+}
+
+TEST(LogModelTest, UpdateSourcesDropsLinesOfClosedSourcesIncludingPausedOnes)
+{
+    LogModel model;
+    model.append_lines({{"alpha.log", "a1"}, {"beta.log", "b1"}, {"alpha.log", "a2"}});
+    model.toggle_pause();
+    model.append_lines({{"beta.log", "b2"}, {"alpha.log", "a3"}});
+
+    model.update_sources({}, [](std::string_view source_label) { return source_label == "beta.log" ? std::nullopt : std::optional<std::string>(source_label); });
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"a1", "a2"}));
+    EXPECT_EQ(model.memory_usage().entry_count, 2U);
+    EXPECT_EQ(model.memory_usage().paused_entry_count, 1U);
+
+    model.toggle_pause();
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"a1", "a2", "a3"}));
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {2}), 3);
+    EXPECT_EQ(model.last_line_number(), 3);
+}
+
+TEST(LogModelTest, UpdateSourcesKeepsCutoffFindAndTimelineOfTheOtherSources)
+{
+    LogModel model;
+    model.append_lines({
+        {"alpha.log", "2026-04-01 10:00:01 a1"},
+        {"beta.log", "2026-04-01 10:00:01 ERROR b1"},
+        {"alpha.log", "2026-04-01 10:00:02 a2"},
+        {"beta.log", "2026-04-01 10:00:02 b2"},
+    });
+    model.hide_before_line_number(2);
+    model.set_find_query("b");
+    ASSERT_EQ(model.total_find_match_count(), 2);
+
+    // The cutoff was set at a closed line, so it moves to the next line still open.
+    const auto close_beta = [](std::string_view source_label) { return source_label == "beta.log" ? std::nullopt : std::optional<std::string>(source_label); };
+    model.update_sources({}, close_beta);
+
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"2026-04-01 10:00:02 a2"}));
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {0}), 2);
+    EXPECT_EQ(model.hidden_before_line_number(), 2);
+    EXPECT_EQ(model.total_find_match_count(), 0);
+
+    const auto& rates = model.line_rates();
+    const auto totals = rates.resample(rates.first_second(), rates.end_second(), 1);
+    EXPECT_DOUBLE_EQ(totals[0].lines_per_second * static_cast<double>(rates.end_second() - rates.first_second()), 2.0);
+    EXPECT_DOUBLE_EQ(totals[0].errors_per_second, 0.0);
+
+    const auto keep_labels = [](std::string_view source_label) { return std::optional<std::string>(source_label); };
+    model.update_sources({{"beta.log", "2026-04-01 10:00:03 b3"}}, keep_labels);
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"2026-04-01 10:00:02 a2", "2026-04-01 10:00:03 b3"}));
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {1}), 3);
+    EXPECT_EQ(model.total_find_match_count(), 1);
+
+    // A line merged in before the cutoff stays hidden behind it.
+    model.update_sources({{"gamma.log", "2026-04-01 10:00:00 g0"}}, keep_labels);
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"2026-04-01 10:00:02 a2", "2026-04-01 10:00:03 b3"}));
+    EXPECT_EQ(model.hidden_before_line_number(), 3);
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {0}), 3);
+}
+
+TEST(LogModelTest, LinesLeftOutBySourceCountTowardsLineNumbers)
+{
+    LogModel model;
+    model.append_lines({
+        {"remote.log", "keep 1"},
+        {"remote.log", "keep 4", false, std::nullopt, 2},
+        {"remote.log", "keep 5"},
+    });
+
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {1}), 4);
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {2}), 5);
+    EXPECT_EQ(model.first_line_number(), 1);
+    EXPECT_EQ(model.last_line_number(), 5);
+    EXPECT_TRUE(model.line_number_stored(4));
+    EXPECT_FALSE(model.line_number_stored(2));
+    ASSERT_TRUE(model.visible_line_index_for_line_number(4).has_value());
+    EXPECT_EQ(model.visible_line_index_for_line_number(4)->value, 1);
+
+    // A cutoff inside the gap hides everything up to the next stored line.
+    model.hide_before_line_number(3);
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {"keep 4", "keep 5"}));
+    EXPECT_EQ(model.line_number_for_visible_line(VisibleLineIndex {0}), 4);
+}
+
+TEST(LogModelTest, RefetchedLinesReplaceTheNewestLinesOfTheirSource)
+{
+    LogModel model;
+    model.append_lines({
+        {"remote.log", "2026-04-01 10:00:01 keep 1"},
+        {"local.log", "2026-04-01 10:00:02 local"},
+        {"remote.log", "2026-04-01 10:00:04 keep 3", false, std::nullopt, 1},
+    });
+
+    model.merge_refetched_lines("remote.log", 2,
+                                {
+                                    {"remote.log", "2026-04-01 10:00:01 keep 1"},
+                                    {"remote.log", "2026-04-01 10:00:03 drop 2"},
+                                    {"remote.log", "2026-04-01 10:00:04 keep 3"},
+                                });
+
+    EXPECT_EQ(rendered_texts(model), (std::vector<std::string> {
+                                         "2026-04-01 10:00:01 keep 1",
+                                         "2026-04-01 10:00:02 local",
+                                         "2026-04-01 10:00:03 drop 2",
+                                         "2026-04-01 10:00:04 keep 3",
+                                     }));
+    EXPECT_EQ(model.total_line_count(), 4);
+    EXPECT_EQ(model.last_line_number(), 4);
+    EXPECT_TRUE(model.line_number_stored(3));
+}
+
 } // namespace slayerlog
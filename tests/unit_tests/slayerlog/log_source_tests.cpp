@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "log_source.hpp"
@@ -35,6 +39,59 @@ TEST(LogSourceTest, RejectsRemoteSourceWithoutAbsolutePath)
     EXPECT_THROW(parse_log_source("ssh://example.com/"), std::invalid_argument);
 }
 
+TEST(LogSourceTest, ParsesStdinAndCommandSources)
+{
+    const LogSource stdin_source = parse_log_source(" - ");
+    EXPECT_EQ(stdin_source.kind, LogSourceKind::StandardInput);
+    EXPECT_EQ(source_display_path(stdin_source), "stdin");
+    EXPECT_EQ(source_basename(stdin_source), "stdin");
+
+    const LogSource command_source = parse_log_source("cmd:  /usr/bin/kubectl logs -f api-0");
+    EXPECT_EQ(command_source.kind, LogSourceKind::Command);
+    EXPECT_EQ(command_source.command, "/usr/bin/kubectl logs -f api-0");
+    EXPECT_EQ(source_display_path(command_source), "cmd:/usr/bin/kubectl logs -f api-0");
+    EXPECT_EQ(source_basename(command_source), "kubectl");
+    EXPECT_TRUE(same_source(command_source, parse_log_source("cmd:/usr/bin/kubectl logs -f api-0")));
+    EXPECT_FALSE(same_source(command_source, parse_log_source("cmd:/usr/bin/kubectl logs -f api-1")));
+
+    EXPECT_THROW(parse_log_source("cmd: "), std::invalid_argument);
+}
+
+TEST(LogSourceTest, ParsesDirectoriesAndGlobsAsFileGlobs)
+{
+    const LogSource glob_source = parse_log_source("/var/log/pods/**/*.log");
+    EXPECT_EQ(glob_source.kind, LogSourceKind::FileGlob);
+    EXPECT_EQ(glob_source.local_path, "/var/log/pods/**/*.log");
+    EXPECT_EQ(source_basename(glob_source), "/var/log/pods/**/*.log");
+    EXPECT_EQ(parse_log_source("logs/app.log*").kind, LogSourceKind::LocalFile);
+    EXPECT_EQ(parse_log_source("logs/*").kind, LogSourceKind::FileGlob);
+
+    const auto directory = std::filesystem::temp_directory_path() / "slayerlog_log_source_glob_directory";
+    std::filesystem::create_directories(directory);
+    const LogSource directory_source = parse_log_source(directory.string());
+    EXPECT_EQ(directory_source.kind, LogSourceKind::FileGlob);
+    EXPECT_EQ(directory_source.local_path, (directory / "*").string());
+    std::filesystem::remove_all(directory);
+
+    const LogGlob glob = split_log_glob("/var/log/pods/**/*.log");
+    EXPECT_EQ(glob.base_directory, "/var/log/pods");
+    EXPECT_EQ(glob.relative_pattern, "**/*.log");
+    EXPECT_EQ(split_log_glob("*.log").base_directory, ".");
+    EXPECT_EQ(split_log_glob("/*.log").base_directory, "/");
+}
+
+TEST(LogSourceTest, MatchesGlobsSegmentBySegment)
+{
+    EXPECT_TRUE(matches_log_glob("*.log", "app.log"));
+    EXPECT_FALSE(matches_log_glob("*.log", "pod/app.log"));
+    EXPECT_TRUE(matches_log_glob("**/*.log", "app.log"));
+    EXPECT_TRUE(matches_log_glob("**/*.log", "ns_pod_uid/api/0.log"));
+    EXPECT_TRUE(matches_log_glob("*/api/?.log", "ns_pod_uid/api/0.log"));
+    EXPECT_FALSE(matches_log_glob("*/api/?.log", "ns_pod_uid/api/10.log"));
+    EXPECT_TRUE(matches_log_glob("pod-*/**", "pod-a/api/0.log"));
+    EXPECT_FALSE(matches_log_glob("*.log", "app.log.1"));
+}
+
 TEST(LogSourceTest, MatchesEquivalentRemoteSources)
 {
     const LogSource left  = parse_log_source("ssh://user@EXAMPLE.com/var/log/../log/app.log");
@@ -56,4 +113,48 @@ TEST(LogSourceTest, UsesFullSourceWhenBasenameCollides)
     EXPECT_EQ(labels[1], "ssh://user@example.com/var/log/app.log");
 }
 
+TEST(LogSourceTest, ExpandsRotationChainOldestFirst)
+{
+    const auto unique_suffix = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    const auto directory     = std::filesystem::temp_directory_path() / ("slayerlog_rotation_" + unique_suffix);
+    std::filesystem::create_directories(directory);
+    for (const char* name : {"app.log", "app.log.1", "app.log.2.gz", "app.log.10.zst", "app.log.bak", "app.log.old.gz", "other.log.1"})
+    {
+        std::ofstream(directory / name) << "line\n";
+    }
+
+    const LogSource source = parse_log_source((directory / "app.log*").string());
+
+    EXPECT_EQ(source.kind, LogSourceKind::LocalFile);
+    EXPECT_EQ(source.local_path, (directory / "app.log").string());
+    EXPECT_EQ(source_basename(source), "app.log");
+    EXPECT_EQ(source.rotated_paths, (std::vector<std::string> {
+                                        (directory / "app.log.10.zst").string(),
+                                        (directory / "app.log.2.gz").string(),
+                                        (directory / "app.log.1").string(),
+                                    }));
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+}
+
+TEST(LogSourceTest, DetectsCompressionByMagicBytes)
+{
+    const auto unique_suffix = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    const auto base_path     = std::filesystem::temp_directory_path() / ("slayerlog_magic_" + unique_suffix);
+    std::ofstream(base_path.string() + ".gz", std::ios::binary) << std::string("\x1f\x8b\x08\x00", 4);
+    std::ofstream(base_path.string() + ".zst", std::ios::binary) << std::string("\x28\xb5\x2f\xfd", 4);
+    std::ofstream(base_path.string() + ".log", std::ios::binary) << "plain text\n";
+
+    EXPECT_EQ(detect_log_compression(base_path.string() + ".gz"), LogCompression::Gzip);
+    EXPECT_EQ(detect_log_compression(base_path.string() + ".zst"), LogCompression::Zstd);
+    EXPECT_EQ(detect_log_compression(base_path.string() + ".log"), LogCompression::None);
+    EXPECT_EQ(detect_log_compression(base_path.string() + ".missing"), LogCompression::None);
+
+    for (const char* extension : {".gz", ".zst", ".log"})
+    {
+        std::filesystem::remove(base_path.string() + extension);
+    }
+}
+
 } // namespace slayerlog
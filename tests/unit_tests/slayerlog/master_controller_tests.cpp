@@ -15,6 +15,7 @@
 #include "log_view.hpp"
 #include "master_controller.hpp"
 #include "settings_store.hpp"
+#include "timeline_view.hpp"
 
 namespace slayerlog
 {
@@ -45,8 +46,9 @@ TEST(MasterControllerTest, CtrlPOpensCommandPalette)
     CommandManager command_manager;
     CommandPaletteController command_palette_controller(command_palette_model, command_manager);
     LogView view;
+    TimelineView timeline_view;
     auto screen = ftxui::ScreenInteractive::FixedSize(80, 24);
-    MasterController master_controller(model, controller, view, screen, command_palette_controller);
+    MasterController master_controller(model, controller, view, timeline_view, screen, command_palette_controller);
 
     EXPECT_TRUE(master_controller.handle_event(ftxui::Event::CtrlP));
     EXPECT_TRUE(command_palette_controller.is_open());
@@ -60,8 +62,9 @@ TEST(MasterControllerTest, CtrlROpensHistoryPaletteWhenClosed)
     CommandManager command_manager;
     CommandPaletteController command_palette_controller(command_palette_model, command_manager);
     LogView view;
+    TimelineView timeline_view;
     auto screen = ftxui::ScreenInteractive::FixedSize(80, 24);
-    MasterController master_controller(model, controller, view, screen, command_palette_controller);
+    MasterController master_controller(model, controller, view, timeline_view, screen, command_palette_controller);
 
     EXPECT_TRUE(master_controller.handle_event(ftxui::Event::CtrlR));
     EXPECT_TRUE(command_palette_controller.is_open());
@@ -87,8 +90,9 @@ TEST(MasterControllerTest, WhenPaletteOpenInputRoutesToPalette)
     command_palette_controller.open();
 
     LogView view;
+    TimelineView timeline_view;
     auto screen = ftxui::ScreenInteractive::FixedSize(80, 24);
-    MasterController master_controller(model, controller, view, screen, command_palette_controller);
+    MasterController master_controller(model, controller, view, timeline_view, screen, command_palette_controller);
 
     EXPECT_TRUE(master_controller.handle_event(ftxui::Event::ArrowDown));
     EXPECT_EQ(controller.first_visible_line_index(model, 1).value, 0);
@@ -112,8 +116,9 @@ TEST(MasterControllerTest, CtrlRTogglesHistoryModeWhilePaletteOpen)
     command_palette_controller.open();
 
     LogView view;
+    TimelineView timeline_view;
     auto screen = ftxui::ScreenInteractive::FixedSize(80, 24);
-    MasterController master_controller(model, controller, view, screen, command_palette_controller);
+    MasterController master_controller(model, controller, view, timeline_view, screen, command_palette_controller);
 
     EXPECT_TRUE(master_controller.handle_event(ftxui::Event::CtrlR));
     EXPECT_TRUE(command_palette_controller.is_open());
@@ -132,8 +137,9 @@ TEST(MasterControllerTest, EscapeClosesPaletteBeforeExiting)
     command_palette_controller.open();
 
     LogView view;
+    TimelineView timeline_view;
     auto screen = ftxui::ScreenInteractive::FixedSize(80, 24);
-    MasterController master_controller(model, controller, view, screen, command_palette_controller);
+    MasterController master_controller(model, controller, view, timeline_view, screen, command_palette_controller);
 
     EXPECT_TRUE(master_controller.handle_event(ftxui::Event::Escape));
     EXPECT_FALSE(command_palette_controller.is_open());
@@ -149,8 +155,9 @@ TEST(MasterControllerTest, EscapeExitsWhenPaletteClosedAndFindInactive)
     CommandPaletteController command_palette_controller(command_palette_model, command_manager);
 
     LogView view;
+    TimelineView timeline_view;
     auto screen = ftxui::ScreenInteractive::FixedSize(80, 24);
-    MasterController master_controller(model, controller, view, screen, command_palette_controller);
+    MasterController master_controller(model, controller, view, timeline_view, screen, command_palette_controller);
 
     EXPECT_TRUE(master_controller.handle_event(ftxui::Event::Escape));
     EXPECT_TRUE(master_controller.exit_requested());
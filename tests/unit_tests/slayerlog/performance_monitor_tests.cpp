@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "log_model.hpp"
+#include "performance_hud_view.hpp"
+#include "performance_monitor.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+struct FakeClock
+{
+    PerformanceMonitor::Clock::time_point now {};
+
+    void advance(std::chrono::milliseconds duration) { now += duration; }
+};
+
+PerformanceMonitor make_monitor(FakeClock& clock)
+{
+    return PerformanceMonitor([&clock] { return clock.now; });
+}
+
+} // namespace
+
+TEST(PerformanceMonitorTest, PublishesStageTimingsWhenWindowCompletes)
+{
+    FakeClock clock;
+    PerformanceMonitor monitor = make_monitor(clock);
+
+    monitor.record_stage(PerformanceStage::Merge, std::chrono::microseconds(100));
+    monitor.record_stage(PerformanceStage::Merge, std::chrono::microseconds(300));
+
+    auto snapshot = monitor.snapshot();
+    EXPECT_EQ(snapshot.stage(PerformanceStage::Merge).last, std::chrono::microseconds(300));
+    EXPECT_EQ(snapshot.stage(PerformanceStage::Merge).samples, 0U);
+
+    clock.advance(std::chrono::milliseconds(1000));
+    snapshot = monitor.snapshot();
+    EXPECT_EQ(snapshot.stage(PerformanceStage::Merge).average, std::chrono::microseconds(200));
+    EXPECT_EQ(snapshot.stage(PerformanceStage::Merge).max, std::chrono::microseconds(300));
+    EXPECT_EQ(snapshot.stage(PerformanceStage::Merge).samples, 2U);
+    EXPECT_EQ(snapshot.stage(PerformanceStage::AppendLines).samples, 0U);
+
+    clock.advance(std::chrono::milliseconds(1000));
+    snapshot = monitor.snapshot();
+    EXPECT_EQ(snapshot.stage(PerformanceStage::Merge).samples, 0U);
+    EXPECT_EQ(snapshot.stage(PerformanceStage::Merge).last, std::chrono::microseconds(300));
+}
+
+TEST(PerformanceMonitorTest, ReportsIngestRatesPerSource)
+{
+    FakeClock clock;
+    PerformanceMonitor monitor = make_monitor(clock);
+    monitor.set_sources({"alpha.log", "beta.log"});
+
+    monitor.record_poll(0, 100, 4000);
+    monitor.record_poll(0, 100, 6000);
+    monitor.record_poll(1, 10, 500);
+    monitor.record_poll(7, 10, 500);
+
+    clock.advance(std::chrono::milliseconds(2000));
+    const auto snapshot = monitor.snapshot();
+    ASSERT_EQ(snapshot.sources.size(), 2U);
+    EXPECT_EQ(snapshot.sources[0].label, "alpha.log");
+    EXPECT_DOUBLE_EQ(snapshot.sources[0].lines_per_second, 100.0);
+    EXPECT_DOUBLE_EQ(snapshot.sources[0].bytes_per_second, 5000.0);
+    EXPECT_EQ(snapshot.sources[0].last_poll_bytes, 6000U);
+    EXPECT_EQ(snapshot.sources[0].total_lines, 200U);
+    EXPECT_DOUBLE_EQ(snapshot.sources[1].lines_per_second, 5.0);
+
+    monitor.set_sources({"gamma.log"});
+    const auto reset_snapshot = monitor.snapshot();
+    ASSERT_EQ(reset_snapshot.sources.size(), 1U);
+    EXPECT_EQ(reset_snapshot.sources[0].total_lines, 0U);
+}
+
+TEST(PerformanceMonitorTest, KeepsLatestCatchUpProgressPerSource)
+{
+    FakeClock clock;
+    PerformanceMonitor monitor = make_monitor(clock);
+    monitor.set_sources({"ssh://alpha/app.log", "local.log"});
+
+    CatchUpProgress progress;
+    progress.backlog_bytes  = 4000;
+    progress.received_bytes = 1000;
+    progress.elapsed        = std::chrono::seconds(2);
+    monitor.record_catch_up(0, progress);
+    progress.received_bytes = 4000;
+    progress.elapsed        = std::chrono::seconds(4);
+    progress.complete       = true;
+    monitor.record_catch_up(0, progress);
+    monitor.record_catch_up(5, progress);
+
+    const auto snapshot = monitor.snapshot();
+    ASSERT_TRUE(snapshot.sources[0].catch_up.has_value());
+    EXPECT_TRUE(snapshot.sources[0].catch_up->complete);
+    EXPECT_DOUBLE_EQ(snapshot.sources[0].catch_up->bytes_per_second(), 1000.0);
+    EXPECT_FALSE(snapshot.sources[1].catch_up.has_value());
+
+    monitor.set_sources({"ssh://alpha/app.log"});
+    EXPECT_FALSE(monitor.snapshot().sources[0].catch_up.has_value());
+}
+
+TEST(PerformanceMonitorTest, MonitoredLockGuardRecordsWaitAndHoldPerThread)
+{
+    FakeClock clock;
+    PerformanceMonitor monitor = make_monitor(clock);
+    std::mutex mutex;
+
+    {
+        const MonitoredLockGuard lock(mutex, monitor, LockHolder::Watcher);
+        EXPECT_FALSE(mutex.try_lock());
+    }
+
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+
+    for (int index = 0; index < 2; ++index)
+    {
+        const MonitoredLockGuard lock(mutex, monitor, LockHolder::Ui);
+    }
+
+    clock.advance(std::chrono::milliseconds(1000));
+    const auto snapshot = monitor.snapshot();
+    EXPECT_EQ(snapshot.stage(PerformanceStage::WatcherLockWait).samples, 1U);
+    EXPECT_EQ(snapshot.stage(PerformanceStage::WatcherLockHold).samples, 1U);
+    EXPECT_EQ(snapshot.stage(PerformanceStage::UiLockWait).samples, 2U);
+    EXPECT_EQ(snapshot.stage(PerformanceStage::UiLockHold).samples, 2U);
+}
+
+TEST(PerformanceMonitorTest, LogModelReportsRebuildsAndMemoryUsage)
+{
+    FakeClock clock;
+    PerformanceMonitor monitor = make_monitor(clock);
+    LogModel model;
+    model.set_performance_monitor(&monitor);
+
+    model.append_lines({{"alpha.log", "first"}, {"alpha.log", "second"}});
+    model.add_include_filter("first");
+    model.set_find_query("second");
+    model.toggle_pause();
+    model.append_lines({{"alpha.log", "third"}});
+
+    const auto memory_usage = model.memory_usage();
+    EXPECT_EQ(memory_usage.entry_count, 2U);
+    EXPECT_GE(memory_usage.entry_bytes, std::string("alpha.logfirstalpha.logsecond").size());
+    EXPECT_EQ(memory_usage.paused_entry_count, 1U);
+    EXPECT_GE(memory_usage.paused_bytes, std::string("alpha.logthird").size());
+    EXPECT_GT(memory_usage.level_index_bytes, 0U);
+    EXPECT_EQ(memory_usage.total_bytes(), memory_usage.entry_bytes + memory_usage.visible_index_bytes + memory_usage.find_index_bytes + memory_usage.field_column_bytes
+                                              + memory_usage.level_index_bytes + memory_usage.timeline_bytes + memory_usage.template_bytes + memory_usage.paused_bytes);
+
+    clock.advance(std::chrono::milliseconds(1000));
+    const auto snapshot = monitor.snapshot();
+    EXPECT_EQ(snapshot.stage(PerformanceStage::FilterRebuild).samples, 1U);
+    EXPECT_EQ(snapshot.stage(PerformanceStage::FindRebuild).samples, 2U);
+
+    model.toggle_pause();
+    EXPECT_EQ(model.memory_usage().paused_entry_count, 0U);
+    EXPECT_EQ(model.memory_usage().entry_count, 3U);
+}
+
+TEST(PerformanceHudFormatTest, FormatsByteSizesAndDurations)
+{
+    EXPECT_EQ(format_byte_size(512), "512 B");
+    EXPECT_EQ(format_byte_size(1536), "1.5 KiB");
+    EXPECT_EQ(format_byte_size(3 * 1024 * 1024), "3.0 MiB");
+
+    EXPECT_EQ(format_stage_duration(std::chrono::microseconds(250)), "250 us");
+    EXPECT_EQ(format_stage_duration(std::chrono::microseconds(1500)), "1.50 ms");
+    EXPECT_EQ(format_stage_duration(std::chrono::milliseconds(2500)), "2.50 s");
+}
+
+} // namespace slayerlog
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pipe_reactor.hpp"
+#include "process_pipe.hpp"
+
+namespace slayerlog
+{
+
+TEST(PipeReactorTest, WaitTimesOutWithoutActivity)
+{
+    PipeReactor reactor;
+
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_FALSE(reactor.wait(std::chrono::milliseconds(20)));
+    EXPECT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(15));
+}
+
+TEST(PipeReactorTest, WakeInterruptsWait)
+{
+    PipeReactor reactor;
+    std::thread waker(
+        [&reactor]
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            reactor.wake();
+        });
+
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_TRUE(reactor.wait(std::chrono::seconds(10)));
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(5));
+    waker.join();
+
+    EXPECT_FALSE(reactor.wait(std::chrono::milliseconds(1)));
+}
+
+#ifdef __linux__
+
+TEST(PipeReactorTest, WakesWhenRegisteredProcessWritesAndStopsAfterItExits)
+{
+    PipeReactor reactor;
+    ProcessPipe pipe("sh", {"-c", "sleep 0.05; echo ready"}, &reactor);
+
+    ASSERT_TRUE(reactor.wait(std::chrono::seconds(10)));
+
+    std::string output;
+    std::vector<char> buffer(256);
+    bool stdout_ended = false;
+    while (!stdout_ended)
+    {
+        output.append(buffer.data(), pipe.read_stdout(buffer.data(), buffer.size(), stdout_ended));
+        if (!stdout_ended)
+        {
+            reactor.wait(std::chrono::seconds(1));
+        }
+    }
+
+    bool stderr_ended = false;
+    while (!stderr_ended)
+    {
+        pipe.read_stderr(buffer.data(), buffer.size(), stderr_ended);
+        if (!stderr_ended)
+        {
+            reactor.wait(std::chrono::seconds(1));
+        }
+    }
+
+    EXPECT_EQ(output, "ready\n");
+    EXPECT_EQ(pipe.wait(), 0);
+    // Both pipes hit end of stream and were unregistered, so the reactor is idle again.
+    EXPECT_FALSE(reactor.wait(std::chrono::milliseconds(20)));
+}
+
+#endif
+
+} // namespace slayerlog
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "poll_scheduler.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+struct FakeClock
+{
+    RedrawThrottle::Clock::time_point now {};
+
+    void advance(std::chrono::milliseconds duration) { now += duration; }
+};
+
+} // namespace
+
+TEST(AdaptivePollIntervalTest, PollsFasterWhileActiveAndBacksOffWhenIdle)
+{
+    AdaptivePollInterval interval(std::chrono::milliseconds(250), std::chrono::milliseconds(20));
+    EXPECT_EQ(interval.current(), std::chrono::milliseconds(250));
+
+    interval.record_poll(true);
+    EXPECT_EQ(interval.current(), std::chrono::milliseconds(20));
+
+    interval.record_poll(false);
+    EXPECT_EQ(interval.current(), std::chrono::milliseconds(40));
+    interval.record_poll(false);
+    interval.record_poll(false);
+    interval.record_poll(false);
+    EXPECT_EQ(interval.current(), std::chrono::milliseconds(250));
+}
+
+TEST(AdaptivePollIntervalTest, ActiveIntervalNeverExceedsIdleInterval)
+{
+    AdaptivePollInterval interval(std::chrono::milliseconds(5));
+
+    interval.record_poll(true);
+    EXPECT_EQ(interval.current(), std::chrono::milliseconds(5));
+}
+
+TEST(RedrawThrottleTest, FoldsRequestsWithinOneFrame)
+{
+    FakeClock clock;
+    RedrawThrottle throttle(10, [&clock] { return clock.now; });
+
+    EXPECT_TRUE(throttle.request());
+    EXPECT_FALSE(throttle.time_until_due().has_value());
+
+    clock.advance(std::chrono::milliseconds(30));
+    EXPECT_FALSE(throttle.request());
+    EXPECT_FALSE(throttle.request());
+    EXPECT_EQ(throttle.time_until_due(), std::chrono::nanoseconds(std::chrono::milliseconds(70)));
+    EXPECT_FALSE(throttle.take_due());
+
+    clock.advance(std::chrono::milliseconds(70));
+    EXPECT_TRUE(throttle.take_due());
+    EXPECT_FALSE(throttle.take_due());
+}
+
+TEST(RedrawThrottleTest, ZeroFpsRedrawsEveryRequest)
+{
+    FakeClock clock;
+    RedrawThrottle throttle(0, [&clock] { return clock.now; });
+
+    EXPECT_TRUE(throttle.request());
+    EXPECT_TRUE(throttle.request());
+}
+
+} // namespace slayerlog
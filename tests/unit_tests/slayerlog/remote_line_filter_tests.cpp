@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "remote_line_filter.hpp"
+
+namespace slayerlog
+{
+
+TEST(RemoteLineFilterTest, PushesLiteralIncludeFilters)
+{
+    const auto filter = build_remote_line_filter({"request=42", "request=43"}, {"DEBUG"}, "api.log");
+
+    EXPECT_EQ(filter.include_literals, (std::vector<std::string> {"request=42", "request=43"}));
+    EXPECT_TRUE(filter.exclude_literals.empty());
+}
+
+TEST(RemoteLineFilterTest, KeepsIncludesLocalWhenTheyCannotBeExpressedRemotely)
+{
+    const auto regex_filter = build_remote_line_filter({"request=42", "re:id=[0-9]+"}, {"DEBUG", "re:trace.*"}, "api.log");
+    EXPECT_TRUE(regex_filter.include_literals.empty());
+    EXPECT_EQ(regex_filter.exclude_literals, (std::vector<std::string> {"DEBUG"}));
+
+    // Every line of api.log matches an include filter through its label, so nothing may be dropped remotely.
+    const auto label_filter = build_remote_line_filter({"api"}, {}, "api.log");
+    EXPECT_TRUE(label_filter.empty());
+}
+
+TEST(RemoteLineFilterTest, EmptyWithoutFilters)
+{
+    EXPECT_TRUE(build_remote_line_filter({}, {}, "api.log").empty());
+    EXPECT_EQ(build_remote_line_filter({}, {}, "api.log"), RemoteLineFilter {});
+}
+
+TEST(RemoteLineFilterTest, CoversFiltersThatSendNoLineItWouldNot)
+{
+    const RemoteLineFilter everything;
+    const RemoteLineFilter requests {{"request="}, {}};
+    const RemoteLineFilter request_42 {{"request=42", "request=43"}, {}};
+    const RemoteLineFilter no_debug {{}, {"DEBUG"}};
+    const RemoteLineFilter no_debug_or_trace {{}, {"DEBUG", "TRACE"}};
+
+    EXPECT_TRUE(remote_line_filter_covers(everything, requests));
+    EXPECT_TRUE(remote_line_filter_covers(requests, request_42));
+    EXPECT_TRUE(remote_line_filter_covers(no_debug, no_debug_or_trace));
+    EXPECT_TRUE(remote_line_filter_covers(requests, requests));
+
+    // Widening a filter needs the lines it dropped, which the narrower one never sent.
+    EXPECT_FALSE(remote_line_filter_covers(request_42, requests));
+    EXPECT_FALSE(remote_line_filter_covers(no_debug_or_trace, no_debug));
+    EXPECT_FALSE(remote_line_filter_covers(requests, everything));
+    EXPECT_FALSE(remote_line_filter_covers(requests, no_debug));
+    EXPECT_FALSE(remote_line_filter_covers(no_debug, requests));
+}
+
+} // namespace slayerlog
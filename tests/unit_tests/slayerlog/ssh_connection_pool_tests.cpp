@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "log_source.hpp"
+#include "watchers/ssh_connection_pool.hpp"
+#include "watchers/ssh_tail_watcher.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+std::filesystem::path unique_control_directory()
+{
+    return std::filesystem::temp_directory_path() / ("slayerlog-ssh-pool-test-" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "-" +
+                                                     ::testing::UnitTest::GetInstance()->current_test_info()->name());
+}
+
+} // namespace
+
+#ifndef _WIN32
+
+TEST(SshConnectionPoolTest, GivesEachTargetItsOwnControlPath)
+{
+    const auto directory = unique_control_directory();
+    SshConnectionPool pool(directory);
+
+    const auto first       = pool.session_arguments("alice@alpha");
+    const auto first_again = pool.session_arguments("alice@alpha");
+    const auto second      = pool.session_arguments("bob@beta");
+
+    ASSERT_EQ(first.size(), 4U);
+    EXPECT_EQ(first[0], "-o");
+    EXPECT_EQ(first[1], "ControlMaster=no");
+    EXPECT_EQ(first[2], "-o");
+    EXPECT_EQ(first[3].rfind("ControlPath=" + directory.string(), 0), 0U);
+    EXPECT_EQ(first, first_again);
+    EXPECT_NE(first[3], second[3]);
+}
+
+TEST(SshConnectionPoolTest, OwnsItsControlDirectory)
+{
+    const auto directory = unique_control_directory();
+    {
+        SshConnectionPool pool(directory);
+        ASSERT_TRUE(std::filesystem::is_directory(directory));
+        EXPECT_EQ(std::filesystem::status(directory).permissions() & std::filesystem::perms::all, std::filesystem::perms::owner_all);
+    }
+
+    EXPECT_FALSE(std::filesystem::exists(directory));
+}
+
+#endif
+
+TEST(SshConnectionPoolTest, MasterArgumentsRunWithoutRemoteCommand)
+{
+    const auto arguments = SshConnectionPool::build_master_arguments("alice@alpha", "/tmp/slayerlog-ssh/m0");
+
+    ASSERT_FALSE(arguments.empty());
+    EXPECT_EQ(arguments.back(), "alice@alpha");
+    EXPECT_NE(std::find(arguments.begin(), arguments.end(), "-M"), arguments.end());
+    EXPECT_NE(std::find(arguments.begin(), arguments.end(), "-N"), arguments.end());
+    EXPECT_NE(std::find(arguments.begin(), arguments.end(), "ControlPath=/tmp/slayerlog-ssh/m0"), arguments.end());
+}
+
+TEST(SshConnectionPoolTest, CompressionAppliesToMasterAndSessions)
+{
+    SshConnectionPool pool(unique_control_directory());
+    const auto plain_arguments = pool.session_arguments("alice@alpha");
+    EXPECT_EQ(std::find(plain_arguments.begin(), plain_arguments.end(), "-C"), plain_arguments.end());
+
+    pool.set_compression(true);
+    const auto session_arguments = pool.session_arguments("alice@alpha");
+    const auto master_arguments  = SshConnectionPool::build_master_arguments("alice@alpha", "/tmp/m0", true);
+    EXPECT_TRUE(pool.compression());
+    EXPECT_NE(std::find(session_arguments.begin(), session_arguments.end(), "-C"), session_arguments.end());
+    EXPECT_NE(std::find(master_arguments.begin(), master_arguments.end(), "-C"), master_arguments.end());
+    EXPECT_EQ(master_arguments.back(), "alice@alpha");
+}
+
+TEST(SshConnectionPoolTest, TailSessionAnnouncesWhereItResumed)
+{
+    const auto source    = parse_log_source("ssh://alice@alpha/var/log/app.log");
+    const auto arguments = SshTailWatcher::build_ssh_arguments(source, "4242", 128);
+
+    ASSERT_FALSE(arguments.empty());
+    EXPECT_EQ(arguments[arguments.size() - 2], source.ssh_target);
+    EXPECT_EQ(arguments.back().rfind("sh -lc 'f=", 0), 0U);
+    EXPECT_NE(arguments.back().find("off=128;"), std::string::npos);
+    EXPECT_NE(arguments.back().find("slayerlog-resume $ino $off $((size - off))"), std::string::npos);
+}
+
+TEST(SshConnectionPoolTest, TailSessionPlacesConnectionOptionsBeforeTarget)
+{
+    const auto source    = parse_log_source("ssh://alice@alpha/var/log/app.log");
+    const auto arguments = SshTailWatcher::build_ssh_arguments(source, "", 0, {"-o", "ControlPath=/tmp/m0"});
+
+    const auto control_path = std::find(arguments.begin(), arguments.end(), "ControlPath=/tmp/m0");
+    const auto target       = std::find(arguments.begin(), arguments.end(), source.ssh_target);
+    ASSERT_NE(control_path, arguments.end());
+    ASSERT_NE(target, arguments.end());
+    EXPECT_LT(control_path, target);
+    EXPECT_EQ(std::find(arguments.begin(), arguments.end(), "-M"), arguments.end());
+}
+
+} // namespace slayerlog
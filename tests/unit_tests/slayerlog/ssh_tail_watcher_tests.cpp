@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+
+#ifndef _WIN32
+
+#    include <algorithm>
+#    include <chrono>
+#    include <cstdlib>
+#    include <filesystem>
+#    include <fstream>
+#    include <functional>
+#    include <string>
+#    include <thread>
+#    include <vector>
+
+#    include "log_source.hpp"
+#    include "watchers/ssh_tail_watcher.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+// Runs the remote command locally and drops the "connection" whenever the test creates the disconnect file. Like sshd,
+// it joins the command arguments with spaces and hands the result to a shell.
+constexpr const char* fake_ssh_script = R"(#!/bin/sh
+while [ "${1#-}" != "$1" ]; do if [ "$1" = "-o" ]; then shift; fi; shift; done
+shift
+sh -c "$*" &
+child=$!
+while kill -0 $child 2>/dev/null; do
+    if [ -e "$SLAYERLOG_FAKE_SSH_DIR/disconnect" ]; then rm -f "$SLAYERLOG_FAKE_SSH_DIR/disconnect"; kill $child; exit 255; fi
+    sleep 0.05
+done
+wait $child
+)";
+
+class FakeSshEnvironment
+{
+public:
+    FakeSshEnvironment()
+    {
+        const auto unique_suffix = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        _path                    = std::filesystem::temp_directory_path() / ("slayerlog_ssh_tail_watcher_" + unique_suffix);
+        std::filesystem::create_directories(_path);
+
+        const auto ssh_path = _path / "ssh";
+        std::ofstream(ssh_path) << fake_ssh_script;
+        std::filesystem::permissions(ssh_path, std::filesystem::perms::owner_all);
+
+        const char* path = std::getenv("PATH");
+        _saved_path      = path != nullptr ? path : "";
+        ::setenv("PATH", (_path.string() + ":" + _saved_path).c_str(), 1);
+        ::setenv("SLAYERLOG_FAKE_SSH_DIR", _path.c_str(), 1);
+    }
+
+    ~FakeSshEnvironment()
+    {
+        ::setenv("PATH", _saved_path.c_str(), 1);
+        ::unsetenv("SLAYERLOG_FAKE_SSH_DIR");
+        std::error_code error;
+        std::filesystem::remove_all(_path, error);
+    }
+
+    std::filesystem::path log_path() const { return _path / "app.log"; }
+
+    void append(const std::string& text) const { std::ofstream(log_path(), std::ios::binary | std::ios::app) << text; }
+
+    void disconnect() const { std::ofstream(_path / "disconnect") << "1"; }
+
+private:
+    std::filesystem::path _path;
+    std::string _saved_path;
+};
+
+bool contains(const std::vector<std::string>& lines, const std::string& text)
+{
+    return std::find(lines.begin(), lines.end(), text) != lines.end();
+}
+
+bool poll_until(SshTailWatcher& watcher, std::vector<std::string>& collected, const std::function<bool()>& done)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        std::vector<std::string> lines;
+        watcher.poll(lines);
+        collected.insert(collected.end(), lines.begin(), lines.end());
+        if (done())
+        {
+            return true;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    return false;
+}
+
+/** @brief Like poll_until, but keeps the batches with the details poll() leaves out. */
+bool poll_batches_until(SshTailWatcher& watcher, std::vector<MemberLineBatch>& collected, const std::function<bool()>& done)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        std::vector<MemberLineBatch> batches;
+        watcher.poll_members(batches);
+        for (auto& batch : batches)
+        {
+            if (!batch.lines.empty())
+            {
+                collected.push_back(std::move(batch));
+            }
+        }
+
+        if (done())
+        {
+            return true;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    return false;
+}
+
+bool batches_contain(const std::vector<MemberLineBatch>& batches, const std::string& text)
+{
+    return std::any_of(batches.begin(), batches.end(), [&](const MemberLineBatch& batch) { return contains(batch.lines, text); });
+}
+
+/** @brief Joins batches that may have been split across polls; refetched is only set when every batch was. */
+MemberLineBatch join_batches(const std::vector<MemberLineBatch>& batches)
+{
+    MemberLineBatch joined;
+    joined.refetched = !batches.empty();
+    for (const auto& batch : batches)
+    {
+        for (const auto& skipped : batch.skipped)
+        {
+            joined.skipped.push_back(SkippedLines {joined.lines.size() + skipped.line, skipped.count});
+        }
+
+        joined.lines.insert(joined.lines.end(), batch.lines.begin(), batch.lines.end());
+        joined.refetched = joined.refetched && batch.refetched;
+        joined.replaced_line_count += batch.replaced_line_count;
+    }
+
+    return joined;
+}
+
+} // namespace
+
+TEST(SshTailWatcherTest, ResumesAfterDisconnectWithoutLosingOrRepeatingBytes)
+{
+    FakeSshEnvironment environment;
+    environment.append("alpha\nbe");
+    SshTailWatcher watcher(parse_log_source("ssh://fake-host" + environment.log_path().string()));
+
+    std::vector<std::string> collected;
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "alpha"); }));
+    const auto progress = watcher.catch_up_progress();
+    ASSERT_TRUE(progress.has_value());
+    EXPECT_EQ(progress->backlog_bytes, 8U);
+
+    environment.disconnect();
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return collected.back().rfind("[slayerlog] remote stream disconnected", 0) == 0; }));
+
+    environment.append("ta\ngamma\n");
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "gamma"); }));
+
+    EXPECT_EQ(std::count(collected.begin(), collected.end(), "alpha"), 1);
+    EXPECT_TRUE(contains(collected, "beta"));
+    ASSERT_TRUE(watcher.catch_up_progress().has_value());
+    EXPECT_TRUE(watcher.catch_up_progress()->backfill);
+}
+
+TEST(SshTailWatcherTest, FollowsRotationByInode)
+{
+    FakeSshEnvironment environment;
+    environment.append("old one\nold tail");
+    SshTailWatcher watcher(parse_log_source("ssh://fake-host" + environment.log_path().string()));
+
+    std::vector<std::string> collected;
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "old one"); }));
+
+    // The replacement is larger than the offset already read, so only the inode reveals the rotation.
+    const auto rotated_path = environment.log_path().string() + ".1";
+    std::filesystem::rename(environment.log_path(), rotated_path);
+    environment.append("new one\nnew two\nnew three\n");
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "new three"); }));
+
+    EXPECT_EQ(std::count(collected.begin(), collected.end(), "old one"), 1);
+    EXPECT_TRUE(contains(collected, "old tail"));
+    EXPECT_TRUE(contains(collected, "new one"));
+    EXPECT_TRUE(std::none_of(collected.begin(), collected.end(), [](const std::string& line) { return line.rfind("[slayerlog] remote stream disconnected", 0) == 0; }));
+}
+
+TEST(SshTailWatcherTest, RemoteFilterSendsOnlyMatchingLinesAndResumesExactly)
+{
+    FakeSshEnvironment environment;
+    environment.append("request=1 start\nrequest=2 start\n");
+    SshTailWatcher watcher(parse_log_source("ssh://fake-host" + environment.log_path().string()));
+
+    std::vector<std::string> collected;
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "request=2 start"); }));
+
+    watcher.set_remote_filter(RemoteLineFilter {{"request=2"}, {}});
+    environment.append("request=1 body\nrequest=2 body\n");
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "request=2 body"); }));
+
+    environment.disconnect();
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return collected.back().rfind("[slayerlog] remote stream disconnected", 0) == 0; }));
+    environment.append("request=2 end\nrequest=1 end\n");
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "request=2 end"); }));
+
+    EXPECT_FALSE(contains(collected, "request=1 body"));
+    EXPECT_FALSE(contains(collected, "request=1 end"));
+    EXPECT_EQ(std::count(collected.begin(), collected.end(), "request=2 body"), 1);
+    EXPECT_EQ(std::count(collected.begin(), collected.end(), "request=2 start"), 1);
+}
+
+TEST(SshTailWatcherTest, RemoteFilterResumesAfterCrlfLineEnds)
+{
+    FakeSshEnvironment environment;
+    environment.append("keep one\r\n");
+    SshTailWatcher watcher(parse_log_source("ssh://fake-host" + environment.log_path().string()));
+
+    std::vector<std::string> collected;
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "keep one"); }));
+
+    watcher.set_remote_filter(RemoteLineFilter {{}, {"drop"}});
+    environment.append("drop two\r\nkeep three\r\n");
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "keep three"); }));
+
+    // A resume offset that stopped on the '\n' of "keep three" would send an empty line after reconnecting.
+    environment.disconnect();
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return collected.back().rfind("[slayerlog] remote stream disconnected", 0) == 0; }));
+    environment.append("keep four\r\n");
+    ASSERT_TRUE(poll_until(watcher, collected, [&] { return contains(collected, "keep four"); }));
+
+    EXPECT_FALSE(contains(collected, ""));
+    EXPECT_FALSE(contains(collected, "drop two"));
+    EXPECT_EQ(std::count(collected.begin(), collected.end(), "keep three"), 1);
+}
+
+TEST(SshTailWatcherTest, RemoteFilterReportsHowManyLinesItDropped)
+{
+    FakeSshEnvironment environment;
+    environment.append("keep 1\ndrop 2\nkeep 3\n");
+    SshTailWatcher watcher(parse_log_source("ssh://fake-host" + environment.log_path().string()));
+    watcher.set_remote_filter(RemoteLineFilter {{"keep"}, {}});
+
+    std::vector<MemberLineBatch> collected;
+    ASSERT_TRUE(poll_batches_until(watcher, collected, [&] { return batches_contain(collected, "keep 3"); }));
+    auto joined = join_batches(collected);
+    EXPECT_EQ(joined.lines, (std::vector<std::string> {"keep 1", "keep 3"}));
+    ASSERT_EQ(joined.skipped.size(), 1U);
+    EXPECT_EQ(joined.skipped[0].line, 1U);
+    EXPECT_EQ(joined.skipped[0].count, 1U);
+
+    // The numbering goes on across a reconnect, which starts counting from where the last session stopped.
+    environment.disconnect();
+    ASSERT_TRUE(poll_batches_until(watcher, collected, [&] { return collected.back().lines.back().rfind("[slayerlog] remote stream disconnected", 0) == 0; }));
+    environment.append("drop 4\ndrop 5\nkeep 6\n");
+    collected.clear();
+    ASSERT_TRUE(poll_batches_until(watcher, collected, [&] { return batches_contain(collected, "keep 6"); }));
+    joined = join_batches(collected);
+    EXPECT_EQ(joined.lines, (std::vector<std::string> {"keep 6"}));
+    ASSERT_EQ(joined.skipped.size(), 1U);
+    EXPECT_EQ(joined.skipped[0].count, 2U);
+    EXPECT_FALSE(joined.refetched);
+}
+
+TEST(SshTailWatcherTest, WiderRemoteFilterReadsTheDroppedLinesAgain)
+{
+    FakeSshEnvironment environment;
+    environment.append("keep 1\ndrop 2\nkeep 3\n");
+    SshTailWatcher watcher(parse_log_source("ssh://fake-host" + environment.log_path().string()));
+    watcher.set_remote_filter(RemoteLineFilter {{"keep"}, {}});
+
+    std::vector<MemberLineBatch> collected;
+    ASSERT_TRUE(poll_batches_until(watcher, collected, [&] { return batches_contain(collected, "keep 3"); }));
+
+    // Narrowing the filter needs nothing read again.
+    watcher.set_remote_filter(RemoteLineFilter {{"keep 3"}, {}});
+    environment.append("keep 4\nkeep 3 again\n");
+    collected.clear();
+    ASSERT_TRUE(poll_batches_until(watcher, collected, [&] { return batches_contain(collected, "keep 3 again"); }));
+    auto joined = join_batches(collected);
+    EXPECT_FALSE(joined.refetched);
+    EXPECT_EQ(joined.lines, (std::vector<std::string> {"keep 3 again"}));
+
+    // Dropping the filter reads again from where "keep" first applied; the three lines sent since are replaced.
+    watcher.set_remote_filter(RemoteLineFilter {});
+    collected.clear();
+    ASSERT_TRUE(poll_batches_until(watcher, collected, [&] { return batches_contain(collected, "keep 3 again"); }));
+    joined = join_batches(collected);
+    EXPECT_TRUE(joined.refetched);
+    EXPECT_EQ(joined.replaced_line_count, 3U);
+    EXPECT_EQ(joined.lines, (std::vector<std::string> {"keep 1", "drop 2", "keep 3", "keep 4", "keep 3 again"}));
+    EXPECT_TRUE(joined.skipped.empty());
+
+    environment.append("drop 6\n");
+    collected.clear();
+    ASSERT_TRUE(poll_batches_until(watcher, collected, [&] { return batches_contain(collected, "drop 6"); }));
+    EXPECT_FALSE(join_batches(collected).refetched);
+}
+
+} // namespace slayerlog
+
+#endif
@@ -34,6 +34,19 @@ TEST(StreamLineBufferTest, HoldsIncompleteTrailingFragment)
     EXPECT_FALSE(buffer.has_pending_fragment());
 }
 
+TEST(StreamLineBufferTest, CountsCarriageReturnsSplitAcrossChunks)
+{
+    StreamLineBuffer buffer;
+    std::vector<std::string> lines;
+
+    EXPECT_EQ(buffer.append("first\r\nsec", lines), std::string("first\r\n").size());
+    EXPECT_EQ(buffer.append("ond\r", lines), 0U);
+    EXPECT_EQ(buffer.append("\nthird\r\n", lines), std::string("second\r\nthird\r\n").size());
+
+    EXPECT_EQ(lines, (std::vector<std::string> {"first", "second", "third"}));
+    EXPECT_FALSE(buffer.has_pending_fragment());
+}
+
 TEST(StreamLineBufferTest, DiscardsPendingFragment)
 {
     StreamLineBuffer buffer;
@@ -47,4 +60,17 @@ TEST(StreamLineBufferTest, DiscardsPendingFragment)
     EXPECT_EQ(lines, (std::vector<std::string> {"fresh"}));
 }
 
+TEST(StreamLineBufferTest, FlushesUnterminatedFragmentAsLine)
+{
+    StreamLineBuffer buffer;
+    std::vector<std::string> lines;
+
+    buffer.append("complete\ntrailing\r", lines);
+    buffer.flush_pending_fragment(lines);
+    buffer.flush_pending_fragment(lines);
+
+    EXPECT_EQ(lines, (std::vector<std::string> {"complete", "trailing"}));
+    EXPECT_FALSE(buffer.has_pending_fragment());
+}
+
 } // namespace slayerlog
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "structured_fields.hpp"
+
+namespace slayerlog
+{
+
+TEST(StructuredFieldsTest, ExtractsTopLevelScalarsAndSkipsNestedValues)
+{
+    const std::vector<std::string> names {"level", "latency_ms", "trace_id", "ok", "missing"};
+    std::vector<std::optional<JsonScalar>> values;
+
+    ASSERT_TRUE(extract_json_fields(R"({"ctx":{"level":"DEBUG","list":[1,{"x":"]"}]},"level":"ERR\u00e9\"", "latency_ms": 512.5 ,"ok":true,"trace_id":"abc"})", names, values));
+
+    ASSERT_EQ(values.size(), names.size());
+    ASSERT_TRUE(values[0].has_value());
+    EXPECT_EQ(values[0]->text, "ERR\xC3\xA9\"");
+    EXPECT_FALSE(values[0]->number.has_value());
+    ASSERT_TRUE(values[1].has_value());
+    EXPECT_DOUBLE_EQ(*values[1]->number, 512.5);
+    EXPECT_EQ(values[2]->text, "abc");
+    EXPECT_EQ(values[3]->text, "true");
+    EXPECT_FALSE(values[4].has_value());
+}
+
+TEST(StructuredFieldsTest, RejectsLinesThatAreNotJsonObjects)
+{
+    const std::vector<std::string> names {"level"};
+    std::vector<std::optional<JsonScalar>> values;
+
+    EXPECT_FALSE(extract_json_fields("2024-01-01 level=ERROR", names, values));
+    ASSERT_EQ(values.size(), 1U);
+    EXPECT_FALSE(values[0].has_value());
+}
+
+TEST(StructuredFieldsTest, ParsesFieldFilters)
+{
+    const auto equal = parse_field_filter(" level = \"ERROR\" ");
+    EXPECT_EQ(equal.field, "level");
+    EXPECT_EQ(equal.comparison, FieldComparison::Equal);
+    EXPECT_EQ(equal.operand, "ERROR");
+
+    const auto greater = parse_field_filter("latency_ms>=500");
+    EXPECT_EQ(greater.field, "latency_ms");
+    EXPECT_EQ(greater.comparison, FieldComparison::GreaterOrEqual);
+    EXPECT_DOUBLE_EQ(*greater.number, 500.0);
+
+    EXPECT_EQ(parse_field_filter("level!=DEBUG").comparison, FieldComparison::NotEqual);
+    EXPECT_THROW(parse_field_filter("level"), std::invalid_argument);
+    EXPECT_THROW(parse_field_filter("=ERROR"), std::invalid_argument);
+    EXPECT_THROW(parse_field_filter("level>high"), std::invalid_argument);
+}
+
+TEST(StructuredFieldsTest, FiltersCompareColumnValuesAndSurviveEviction)
+{
+    StructuredFields fields;
+    EXPECT_TRUE(fields.add_filter(parse_field_filter("level=ERROR")));
+    EXPECT_TRUE(fields.add_filter(parse_field_filter("latency_ms>500")));
+    EXPECT_FALSE(fields.add_fields({"level"}));
+
+    fields.append(R"({"level":"ERROR","latency_ms":900})");
+    fields.append(R"({"level":"ERROR","latency_ms":100})");
+    fields.append(R"({"level":"INFO","latency_ms":900})");
+    fields.append("plain text line");
+    fields.append(R"({"level":"ERROR","latency_ms":"slow"})");
+    fields.append(R"({"latency_ms":700,"level":"ERROR"})");
+
+    ASSERT_EQ(fields.row_count(), 6U);
+    std::vector<bool> matches;
+    for (std::size_t row = 0; row < fields.row_count(); ++row)
+    {
+        matches.push_back(fields.matches_filters(row));
+    }
+
+    EXPECT_EQ(matches, (std::vector<bool> {true, false, false, false, false, true}));
+
+    fields.erase_front(5);
+    ASSERT_EQ(fields.row_count(), 1U);
+    EXPECT_TRUE(fields.matches_filters(0));
+
+    fields.clear_filters();
+    EXPECT_FALSE(fields.has_filters());
+    EXPECT_TRUE(fields.filter_texts().empty());
+}
+
+} // namespace slayerlog
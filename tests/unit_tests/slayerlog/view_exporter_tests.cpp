@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "log_model.hpp"
+#include "view_exporter.hpp"
+
+namespace slayerlog
+{
+
+namespace
+{
+
+std::filesystem::path make_temp_export_path()
+{
+    const auto unique_suffix = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    return std::filesystem::temp_directory_path() / ("slayerlog_view_exporter_tests_" + unique_suffix + ".log");
+}
+
+std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream input(path, std::ios::binary);
+    std::ostringstream content;
+    content << input.rdbuf();
+    return content.str();
+}
+
+} // namespace
+
+TEST(ViewExporterTest, WritesFilteredLinesAndReportsCompletion)
+{
+    std::mutex model_mutex;
+    LogModel model;
+    model.set_show_source_labels(true);
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "error one"},
+        ObservedLogLine {"beta.log", "info two"},
+        ObservedLogLine {"beta.log", "error three"},
+    });
+    model.add_include_filter("error");
+
+    const auto path = make_temp_export_path();
+    int progress_calls = 0;
+    ViewExporter exporter(model, model_mutex);
+    exporter.start(path, model.export_entry_indices(false), [&progress_calls] { ++progress_calls; });
+    exporter.wait();
+
+    EXPECT_EQ(read_file(path), "[alpha.log] error one\n[beta.log] error three\n");
+    const auto progress = exporter.progress();
+    EXPECT_FALSE(progress.running);
+    EXPECT_TRUE(progress.error.empty());
+    EXPECT_EQ(progress.written_lines, 2U);
+    EXPECT_GE(progress_calls, 1);
+    ASSERT_TRUE(progress.finished_at.has_value());
+    EXPECT_EQ(describe_view_export(progress, *progress.finished_at), "saved 2 lines to " + path.string());
+    EXPECT_EQ(describe_view_export(progress, *progress.finished_at + std::chrono::minutes(1)), "");
+
+    std::filesystem::remove(path);
+}
+
+TEST(ViewExporterTest, SkipsLinesEvictedBeforeTheyAreWritten)
+{
+    std::mutex model_mutex;
+    LogModel model;
+    model.set_retention_limits(LogRetentionLimits {4, 0});
+    model.append_lines({
+        ObservedLogLine {"alpha.log", "one"},
+        ObservedLogLine {"alpha.log", "two"},
+        ObservedLogLine {"alpha.log", "three"},
+        ObservedLogLine {"alpha.log", "four"},
+    });
+    auto entries = model.export_entry_indices(false);
+    model.append_lines({ObservedLogLine {"alpha.log", "five"}, ObservedLogLine {"alpha.log", "six"}});
+
+    const auto path = make_temp_export_path();
+    ViewExporter exporter(model, model_mutex);
+    exporter.start(path, std::move(entries), {});
+    exporter.wait();
+
+    EXPECT_EQ(read_file(path), "three\nfour\n");
+    EXPECT_EQ(exporter.progress().evicted_lines, 2U);
+    EXPECT_THROW(exporter.start(path.parent_path() / "missing-directory" / "out.log", {}, {}), std::invalid_argument);
+
+    std::filesystem::remove(path);
+}
+
+TEST(ViewExporterTest, FailsWhenTheModelIsResetWhileSaving)
+{
+    std::mutex model_mutex;
+    LogModel model;
+    model.append_lines({ObservedLogLine {"alpha.log", "one"}, ObservedLogLine {"alpha.log", "two"}});
+
+    const auto path = make_temp_export_path();
+    ViewExporter exporter(model, model_mutex);
+    {
+        // The export thread waits for the lock, so the reset lands before it copies the first slice.
+        const std::lock_guard lock(model_mutex);
+        exporter.start(path, model.export_entry_indices(false), {});
+        model.reset();
+        model.append_lines({ObservedLogLine {"beta.log", "other"}});
+    }
+
+    exporter.wait();
+
+    const auto progress = exporter.progress();
+    EXPECT_FALSE(progress.running);
+    EXPECT_EQ(progress.error, "the log was reloaded while saving");
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+} // namespace slayerlog